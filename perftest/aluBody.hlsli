@@ -0,0 +1,67 @@
+#include "loadConstantsGPU.h"
+
+RWBuffer<float> output : register(u0);
+
+cbuffer CB0 : register(b0)
+{
+	LoadConstants loadConstants;
+};
+
+#define THREAD_GROUP_SIZE 256
+
+// Packed fp16 needs native 16 bit types, cs_5_0 only has the min precision hint. Drivers with fp16 ALUs run it at half precision.
+#if defined(ALU_FP32) || defined(ALU_TRANSCENDENTAL)
+#define ALU_TYPE float4
+#elif defined(ALU_FP16)
+#define ALU_TYPE min16float4
+#elif defined(ALU_INT32)
+#define ALU_TYPE uint4
+#endif
+
+#if defined(ALU_INT32)
+#define ALU_OP(v) (v * a + b)
+#elif defined(ALU_TRANSCENDENTAL)
+#define ALU_OP(v) rsqrt(v)
+#else
+#define ALU_OP(v) mad(v, a, b)
+#endif
+
+groupshared float dummyLDS[THREAD_GROUP_SIZE];
+
+[numthreads(THREAD_GROUP_SIZE, 1, 1)]
+void main(uint3 tid : SV_DispatchThreadID, uint gix : SV_GroupIndex)
+{
+	// Operands from the cbuffer, a = 1 and b = 0 at runtime. The compiler can't fold the chains.
+	ALU_TYPE a = (ALU_TYPE)(loadConstants.elementsMask + 1);
+	ALU_TYPE b = (ALU_TYPE)loadConstants.elementsMask;
+
+	// Four independent chains hide the ALU latency. Starting values are positive for rsqrt.
+	ALU_TYPE v0 = (ALU_TYPE)(gix + 1);
+	ALU_TYPE v1 = (ALU_TYPE)(gix + 2);
+	ALU_TYPE v2 = (ALU_TYPE)(gix + 3);
+	ALU_TYPE v3 = (ALU_TYPE)(gix + 4);
+
+	[unroll(8)]
+	for (int i = 0; i < 256; ++i)
+	{
+		v0 = ALU_OP(v0);
+		v1 = ALU_OP(v1);
+		v2 = ALU_OP(v2);
+		v3 = ALU_OP(v3);
+	}
+
+	float4 value = (float4)(v0 + v1 + v2 + v3);
+
+	// Linear write to LDS (no bank conflicts). Significantly faster than memory loads.
+	dummyLDS[gix] = value.x + value.y + value.z + value.w;
+
+	GroupMemoryBarrierWithGroupSync();
+
+	// This branch is never taken, but the compiler doesn't know it
+	// Optimizer would remove all the ALU work if the result wouldn't be potentially used
+	[branch]
+	if (loadConstants.writeIndex != 0xffffffff)
+	{
+		output[tid.x + tid.y] = dummyLDS[loadConstants.writeIndex];
+	}
+}
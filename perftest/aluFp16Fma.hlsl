@@ -0,0 +1,2 @@
+#define ALU_FP16
+#include "aluBody.hlsli"
@@ -0,0 +1,2 @@
+#define ALU_FP32
+#include "aluBody.hlsli"
@@ -0,0 +1,2 @@
+#define ALU_INT32
+#include "aluBody.hlsli"
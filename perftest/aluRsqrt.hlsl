@@ -0,0 +1,2 @@
+#define ALU_TRANSCENDENTAL
+#include "aluBody.hlsli"
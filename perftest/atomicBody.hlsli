@@ -0,0 +1,92 @@
+#include "hash.hlsli"
+#include "loadConstantsGPU.h"
+
+cbuffer CB0 : register(b0)
+{
+	LoadConstants loadConstants;
+};
+
+#define THREAD_GROUP_SIZE 256
+#define DISPATCH_WIDTH 1024				// Threads per row of the benchmark dispatch
+#define WAVE_SIZE 32					// Threads sharing an address with LOAD_WAVE. 64 wide waves hit two addresses.
+#define ATOMIC_ELEMENTS (1024 * 1024)	// Global target: one uint per thread of the dispatch
+
+#if defined(ATOMIC_GROUPSHARED)
+groupshared uint atomicLDS[THREAD_GROUP_SIZE];
+#define INTERLOCKED(op, index, v) Interlocked##op(atomicLDS[index], v)
+#define INTERLOCKED_COMPARE_EXCHANGE(index, compare, v, original) InterlockedCompareExchange(atomicLDS[index], compare, v, original)
+#elif defined(ATOMIC_RAW)
+#define INTERLOCKED(op, index, v) target.Interlocked##op((index) * 4, v)
+#define INTERLOCKED_COMPARE_EXCHANGE(index, compare, v, original) target.InterlockedCompareExchange((index) * 4, compare, v, original)
+#elif defined(ATOMIC_TYPED)
+#define INTERLOCKED(op, index, v) Interlocked##op(target[index], v)
+#define INTERLOCKED_COMPARE_EXCHANGE(index, compare, v, original) InterlockedCompareExchange(target[index], compare, v, original)
+#endif
+
+[numthreads(THREAD_GROUP_SIZE, 1, 1)]
+void main(uint3 tid : SV_DispatchThreadID, uint gix : SV_GroupIndex)
+{
+#if defined(ATOMIC_GROUPSHARED)
+	// Contention between the threads of the group
+	uint threadIndex = gix;
+	uint numElements = THREAD_GROUP_SIZE;
+	atomicLDS[gix] = 0;
+	GroupMemoryBarrierWithGroupSync();
+#else
+	// Contention between every thread of the dispatch
+	uint threadIndex = tid.y * DISPATCH_WIDTH + tid.x;
+	uint numElements = ATOMIC_ELEMENTS;
+#endif
+
+#if defined(LOAD_INVARIANT)
+	// All threads access the same address
+	uint address = 0;
+#elif defined(LOAD_WAVE)
+	// One address per wave
+	uint address = threadIndex / WAVE_SIZE;
+#elif defined(LOAD_LINEAR)
+	// One address per thread, neighbour threads access neighbour addresses
+	uint address = threadIndex;
+#elif defined(LOAD_RANDOM)
+	// One address per thread, scattered. Odd multiplier, so the low bits are a permutation.
+	uint address = hash1(threadIndex) & (numElements - 1);
+#endif
+
+	uint value = 0;
+
+	[loop]
+	for (uint i = 0; i < 256; ++i)
+	{
+		// Mask with runtime constant to prevent unwanted compiler optimizations
+		uint elemIdx = address | loadConstants.elementsMask;
+
+#if defined(ATOMIC_ADD)
+		INTERLOCKED(Add, elemIdx, 1);
+#elif defined(ATOMIC_MIN)
+		INTERLOCKED(Min, elemIdx, i);
+#elif defined(ATOMIC_MAX)
+		INTERLOCKED(Max, elemIdx, i);
+#elif defined(ATOMIC_COMPARE_EXCHANGE)
+		// Increment attempt, the next compare depends on the returned value
+		uint original;
+		INTERLOCKED_COMPARE_EXCHANGE(elemIdx, value, value + 1, original);
+		value = original;
+#endif
+	}
+
+#if defined(ATOMIC_GROUPSHARED)
+	GroupMemoryBarrierWithGroupSync();
+#endif
+
+	// This branch is never taken, but the compiler doesn't know it
+	// Optimizer would remove the groupshared atomics if the data wouldn't be potentially used
+	[branch]
+	if (loadConstants.writeIndex != 0xffffffff)
+	{
+#if defined(ATOMIC_GROUPSHARED)
+		output[tid.x + tid.y] = atomicLDS[loadConstants.writeIndex & (THREAD_GROUP_SIZE - 1)] + value;
+#else
+		INTERLOCKED(Add, tid.x + tid.y, value);
+#endif
+	}
+}
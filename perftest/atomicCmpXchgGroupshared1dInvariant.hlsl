@@ -0,0 +1,5 @@
+#define ATOMIC_COMPARE_EXCHANGE
+#define LOAD_INVARIANT
+#define ATOMIC_GROUPSHARED
+RWBuffer<float> output : register(u0);
+#include "atomicBody.hlsli"
@@ -0,0 +1,5 @@
+#define ATOMIC_MAX
+#define LOAD_WAVE
+#define ATOMIC_RAW
+RWByteAddressBuffer target : register(u0);
+#include "atomicBody.hlsli"
@@ -0,0 +1,5 @@
+#define ATOMIC_MAX
+#define LOAD_INVARIANT
+#define ATOMIC_TYPED
+RWBuffer<uint> target : register(u0);
+#include "atomicBody.hlsli"
@@ -0,0 +1,5 @@
+#define ATOMIC_MIN
+#define LOAD_LINEAR
+#define ATOMIC_GROUPSHARED
+RWBuffer<float> output : register(u0);
+#include "atomicBody.hlsli"
@@ -0,0 +1,5 @@
+#define ATOMIC_MIN
+#define LOAD_RANDOM
+#define ATOMIC_TYPED
+RWBuffer<uint> target : register(u0);
+#include "atomicBody.hlsli"
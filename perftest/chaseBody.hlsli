@@ -0,0 +1,44 @@
+#include "loadConstantsGPU.h"
+
+// Chain position, carried over to the next dispatch so every run walks new elements
+RWBuffer<uint> chaseState : register(u0);
+
+cbuffer CB0 : register(b0)
+{
+	ChaseConstants chaseConstants;
+};
+
+#if defined(CHASE_CONSTANT)
+// 64 KB chain, 4096 elements. Only x is used.
+cbuffer CB1 : register(b1)
+{
+	uint4 chain[4096];
+};
+#endif
+
+#define CHASE_STEPS 1024
+
+// Single thread: every load waits for the previous one, nothing hides the latency
+[numthreads(1, 1, 1)]
+void main()
+{
+	uint next = chaseState[0] & chaseConstants.startMask;
+
+	[loop]
+	for (uint i = 0; i < CHASE_STEPS; ++i)
+	{
+		// Elements store the address of the next element: texel as x | (y << 16), byte address or index
+#if defined(CHASE_TEX)
+		next = sourceData[uint2(next & 0xffff, next >> 16)];
+#elif defined(CHASE_RAW)
+		next = sourceData.Load(next);
+#elif defined(CHASE_CONSTANT)
+		next = chain[next].x;
+#else
+		next = sourceData[next];
+#endif
+	}
+
+	// The loads are used, no never taken branch needed
+	chaseState[0] = next;
+}
@@ -0,0 +1,2 @@
+#define CHASE_CONSTANT
+#include "chaseBody.hlsli"
@@ -0,0 +1,34 @@
+#include "hash.hlsli"
+#include "loadConstantsGPU.h"
+
+cbuffer CB0 : register(b0)
+{
+	ChaseConstants chaseConstants;
+};
+
+#define THREAD_GROUP_SIZE 256
+#define DISPATCH_WIDTH 1024		// Threads per row, one thread per element
+#define DISPATCH_HEIGHT 1024	// Rows per slice, slices keep the group counts under the dispatch limit
+
+// Element permute(j) points to permute(j + 1): a single cycle through the whole working set in random order
+[numthreads(THREAD_GROUP_SIZE, 1, 1)]
+void main(uint3 tid : SV_DispatchThreadID)
+{
+	uint j = (tid.z * DISPATCH_HEIGHT + tid.y) * DISPATCH_WIDTH + tid.x;
+	if (j > chaseConstants.addressMask)
+		return;
+
+	uint element = permute(j, chaseConstants.addressMask, chaseConstants.permuteShift);
+	uint next = permute((j + 1) & chaseConstants.addressMask, chaseConstants.addressMask, chaseConstants.permuteShift);
+
+	// Same address encoding as chaseBody.hlsli
+#if defined(CHASE_TEX)
+	uint widthMask = (1u << chaseConstants.textureWidthLog2) - 1;
+	uint2 texel = uint2(element & widthMask, element >> chaseConstants.textureWidthLog2);
+	target[texel] = (next & widthMask) | ((next >> chaseConstants.textureWidthLog2) << 16);
+#elif defined(CHASE_RAW)
+	target.Store(element * 4, next * 4);
+#else
+	target[element] = next;
+#endif
+}
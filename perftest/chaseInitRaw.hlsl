@@ -0,0 +1,3 @@
+#define CHASE_RAW
+RWByteAddressBuffer target : register(u0);
+#include "chaseInitBody.hlsli"
@@ -0,0 +1,2 @@
+RWStructuredBuffer<uint> target : register(u0);
+#include "chaseInitBody.hlsli"
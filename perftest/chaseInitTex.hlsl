@@ -0,0 +1,3 @@
+#define CHASE_TEX
+RWTexture2D<uint> target : register(u0);
+#include "chaseInitBody.hlsli"
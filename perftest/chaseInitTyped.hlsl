@@ -0,0 +1,2 @@
+RWBuffer<uint> target : register(u0);
+#include "chaseInitBody.hlsli"
@@ -0,0 +1,3 @@
+#define CHASE_RAW
+ByteAddressBuffer sourceData : register(t0);
+#include "chaseBody.hlsli"
@@ -0,0 +1,2 @@
+StructuredBuffer<uint> sourceData : register(t0);
+#include "chaseBody.hlsli"
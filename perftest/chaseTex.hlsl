@@ -0,0 +1,3 @@
+#define CHASE_TEX
+Texture2D<uint> sourceData : register(t0);
+#include "chaseBody.hlsli"
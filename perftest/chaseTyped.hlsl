@@ -0,0 +1,2 @@
+Buffer<uint> sourceData : register(t0);
+#include "chaseBody.hlsli"
@@ -0,0 +1,314 @@
+#include "cpu.h"
+#include <algorithm>
+#include <string.h>
+#include <assert.h>
+
+std::vector<std::string> enumerateCpuAdapters()
+{
+	return { "CPU reference (" + std::to_string(std::max(std::thread::hardware_concurrency(), 1u)) + " threads)" };
+}
+
+CpuDevice::CpuDevice()
+{
+}
+
+ComputeShader* CpuDevice::createComputeShader(const unsigned char*, size_t)
+{
+	// No bytecode. Kernels are looked up by name.
+	assert(false);
+	return nullptr;
+}
+
+ComputeShader* CpuDevice::loadComputeShader(const std::string& name)
+{
+	CpuKernel kernel = findCpuKernel(name);
+	if (!kernel)
+		failShaderLoad(name, "no CPU kernel of this name in cpuKernels.cpp");
+
+	CpuComputeShader* shader = new CpuComputeShader;
+	shader->kernel = kernel;
+	return shader;
+}
+
+Buffer* CpuDevice::createConstantBuffer(unsigned bytes)
+{
+	CpuBuffer* buffer = new CpuBuffer;
+	buffer->data.resize(bytes);
+	return buffer;
+}
+
+Buffer* CpuDevice::createBuffer(unsigned numElements, unsigned strideBytes, BufferType)
+{
+	CpuBuffer* buffer = new CpuBuffer;
+	buffer->data.resize(size_t(numElements) * strideBytes);
+	return buffer;
+}
+
+Texture* CpuDevice::createTexture2d(uint2 dimensions, Format format, unsigned mips)
+{
+	return createTexture3d(uint3(dimensions, 1), format, mips);
+}
+
+Texture* CpuDevice::createTexture3d(uint3 dimensions, Format format, unsigned mips)
+{
+	CpuTexture* texture = new CpuTexture;
+	texture->dimensions = dimensions;
+	texture->format = format;
+	texture->mips = mips;
+
+	size_t bytes = 0;
+	uint3 mipSize = dimensions;
+	for (unsigned mip = 0; mip < mips; ++mip)
+	{
+		bytes += size_t(mipSize.x) * mipSize.y * mipSize.z * formatBytes(format);
+		mipSize = uint3(std::max(mipSize.x / 2, 1u), std::max(mipSize.y / 2, 1u), std::max(mipSize.z / 2, 1u));
+	}
+	texture->data.resize(bytes);
+	return texture;
+}
+
+// Every CPU buffer is host memory
+Buffer* CpuDevice::createDynamicBuffer(unsigned bytes)
+{
+	return createBuffer(bytes, 1);
+}
+
+Buffer* CpuDevice::createStagingBuffer(unsigned bytes, StagingType)
+{
+	return createBuffer(bytes, 1);
+}
+
+SamplerState* CpuDevice::createSampler(SamplerType type)
+{
+	CpuSampler* sampler = new CpuSampler;
+	sampler->type = type;
+	return sampler;
+}
+
+CpuView CpuDevice::textureView(Texture* texture)
+{
+	CpuTexture* cpuTexture = static_cast<CpuTexture*>(texture);
+
+	CpuView view;
+	view.type = CpuView::Type::Texture;
+	view.data = cpuTexture->data.data();
+	view.bytes = cpuTexture->data.size();
+	view.format = cpuTexture->format;
+	view.dimensions = cpuTexture->dimensions;
+	view.mips = cpuTexture->mips;
+	return view;
+}
+
+static CpuView bufferView(Buffer* buffer, CpuView::Type type, unsigned numElements, unsigned elementBytes)
+{
+	CpuBuffer* cpuBuffer = static_cast<CpuBuffer*>(buffer);
+	assert(size_t(numElements) * elementBytes <= cpuBuffer->data.size());
+
+	CpuView view;
+	view.type = type;
+	view.data = cpuBuffer->data.data();
+	view.bytes = size_t(numElements) * elementBytes;
+	view.numElements = numElements;
+	view.stride = elementBytes;
+	return view;
+}
+
+UnorderedAccessView* CpuDevice::createUAV(Texture* texture)
+{
+	CpuUAV* uav = new CpuUAV;
+	uav->view = textureView(texture);
+	return uav;
+}
+
+UnorderedAccessView* CpuDevice::createTypedUAV(Buffer* buffer, unsigned numElements, Format format)
+{
+	CpuUAV* uav = new CpuUAV;
+	uav->view = bufferView(buffer, CpuView::Type::Typed, numElements, formatBytes(format));
+	uav->view.format = format;
+	return uav;
+}
+
+UnorderedAccessView* CpuDevice::createStructuredUAV(Buffer* buffer, unsigned numElements, unsigned stride)
+{
+	CpuUAV* uav = new CpuUAV;
+	uav->view = bufferView(buffer, CpuView::Type::Structured, numElements, stride);
+	return uav;
+}
+
+UnorderedAccessView* CpuDevice::createByteAddressUAV(Buffer* buffer, unsigned numElements)
+{
+	CpuUAV* uav = new CpuUAV;
+	uav->view = bufferView(buffer, CpuView::Type::Raw, numElements, 4);
+	return uav;
+}
+
+ShaderResourceView* CpuDevice::createSRV(Texture* texture)
+{
+	CpuSRV* srv = new CpuSRV;
+	srv->view = textureView(texture);
+	return srv;
+}
+
+ShaderResourceView* CpuDevice::createTypedSRV(Buffer* buffer, unsigned numElements, Format format)
+{
+	CpuSRV* srv = new CpuSRV;
+	srv->view = bufferView(buffer, CpuView::Type::Typed, numElements, formatBytes(format));
+	srv->view.format = format;
+	return srv;
+}
+
+ShaderResourceView* CpuDevice::createStructuredSRV(Buffer* buffer, unsigned numElements, unsigned stride)
+{
+	CpuSRV* srv = new CpuSRV;
+	srv->view = bufferView(buffer, CpuView::Type::Structured, numElements, stride);
+	return srv;
+}
+
+ShaderResourceView* CpuDevice::createByteAddressSRV(Buffer* buffer, unsigned numElements)
+{
+	CpuSRV* srv = new CpuSRV;
+	srv->view = bufferView(buffer, CpuView::Type::Raw, numElements, 4);
+	return srv;
+}
+
+void CpuDevice::updateConstantBuffer(Buffer* cbuffer, const void* data, size_t bytes)
+{
+	CpuBuffer* buffer = static_cast<CpuBuffer*>(cbuffer);
+	assert(bytes <= buffer->data.size());
+	memcpy(buffer->data.data(), data, bytes);
+}
+
+void CpuDevice::writeBuffer(Buffer* buffer, const void* data, size_t bytes)
+{
+	CpuBuffer* cpuBuffer = static_cast<CpuBuffer*>(buffer);
+	assert(bytes <= cpuBuffer->data.size());
+	memcpy(cpuBuffer->data.data(), data, bytes);
+}
+
+void CpuDevice::updateBuffer(Buffer* buffer, const void* data, size_t bytes)
+{
+	writeBuffer(buffer, data, bytes);
+}
+
+void CpuDevice::readBuffer(Buffer* buffer, void* data, size_t bytes)
+{
+	CpuBuffer* cpuBuffer = static_cast<CpuBuffer*>(buffer);
+	assert(bytes <= cpuBuffer->data.size());
+	memcpy(data, cpuBuffer->data.data(), bytes);
+}
+
+CpuBindings CpuDevice::gatherBindings(std::initializer_list<Buffer*> cbs,
+									  std::initializer_list<ShaderResourceView*> srvs,
+									  std::initializer_list<UnorderedAccessView*> uavs,
+									  std::initializer_list<SamplerState*> samplers)
+{
+	CpuBindings bindings;
+	assert(cbs.size() <= bindings.cbs.size() && srvs.size() <= bindings.srvs.size() && uavs.size() <= bindings.uavs.size() &&
+		   samplers.size() <= bindings.samplers.size());
+
+	unsigned slot = 0;
+	for (auto cb : cbs)
+	{
+		bindings.cbs[slot++] = cb ? static_cast<CpuBuffer*>(cb)->data.data() : nullptr;
+	}
+
+	slot = 0;
+	for (auto srv : srvs)
+	{
+		bindings.srvs[slot++] = srv ? &static_cast<CpuSRV*>(srv)->view : nullptr;
+	}
+
+	slot = 0;
+	for (auto uav : uavs)
+	{
+		bindings.uavs[slot++] = uav ? &static_cast<CpuUAV*>(uav)->view : nullptr;
+	}
+
+	slot = 0;
+	for (auto sampler : samplers)
+	{
+		bindings.samplers[slot++] = sampler ? static_cast<CpuSampler*>(sampler)->type : Device::SamplerType::Nearest;
+	}
+	return bindings;
+}
+
+void CpuDevice::run(CpuKernel kernel, uint3 resolution, uint3 groupSize, const CpuBindings& bindings)
+{
+	// One task per thread group
+	uint3 groups = divRoundUp(resolution, groupSize);
+	assert(groups.x <= maxDispatchGroups && groups.y <= maxDispatchGroups && groups.z <= maxDispatchGroups);
+	unsigned groupsXY = groups.x * groups.y;
+	threadPool.parallelFor(groupsXY * groups.z, [&](unsigned index)
+	{
+		uint3 groupId(index % groups.x, (index / groups.x) % groups.y, index / groupsXY);
+		kernel(bindings, groupId);
+	});
+}
+
+void CpuDevice::dispatch(ComputeShader* shader, uint3 resolution, uint3 groupSize,
+						std::initializer_list<Buffer*> cbs,
+						std::initializer_list<ShaderResourceView*> srvs,
+						std::initializer_list<UnorderedAccessView*> uavs,
+						std::initializer_list<SamplerState*> samplers)
+{
+	run(static_cast<CpuComputeShader*>(shader)->kernel, resolution, groupSize, gatherBindings(cbs, srvs, uavs, samplers));
+}
+
+void CpuDevice::beginCommandList(CommandList* list)
+{
+	static_cast<CpuCommandList*>(list)->dispatches.clear();
+}
+
+void CpuDevice::recordDispatch(CommandList* list, ComputeShader* shader, uint3 resolution, uint3 groupSize,
+							   std::initializer_list<Buffer*> cbs,
+							   std::initializer_list<ShaderResourceView*> srvs,
+							   std::initializer_list<UnorderedAccessView*> uavs,
+							   std::initializer_list<SamplerState*> samplers)
+{
+	CpuCommandList::Dispatch dispatch = { static_cast<CpuComputeShader*>(shader)->kernel, resolution, groupSize,
+										  gatherBindings(cbs, srvs, uavs, samplers) };
+	static_cast<CpuCommandList*>(list)->dispatches.push_back(dispatch);
+}
+
+void CpuDevice::executeCommandList(CommandList* list)
+{
+	for (auto&& dispatch : static_cast<CpuCommandList*>(list)->dispatches)
+	{
+		run(dispatch.kernel, dispatch.resolution, dispatch.groupSize, dispatch.bindings);
+	}
+}
+
+void CpuDevice::copyBuffer(Buffer* destination, Buffer* source, size_t bytes)
+{
+	readBuffer(source, static_cast<CpuBuffer*>(destination)->data.data(), bytes);
+}
+
+QueryHandle CpuDevice::startPerformanceQuery(unsigned id)
+{
+	PerformanceQuery& query = queries[queryCounter % queries.size()];
+
+	query.id = id;
+	query.start = std::chrono::steady_clock::now();
+
+	QueryHandle out {queryCounter};
+	queryCounter++;
+	return out;
+}
+
+void CpuDevice::endPerformanceQuery(QueryHandle queryHandle)
+{
+	PerformanceQuery& query = queries[queryHandle.queryIndex % queries.size()];
+	query.end = std::chrono::steady_clock::now();
+}
+
+void CpuDevice::processPerformanceResults(std::vector<QueryResult>& results)
+{
+	// Dispatches are synchronous, every query has finished
+	while (queryProcessCounter < queryCounter)
+	{
+		PerformanceQuery& query = queries[queryProcessCounter % queries.size()];
+		int64_t start = std::chrono::duration_cast<std::chrono::nanoseconds>(query.start.time_since_epoch()).count();
+		results.push_back({ query.id, std::chrono::duration<float, std::milli>(query.end - query.start).count(), start });
+		queryProcessCounter++;
+	}
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include "device.h"
+#include "cpuKernels.h"
+#include "threadPool.h"
+#include <chrono>
+#include <array>
+
+class CpuBuffer : public Buffer
+{
+public:
+	std::vector<uint8_t> data;
+};
+
+class CpuTexture : public Texture
+{
+public:
+	uint3 dimensions;
+	Format format = Format::R8_UNORM;
+	unsigned mips = 1;
+	std::vector<uint8_t> data;		// Mips stored one after another, mip 0 first
+};
+
+class CpuSRV : public ShaderResourceView
+{
+public:
+	CpuView view;
+};
+
+class CpuUAV : public UnorderedAccessView
+{
+public:
+	CpuView view;
+};
+
+class CpuSampler : public SamplerState
+{
+public:
+	Device::SamplerType type = Device::SamplerType::Nearest;
+};
+
+class CpuComputeShader : public ComputeShader
+{
+public:
+	CpuKernel kernel = nullptr;
+};
+
+// Dispatches with their bindings, run when the list is executed
+class CpuCommandList : public CommandList
+{
+public:
+	struct Dispatch
+	{
+		CpuKernel kernel;
+		uint3 resolution;
+		uint3 groupSize;
+		CpuBindings bindings;
+	};
+
+	std::vector<Dispatch> dispatches;
+};
+
+std::vector<std::string> enumerateCpuAdapters();
+
+// Reference backend running C++ ports of the shaders. Thread groups are distributed over a work-stealing
+// thread pool using all cores. Dispatches execute synchronously, so timestamps are taken on the CPU.
+class CpuDevice : public Device
+{
+public:
+
+	CpuDevice();
+
+	// Create resources
+	ComputeShader* createComputeShader(const unsigned char* shaderBytes, size_t size) override;
+	ComputeShader* loadComputeShader(const std::string& name) override;
+
+	Buffer* createConstantBuffer(unsigned bytes) override;
+	Buffer* createBuffer(unsigned numElements, unsigned strideBytes, BufferType type = BufferType::Default) override;
+	Texture* createTexture2d(uint2 dimensions, Format format, unsigned mips) override;
+	Texture* createTexture3d(uint3 dimensions, Format format, unsigned mips) override;
+	SamplerState* createSampler(SamplerType type) override;
+	Buffer* createDynamicBuffer(unsigned bytes) override;
+	Buffer* createStagingBuffer(unsigned bytes, StagingType type) override;
+
+	UnorderedAccessView* createUAV(Texture* texture) override;
+	UnorderedAccessView* createTypedUAV(Buffer* buffer, unsigned numElements, Format format) override;
+	UnorderedAccessView* createStructuredUAV(Buffer* buffer, unsigned numElements, unsigned stride) override;
+	UnorderedAccessView* createByteAddressUAV(Buffer* buffer, unsigned numElements) override;
+
+	ShaderResourceView* createSRV(Texture* texture) override;
+	ShaderResourceView* createTypedSRV(Buffer* buffer, unsigned numElements, Format format) override;
+	ShaderResourceView* createStructuredSRV(Buffer* buffer, unsigned numElements, unsigned stride) override;
+	ShaderResourceView* createByteAddressSRV(Buffer* buffer, unsigned numElements) override;
+
+	// Data update
+	using Device::updateConstantBuffer;
+	void updateConstantBuffer(Buffer* cbuffer, const void* data, size_t bytes) override;
+	void writeBuffer(Buffer* buffer, const void* data, size_t bytes) override;
+	void updateBuffer(Buffer* buffer, const void* data, size_t bytes) override;
+	void readBuffer(Buffer* buffer, void* data, size_t bytes) override;
+
+	// Commands
+	void dispatch(ComputeShader* shader, uint3 resolution, uint3 groupSize,
+					std::initializer_list<Buffer*> cbs,
+					std::initializer_list<ShaderResourceView*> srvs,
+					std::initializer_list<UnorderedAccessView*> uavs = {},
+					std::initializer_list<SamplerState*> samplers = {}) override;
+	void copyBuffer(Buffer* destination, Buffer* source, size_t bytes) override;
+	void presentFrame() override {}
+	CommandList* createCommandList() override { return new CpuCommandList(); }
+	void beginCommandList(CommandList* list) override;
+	void recordDispatch(CommandList* list, ComputeShader* shader, uint3 resolution, uint3 groupSize,
+						std::initializer_list<Buffer*> cbs,
+						std::initializer_list<ShaderResourceView*> srvs,
+						std::initializer_list<UnorderedAccessView*> uavs = {},
+						std::initializer_list<SamplerState*> samplers = {}) override;
+	void endCommandList(CommandList* list) override {}
+	void executeCommandList(CommandList* list) override;
+
+	// Performance querys
+	QueryHandle startPerformanceQuery(unsigned id) override;
+	void endPerformanceQuery(QueryHandle queryHandle) override;
+	void processPerformanceResults(std::vector<QueryResult>& results) override;
+	bool calibrateTimestamps() override { return true; }		// Queries already use the steady_clock
+
+	// Kernels are compiled into the executable
+	const char* shaderFileExtension() const override { return ""; }
+	std::string driverVersion() override { return ""; }
+	bool supportsWaveIntrinsics() const override { return true; }		// 32 lane waves
+
+private:
+
+	struct PerformanceQuery
+	{
+		unsigned id;
+		std::chrono::steady_clock::time_point start;
+		std::chrono::steady_clock::time_point end;
+	};
+
+	CpuView textureView(Texture* texture);
+	CpuBindings gatherBindings(std::initializer_list<Buffer*> cbs,
+							   std::initializer_list<ShaderResourceView*> srvs,
+							   std::initializer_list<UnorderedAccessView*> uavs,
+							   std::initializer_list<SamplerState*> samplers);
+	void run(CpuKernel kernel, uint3 resolution, uint3 groupSize, const CpuBindings& bindings);
+
+	ThreadPool threadPool;
+
+	// Queries
+	std::array<PerformanceQuery, 4096> queries;
+	unsigned queryCounter = 0;
+	unsigned queryProcessCounter = 0;
+};
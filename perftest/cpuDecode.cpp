@@ -0,0 +1,268 @@
+#include "cpuDecode.h"
+#include "cpuDecodeKernels.h"
+#include "device.h"
+#include "half.h"
+#include <chrono>
+#include <vector>
+#include <math.h>
+#include <assert.h>
+
+#ifdef CPU_DECODE_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// Same address generation as the GPU shaders
+namespace gpu
+{
+#include "hash.hlsli"
+}
+
+#ifdef CPU_DECODE_X86
+
+static void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4])
+{
+#ifdef _MSC_VER
+	__cpuidex(reinterpret_cast<int*>(regs), int(leaf), int(subleaf));
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// OS enabled register state (XCR0)
+static uint64_t xgetbv()
+{
+#ifdef _MSC_VER
+	return _xgetbv(0);
+#else
+	uint32_t eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return (uint64_t(edx) << 32) | eax;
+#endif
+}
+
+struct CpuFeatures
+{
+	bool sse4 = false;
+	bool avx2 = false;
+	bool avx512 = false;
+
+	CpuFeatures()
+	{
+		unsigned regs[4];
+		cpuid(0, 0, regs);
+		unsigned maxLeaf = regs[0];
+
+		cpuid(1, 0, regs);
+		unsigned leaf1Ecx = regs[2];
+		sse4 = (leaf1Ecx & (1u << 19)) != 0;
+
+		bool osxsave = (leaf1Ecx & (1u << 27)) != 0;
+		bool avx = (leaf1Ecx & (1u << 28)) != 0;
+		bool f16c = (leaf1Ecx & (1u << 29)) != 0;
+		if (!osxsave || !avx || !f16c || maxLeaf < 7)
+			return;
+
+		cpuid(7, 0, regs);
+		unsigned leaf7Ebx = regs[1];
+		uint64_t xcr0 = xgetbv();
+
+		// XMM + YMM state, then opmask + ZMM state
+		avx2 = (leaf7Ebx & (1u << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+		avx512 = avx2 && (leaf7Ebx & (1u << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+	}
+};
+
+#endif
+
+const char* cpuIsaName(CpuIsa isa)
+{
+	switch (isa)
+	{
+	case CpuIsa::Scalar: return "scalar";
+	case CpuIsa::Sse4: return "SSE4";
+	case CpuIsa::Avx2: return "AVX2";
+	case CpuIsa::Avx512: return "AVX-512";
+	}
+	return "";
+}
+
+bool isCpuIsaSupported(CpuIsa isa)
+{
+#ifdef CPU_DECODE_X86
+	static const CpuFeatures features;
+	switch (isa)
+	{
+	case CpuIsa::Scalar: return true;
+	case CpuIsa::Sse4: return features.sse4;
+	case CpuIsa::Avx2: return features.avx2;
+	case CpuIsa::Avx512: return features.avx512;
+	}
+	return false;
+#else
+	return isa == CpuIsa::Scalar;
+#endif
+}
+
+static void decode(CpuIsa isa, DecodeArgs& args)
+{
+	switch (isa)
+	{
+	case CpuIsa::Scalar: decodeScalar(args); break;
+#ifdef CPU_DECODE_X86
+	case CpuIsa::Sse4: decodeSse4(args); break;
+	case CpuIsa::Avx2: decodeAvx2(args); break;
+	case CpuIsa::Avx512: decodeAvx512(args); break;
+#else
+	default: assert(false); break;
+#endif
+	}
+}
+
+struct DecodeFormat
+{
+	const char* name;
+	Format format;
+	DecodeComponent component;
+	unsigned channels;
+};
+
+// Same formats and names as the Buffer<T> cases
+static const DecodeFormat decodeFormats[] =
+{
+	{ "R8", Format::R8_UNORM, DecodeComponent::Unorm8, 1 },
+	{ "RG8", Format::R8G8_UNORM, DecodeComponent::Unorm8, 2 },
+	{ "RGBA8", Format::R8G8B8A8_UNORM, DecodeComponent::Unorm8, 4 },
+	{ "R16f", Format::R16_FLOAT, DecodeComponent::Half, 1 },
+	{ "RG16f", Format::R16G16_FLOAT, DecodeComponent::Half, 2 },
+	{ "RGBA16f", Format::R16G16B16A16_FLOAT, DecodeComponent::Half, 4 },
+	{ "R32f", Format::R32_FLOAT, DecodeComponent::Float, 1 },
+	{ "RG32f", Format::R32G32_FLOAT, DecodeComponent::Float, 2 },
+	{ "RGBA32f", Format::R32G32B32A32_FLOAT, DecodeComponent::Float, 4 },
+};
+
+// Fills with values in [0, 1) that every kernel decodes exactly. Avoids denormal slow paths.
+static void fillSource(std::vector<uint8_t>& data, const DecodeFormat& format)
+{
+	switch (format.component)
+	{
+	case DecodeComponent::Unorm8:
+		for (size_t i = 0; i < data.size(); ++i)
+			data[i] = uint8_t(i * 37);
+		break;
+	case DecodeComponent::Half:
+		for (size_t i = 0; i < data.size() / 2; ++i)
+		{
+			uint16_t h = floatToHalf(float(i & 255) / 256.0f);
+			memcpy(&data[i * 2], &h, sizeof(h));
+		}
+		break;
+	case DecodeComponent::Float:
+		for (size_t i = 0; i < data.size() / 4; ++i)
+		{
+			float f = float(i & 255) / 256.0f;
+			memcpy(&data[i * 4], &f, sizeof(f));
+		}
+		break;
+	}
+}
+
+void runCpuDecodeSuite(unsigned numWarmUpRuns, unsigned numBenchmarkRuns,
+					   const std::function<bool(const std::string&)>& selectCase,
+					   const std::function<void(const std::string&, const float*, unsigned, double, unsigned)>& functor)
+{
+	// Same buffer size and loads per thread as the GPU cases. Fewer threads, it is a single core.
+	const unsigned numElements = 1024;
+	const unsigned numThreads = 4096;
+	const unsigned loadsPerThread = 256;
+
+	// Padding for vector loads and dword gathers past the last element
+	std::vector<uint8_t> source(numElements * 16 + 64);
+
+	struct Pattern
+	{
+		const char* name;
+		uint32_t startIndex[256];
+	};
+
+	Pattern patterns[3] = { { "uniform" }, { "linear" }, { "random" } };
+	for (uint gix = 0; gix < 256; ++gix)
+	{
+		patterns[0].startIndex[gix] = 0;
+		patterns[1].startIndex[gix] = gix;
+		patterns[2].startIndex[gix] = gpu::hash1(gix) & 0xf;
+	}
+
+	std::vector<float> samples;
+	samples.reserve(numBenchmarkRuns);
+
+	const CpuIsa isas[] = { CpuIsa::Scalar, CpuIsa::Sse4, CpuIsa::Avx2, CpuIsa::Avx512 };
+
+	for (const DecodeFormat& format : decodeFormats)
+	{
+		fillSource(source, format);
+
+		for (const Pattern& pattern : patterns)
+		{
+			double reference[4] = {};
+
+			for (CpuIsa isa : isas)
+			{
+				if (!isCpuIsaSupported(isa))
+					continue;
+
+				for (bool gather : { false, true })
+				{
+					// Scalar has no lanes to gather into
+					if (isa == CpuIsa::Scalar && gather)
+						continue;
+
+					std::string name = std::string("CPU ") + cpuIsaName(isa) + " " + format.name + " decode " + pattern.name;
+					if (isa != CpuIsa::Scalar)
+						name += gather ? " gather" : " contiguous";
+
+					// The scalar result is the reference for the SIMD kernels, it runs once when not selected
+					bool selected = selectCase(name);
+					if (!selected && isa != CpuIsa::Scalar)
+						continue;
+					unsigned numRuns = selected ? numWarmUpRuns + numBenchmarkRuns : 1;
+
+					DecodeArgs args = {};
+					args.data = source.data();
+					args.component = format.component;
+					args.channels = format.channels;
+					args.startIndex = pattern.startIndex;
+					args.elementsMask = 0;
+					args.numThreads = numThreads;
+					args.loadsPerThread = loadsPerThread;
+					args.gather = gather;
+
+					samples.clear();
+					for (unsigned run = 0; run < numRuns; ++run)
+					{
+						memset(args.result, 0, sizeof(args.result));
+
+						auto start = std::chrono::steady_clock::now();
+						decode(isa, args);
+						auto end = std::chrono::steady_clock::now();
+
+						if (run >= numWarmUpRuns)
+							samples.push_back(std::chrono::duration<float, std::milli>(end - start).count());
+					}
+
+					// Every kernel must decode the same values as the scalar one. Sums differ only by rounding.
+					if (isa == CpuIsa::Scalar)
+						memcpy(reference, args.result, sizeof(reference));
+					for (unsigned c = 0; c < 4; ++c)
+						assert(fabs(args.result[c] - reference[c]) <= 1e-4 * fabs(reference[c]) + 1e-3);
+
+					if (selected)
+						functor(name, samples.data(), unsigned(samples.size()), double(numThreads) * loadsPerThread, formatBytes(format.format));
+				}
+			}
+		}
+	}
+}
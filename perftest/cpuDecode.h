@@ -0,0 +1,25 @@
+#pragma once
+#include <functional>
+#include <string>
+
+// Typed buffer loads done on the CPU: load + format conversion to float4 for each format of the
+// typed buffer matrix, with the same uniform/linear/random addresses as the shaders. Kernels for
+// each instruction set are selected at runtime. Runs on one thread, results are per core.
+
+enum class CpuIsa
+{
+	Scalar,
+	Sse4,
+	Avx2,
+	Avx512
+};
+
+const char* cpuIsaName(CpuIsa isa);
+bool isCpuIsaSupported(CpuIsa isa);
+
+// Runs every case on every supported instruction set, if selectCase(name) returns true. SIMD kernels
+// run twice: contiguous vector loads along each thread and gathers across threads. Calls functor(name,
+// time of each benchmark run in ms, number of runs, loads per run, bytes per load) for each case.
+void runCpuDecodeSuite(unsigned numWarmUpRuns, unsigned numBenchmarkRuns,
+					   const std::function<bool(const std::string&)>& selectCase,
+					   const std::function<void(const std::string&, const float*, unsigned, double, unsigned)>& functor);
@@ -0,0 +1,92 @@
+#include "cpuDecodeKernels.h"
+
+#ifdef CPU_DECODE_X86
+#include "cpuDecodeSimd.h"
+#include <immintrin.h>
+
+// AVX2 + F16C, 8 lanes. Gather mode uses the hardware gather.
+
+namespace
+{
+
+struct Avx2
+{
+	static const unsigned lanes = 8;
+	typedef __m256 Float;
+	typedef __m256i Int;
+
+	static Float zero() { return _mm256_setzero_ps(); }
+	static Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+	static void store(float* out, Float v) { _mm256_storeu_ps(out, v); }
+
+	static float reduce(Float v)
+	{
+		__m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+		return _mm_cvtss_f32(sum);
+	}
+
+	static Int set1(uint32_t v) { return _mm256_set1_epi32(int(v)); }
+	static Int loadIndices(const uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+	static Int add(Int a, Int b) { return _mm256_add_epi32(a, b); }
+	static Int bitOr(Int a, Int b) { return _mm256_or_si256(a, b); }
+	static Int shiftLeft(Int v, unsigned bits) { return _mm256_sll_epi32(v, _mm_cvtsi32_si128(int(bits))); }
+
+	static Int gather(const uint8_t* base, Int offset)
+	{
+		return _mm256_i32gather_epi32(reinterpret_cast<const int*>(base), offset, 1);
+	}
+
+	// 16 bit values in the low half of each lane to float
+	static Float halfToFloat(Int v)
+	{
+		__m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+		return _mm256_cvtph_ps(packed);
+	}
+
+	template <DecodeComponent C> static Float load(const uint8_t* p);
+	template <DecodeComponent C> static Float convert(Int v, unsigned shift);
+};
+
+template <> Avx2::Float Avx2::load<DecodeComponent::Unorm8>(const uint8_t* p)
+{
+	__m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+	return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes)), _mm256_set1_ps(1.0f / 255.0f));
+}
+
+template <> Avx2::Float Avx2::load<DecodeComponent::Half>(const uint8_t* p)
+{
+	return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+template <> Avx2::Float Avx2::load<DecodeComponent::Float>(const uint8_t* p)
+{
+	return _mm256_loadu_ps(reinterpret_cast<const float*>(p));
+}
+
+template <> Avx2::Float Avx2::convert<DecodeComponent::Unorm8>(Int v, unsigned shift)
+{
+	v = _mm256_and_si256(_mm256_srl_epi32(v, _mm_cvtsi32_si128(int(shift))), _mm256_set1_epi32(0xff));
+	return _mm256_mul_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(1.0f / 255.0f));
+}
+
+template <> Avx2::Float Avx2::convert<DecodeComponent::Half>(Int v, unsigned shift)
+{
+	v = _mm256_and_si256(_mm256_srl_epi32(v, _mm_cvtsi32_si128(int(shift))), _mm256_set1_epi32(0xffff));
+	return halfToFloat(v);
+}
+
+template <> Avx2::Float Avx2::convert<DecodeComponent::Float>(Int v, unsigned)
+{
+	return _mm256_castsi256_ps(v);
+}
+
+}
+
+void decodeAvx2(DecodeArgs& args)
+{
+	decode<Avx2>(args);
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include "cpuDecodeKernels.h"
+
+#ifdef CPU_DECODE_X86
+#include "cpuDecodeSimd.h"
+#include <immintrin.h>
+
+// AVX-512F, 16 lanes. Only foundation instructions are used, so any AVX-512 CPU runs this.
+
+namespace
+{
+
+struct Avx512
+{
+	static const unsigned lanes = 16;
+	typedef __m512 Float;
+	typedef __m512i Int;
+
+	static Float zero() { return _mm512_setzero_ps(); }
+	static Float add(Float a, Float b) { return _mm512_add_ps(a, b); }
+	static void store(float* out, Float v) { _mm512_storeu_ps(out, v); }
+	static float reduce(Float v) { return _mm512_reduce_add_ps(v); }
+
+	static Int set1(uint32_t v) { return _mm512_set1_epi32(int(v)); }
+	static Int loadIndices(const uint32_t* p) { return _mm512_loadu_si512(p); }
+	static Int add(Int a, Int b) { return _mm512_add_epi32(a, b); }
+	static Int bitOr(Int a, Int b) { return _mm512_or_si512(a, b); }
+	static Int shiftLeft(Int v, unsigned bits) { return _mm512_sll_epi32(v, _mm_cvtsi32_si128(int(bits))); }
+
+	static Int gather(const uint8_t* base, Int offset)
+	{
+		return _mm512_i32gather_epi32(offset, base, 1);
+	}
+
+	template <DecodeComponent C> static Float load(const uint8_t* p);
+	template <DecodeComponent C> static Float convert(Int v, unsigned shift);
+};
+
+template <> Avx512::Float Avx512::load<DecodeComponent::Unorm8>(const uint8_t* p)
+{
+	__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+	return _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(bytes)), _mm512_set1_ps(1.0f / 255.0f));
+}
+
+template <> Avx512::Float Avx512::load<DecodeComponent::Half>(const uint8_t* p)
+{
+	return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+}
+
+template <> Avx512::Float Avx512::load<DecodeComponent::Float>(const uint8_t* p)
+{
+	return _mm512_loadu_ps(p);
+}
+
+template <> Avx512::Float Avx512::convert<DecodeComponent::Unorm8>(Int v, unsigned shift)
+{
+	v = _mm512_and_si512(_mm512_srl_epi32(v, _mm_cvtsi32_si128(int(shift))), _mm512_set1_epi32(0xff));
+	return _mm512_mul_ps(_mm512_cvtepi32_ps(v), _mm512_set1_ps(1.0f / 255.0f));
+}
+
+template <> Avx512::Float Avx512::convert<DecodeComponent::Half>(Int v, unsigned shift)
+{
+	// Truncating narrow keeps the low 16 bits of each lane
+	v = _mm512_srl_epi32(v, _mm_cvtsi32_si128(int(shift)));
+	return _mm512_cvtph_ps(_mm512_cvtepi32_epi16(v));
+}
+
+template <> Avx512::Float Avx512::convert<DecodeComponent::Float>(Int v, unsigned)
+{
+	return _mm512_castsi512_ps(v);
+}
+
+}
+
+void decodeAvx512(DecodeArgs& args)
+{
+	decode<Avx512>(args);
+}
+
+#endif
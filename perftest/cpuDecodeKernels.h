@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+
+// Interface between the decode benchmark (cpuDecode.cpp) and the per instruction set kernels.
+// Each kernel file is compiled with its own instruction set flags, so this header and the kernel
+// files must not use inline code shared with the rest of the program (datatypes.h etc). The linker
+// could otherwise keep an AVX-512 copy of a shared inline function and call it on every CPU.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_DECODE_X86 1
+#endif
+
+enum class DecodeComponent
+{
+	Unorm8,
+	Half,
+	Float
+};
+
+struct DecodeArgs
+{
+	const uint8_t* data;			// At least 64 readable bytes after the last element
+	DecodeComponent component;
+	unsigned channels;				// 1, 2 or 4. Element size is channels * component size.
+	const uint32_t* startIndex;		// First element of each SV_GroupIndex, 256 entries
+	uint32_t elementsMask;			// Dummy mask, like LoadConstants::elementsMask
+	unsigned numThreads;			// Multiple of 256
+	unsigned loadsPerThread;		// Multiple of 16
+	bool gather;					// SIMD lanes are threads (gather) instead of consecutive loads of one thread
+	double result[4];				// Sum of all loaded channels. Keeps the loads alive.
+};
+
+// Contiguous mode applies elementsMask to the start index only, the loads of a thread are always consecutive.
+// The scalar kernel has no lanes and ignores the gather flag.
+void decodeScalar(DecodeArgs& args);
+
+#ifdef CPU_DECODE_X86
+void decodeSse4(DecodeArgs& args);
+void decodeAvx2(DecodeArgs& args);
+void decodeAvx512(DecodeArgs& args);
+#endif
@@ -0,0 +1,74 @@
+#include "cpuDecodeKernels.h"
+#include "half.h"
+
+namespace
+{
+
+template <DecodeComponent C> struct Component;
+
+template <> struct Component<DecodeComponent::Unorm8>
+{
+	static const unsigned bytes = 1;
+	static float load(const uint8_t* p) { return float(*p) * (1.0f / 255.0f); }
+};
+
+template <> struct Component<DecodeComponent::Half>
+{
+	static const unsigned bytes = 2;
+	static float load(const uint8_t* p) { uint16_t h; memcpy(&h, p, sizeof(h)); return halfToFloat(h); }
+};
+
+template <> struct Component<DecodeComponent::Float>
+{
+	static const unsigned bytes = 4;
+	static float load(const uint8_t* p) { float f; memcpy(&f, p, sizeof(f)); return f; }
+};
+
+template <DecodeComponent C, unsigned CHANNELS>
+void decode(DecodeArgs& args)
+{
+	const unsigned elementBytes = Component<C>::bytes * CHANNELS;
+
+	for (unsigned thread = 0; thread < args.numThreads; ++thread)
+	{
+		uint32_t start = args.startIndex[thread & 255];
+
+		float sum[CHANNELS] = {};
+		for (unsigned i = 0; i < args.loadsPerThread; ++i)
+		{
+			const uint8_t* element = args.data + size_t((start + i) | args.elementsMask) * elementBytes;
+			for (unsigned c = 0; c < CHANNELS; ++c)
+			{
+				sum[c] += Component<C>::load(element + c * Component<C>::bytes);
+			}
+		}
+
+		for (unsigned c = 0; c < CHANNELS; ++c)
+		{
+			args.result[c] += sum[c];
+		}
+	}
+}
+
+template <DecodeComponent C>
+void decodeChannels(DecodeArgs& args)
+{
+	switch (args.channels)
+	{
+	case 1: decode<C, 1>(args); break;
+	case 2: decode<C, 2>(args); break;
+	case 4: decode<C, 4>(args); break;
+	}
+}
+
+}
+
+void decodeScalar(DecodeArgs& args)
+{
+	switch (args.component)
+	{
+	case DecodeComponent::Unorm8: decodeChannels<DecodeComponent::Unorm8>(args); break;
+	case DecodeComponent::Half: decodeChannels<DecodeComponent::Half>(args); break;
+	case DecodeComponent::Float: decodeChannels<DecodeComponent::Float>(args); break;
+	}
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include "cpuDecodeKernels.h"
+#include <stddef.h>
+
+// Kernel loops shared by the SIMD kernel files. Everything is in an anonymous namespace, so each
+// kernel file gets its own copy compiled with its own instruction set flags.
+//
+// Simd wraps one instruction set:
+//   lanes, Float, Int
+//   zero(), add(Float, Float), reduce(Float), store(float*, Float)
+//   set1(uint32_t), loadIndices(const uint32_t*), add(Int, Int), bitOr(Int, Int), shiftLeft(Int, unsigned)
+//   gather(const uint8_t* base, Int byteOffsets)		32 bit gather, unaligned
+//   load<C>(const uint8_t*)							Decodes lanes consecutive components
+//   convert<C>(Int, unsigned shift)					Decodes the component at bit shift of each lane
+
+namespace
+{
+
+template <DecodeComponent C> struct ComponentBytes;
+template <> struct ComponentBytes<DecodeComponent::Unorm8> { static const unsigned value = 1; };
+template <> struct ComponentBytes<DecodeComponent::Half> { static const unsigned value = 2; };
+template <> struct ComponentBytes<DecodeComponent::Float> { static const unsigned value = 4; };
+
+constexpr unsigned shiftOf(unsigned bytes) { return bytes > 1 ? 1 + shiftOf(bytes / 2) : 0; }
+
+// Lanes are consecutive components of one thread. Multi-channel elements are stored interleaved,
+// so lane l accumulates channel l % CHANNELS.
+template <typename Simd, DecodeComponent C, unsigned CHANNELS>
+void decodeContiguous(DecodeArgs& args)
+{
+	const unsigned componentBytes = ComponentBytes<C>::value;
+	const unsigned elementBytes = componentBytes * CHANNELS;
+	const unsigned components = args.loadsPerThread * CHANNELS;
+
+	for (unsigned thread = 0; thread < args.numThreads; ++thread)
+	{
+		const uint8_t* element = args.data + size_t(args.startIndex[thread & 255] | args.elementsMask) * elementBytes;
+
+		// Two accumulators to hide the add latency
+		typename Simd::Float sum0 = Simd::zero();
+		typename Simd::Float sum1 = Simd::zero();
+		for (unsigned k = 0; k < components; k += 2 * Simd::lanes)
+		{
+			sum0 = Simd::add(sum0, Simd::template load<C>(element + k * componentBytes));
+			sum1 = Simd::add(sum1, Simd::template load<C>(element + (k + Simd::lanes) * componentBytes));
+		}
+
+		float lanes[Simd::lanes];
+		Simd::store(lanes, Simd::add(sum0, sum1));
+		for (unsigned l = 0; l < Simd::lanes; ++l)
+		{
+			args.result[l % CHANNELS] += lanes[l];
+		}
+	}
+}
+
+// Lanes are threads, like a GPU wave. Each lane has its own address, so every load is a gather.
+// Small elements are fetched with a full dword, the source buffer is padded for this.
+template <typename Simd, DecodeComponent C, unsigned CHANNELS>
+void decodeGather(DecodeArgs& args)
+{
+	const unsigned componentBytes = ComponentBytes<C>::value;
+	const unsigned elementBytes = componentBytes * CHANNELS;
+	const unsigned dwords = (elementBytes + 3) / 4;
+
+	const typename Simd::Int mask = Simd::set1(args.elementsMask);
+
+	for (unsigned thread = 0; thread < args.numThreads; thread += Simd::lanes)
+	{
+		typename Simd::Int start = Simd::loadIndices(args.startIndex + (thread & 255));
+
+		typename Simd::Float sum[CHANNELS];
+		for (unsigned c = 0; c < CHANNELS; ++c)
+		{
+			sum[c] = Simd::zero();
+		}
+
+		for (unsigned i = 0; i < args.loadsPerThread; ++i)
+		{
+			typename Simd::Int index = Simd::bitOr(Simd::add(start, Simd::set1(i)), mask);
+			typename Simd::Int offset = Simd::shiftLeft(index, shiftOf(elementBytes));
+
+			typename Simd::Int data[dwords];
+			for (unsigned d = 0; d < dwords; ++d)
+			{
+				data[d] = Simd::gather(args.data + d * 4, offset);
+			}
+
+			for (unsigned c = 0; c < CHANNELS; ++c)
+			{
+				unsigned byte = c * componentBytes;
+				sum[c] = Simd::add(sum[c], Simd::template convert<C>(data[byte / 4], (byte % 4) * 8));
+			}
+		}
+
+		for (unsigned c = 0; c < CHANNELS; ++c)
+		{
+			args.result[c] += Simd::reduce(sum[c]);
+		}
+	}
+}
+
+template <typename Simd, DecodeComponent C, unsigned CHANNELS>
+void decodeAccess(DecodeArgs& args)
+{
+	if (args.gather)
+		decodeGather<Simd, C, CHANNELS>(args);
+	else
+		decodeContiguous<Simd, C, CHANNELS>(args);
+}
+
+template <typename Simd, DecodeComponent C>
+void decodeChannels(DecodeArgs& args)
+{
+	switch (args.channels)
+	{
+	case 1: decodeAccess<Simd, C, 1>(args); break;
+	case 2: decodeAccess<Simd, C, 2>(args); break;
+	case 4: decodeAccess<Simd, C, 4>(args); break;
+	}
+}
+
+template <typename Simd>
+void decode(DecodeArgs& args)
+{
+	switch (args.component)
+	{
+	case DecodeComponent::Unorm8: decodeChannels<Simd, DecodeComponent::Unorm8>(args); break;
+	case DecodeComponent::Half: decodeChannels<Simd, DecodeComponent::Half>(args); break;
+	case DecodeComponent::Float: decodeChannels<Simd, DecodeComponent::Float>(args); break;
+	}
+}
+
+}
@@ -0,0 +1,109 @@
+#include "cpuDecodeKernels.h"
+
+#ifdef CPU_DECODE_X86
+#include "cpuDecodeSimd.h"
+#include <smmintrin.h>
+#include <string.h>
+
+// SSE4.1, 4 lanes. There is no gather instruction and no F16C, both are emulated like compilers do.
+
+namespace
+{
+
+__m128 halfToFloat4(__m128i h)
+{
+	// Exponent rebias by multiplication also normalizes denormals. Inf/NaN exponent is patched after.
+	const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+
+	__m128i expMant = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+	__m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expMant), 16);
+	__m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expMant, 13)), magic);
+	__m128i infNan = _mm_and_si128(_mm_cmpgt_epi32(expMant, _mm_set1_epi32(0x7bff)), _mm_set1_epi32(255 << 23));
+	return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infNan)));
+}
+
+int32_t load32(const uint8_t* p)
+{
+	int32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+struct Sse4
+{
+	static const unsigned lanes = 4;
+	typedef __m128 Float;
+	typedef __m128i Int;
+
+	static Float zero() { return _mm_setzero_ps(); }
+	static Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+	static void store(float* out, Float v) { _mm_storeu_ps(out, v); }
+
+	static float reduce(Float v)
+	{
+		v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+		v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+		return _mm_cvtss_f32(v);
+	}
+
+	static Int set1(uint32_t v) { return _mm_set1_epi32(int(v)); }
+	static Int loadIndices(const uint32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+	static Int add(Int a, Int b) { return _mm_add_epi32(a, b); }
+	static Int bitOr(Int a, Int b) { return _mm_or_si128(a, b); }
+	static Int shiftLeft(Int v, unsigned bits) { return _mm_sll_epi32(v, _mm_cvtsi32_si128(int(bits))); }
+
+	static Int gather(const uint8_t* base, Int offset)
+	{
+		return _mm_setr_epi32(
+			load32(base + uint32_t(_mm_cvtsi128_si32(offset))),
+			load32(base + uint32_t(_mm_extract_epi32(offset, 1))),
+			load32(base + uint32_t(_mm_extract_epi32(offset, 2))),
+			load32(base + uint32_t(_mm_extract_epi32(offset, 3))));
+	}
+
+	template <DecodeComponent C> static Float load(const uint8_t* p);
+	template <DecodeComponent C> static Float convert(Int v, unsigned shift);
+};
+
+template <> Sse4::Float Sse4::load<DecodeComponent::Unorm8>(const uint8_t* p)
+{
+	__m128i bytes = _mm_cvtsi32_si128(load32(p));
+	return _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(bytes)), _mm_set1_ps(1.0f / 255.0f));
+}
+
+template <> Sse4::Float Sse4::load<DecodeComponent::Half>(const uint8_t* p)
+{
+	__m128i halfs = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+	return halfToFloat4(_mm_cvtepu16_epi32(halfs));
+}
+
+template <> Sse4::Float Sse4::load<DecodeComponent::Float>(const uint8_t* p)
+{
+	return _mm_loadu_ps(reinterpret_cast<const float*>(p));
+}
+
+template <> Sse4::Float Sse4::convert<DecodeComponent::Unorm8>(Int v, unsigned shift)
+{
+	v = _mm_and_si128(_mm_srl_epi32(v, _mm_cvtsi32_si128(int(shift))), _mm_set1_epi32(0xff));
+	return _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(1.0f / 255.0f));
+}
+
+template <> Sse4::Float Sse4::convert<DecodeComponent::Half>(Int v, unsigned shift)
+{
+	v = _mm_and_si128(_mm_srl_epi32(v, _mm_cvtsi32_si128(int(shift))), _mm_set1_epi32(0xffff));
+	return halfToFloat4(v);
+}
+
+template <> Sse4::Float Sse4::convert<DecodeComponent::Float>(Int v, unsigned)
+{
+	return _mm_castsi128_ps(v);
+}
+
+}
+
+void decodeSse4(DecodeArgs& args)
+{
+	decode<Sse4>(args);
+}
+
+#endif
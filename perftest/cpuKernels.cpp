@@ -0,0 +1,1998 @@
+#include "cpuKernels.h"
+#include "loadConstantsGPU.h"
+#include "half.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+// Same address generation as the GPU shaders
+#include "hash.hlsli"
+
+// Format conversion
+
+static float unorm8ToFloat(uint8_t v) { return float(v) * (1.0f / 255.0f); }
+
+static uint8_t floatToUnorm8(float v)
+{
+	v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+	return uint8_t(v * 255.0f + 0.5f);
+}
+
+// Storage of one element of each format. Missing channels load as (0, 0, 0, 1) like D3D.
+template <Format F> struct Texel;
+
+template <> struct Texel<Format::R8_UNORM>
+{
+	uint8_t r;
+	float4 load() const { return float4(unorm8ToFloat(r), 0.0f, 0.0f, 1.0f); }
+	void store(float4 v) { r = floatToUnorm8(v.x); }
+};
+
+template <> struct Texel<Format::R8G8_UNORM>
+{
+	uint8_t r, g;
+	float4 load() const { return float4(unorm8ToFloat(r), unorm8ToFloat(g), 0.0f, 1.0f); }
+	void store(float4 v) { r = floatToUnorm8(v.x); g = floatToUnorm8(v.y); }
+};
+
+template <> struct Texel<Format::R8G8B8A8_UNORM>
+{
+	uint8_t r, g, b, a;
+	float4 load() const { return float4(unorm8ToFloat(r), unorm8ToFloat(g), unorm8ToFloat(b), unorm8ToFloat(a)); }
+	void store(float4 v) { r = floatToUnorm8(v.x); g = floatToUnorm8(v.y); b = floatToUnorm8(v.z); a = floatToUnorm8(v.w); }
+};
+
+template <> struct Texel<Format::R16_FLOAT>
+{
+	uint16_t r;
+	float4 load() const { return float4(halfToFloat(r), 0.0f, 0.0f, 1.0f); }
+	void store(float4 v) { r = floatToHalf(v.x); }
+};
+
+template <> struct Texel<Format::R16G16_FLOAT>
+{
+	uint16_t r, g;
+	float4 load() const { return float4(halfToFloat(r), halfToFloat(g), 0.0f, 1.0f); }
+	void store(float4 v) { r = floatToHalf(v.x); g = floatToHalf(v.y); }
+};
+
+template <> struct Texel<Format::R16G16B16A16_FLOAT>
+{
+	uint16_t r, g, b, a;
+	float4 load() const { return float4(halfToFloat(r), halfToFloat(g), halfToFloat(b), halfToFloat(a)); }
+	void store(float4 v) { r = floatToHalf(v.x); g = floatToHalf(v.y); b = floatToHalf(v.z); a = floatToHalf(v.w); }
+};
+
+template <> struct Texel<Format::R32_FLOAT>
+{
+	float r;
+	float4 load() const { return float4(r, 0.0f, 0.0f, 1.0f); }
+	void store(float4 v) { r = v.x; }
+};
+
+template <> struct Texel<Format::R32G32_FLOAT>
+{
+	float r, g;
+	float4 load() const { return float4(r, g, 0.0f, 1.0f); }
+	void store(float4 v) { r = v.x; g = v.y; }
+};
+
+template <> struct Texel<Format::R32G32B32A32_FLOAT>
+{
+	float r, g, b, a;
+	float4 load() const { return float4(r, g, b, a); }
+	void store(float4 v) { r = v.x; g = v.y; b = v.z; a = v.w; }
+};
+
+template <> struct Texel<Format::R32_UINT>
+{
+	uint32_t r;
+	float4 load() const { return float4(float(r), 0.0f, 0.0f, 1.0f); }
+	void store(float4 v) { r = uint32_t(v.x); }
+};
+
+template <Format F>
+struct FormatTag
+{
+	static const Format format = F;
+};
+
+// Calls func(FormatTag<format>()). Kernels use this to pick the typed load once per group instead of once per load.
+template <typename Func>
+void switchFormat(Format format, Func&& func)
+{
+	switch (format)
+	{
+	case Format::R8_UNORM: func(FormatTag<Format::R8_UNORM>()); break;
+	case Format::R8G8_UNORM: func(FormatTag<Format::R8G8_UNORM>()); break;
+	case Format::R8G8B8A8_UNORM: func(FormatTag<Format::R8G8B8A8_UNORM>()); break;
+	case Format::R16_FLOAT: func(FormatTag<Format::R16_FLOAT>()); break;
+	case Format::R16G16_FLOAT: func(FormatTag<Format::R16G16_FLOAT>()); break;
+	case Format::R16G16B16A16_FLOAT: func(FormatTag<Format::R16G16B16A16_FLOAT>()); break;
+	case Format::R32_FLOAT: func(FormatTag<Format::R32_FLOAT>()); break;
+	case Format::R32G32_FLOAT: func(FormatTag<Format::R32G32_FLOAT>()); break;
+	case Format::R32G32B32A32_FLOAT: func(FormatTag<Format::R32G32B32A32_FLOAT>()); break;
+	case Format::R32_UINT: func(FormatTag<Format::R32_UINT>()); break;
+	}
+}
+
+// HLSL resource types. Out of bounds loads return zero and out of bounds stores are dropped, like D3D.
+// The RW variants are the same types: stores go to the bound UAV. Groups running on other threads
+// write the same addresses without synchronization, like GPU threads do.
+
+template <Format F>
+struct TypedBuffer
+{
+	TypedBuffer(const CpuView& view) : data(reinterpret_cast<Texel<F>*>(view.data)), numElements(view.numElements) {}
+
+	float4 operator[](uint index) const
+	{
+		if (index >= numElements)
+			return float4();
+		return data[index].load();
+	}
+
+	void store(uint index, float4 value)
+	{
+		if (index < numElements)
+			data[index].store(value);
+	}
+
+	Texel<F>* data;
+	uint numElements;
+};
+
+struct ByteAddressBuffer
+{
+	ByteAddressBuffer(const CpuView& view) : data(view.data), bytes(view.numElements * 4) {}
+
+	// Load, Load2, Load3, Load4. Address is dword aligned, like D3D.
+	template <int WIDTH>
+	uint4 load(uint address) const
+	{
+		address &= ~3u;
+
+		uint v[4] = {};
+		for (int c = 0; c < WIDTH; ++c)
+		{
+			uint offset = address + c * 4;
+			if (offset + 4 <= bytes)
+				memcpy(&v[c], data + offset, sizeof(uint));
+		}
+		return uint4(v[0], v[1], v[2], v[3]);
+	}
+
+	// Store, Store2, Store3, Store4
+	template <int WIDTH>
+	void store(uint address, uint4 value)
+	{
+		address &= ~3u;
+
+		uint v[4] = { value.x, value.y, value.z, value.w };
+		for (int c = 0; c < WIDTH; ++c)
+		{
+			uint offset = address + c * 4;
+			if (offset + 4 <= bytes)
+				memcpy(data + offset, &v[c], sizeof(uint));
+		}
+	}
+
+	uint8_t* data;
+	uint bytes;
+};
+
+template <int WIDTH>
+struct StructuredBuffer
+{
+	StructuredBuffer(const CpuView& view) : data(view.data), numElements(view.numElements), stride(view.stride)
+	{
+		assert(stride == WIDTH * sizeof(float));
+	}
+
+	float4 operator[](uint index) const
+	{
+		float v[4] = {};
+		if (index < numElements)
+			memcpy(v, data + index * stride, WIDTH * sizeof(float));
+		return float4(v[0], v[1], v[2], v[3]);
+	}
+
+	void store(uint index, float4 value)
+	{
+		float v[4] = { value.x, value.y, value.z, value.w };
+		if (index < numElements)
+			memcpy(data + index * stride, v, WIDTH * sizeof(float));
+	}
+
+	uint8_t* data;
+	uint numElements;
+	uint stride;
+};
+
+template <Format F>
+struct Texture2D
+{
+	Texture2D(const CpuView& view) : data(reinterpret_cast<Texel<F>*>(view.data)), width(view.dimensions.x), height(view.dimensions.y) {}
+
+	float4 operator[](uint2 coord) const
+	{
+		if (coord.x >= width || coord.y >= height)
+			return float4();
+		return data[coord.y * width + coord.x].load();
+	}
+
+	void store(uint2 coord, float4 value)
+	{
+		if (coord.x < width && coord.y < height)
+			data[coord.y * width + coord.x].store(value);
+	}
+
+	Texel<F>* data;
+	uint width;
+	uint height;
+};
+
+// RWBuffer<float> output. Never written at runtime, only needs to be correct.
+static void storeTyped(const CpuView& view, uint index, float value)
+{
+	if (index >= view.numElements)
+		return;
+
+	switchFormat(view.format, [&](auto tag)
+	{
+		typedef Texel<decltype(tag)::format> T;
+		reinterpret_cast<T*>(view.data)[index].store(float4(value, value, value, value));
+	});
+}
+
+// Component selection of the load bodies
+template <int LOAD_WIDTH>
+float4 swizzle(float4 v)
+{
+	switch (LOAD_WIDTH)
+	{
+	case 1: return float4(v.x, v.x, v.x, v.x);
+	case 2: return float4(v.x, v.y, v.x, v.y);
+	case 3: return float4(v.x, v.y, v.z, v.x);
+	default: return v;
+	}
+}
+
+static float4 toFloat4(uint4 v)
+{
+	return float4(float(v.x), float(v.y), float(v.z), float(v.w));
+}
+
+static uint asuint(float v)
+{
+	uint u;
+	memcpy(&u, &v, sizeof(u));
+	return u;
+}
+
+static uint4 asuint(float4 v)
+{
+	return uint4(asuint(v.x), asuint(v.y), asuint(v.z), asuint(v.w));
+}
+
+enum class Address
+{
+	Invariant,
+	Wave,		// Atomics only
+	Linear,
+	Random
+};
+
+template <Address A>
+uint startIndex(uint gix)
+{
+	switch (A)
+	{
+	case Address::Invariant:
+		// All threads load from same address. Index is wave invariant.
+		return 0;
+	case Address::Linear:
+		// Linearly increasing starting address to allow memory coalescing
+		return gix;
+	default:
+		// Randomize start address offset (0-15) to prevent memory coalescing
+		return hash1(gix) & 0xf;
+	}
+}
+
+// numthreads(THREAD_GROUP_SIZE, 1, 1) group shared by the buffer bodies.
+// threadBody(gix) runs the load loop of one thread and returns its value. store(index, value) is the never taken output write.
+const uint THREAD_GROUP_SIZE = 256;
+
+template <typename Constants, typename ThreadBody, typename Store>
+void runGroup(uint3 groupId, const Constants& loadConstants, ThreadBody threadBody, Store store)
+{
+	float dummyLDS[THREAD_GROUP_SIZE];
+
+	for (uint gix = 0; gix < THREAD_GROUP_SIZE; ++gix)
+	{
+		float4 value = threadBody(gix);
+
+		// Linear write to LDS (no bank conflicts). Significantly faster than memory loads.
+		dummyLDS[gix] = value.x + value.y + value.z + value.w;
+	}
+
+	// GroupMemoryBarrierWithGroupSync()
+
+	for (uint gix = 0; gix < THREAD_GROUP_SIZE; ++gix)
+	{
+		uint3 tid(groupId.x * THREAD_GROUP_SIZE + gix, groupId.y, groupId.z);
+
+		// This branch is never taken, but the compiler doesn't know it
+		if (loadConstants.writeIndex != 0xffffffff)
+		{
+			store(tid.x + tid.y, dummyLDS[loadConstants.writeIndex]);
+		}
+	}
+}
+
+// RWBuffer<float> output bound to u0
+template <typename Constants, typename ThreadBody>
+void runGroup(const CpuBindings& bindings, uint3 groupId, const Constants& loadConstants, ThreadBody threadBody)
+{
+	runGroup(groupId, loadConstants, threadBody, [&](uint index, float value) { storeTyped(*bindings.uavs[0], index, value); });
+}
+
+template <typename Constants>
+const Constants& constantBuffer(const CpuBindings& bindings)
+{
+	return *reinterpret_cast<const Constants*>(bindings.cbs[0]);
+}
+
+// loadTypedBody.hlsli
+template <int LOAD_WIDTH, Address A>
+void loadTyped(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+
+	switchFormat(bindings.srvs[0]->format, [&](auto tag)
+	{
+		TypedBuffer<decltype(tag)::format> sourceData(*bindings.srvs[0]);
+
+		runGroup(bindings, groupId, loadConstants, [&](uint gix)
+		{
+			float4 value;
+			uint htid = startIndex<A>(gix);
+
+			for (int i = 0; i < 256; ++i)
+			{
+				// Mask with runtime constant to prevent unwanted compiler optimizations
+				uint elemIdx = (htid + i) | loadConstants.elementsMask;
+				value = value + swizzle<LOAD_WIDTH>(sourceData[elemIdx]);
+			}
+			return value;
+		});
+	});
+}
+
+// loadRawBody.hlsli
+template <int LOAD_WIDTH, Address A>
+void loadRaw(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	ByteAddressBuffer sourceData(*bindings.srvs[0]);
+
+	runGroup(bindings, groupId, loadConstants, [&](uint gix)
+	{
+		float4 value;
+		uint htid = startIndex<A>(gix) * (4 * LOAD_WIDTH) + loadConstants.readStartAddress;
+
+		for (int i = 0; i < 256; ++i)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			uint address = (htid + i * (4 * LOAD_WIDTH)) | loadConstants.elementsMask;
+			value = value + swizzle<LOAD_WIDTH>(toFloat4(sourceData.load<LOAD_WIDTH>(address)));
+		}
+		return value;
+	});
+}
+
+// loadStructuredBody.hlsli
+template <int LOAD_WIDTH, Address A>
+void loadStructured(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	StructuredBuffer<LOAD_WIDTH> sourceData(*bindings.srvs[0]);
+
+	runGroup(bindings, groupId, loadConstants, [&](uint gix)
+	{
+		float4 value;
+		uint htid = startIndex<A>(gix);
+
+		for (int i = 0; i < 256; ++i)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			uint elemIdx = (htid + i) | loadConstants.elementsMask;
+			value = value + swizzle<LOAD_WIDTH>(sourceData[elemIdx]);
+		}
+		return value;
+	});
+}
+
+// loadConstantBody.hlsli
+template <Address A>
+void loadConstant(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstantsWithArray& loadConstants = constantBuffer<LoadConstantsWithArray>(bindings);
+	const uint arraySize = sizeof(loadConstants.benchmarkArray) / sizeof(loadConstants.benchmarkArray[0]);
+
+	runGroup(bindings, groupId, loadConstants, [&](uint gix)
+	{
+		float4 value;
+		uint htid = startIndex<A>(gix);
+
+		for (int i = 0; i < 256; ++i)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			uint elemIdx = (htid + i) | loadConstants.elementsMask;
+			if (elemIdx < arraySize)
+				value = value + loadConstants.benchmarkArray[elemIdx];
+		}
+		return value;
+	});
+}
+
+// waveLoadBody.hlsli. CPU waves are 32 lanes, the WaveGetLaneCount() of this backend.
+const uint CPU_WAVE_SIZE = 32;
+
+enum class WaveOperation
+{
+	ReadLaneFirst,
+	ReadLaneAt,
+	FirstLaneLoad
+};
+
+// Uniform load loop of one wave. load(i) is iteration i.
+template <WaveOperation OP, typename Load>
+void waveLoop(Load load, float4 (&values)[CPU_WAVE_SIZE])
+{
+	float4 laneValues[CPU_WAVE_SIZE];
+	for (uint lane = 0; lane < CPU_WAVE_SIZE; ++lane)
+		values[lane] = float4();
+
+	switch (OP)
+	{
+	case WaveOperation::ReadLaneFirst:
+		// Every lane loads, the first lane's value is broadcast
+		for (uint i = 0; i < 256; ++i)
+		{
+			for (uint lane = 0; lane < CPU_WAVE_SIZE; ++lane)
+				laneValues[lane] = load(i);
+			for (uint lane = 0; lane < CPU_WAVE_SIZE; ++lane)
+				values[lane] = values[lane] + laneValues[0];
+		}
+		break;
+	case WaveOperation::ReadLaneAt:
+		// Each lane loads one of the next wave width iterations, WaveReadLaneAt broadcasts them in order
+		for (uint base = 0; base < 256; base += CPU_WAVE_SIZE)
+		{
+			for (uint lane = 0; lane < CPU_WAVE_SIZE; ++lane)
+				laneValues[lane] = load(base + lane);
+			for (uint j = 0; j < CPU_WAVE_SIZE; ++j)
+			{
+				for (uint lane = 0; lane < CPU_WAVE_SIZE; ++lane)
+					values[lane] = values[lane] + laneValues[j];
+			}
+		}
+		break;
+	case WaveOperation::FirstLaneLoad:
+		// Only the first lane loads
+		for (uint i = 0; i < 256; ++i)
+		{
+			float4 value = load(i);
+			for (uint lane = 0; lane < CPU_WAVE_SIZE; ++lane)
+				values[lane] = values[lane] + value;
+		}
+		break;
+	}
+}
+
+// runGroup runs the threads in order. The first lane of each wave runs the loop of the whole wave.
+template <WaveOperation OP, typename Constants, typename Load>
+void runWaveGroup(const CpuBindings& bindings, uint3 groupId, const Constants& loadConstants, Load load)
+{
+	float4 waveValues[CPU_WAVE_SIZE];
+	runGroup(bindings, groupId, loadConstants, [&](uint gix)
+	{
+		uint lane = gix % CPU_WAVE_SIZE;
+		if (lane == 0)
+			waveLoop<OP>(load, waveValues);
+		return waveValues[lane];
+	});
+}
+
+template <int LOAD_WIDTH, WaveOperation OP>
+void waveTyped(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+
+	switchFormat(bindings.srvs[0]->format, [&](auto tag)
+	{
+		TypedBuffer<decltype(tag)::format> sourceData(*bindings.srvs[0]);
+
+		runWaveGroup<OP>(bindings, groupId, loadConstants, [&](uint i)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			return swizzle<LOAD_WIDTH>(sourceData[i | loadConstants.elementsMask]);
+		});
+	});
+}
+
+template <int LOAD_WIDTH, WaveOperation OP>
+void waveRaw(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	ByteAddressBuffer sourceData(*bindings.srvs[0]);
+
+	runWaveGroup<OP>(bindings, groupId, loadConstants, [&](uint i)
+	{
+		uint address = (loadConstants.readStartAddress + i * (4 * LOAD_WIDTH)) | loadConstants.elementsMask;
+		return swizzle<LOAD_WIDTH>(toFloat4(sourceData.load<LOAD_WIDTH>(address)));
+	});
+}
+
+template <int LOAD_WIDTH, WaveOperation OP>
+void waveStructured(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	StructuredBuffer<LOAD_WIDTH> sourceData(*bindings.srvs[0]);
+
+	runWaveGroup<OP>(bindings, groupId, loadConstants, [&](uint i)
+	{
+		return swizzle<LOAD_WIDTH>(sourceData[i | loadConstants.elementsMask]);
+	});
+}
+
+template <WaveOperation OP>
+void waveConstant(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstantsWithArray& loadConstants = constantBuffer<LoadConstantsWithArray>(bindings);
+	const uint arraySize = sizeof(loadConstants.benchmarkArray) / sizeof(loadConstants.benchmarkArray[0]);
+
+	runWaveGroup<OP>(bindings, groupId, loadConstants, [&](uint i)
+	{
+		uint elemIdx = i | loadConstants.elementsMask;
+		return elemIdx < arraySize ? loadConstants.benchmarkArray[elemIdx] : float4();
+	});
+}
+
+template <int LOAD_WIDTH, WaveOperation OP>
+void waveTex(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+
+	switchFormat(bindings.srvs[0]->format, [&](auto tag)
+	{
+		Texture2D<decltype(tag)::format> sourceData(*bindings.srvs[0]);
+
+		runWaveGroup<OP>(bindings, groupId, loadConstants, [&](uint i)
+		{
+			// Same texel order as the 16x16 loop of loadTexBody.hlsli
+			uint2 elemIdx((i & 15) | loadConstants.elementsMask, (i >> 4) | loadConstants.elementsMask);
+			return swizzle<LOAD_WIDTH>(sourceData[elemIdx]);
+		});
+	});
+}
+
+// numthreads(THREAD_GROUP_DIM, THREAD_GROUP_DIM, 1) group shared by the texture bodies.
+// threadBody(gid) runs the load loop of one thread and returns its value. store(tid, value) is the never taken output write.
+const uint THREAD_GROUP_DIM = 16;
+
+template <typename Constants, typename ThreadBody, typename Store>
+void runTexGroup(uint3 groupId, const Constants& loadConstants, ThreadBody threadBody, Store store)
+{
+	float dummyLDS[THREAD_GROUP_DIM][THREAD_GROUP_DIM];
+
+	for (uint gy = 0; gy < THREAD_GROUP_DIM; ++gy)
+	{
+		for (uint gx = 0; gx < THREAD_GROUP_DIM; ++gx)
+		{
+			float4 value = threadBody(uint2(gx, gy));
+
+			// Linear write to LDS (no bank conflicts). Significantly faster than memory loads.
+			dummyLDS[gy][gx] = value.x + value.y + value.z + value.w;
+		}
+	}
+
+	// GroupMemoryBarrierWithGroupSync()
+
+	for (uint gy = 0; gy < THREAD_GROUP_DIM; ++gy)
+	{
+		for (uint gx = 0; gx < THREAD_GROUP_DIM; ++gx)
+		{
+			uint2 tid(groupId.x * THREAD_GROUP_DIM + gx, groupId.y * THREAD_GROUP_DIM + gy);
+
+			// This branch is never taken, but the compiler doesn't know it
+			if (loadConstants.writeIndex != 0xffffffff)
+			{
+				store(tid, dummyLDS[(loadConstants.writeIndex >> 8) & 0xff][loadConstants.writeIndex & 0xff]);
+			}
+		}
+	}
+}
+
+// RWBuffer<float> output bound to u0
+template <typename Constants, typename ThreadBody>
+void runTexGroup(const CpuBindings& bindings, uint3 groupId, const Constants& loadConstants, ThreadBody threadBody)
+{
+	runTexGroup(groupId, loadConstants, threadBody, [&](uint2 tid, float value) { storeTyped(*bindings.uavs[0], tid.x + tid.y, value); });
+}
+
+template <Address A>
+uint2 texStartIndex(uint2 gid)
+{
+	switch (A)
+	{
+	case Address::Invariant:
+		// All threads load from same address. Index is wave invariant.
+		return uint2(0, 0);
+	case Address::Linear:
+		// Linearly increasing starting address.
+		return gid;
+	default:
+		// Randomize start address offset (0-3, 0-3)
+		return uint2((hash1(gid.x) & 0x4), (hash1(gid.y) & 0x4));
+	}
+}
+
+// loadTexBody.hlsli
+template <int LOAD_WIDTH, Address A>
+void loadTex(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+
+	switchFormat(bindings.srvs[0]->format, [&](auto tag)
+	{
+		Texture2D<decltype(tag)::format> sourceData(*bindings.srvs[0]);
+
+		runTexGroup(bindings, groupId, loadConstants, [&](uint2 gid)
+		{
+			float4 value;
+			uint2 htid = texStartIndex<A>(gid);
+
+			for (uint y = 0; y < 16; ++y)
+			{
+				for (uint x = 0; x < 16; ++x)
+				{
+					// Mask with runtime constant to prevent unwanted compiler optimizations
+					uint2 elemIdx((htid.x + x) | loadConstants.elementsMask, (htid.y + y) | loadConstants.elementsMask);
+					value = value + swizzle<LOAD_WIDTH>(sourceData[elemIdx]);
+				}
+			}
+			return value;
+		});
+	});
+}
+
+// Texture2D or Texture3D with a full mip chain, as seen through a sampler. 2D textures have a depth of one.
+// Sampling wraps at the edges like the benchmark samplers. Load returns zero out of bounds.
+template <Format F>
+struct MipTexture
+{
+	MipTexture(const CpuView& view) : mips(view.mips)
+	{
+		assert(mips <= maxMips);
+		uint8_t* data = view.data;
+		uint3 size = view.dimensions;
+		for (uint mip = 0; mip < mips; ++mip)
+		{
+			mipData[mip] = reinterpret_cast<Texel<F>*>(data);
+			mipSize[mip] = size;
+			data += size_t(size.x) * size.y * size.z * sizeof(Texel<F>);
+			size = uint3(std::max(size.x / 2, 1u), std::max(size.y / 2, 1u), std::max(size.z / 2, 1u));
+		}
+	}
+
+	float4 load(uint3 coord, uint mip) const
+	{
+		uint3 size = mipSize[mip];
+		if (coord.x >= size.x || coord.y >= size.y || coord.z >= size.z)
+			return float4();
+		return mipData[mip][(coord.z * size.y + coord.y) * size.x + coord.x].load();
+	}
+
+	float4 sampleLevel(Device::SamplerType sampler, float3 uv, float lod) const
+	{
+		lod = std::min(std::max(lod, 0.0f), float(mips - 1));
+		switch (sampler)
+		{
+		case Device::SamplerType::Nearest: return sampleMip(uv, uint(lod + 0.5f), false);
+		case Device::SamplerType::Bilinear: return sampleMip(uv, uint(lod + 0.5f), true);
+		default:
+		{
+			uint mip = uint(lod);
+			float t = lod - float(mip);
+			float4 value = sampleMip(uv, mip, true);
+			if (t > 0.0f)
+				value = value * (1.0f - t) + sampleMip(uv, mip + 1, true) * t;
+			return value;
+		}
+		}
+	}
+
+	// Isotropic: LOD of the longer gradient in mip 0 texels
+	float4 sampleGrad(Device::SamplerType sampler, float3 uv, float3 ddx, float3 ddy) const
+	{
+		float3 size(float(mipSize[0].x), float(mipSize[0].y), float(mipSize[0].z));
+		float3 dx = ddx * size;
+		float3 dy = ddy * size;
+		float footprint = std::max(dot(dx, dx), dot(dy, dy));
+		return sampleLevel(sampler, uv, 0.5f * log2f(footprint));
+	}
+
+	// Red channel of the 2x2 bilinear footprint of mip 0, in the D3D order (-,+), (+,+), (+,-), (-,-)
+	float4 gatherRed(float3 uv) const
+	{
+		int3 c = footprint(uv, 0).first;
+		return float4(fetch(int3(c.x, c.y + 1, c.z), 0).x, fetch(int3(c.x + 1, c.y + 1, c.z), 0).x,
+					  fetch(int3(c.x + 1, c.y, c.z), 0).x, fetch(c, 0).x);
+	}
+
+private:
+	struct int3
+	{
+		int3(int x, int y, int z) : x(x), y(y), z(z) {}
+		int x, y, z;
+	};
+
+	static int wrap(int coord, uint size)
+	{
+		int m = coord % int(size);
+		return m < 0 ? m + int(size) : m;
+	}
+
+	float4 fetch(int3 coord, uint mip) const
+	{
+		uint3 size = mipSize[mip];
+		return load(uint3(wrap(coord.x, size.x), wrap(coord.y, size.y), wrap(coord.z, size.z)), mip);
+	}
+
+	// Top left texel of the linear filter footprint and the weights of the second texel
+	std::pair<int3, float3> footprint(float3 uv, uint mip) const
+	{
+		uint3 size = mipSize[mip];
+		float3 p = uv * float3(float(size.x), float(size.y), float(size.z)) - float3(0.5f, 0.5f, 0.5f);
+		float3 base(floorf(p.x), floorf(p.y), floorf(p.z));
+		return std::make_pair(int3(int(base.x), int(base.y), int(base.z)), p - base);
+	}
+
+	float4 sampleMip(float3 uv, uint mip, bool linear) const
+	{
+		if (!linear)
+		{
+			uint3 size = mipSize[mip];
+			return fetch(int3(int(floorf(uv.x * size.x)), int(floorf(uv.y * size.y)), int(floorf(uv.z * size.z))), mip);
+		}
+
+		std::pair<int3, float3> f = footprint(uv, mip);
+		int3 c = f.first;
+		float3 w = f.second;
+		float4 value;
+		for (int z = 0; z < 2; ++z)
+		{
+			for (int y = 0; y < 2; ++y)
+			{
+				for (int x = 0; x < 2; ++x)
+				{
+					float weight = (x ? w.x : 1.0f - w.x) * (y ? w.y : 1.0f - w.y) * (z ? w.z : 1.0f - w.z);
+					if (weight > 0.0f)
+						value = value + fetch(int3(c.x + x, c.y + y, c.z + z), mip) * weight;
+				}
+			}
+		}
+		return value;
+	}
+
+	static const uint maxMips = 16;
+	Texel<F>* mipData[maxMips];
+	uint3 mipSize[maxMips];
+	uint mips;
+};
+
+enum class TextureOperation
+{
+	Load,
+	SampleLevel,
+	SampleGrad,
+	Gather
+};
+
+// sampleTexBody.hlsli
+template <int LOAD_WIDTH, Address A, TextureOperation OP, bool TEXTURE_3D>
+void sampleTex(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	const uint TEXTURE_SIZE = TEXTURE_3D ? 16 : 32;
+	const float SAMPLE_LOD = 0.5f;
+	const float GRADIENT = 1.5f / TEXTURE_SIZE;
+	Device::SamplerType sampler = bindings.samplers[0];
+
+	switchFormat(bindings.srvs[0]->format, [&](auto tag)
+	{
+		MipTexture<decltype(tag)::format> sourceData(*bindings.srvs[0]);
+
+		runTexGroup(bindings, groupId, loadConstants, [&](uint2 gid)
+		{
+			float4 value;
+
+			for (uint y = 0; y < 16; ++y)
+			{
+				for (uint x = 0; x < 16; ++x)
+				{
+					uint3 texel;
+					if (A == Address::Linear)
+					{
+						// Coherent: neighbour threads access neighbour texels. Volumes are walked slice by slice.
+						texel = TEXTURE_3D ? uint3(gid.x + x, gid.y, y) : uint3(gid.x + x, gid.y + y, 0);
+					}
+					else
+					{
+						// Random texel per thread and iteration
+						uint h = hash2(uint2(gid.y * THREAD_GROUP_DIM + gid.x, y * 16 + x));
+						texel = TEXTURE_3D ? uint3(h, h >> 8, h >> 16) : uint3(h, h >> 16, 0);
+					}
+
+					// Mask with runtime constant to prevent unwanted compiler optimizations
+					uint mask = TEXTURE_SIZE - 1;
+					texel = uint3((texel.x & mask) | loadConstants.elementsMask, (texel.y & mask) | loadConstants.elementsMask,
+								  TEXTURE_3D ? (texel.z & mask) | loadConstants.elementsMask : 0);
+					float3 uv((texel.x + 0.5f) / TEXTURE_SIZE, (texel.y + 0.5f) / TEXTURE_SIZE, TEXTURE_3D ? (texel.z + 0.5f) / TEXTURE_SIZE : 0.5f);
+
+					switch (OP)
+					{
+					case TextureOperation::Load:
+						value = value + swizzle<LOAD_WIDTH>(sourceData.load(texel, 0));
+						break;
+					case TextureOperation::SampleLevel:
+						value = value + swizzle<LOAD_WIDTH>(sourceData.sampleLevel(sampler, uv, SAMPLE_LOD));
+						break;
+					case TextureOperation::SampleGrad:
+						value = value + swizzle<LOAD_WIDTH>(sourceData.sampleGrad(sampler, uv, float3(GRADIENT, 0.0f, 0.0f), float3(0.0f, GRADIENT, 0.0f)));
+						break;
+					case TextureOperation::Gather:
+						value = value + sourceData.gatherRed(uv);
+						break;
+					}
+				}
+			}
+			return value;
+		});
+	});
+}
+
+// groupShapeBody.hlsli. numthreads(GROUP_WIDTH, GROUP_HEIGHT, 1), threadBody(gid, gix) runs the load loop of one thread.
+// Addresses wrap inside the views of the fixed cases.
+template <uint GROUP_WIDTH, uint GROUP_HEIGHT, typename ThreadBody>
+void runShapeGroup(const CpuBindings& bindings, uint3 groupId, const LoadConstants& loadConstants, ThreadBody threadBody)
+{
+	const uint groupSize = GROUP_WIDTH * GROUP_HEIGHT;
+	float dummyLDS[groupSize];
+
+	for (uint gy = 0; gy < GROUP_HEIGHT; ++gy)
+	{
+		for (uint gx = 0; gx < GROUP_WIDTH; ++gx)
+		{
+			uint gix = gy * GROUP_WIDTH + gx;
+			float4 value = threadBody(uint2(gx, gy), gix);
+
+			// Linear write to LDS (no bank conflicts). Significantly faster than memory loads.
+			dummyLDS[gix] = value.x + value.y + value.z + value.w;
+		}
+	}
+
+	// GroupMemoryBarrierWithGroupSync()
+
+	for (uint gy = 0; gy < GROUP_HEIGHT; ++gy)
+	{
+		for (uint gx = 0; gx < GROUP_WIDTH; ++gx)
+		{
+			uint2 tid(groupId.x * GROUP_WIDTH + gx, groupId.y * GROUP_HEIGHT + gy);
+
+			// This branch is never taken, but the compiler doesn't know it
+			if (loadConstants.writeIndex != 0xffffffff)
+			{
+				storeTyped(*bindings.uavs[0], tid.x + tid.y, dummyLDS[loadConstants.writeIndex & (groupSize - 1)]);
+			}
+		}
+	}
+}
+
+template <Address A, uint GROUP_WIDTH, uint GROUP_HEIGHT>
+void shapeTyped(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+
+	switchFormat(bindings.srvs[0]->format, [&](auto tag)
+	{
+		TypedBuffer<decltype(tag)::format> sourceData(*bindings.srvs[0]);
+
+		runShapeGroup<GROUP_WIDTH, GROUP_HEIGHT>(bindings, groupId, loadConstants, [&](uint2, uint gix)
+		{
+			float4 value;
+			uint htid = startIndex<A>(gix);
+
+			for (uint i = 0; i < 256; ++i)
+			{
+				// Mask with runtime constant to prevent unwanted compiler optimizations
+				uint elemIdx = ((htid + i) & 1023) | loadConstants.elementsMask;
+				value = value + sourceData[elemIdx];
+			}
+			return value;
+		});
+	});
+}
+
+template <Address A, uint GROUP_WIDTH, uint GROUP_HEIGHT>
+void shapeRaw(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	ByteAddressBuffer sourceData(*bindings.srvs[0]);
+
+	runShapeGroup<GROUP_WIDTH, GROUP_HEIGHT>(bindings, groupId, loadConstants, [&](uint2, uint gix)
+	{
+		float4 value;
+		uint htid = startIndex<A>(gix);
+
+		for (uint i = 0; i < 256; ++i)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			uint address = (((htid + i) & 255) * 16) | loadConstants.elementsMask;
+			value = value + toFloat4(sourceData.load<4>(address));
+		}
+		return value;
+	});
+}
+
+template <Address A, uint GROUP_WIDTH, uint GROUP_HEIGHT>
+void shapeStructured(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	StructuredBuffer<4> sourceData(*bindings.srvs[0]);
+
+	runShapeGroup<GROUP_WIDTH, GROUP_HEIGHT>(bindings, groupId, loadConstants, [&](uint2, uint gix)
+	{
+		float4 value;
+		uint htid = startIndex<A>(gix);
+
+		for (uint i = 0; i < 256; ++i)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			uint elemIdx = ((htid + i) & 1023) | loadConstants.elementsMask;
+			value = value + sourceData[elemIdx];
+		}
+		return value;
+	});
+}
+
+template <Address A, uint GROUP_WIDTH, uint GROUP_HEIGHT>
+void shapeTex(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+
+	switchFormat(bindings.srvs[0]->format, [&](auto tag)
+	{
+		Texture2D<decltype(tag)::format> sourceData(*bindings.srvs[0]);
+
+		runShapeGroup<GROUP_WIDTH, GROUP_HEIGHT>(bindings, groupId, loadConstants, [&](uint2 gid, uint)
+		{
+			float4 value;
+			uint2 htid = texStartIndex<A>(gid);
+
+			for (uint i = 0; i < 256; ++i)
+			{
+				// Mask with runtime constant to prevent unwanted compiler optimizations
+				uint2 elemIdx(((htid.x + (i & 15)) & 31) | loadConstants.elementsMask, ((htid.y + (i >> 4)) & 31) | loadConstants.elementsMask);
+				value = value + sourceData[elemIdx];
+			}
+			return value;
+		});
+	});
+}
+
+// sweepBufferBody.hlsli. Odd number of groups between the blocks of consecutive iterations.
+const uint BLOCK_STRIDE = THREAD_GROUP_SIZE * 4099;
+
+template <Address A, typename Load>
+void sweepBufferGroup(const CpuBindings& bindings, uint3 groupId, Load load)
+{
+	const SweepConstants& sweepConstants = constantBuffer<SweepConstants>(bindings);
+
+	runGroup(bindings, groupId, sweepConstants, [&](uint gix)
+	{
+		float4 value;
+		uint threadIndex = groupId.y * sweepConstants.dispatchWidth + groupId.x * THREAD_GROUP_SIZE + gix;
+
+		for (uint i = 0; i < 256; ++i)
+		{
+			// Linear: group loads a contiguous block. Random: anywhere in the working set.
+			uint elemIdx = A == Address::Linear ? threadIndex + i * BLOCK_STRIDE : hash2(uint2(threadIndex, i));
+
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			elemIdx = (elemIdx & sweepConstants.addressMask.x) | sweepConstants.elementsMask;
+			value = value + load(elemIdx);
+		}
+		return value;
+	});
+}
+
+template <int LOAD_WIDTH, Address A>
+void sweepTyped(const CpuBindings& bindings, uint3 groupId)
+{
+	switchFormat(bindings.srvs[0]->format, [&](auto tag)
+	{
+		TypedBuffer<decltype(tag)::format> sourceData(*bindings.srvs[0]);
+		sweepBufferGroup<A>(bindings, groupId, [&](uint elemIdx) { return swizzle<LOAD_WIDTH>(sourceData[elemIdx]); });
+	});
+}
+
+template <int LOAD_WIDTH, Address A>
+void sweepRaw(const CpuBindings& bindings, uint3 groupId)
+{
+	ByteAddressBuffer sourceData(*bindings.srvs[0]);
+	sweepBufferGroup<A>(bindings, groupId, [&](uint elemIdx)
+	{
+		return swizzle<LOAD_WIDTH>(toFloat4(sourceData.load<LOAD_WIDTH>(elemIdx * (4 * LOAD_WIDTH))));
+	});
+}
+
+template <int LOAD_WIDTH, Address A>
+void sweepStructured(const CpuBindings& bindings, uint3 groupId)
+{
+	StructuredBuffer<LOAD_WIDTH> sourceData(*bindings.srvs[0]);
+	sweepBufferGroup<A>(bindings, groupId, [&](uint elemIdx) { return swizzle<LOAD_WIDTH>(sourceData[elemIdx]); });
+}
+
+// sweepTexBody.hlsli. Odd number of groups between the tiles of consecutive iterations.
+const uint2 TILE_STRIDE(THREAD_GROUP_DIM * 67, THREAD_GROUP_DIM * 131);
+
+template <int LOAD_WIDTH, Address A>
+void sweepTex(const CpuBindings& bindings, uint3 groupId)
+{
+	const SweepConstants& sweepConstants = constantBuffer<SweepConstants>(bindings);
+
+	switchFormat(bindings.srvs[0]->format, [&](auto tag)
+	{
+		Texture2D<decltype(tag)::format> sourceData(*bindings.srvs[0]);
+
+		runTexGroup(bindings, groupId, sweepConstants, [&](uint2 gid)
+		{
+			float4 value;
+			uint2 tid(groupId.x * THREAD_GROUP_DIM + gid.x, groupId.y * THREAD_GROUP_DIM + gid.y);
+
+			for (uint i = 0; i < 256; ++i)
+			{
+				uint2 elemIdx;
+				if (A == Address::Linear)
+				{
+					// Group loads a contiguous tile
+					elemIdx = uint2(tid.x + i * TILE_STRIDE.x, tid.y + i * TILE_STRIDE.y);
+				}
+				else
+				{
+					// Random texel anywhere in the working set
+					uint h = hash2(uint2(tid.x | (tid.y << 16), i));
+					elemIdx = uint2(h, h >> 16);
+				}
+
+				// Mask with runtime constant to prevent unwanted compiler optimizations
+				elemIdx = uint2((elemIdx.x & sweepConstants.addressMask.x) | sweepConstants.elementsMask,
+								(elemIdx.y & sweepConstants.addressMask.y) | sweepConstants.elementsMask);
+				value = value + swizzle<LOAD_WIDTH>(sourceData[elemIdx]);
+			}
+			return value;
+		});
+	});
+}
+
+// chaseBody.hlsli. Elements store the address of the next element: texel as x | (y << 16), byte address or index.
+// Typed R32 uint and structured uint views are read as plain uint arrays, float conversion would round large indices.
+const uint CHASE_STEPS = 1024;
+
+// Threads per row of the chase init and atomic dispatches, rows per slice of the chase init
+const uint DISPATCH_WIDTH = 1024;
+const uint DISPATCH_HEIGHT = 1024;
+
+template <typename Load>
+void chaseThread(const CpuBindings& bindings, Load load)
+{
+	const ChaseConstants& chaseConstants = constantBuffer<ChaseConstants>(bindings);
+	uint* chaseState = reinterpret_cast<uint*>(bindings.uavs[0]->data);
+
+	uint next = chaseState[0] & chaseConstants.startMask;
+	for (uint i = 0; i < CHASE_STEPS; ++i)
+	{
+		next = load(next);
+	}
+	chaseState[0] = next;
+}
+
+static void chaseBuffer(const CpuBindings& bindings, uint3)
+{
+	const uint* sourceData = reinterpret_cast<const uint*>(bindings.srvs[0]->data);
+	uint numElements = bindings.srvs[0]->numElements;
+	chaseThread(bindings, [&](uint next) { return next < numElements ? sourceData[next] : 0; });
+}
+
+static void chaseRaw(const CpuBindings& bindings, uint3)
+{
+	ByteAddressBuffer sourceData(*bindings.srvs[0]);
+	chaseThread(bindings, [&](uint next) { return sourceData.load<1>(next).x; });
+}
+
+static void chaseConstant(const CpuBindings& bindings, uint3)
+{
+	const uint4* chain = reinterpret_cast<const uint4*>(bindings.cbs[1]);
+	chaseThread(bindings, [&](uint next) { return next < 4096 ? chain[next].x : 0; });
+}
+
+static void chaseTex(const CpuBindings& bindings, uint3)
+{
+	const uint* sourceData = reinterpret_cast<const uint*>(bindings.srvs[0]->data);
+	uint2 dimensions(bindings.srvs[0]->dimensions.x, bindings.srvs[0]->dimensions.y);
+	chaseThread(bindings, [&](uint next)
+	{
+		uint2 texel(next & 0xffff, next >> 16);
+		return texel.x < dimensions.x && texel.y < dimensions.y ? sourceData[texel.y * dimensions.x + texel.x] : 0;
+	});
+}
+
+// chaseInitBody.hlsli. Element permute(j) points to permute(j + 1), a single cycle through the working set.
+// Typed, structured and texture targets are R32 uint, raw addresses are element * 4. Textures are stored row by row,
+// so the texel of an element is at the element index.
+template <bool CHASE_RAW, bool CHASE_TEX>
+void chaseInit(const CpuBindings& bindings, uint3 groupId)
+{
+	const ChaseConstants& chaseConstants = constantBuffer<ChaseConstants>(bindings);
+	uint* target = reinterpret_cast<uint*>(bindings.uavs[0]->data);
+
+	for (uint gix = 0; gix < THREAD_GROUP_SIZE; ++gix)
+	{
+		uint j = (groupId.z * DISPATCH_HEIGHT + groupId.y) * DISPATCH_WIDTH + groupId.x * THREAD_GROUP_SIZE + gix;
+		if (j > chaseConstants.addressMask)
+			return;
+
+		uint element = permute(j, chaseConstants.addressMask, chaseConstants.permuteShift);
+		uint next = permute((j + 1) & chaseConstants.addressMask, chaseConstants.addressMask, chaseConstants.permuteShift);
+
+		if (CHASE_TEX)
+		{
+			uint widthMask = (1u << chaseConstants.textureWidthLog2) - 1;
+			next = (next & widthMask) | ((next >> chaseConstants.textureWidthLog2) << 16);
+		}
+		target[element] = CHASE_RAW ? next * 4 : next;
+	}
+}
+
+enum class UavOperation
+{
+	Load,
+	Store,
+	LoadModifyStore
+};
+
+// One iteration of the UAV body loops. Stores accumulate a constant when nothing is loaded.
+template <UavOperation OP, typename Load, typename Store>
+float4 uavAccess(float4 value, Load load, Store store)
+{
+	value = value + (OP == UavOperation::Store ? float4(1.0f, 1.0f, 1.0f, 1.0f) : load());
+	if (OP != UavOperation::Load)
+		store(value);
+	return value;
+}
+
+// uavTypedBody.hlsli. Loads are single component (R32), stores write every component of the format.
+template <int LOAD_WIDTH, Address A, UavOperation OP>
+void uavTyped(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+
+	switchFormat(bindings.uavs[0]->format, [&](auto tag)
+	{
+		TypedBuffer<decltype(tag)::format> target(*bindings.uavs[0]);
+
+		runGroup(groupId, loadConstants, [&](uint gix)
+		{
+			float4 value;
+			uint htid = startIndex<A>(gix);
+
+			for (int i = 0; i < 256; ++i)
+			{
+				// Mask with runtime constant to prevent unwanted compiler optimizations
+				uint elemIdx = (htid + i) | loadConstants.elementsMask;
+				value = uavAccess<OP>(value, [&] { return swizzle<1>(target[elemIdx]); }, [&](float4 v) { target.store(elemIdx, v); });
+			}
+			return value;
+		},
+		[&](uint index, float value) { target.store(index, float4(value, value, value, value)); });
+	});
+}
+
+// uavRawBody.hlsli
+template <int LOAD_WIDTH, Address A, UavOperation OP>
+void uavRaw(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	ByteAddressBuffer target(*bindings.uavs[0]);
+
+	runGroup(groupId, loadConstants, [&](uint gix)
+	{
+		float4 value;
+		uint htid = startIndex<A>(gix) * (4 * LOAD_WIDTH) + loadConstants.readStartAddress;
+
+		for (int i = 0; i < 256; ++i)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			uint address = (htid + i * (4 * LOAD_WIDTH)) | loadConstants.elementsMask;
+			value = uavAccess<OP>(value, [&] { return swizzle<LOAD_WIDTH>(toFloat4(target.load<LOAD_WIDTH>(address))); },
+								  [&](float4 v) { target.store<LOAD_WIDTH>(address, asuint(v)); });
+		}
+		return value;
+	},
+	[&](uint index, float value) { target.store<1>(index * 4, uint4(asuint(value), 0, 0, 0)); });
+}
+
+// uavStructuredBody.hlsli
+template <int LOAD_WIDTH, Address A, UavOperation OP>
+void uavStructured(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	StructuredBuffer<LOAD_WIDTH> target(*bindings.uavs[0]);
+
+	runGroup(groupId, loadConstants, [&](uint gix)
+	{
+		float4 value;
+		uint htid = startIndex<A>(gix);
+
+		for (int i = 0; i < 256; ++i)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			uint elemIdx = (htid + i) | loadConstants.elementsMask;
+			value = uavAccess<OP>(value, [&] { return swizzle<LOAD_WIDTH>(target[elemIdx]); }, [&](float4 v) { target.store(elemIdx, v); });
+		}
+		return value;
+	},
+	[&](uint index, float value) { target.store(index, float4(value, value, value, value)); });
+}
+
+// uavTexBody.hlsli. Loads are single component (R32), stores write every component of the format.
+template <int LOAD_WIDTH, Address A, UavOperation OP>
+void uavTex(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+
+	switchFormat(bindings.uavs[0]->format, [&](auto tag)
+	{
+		Texture2D<decltype(tag)::format> target(*bindings.uavs[0]);
+
+		runTexGroup(groupId, loadConstants, [&](uint2 gid)
+		{
+			float4 value;
+			uint2 htid = texStartIndex<A>(gid);
+
+			for (uint y = 0; y < 16; ++y)
+			{
+				for (uint x = 0; x < 16; ++x)
+				{
+					// Mask with runtime constant to prevent unwanted compiler optimizations
+					uint2 elemIdx((htid.x + x) | loadConstants.elementsMask, (htid.y + y) | loadConstants.elementsMask);
+					value = uavAccess<OP>(value, [&] { return swizzle<1>(target[elemIdx]); }, [&](float4 v) { target.store(elemIdx, v); });
+				}
+			}
+			return value;
+		},
+		[&](uint2 tid, float value) { target.store(tid, float4(value, value, value, value)); });
+	});
+}
+
+// loadGroupsharedBody.hlsli. STRIDE is in dwords, zero for the broadcast and scattered patterns.
+template <int LOAD_WIDTH, Address A, uint STRIDE = 0>
+void loadGroupshared(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	const uint LDS_ELEMENTS = 4096 / LOAD_WIDTH;
+
+	// Contents come from the cbuffer, the compiler can't know them
+	uint ldsData[4096];
+	for (uint j = 0; j < LDS_ELEMENTS; ++j)
+	{
+		for (int c = 0; c < LOAD_WIDTH; ++c)
+			ldsData[j * LOAD_WIDTH + c] = j + loadConstants.readStartAddress;
+	}
+
+	// GroupMemoryBarrierWithGroupSync()
+
+	runGroup(bindings, groupId, loadConstants, [&](uint gix)
+	{
+		float4 value;
+		uint htid = A == Address::Invariant ? 0 : (A == Address::Linear ? gix * (STRIDE / LOAD_WIDTH) : hash1(gix));
+
+		for (int i = 0; i < 256; ++i)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			uint elemIdx = ((htid + i) & (LDS_ELEMENTS - 1)) | loadConstants.elementsMask;
+
+			uint v[4] = {};
+			memcpy(v, &ldsData[(elemIdx % LDS_ELEMENTS) * LOAD_WIDTH], LOAD_WIDTH * sizeof(uint));
+			value = value + swizzle<LOAD_WIDTH>(toFloat4(uint4(v[0], v[1], v[2], v[3])));
+		}
+		return value;
+	});
+}
+
+enum class AtomicOperation
+{
+	Add,
+	Min,
+	Max,
+	CompareExchange
+};
+
+// atomicBody.hlsli address of a thread
+template <Address A>
+uint atomicAddress(uint threadIndex, uint numElements)
+{
+	switch (A)
+	{
+	case Address::Invariant:
+		// All threads access the same address
+		return 0;
+	case Address::Wave:
+		// One address per wave
+		return threadIndex / 32;
+	case Address::Linear:
+		// One address per thread, neighbour threads access neighbour addresses
+		return threadIndex;
+	default:
+		// One address per thread, scattered. Odd multiplier, so the low bits are a permutation.
+		return hash1(threadIndex) & (numElements - 1);
+	}
+}
+
+// One iteration of the atomic body loops. Returns the value the next compare exchange compares against.
+// Groupshared: the threads of a group run one after another, plain read-modify-write is enough.
+// Volatile like a side effect, otherwise the compiler folds the loop of a thread into one update.
+template <AtomicOperation OP>
+uint interlocked(volatile uint& dest, uint i, uint value)
+{
+	uint original = dest;
+	switch (OP)
+	{
+	case AtomicOperation::Add: dest = original + 1; break;
+	case AtomicOperation::Min: dest = std::min(original, i); break;
+	case AtomicOperation::Max: dest = std::max(original, i); break;
+	case AtomicOperation::CompareExchange:
+		if (original == value)
+			dest = value + 1;
+		return original;
+	}
+	return value;
+}
+
+// UAV: groups running on other threads access the same addresses
+template <AtomicOperation OP>
+uint interlocked(std::atomic<uint>& dest, uint i, uint value)
+{
+	uint current = dest.load(std::memory_order_relaxed);
+	switch (OP)
+	{
+	case AtomicOperation::Add:
+		dest.fetch_add(1, std::memory_order_relaxed);
+		break;
+	case AtomicOperation::Min:
+		while (i < current && !dest.compare_exchange_weak(current, i, std::memory_order_relaxed)) {}
+		break;
+	case AtomicOperation::Max:
+		while (i > current && !dest.compare_exchange_weak(current, i, std::memory_order_relaxed)) {}
+		break;
+	case AtomicOperation::CompareExchange:
+		current = value;
+		dest.compare_exchange_strong(current, value + 1, std::memory_order_relaxed);
+		return current;
+	}
+	return value;
+}
+
+// atomicBody.hlsli, ATOMIC_GROUPSHARED
+template <AtomicOperation OP, Address A>
+void atomicGroupshared(const CpuBindings& bindings, uint3 groupId)
+{
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	volatile uint atomicLDS[THREAD_GROUP_SIZE] = {};
+
+	runGroup(bindings, groupId, loadConstants, [&](uint gix)
+	{
+		uint value = 0;
+		uint address = atomicAddress<A>(gix, THREAD_GROUP_SIZE);
+
+		for (uint i = 0; i < 256; ++i)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			uint elemIdx = (address | loadConstants.elementsMask) & (THREAD_GROUP_SIZE - 1);
+			value = interlocked<OP>(atomicLDS[elemIdx], i, value);
+		}
+		return float4(float(value), 0.0f, 0.0f, 0.0f);
+	});
+}
+
+// atomicBody.hlsli, ATOMIC_RAW and ATOMIC_TYPED. Both views are R32 uint, RWByteAddressBuffer addresses are index * 4.
+template <AtomicOperation OP, Address A>
+void atomicBuffer(const CpuBindings& bindings, uint3 groupId)
+{
+	static_assert(sizeof(std::atomic<uint>) == sizeof(uint), "UAV elements are accessed as atomics");
+
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+	std::atomic<uint>* target = reinterpret_cast<std::atomic<uint>*>(bindings.uavs[0]->data);
+	uint numElements = bindings.uavs[0]->numElements;
+
+	runGroup(groupId, loadConstants, [&](uint gix)
+	{
+		uint value = 0;
+		uint threadIndex = groupId.y * DISPATCH_WIDTH + groupId.x * THREAD_GROUP_SIZE + gix;
+		uint address = atomicAddress<A>(threadIndex, numElements);
+
+		for (uint i = 0; i < 256; ++i)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations. Out of bounds atomics are dropped.
+			uint elemIdx = address | loadConstants.elementsMask;
+			if (elemIdx < numElements)
+				value = interlocked<OP>(target[elemIdx], i, value);
+		}
+		return float4(float(value), 0.0f, 0.0f, 0.0f);
+	},
+	[&](uint index, float value)
+	{
+		if (index < numElements)
+			target[index].fetch_add(uint(value), std::memory_order_relaxed);
+	});
+}
+
+enum class AluOperation
+{
+	Fp32Fma,
+	Fp16Fma,
+	Int32Mad,
+	Transcendental
+};
+
+// One operation of the aluBody.hlsli chains. min16float runs at 32 bits, like hardware without fp16 ALUs.
+template <AluOperation OP>
+struct Alu
+{
+	using Type = float4;
+	static float4 op(float4 v, float4 a, float4 b) { return v * a + b; }
+	static float4 value(float4 v) { return v; }
+};
+
+template <>
+struct Alu<AluOperation::Int32Mad>
+{
+	using Type = uint4;
+	static uint4 op(uint4 v, uint4 a, uint4 b) { return v * a + b; }
+	static float4 value(uint4 v) { return toFloat4(v); }
+};
+
+template <>
+struct Alu<AluOperation::Transcendental>
+{
+	using Type = float4;
+	static float4 op(float4 v, float4, float4) { return float4(1.0f / sqrtf(v.x), 1.0f / sqrtf(v.y), 1.0f / sqrtf(v.z), 1.0f / sqrtf(v.w)); }
+	static float4 value(float4 v) { return v; }
+};
+
+// aluBody.hlsli
+template <AluOperation OP>
+void alu(const CpuBindings& bindings, uint3 groupId)
+{
+	using T = typename Alu<OP>::Type;
+	const LoadConstants& loadConstants = constantBuffer<LoadConstants>(bindings);
+
+	runGroup(bindings, groupId, loadConstants, [&](uint gix)
+	{
+		// Operands from the cbuffer, a = 1 and b = 0 at runtime. The compiler can't fold the chains.
+		uint one = loadConstants.elementsMask + 1, zero = loadConstants.elementsMask;
+		T a(one, one, one, one);
+		T b(zero, zero, zero, zero);
+
+		// Four independent chains
+		T v0(gix + 1, gix + 1, gix + 1, gix + 1);
+		T v1(gix + 2, gix + 2, gix + 2, gix + 2);
+		T v2(gix + 3, gix + 3, gix + 3, gix + 3);
+		T v3(gix + 4, gix + 4, gix + 4, gix + 4);
+
+		for (int i = 0; i < 256; ++i)
+		{
+			v0 = Alu<OP>::op(v0, a, b);
+			v1 = Alu<OP>::op(v1, a, b);
+			v2 = Alu<OP>::op(v2, a, b);
+			v3 = Alu<OP>::op(v3, a, b);
+		}
+		return Alu<OP>::value(v0 + v1 + v2 + v3);
+	});
+}
+
+CpuKernel findCpuKernel(const std::string& name)
+{
+	static const std::map<std::string, CpuKernel> kernels =
+	{
+		{ "loadTyped1dInvariant", loadTyped<1, Address::Invariant> },
+		{ "loadTyped1dLinear", loadTyped<1, Address::Linear> },
+		{ "loadTyped1dRandom", loadTyped<1, Address::Random> },
+		{ "loadTyped2dInvariant", loadTyped<2, Address::Invariant> },
+		{ "loadTyped2dLinear", loadTyped<2, Address::Linear> },
+		{ "loadTyped2dRandom", loadTyped<2, Address::Random> },
+		{ "loadTyped4dInvariant", loadTyped<4, Address::Invariant> },
+		{ "loadTyped4dLinear", loadTyped<4, Address::Linear> },
+		{ "loadTyped4dRandom", loadTyped<4, Address::Random> },
+
+		{ "loadRaw1dInvariant", loadRaw<1, Address::Invariant> },
+		{ "loadRaw1dLinear", loadRaw<1, Address::Linear> },
+		{ "loadRaw1dRandom", loadRaw<1, Address::Random> },
+		{ "loadRaw2dInvariant", loadRaw<2, Address::Invariant> },
+		{ "loadRaw2dLinear", loadRaw<2, Address::Linear> },
+		{ "loadRaw2dRandom", loadRaw<2, Address::Random> },
+		{ "loadRaw3dInvariant", loadRaw<3, Address::Invariant> },
+		{ "loadRaw3dLinear", loadRaw<3, Address::Linear> },
+		{ "loadRaw3dRandom", loadRaw<3, Address::Random> },
+		{ "loadRaw4dInvariant", loadRaw<4, Address::Invariant> },
+		{ "loadRaw4dLinear", loadRaw<4, Address::Linear> },
+		{ "loadRaw4dRandom", loadRaw<4, Address::Random> },
+
+		{ "loadTex1dInvariant", loadTex<1, Address::Invariant> },
+		{ "loadTex1dLinear", loadTex<1, Address::Linear> },
+		{ "loadTex1dRandom", loadTex<1, Address::Random> },
+		{ "loadTex2dInvariant", loadTex<2, Address::Invariant> },
+		{ "loadTex2dLinear", loadTex<2, Address::Linear> },
+		{ "loadTex2dRandom", loadTex<2, Address::Random> },
+		{ "loadTex4dInvariant", loadTex<4, Address::Invariant> },
+		{ "loadTex4dLinear", loadTex<4, Address::Linear> },
+		{ "loadTex4dRandom", loadTex<4, Address::Random> },
+
+		{ "loadConstant4dInvariant", loadConstant<Address::Invariant> },
+		{ "loadConstant4dLinear", loadConstant<Address::Linear> },
+		{ "loadConstant4dRandom", loadConstant<Address::Random> },
+
+		{ "loadStructured1dInvariant", loadStructured<1, Address::Invariant> },
+		{ "loadStructured1dLinear", loadStructured<1, Address::Linear> },
+		{ "loadStructured1dRandom", loadStructured<1, Address::Random> },
+		{ "loadStructured2dInvariant", loadStructured<2, Address::Invariant> },
+		{ "loadStructured2dLinear", loadStructured<2, Address::Linear> },
+		{ "loadStructured2dRandom", loadStructured<2, Address::Random> },
+		{ "loadStructured4dInvariant", loadStructured<4, Address::Invariant> },
+		{ "loadStructured4dLinear", loadStructured<4, Address::Linear> },
+		{ "loadStructured4dRandom", loadStructured<4, Address::Random> },
+
+		{ "sampleLevelTex1dLinear", sampleTex<1, Address::Linear, TextureOperation::SampleLevel, false> },
+		{ "sampleLevelTex1dRandom", sampleTex<1, Address::Random, TextureOperation::SampleLevel, false> },
+		{ "sampleLevelTex2dLinear", sampleTex<2, Address::Linear, TextureOperation::SampleLevel, false> },
+		{ "sampleLevelTex2dRandom", sampleTex<2, Address::Random, TextureOperation::SampleLevel, false> },
+		{ "sampleLevelTex4dLinear", sampleTex<4, Address::Linear, TextureOperation::SampleLevel, false> },
+		{ "sampleLevelTex4dRandom", sampleTex<4, Address::Random, TextureOperation::SampleLevel, false> },
+
+		{ "sampleGradTex1dLinear", sampleTex<1, Address::Linear, TextureOperation::SampleGrad, false> },
+		{ "sampleGradTex1dRandom", sampleTex<1, Address::Random, TextureOperation::SampleGrad, false> },
+		{ "sampleGradTex2dLinear", sampleTex<2, Address::Linear, TextureOperation::SampleGrad, false> },
+		{ "sampleGradTex2dRandom", sampleTex<2, Address::Random, TextureOperation::SampleGrad, false> },
+		{ "sampleGradTex4dLinear", sampleTex<4, Address::Linear, TextureOperation::SampleGrad, false> },
+		{ "sampleGradTex4dRandom", sampleTex<4, Address::Random, TextureOperation::SampleGrad, false> },
+
+		{ "gatherTex1dLinear", sampleTex<1, Address::Linear, TextureOperation::Gather, false> },
+		{ "gatherTex1dRandom", sampleTex<1, Address::Random, TextureOperation::Gather, false> },
+		{ "gatherTex2dLinear", sampleTex<2, Address::Linear, TextureOperation::Gather, false> },
+		{ "gatherTex2dRandom", sampleTex<2, Address::Random, TextureOperation::Gather, false> },
+		{ "gatherTex4dLinear", sampleTex<4, Address::Linear, TextureOperation::Gather, false> },
+		{ "gatherTex4dRandom", sampleTex<4, Address::Random, TextureOperation::Gather, false> },
+
+		{ "loadTex3d1dLinear", sampleTex<1, Address::Linear, TextureOperation::Load, true> },
+		{ "loadTex3d1dRandom", sampleTex<1, Address::Random, TextureOperation::Load, true> },
+		{ "loadTex3d2dLinear", sampleTex<2, Address::Linear, TextureOperation::Load, true> },
+		{ "loadTex3d2dRandom", sampleTex<2, Address::Random, TextureOperation::Load, true> },
+		{ "loadTex3d4dLinear", sampleTex<4, Address::Linear, TextureOperation::Load, true> },
+		{ "loadTex3d4dRandom", sampleTex<4, Address::Random, TextureOperation::Load, true> },
+
+		{ "sampleLevelTex3d1dLinear", sampleTex<1, Address::Linear, TextureOperation::SampleLevel, true> },
+		{ "sampleLevelTex3d1dRandom", sampleTex<1, Address::Random, TextureOperation::SampleLevel, true> },
+		{ "sampleLevelTex3d2dLinear", sampleTex<2, Address::Linear, TextureOperation::SampleLevel, true> },
+		{ "sampleLevelTex3d2dRandom", sampleTex<2, Address::Random, TextureOperation::SampleLevel, true> },
+		{ "sampleLevelTex3d4dLinear", sampleTex<4, Address::Linear, TextureOperation::SampleLevel, true> },
+		{ "sampleLevelTex3d4dRandom", sampleTex<4, Address::Random, TextureOperation::SampleLevel, true> },
+
+		{ "sampleGradTex3d1dLinear", sampleTex<1, Address::Linear, TextureOperation::SampleGrad, true> },
+		{ "sampleGradTex3d1dRandom", sampleTex<1, Address::Random, TextureOperation::SampleGrad, true> },
+		{ "sampleGradTex3d2dLinear", sampleTex<2, Address::Linear, TextureOperation::SampleGrad, true> },
+		{ "sampleGradTex3d2dRandom", sampleTex<2, Address::Random, TextureOperation::SampleGrad, true> },
+		{ "sampleGradTex3d4dLinear", sampleTex<4, Address::Linear, TextureOperation::SampleGrad, true> },
+		{ "sampleGradTex3d4dRandom", sampleTex<4, Address::Random, TextureOperation::SampleGrad, true> },
+
+		{ "shapeTyped4dLinear32x1", shapeTyped<Address::Linear, 32, 1> },
+		{ "shapeTyped4dLinear64x1", shapeTyped<Address::Linear, 64, 1> },
+		{ "shapeTyped4dLinear128x1", shapeTyped<Address::Linear, 128, 1> },
+		{ "shapeTyped4dLinear256x1", shapeTyped<Address::Linear, 256, 1> },
+		{ "shapeTyped4dLinear512x1", shapeTyped<Address::Linear, 512, 1> },
+		{ "shapeTyped4dLinear1024x1", shapeTyped<Address::Linear, 1024, 1> },
+		{ "shapeTyped4dLinear8x4", shapeTyped<Address::Linear, 8, 4> },
+		{ "shapeTyped4dLinear8x8", shapeTyped<Address::Linear, 8, 8> },
+		{ "shapeTyped4dLinear16x8", shapeTyped<Address::Linear, 16, 8> },
+		{ "shapeTyped4dLinear16x16", shapeTyped<Address::Linear, 16, 16> },
+		{ "shapeTyped4dLinear32x16", shapeTyped<Address::Linear, 32, 16> },
+		{ "shapeTyped4dLinear32x32", shapeTyped<Address::Linear, 32, 32> },
+
+		{ "shapeTyped4dRandom32x1", shapeTyped<Address::Random, 32, 1> },
+		{ "shapeTyped4dRandom64x1", shapeTyped<Address::Random, 64, 1> },
+		{ "shapeTyped4dRandom128x1", shapeTyped<Address::Random, 128, 1> },
+		{ "shapeTyped4dRandom256x1", shapeTyped<Address::Random, 256, 1> },
+		{ "shapeTyped4dRandom512x1", shapeTyped<Address::Random, 512, 1> },
+		{ "shapeTyped4dRandom1024x1", shapeTyped<Address::Random, 1024, 1> },
+		{ "shapeTyped4dRandom8x4", shapeTyped<Address::Random, 8, 4> },
+		{ "shapeTyped4dRandom8x8", shapeTyped<Address::Random, 8, 8> },
+		{ "shapeTyped4dRandom16x8", shapeTyped<Address::Random, 16, 8> },
+		{ "shapeTyped4dRandom16x16", shapeTyped<Address::Random, 16, 16> },
+		{ "shapeTyped4dRandom32x16", shapeTyped<Address::Random, 32, 16> },
+		{ "shapeTyped4dRandom32x32", shapeTyped<Address::Random, 32, 32> },
+
+		{ "shapeRaw4dLinear32x1", shapeRaw<Address::Linear, 32, 1> },
+		{ "shapeRaw4dLinear64x1", shapeRaw<Address::Linear, 64, 1> },
+		{ "shapeRaw4dLinear128x1", shapeRaw<Address::Linear, 128, 1> },
+		{ "shapeRaw4dLinear256x1", shapeRaw<Address::Linear, 256, 1> },
+		{ "shapeRaw4dLinear512x1", shapeRaw<Address::Linear, 512, 1> },
+		{ "shapeRaw4dLinear1024x1", shapeRaw<Address::Linear, 1024, 1> },
+		{ "shapeRaw4dLinear8x4", shapeRaw<Address::Linear, 8, 4> },
+		{ "shapeRaw4dLinear8x8", shapeRaw<Address::Linear, 8, 8> },
+		{ "shapeRaw4dLinear16x8", shapeRaw<Address::Linear, 16, 8> },
+		{ "shapeRaw4dLinear16x16", shapeRaw<Address::Linear, 16, 16> },
+		{ "shapeRaw4dLinear32x16", shapeRaw<Address::Linear, 32, 16> },
+		{ "shapeRaw4dLinear32x32", shapeRaw<Address::Linear, 32, 32> },
+
+		{ "shapeRaw4dRandom32x1", shapeRaw<Address::Random, 32, 1> },
+		{ "shapeRaw4dRandom64x1", shapeRaw<Address::Random, 64, 1> },
+		{ "shapeRaw4dRandom128x1", shapeRaw<Address::Random, 128, 1> },
+		{ "shapeRaw4dRandom256x1", shapeRaw<Address::Random, 256, 1> },
+		{ "shapeRaw4dRandom512x1", shapeRaw<Address::Random, 512, 1> },
+		{ "shapeRaw4dRandom1024x1", shapeRaw<Address::Random, 1024, 1> },
+		{ "shapeRaw4dRandom8x4", shapeRaw<Address::Random, 8, 4> },
+		{ "shapeRaw4dRandom8x8", shapeRaw<Address::Random, 8, 8> },
+		{ "shapeRaw4dRandom16x8", shapeRaw<Address::Random, 16, 8> },
+		{ "shapeRaw4dRandom16x16", shapeRaw<Address::Random, 16, 16> },
+		{ "shapeRaw4dRandom32x16", shapeRaw<Address::Random, 32, 16> },
+		{ "shapeRaw4dRandom32x32", shapeRaw<Address::Random, 32, 32> },
+
+		{ "shapeStructured4dLinear32x1", shapeStructured<Address::Linear, 32, 1> },
+		{ "shapeStructured4dLinear64x1", shapeStructured<Address::Linear, 64, 1> },
+		{ "shapeStructured4dLinear128x1", shapeStructured<Address::Linear, 128, 1> },
+		{ "shapeStructured4dLinear256x1", shapeStructured<Address::Linear, 256, 1> },
+		{ "shapeStructured4dLinear512x1", shapeStructured<Address::Linear, 512, 1> },
+		{ "shapeStructured4dLinear1024x1", shapeStructured<Address::Linear, 1024, 1> },
+		{ "shapeStructured4dLinear8x4", shapeStructured<Address::Linear, 8, 4> },
+		{ "shapeStructured4dLinear8x8", shapeStructured<Address::Linear, 8, 8> },
+		{ "shapeStructured4dLinear16x8", shapeStructured<Address::Linear, 16, 8> },
+		{ "shapeStructured4dLinear16x16", shapeStructured<Address::Linear, 16, 16> },
+		{ "shapeStructured4dLinear32x16", shapeStructured<Address::Linear, 32, 16> },
+		{ "shapeStructured4dLinear32x32", shapeStructured<Address::Linear, 32, 32> },
+
+		{ "shapeStructured4dRandom32x1", shapeStructured<Address::Random, 32, 1> },
+		{ "shapeStructured4dRandom64x1", shapeStructured<Address::Random, 64, 1> },
+		{ "shapeStructured4dRandom128x1", shapeStructured<Address::Random, 128, 1> },
+		{ "shapeStructured4dRandom256x1", shapeStructured<Address::Random, 256, 1> },
+		{ "shapeStructured4dRandom512x1", shapeStructured<Address::Random, 512, 1> },
+		{ "shapeStructured4dRandom1024x1", shapeStructured<Address::Random, 1024, 1> },
+		{ "shapeStructured4dRandom8x4", shapeStructured<Address::Random, 8, 4> },
+		{ "shapeStructured4dRandom8x8", shapeStructured<Address::Random, 8, 8> },
+		{ "shapeStructured4dRandom16x8", shapeStructured<Address::Random, 16, 8> },
+		{ "shapeStructured4dRandom16x16", shapeStructured<Address::Random, 16, 16> },
+		{ "shapeStructured4dRandom32x16", shapeStructured<Address::Random, 32, 16> },
+		{ "shapeStructured4dRandom32x32", shapeStructured<Address::Random, 32, 32> },
+
+		{ "shapeTex4dLinear32x1", shapeTex<Address::Linear, 32, 1> },
+		{ "shapeTex4dLinear64x1", shapeTex<Address::Linear, 64, 1> },
+		{ "shapeTex4dLinear128x1", shapeTex<Address::Linear, 128, 1> },
+		{ "shapeTex4dLinear256x1", shapeTex<Address::Linear, 256, 1> },
+		{ "shapeTex4dLinear512x1", shapeTex<Address::Linear, 512, 1> },
+		{ "shapeTex4dLinear1024x1", shapeTex<Address::Linear, 1024, 1> },
+		{ "shapeTex4dLinear8x4", shapeTex<Address::Linear, 8, 4> },
+		{ "shapeTex4dLinear8x8", shapeTex<Address::Linear, 8, 8> },
+		{ "shapeTex4dLinear16x8", shapeTex<Address::Linear, 16, 8> },
+		{ "shapeTex4dLinear16x16", shapeTex<Address::Linear, 16, 16> },
+		{ "shapeTex4dLinear32x16", shapeTex<Address::Linear, 32, 16> },
+		{ "shapeTex4dLinear32x32", shapeTex<Address::Linear, 32, 32> },
+
+		{ "shapeTex4dRandom32x1", shapeTex<Address::Random, 32, 1> },
+		{ "shapeTex4dRandom64x1", shapeTex<Address::Random, 64, 1> },
+		{ "shapeTex4dRandom128x1", shapeTex<Address::Random, 128, 1> },
+		{ "shapeTex4dRandom256x1", shapeTex<Address::Random, 256, 1> },
+		{ "shapeTex4dRandom512x1", shapeTex<Address::Random, 512, 1> },
+		{ "shapeTex4dRandom1024x1", shapeTex<Address::Random, 1024, 1> },
+		{ "shapeTex4dRandom8x4", shapeTex<Address::Random, 8, 4> },
+		{ "shapeTex4dRandom8x8", shapeTex<Address::Random, 8, 8> },
+		{ "shapeTex4dRandom16x8", shapeTex<Address::Random, 16, 8> },
+		{ "shapeTex4dRandom16x16", shapeTex<Address::Random, 16, 16> },
+		{ "shapeTex4dRandom32x16", shapeTex<Address::Random, 32, 16> },
+		{ "shapeTex4dRandom32x32", shapeTex<Address::Random, 32, 32> },
+
+		{ "waveLaneFirstTyped1dInvariant", waveTyped<1, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstTyped2dInvariant", waveTyped<2, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstTyped4dInvariant", waveTyped<4, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstRaw1dInvariant", waveRaw<1, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstRaw2dInvariant", waveRaw<2, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstRaw3dInvariant", waveRaw<3, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstRaw4dInvariant", waveRaw<4, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstStructured1dInvariant", waveStructured<1, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstStructured2dInvariant", waveStructured<2, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstStructured4dInvariant", waveStructured<4, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstConstant4dInvariant", waveConstant<WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstTex1dInvariant", waveTex<1, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstTex2dInvariant", waveTex<2, WaveOperation::ReadLaneFirst> },
+		{ "waveLaneFirstTex4dInvariant", waveTex<4, WaveOperation::ReadLaneFirst> },
+
+		{ "waveLaneAtTyped1dInvariant", waveTyped<1, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtTyped2dInvariant", waveTyped<2, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtTyped4dInvariant", waveTyped<4, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtRaw1dInvariant", waveRaw<1, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtRaw2dInvariant", waveRaw<2, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtRaw3dInvariant", waveRaw<3, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtRaw4dInvariant", waveRaw<4, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtStructured1dInvariant", waveStructured<1, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtStructured2dInvariant", waveStructured<2, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtStructured4dInvariant", waveStructured<4, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtConstant4dInvariant", waveConstant<WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtTex1dInvariant", waveTex<1, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtTex2dInvariant", waveTex<2, WaveOperation::ReadLaneAt> },
+		{ "waveLaneAtTex4dInvariant", waveTex<4, WaveOperation::ReadLaneAt> },
+
+		{ "waveFirstLaneLoadTyped1dInvariant", waveTyped<1, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadTyped2dInvariant", waveTyped<2, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadTyped4dInvariant", waveTyped<4, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadRaw1dInvariant", waveRaw<1, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadRaw2dInvariant", waveRaw<2, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadRaw3dInvariant", waveRaw<3, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadRaw4dInvariant", waveRaw<4, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadStructured1dInvariant", waveStructured<1, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadStructured2dInvariant", waveStructured<2, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadStructured4dInvariant", waveStructured<4, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadConstant4dInvariant", waveConstant<WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadTex1dInvariant", waveTex<1, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadTex2dInvariant", waveTex<2, WaveOperation::FirstLaneLoad> },
+		{ "waveFirstLaneLoadTex4dInvariant", waveTex<4, WaveOperation::FirstLaneLoad> },
+
+		{ "sweepTyped1dLinear", sweepTyped<1, Address::Linear> },
+		{ "sweepTyped1dRandom", sweepTyped<1, Address::Random> },
+		{ "sweepTyped2dLinear", sweepTyped<2, Address::Linear> },
+		{ "sweepTyped2dRandom", sweepTyped<2, Address::Random> },
+		{ "sweepTyped4dLinear", sweepTyped<4, Address::Linear> },
+		{ "sweepTyped4dRandom", sweepTyped<4, Address::Random> },
+
+		{ "sweepRaw1dLinear", sweepRaw<1, Address::Linear> },
+		{ "sweepRaw1dRandom", sweepRaw<1, Address::Random> },
+		{ "sweepRaw2dLinear", sweepRaw<2, Address::Linear> },
+		{ "sweepRaw2dRandom", sweepRaw<2, Address::Random> },
+		{ "sweepRaw4dLinear", sweepRaw<4, Address::Linear> },
+		{ "sweepRaw4dRandom", sweepRaw<4, Address::Random> },
+
+		{ "sweepStructured1dLinear", sweepStructured<1, Address::Linear> },
+		{ "sweepStructured1dRandom", sweepStructured<1, Address::Random> },
+		{ "sweepStructured2dLinear", sweepStructured<2, Address::Linear> },
+		{ "sweepStructured2dRandom", sweepStructured<2, Address::Random> },
+		{ "sweepStructured4dLinear", sweepStructured<4, Address::Linear> },
+		{ "sweepStructured4dRandom", sweepStructured<4, Address::Random> },
+
+		{ "sweepTex1dLinear", sweepTex<1, Address::Linear> },
+		{ "sweepTex1dRandom", sweepTex<1, Address::Random> },
+		{ "sweepTex2dLinear", sweepTex<2, Address::Linear> },
+		{ "sweepTex2dRandom", sweepTex<2, Address::Random> },
+		{ "sweepTex4dLinear", sweepTex<4, Address::Linear> },
+		{ "sweepTex4dRandom", sweepTex<4, Address::Random> },
+
+		{ "chaseTyped", chaseBuffer },
+		{ "chaseRaw", chaseRaw },
+		{ "chaseStructured", chaseBuffer },
+		{ "chaseConstant", chaseConstant },
+		{ "chaseTex", chaseTex },
+		{ "chaseInitTyped", chaseInit<false, false> },
+		{ "chaseInitRaw", chaseInit<true, false> },
+		{ "chaseInitStructured", chaseInit<false, false> },
+		{ "chaseInitTex", chaseInit<false, true> },
+
+		{ "uavLoadTyped1dInvariant", uavTyped<1, Address::Invariant, UavOperation::Load> },
+		{ "uavLoadTyped1dLinear", uavTyped<1, Address::Linear, UavOperation::Load> },
+		{ "uavLoadTyped1dRandom", uavTyped<1, Address::Random, UavOperation::Load> },
+
+		{ "uavStoreTyped1dInvariant", uavTyped<1, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreTyped1dLinear", uavTyped<1, Address::Linear, UavOperation::Store> },
+		{ "uavStoreTyped1dRandom", uavTyped<1, Address::Random, UavOperation::Store> },
+		{ "uavStoreTyped2dInvariant", uavTyped<2, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreTyped2dLinear", uavTyped<2, Address::Linear, UavOperation::Store> },
+		{ "uavStoreTyped2dRandom", uavTyped<2, Address::Random, UavOperation::Store> },
+		{ "uavStoreTyped4dInvariant", uavTyped<4, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreTyped4dLinear", uavTyped<4, Address::Linear, UavOperation::Store> },
+		{ "uavStoreTyped4dRandom", uavTyped<4, Address::Random, UavOperation::Store> },
+
+		{ "uavRmwTyped1dInvariant", uavTyped<1, Address::Invariant, UavOperation::LoadModifyStore> },
+		{ "uavRmwTyped1dLinear", uavTyped<1, Address::Linear, UavOperation::LoadModifyStore> },
+		{ "uavRmwTyped1dRandom", uavTyped<1, Address::Random, UavOperation::LoadModifyStore> },
+
+		{ "uavLoadRaw1dInvariant", uavRaw<1, Address::Invariant, UavOperation::Load> },
+		{ "uavLoadRaw1dLinear", uavRaw<1, Address::Linear, UavOperation::Load> },
+		{ "uavLoadRaw1dRandom", uavRaw<1, Address::Random, UavOperation::Load> },
+		{ "uavLoadRaw2dInvariant", uavRaw<2, Address::Invariant, UavOperation::Load> },
+		{ "uavLoadRaw2dLinear", uavRaw<2, Address::Linear, UavOperation::Load> },
+		{ "uavLoadRaw2dRandom", uavRaw<2, Address::Random, UavOperation::Load> },
+		{ "uavLoadRaw3dInvariant", uavRaw<3, Address::Invariant, UavOperation::Load> },
+		{ "uavLoadRaw3dLinear", uavRaw<3, Address::Linear, UavOperation::Load> },
+		{ "uavLoadRaw3dRandom", uavRaw<3, Address::Random, UavOperation::Load> },
+		{ "uavLoadRaw4dInvariant", uavRaw<4, Address::Invariant, UavOperation::Load> },
+		{ "uavLoadRaw4dLinear", uavRaw<4, Address::Linear, UavOperation::Load> },
+		{ "uavLoadRaw4dRandom", uavRaw<4, Address::Random, UavOperation::Load> },
+
+		{ "uavStoreRaw1dInvariant", uavRaw<1, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreRaw1dLinear", uavRaw<1, Address::Linear, UavOperation::Store> },
+		{ "uavStoreRaw1dRandom", uavRaw<1, Address::Random, UavOperation::Store> },
+		{ "uavStoreRaw2dInvariant", uavRaw<2, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreRaw2dLinear", uavRaw<2, Address::Linear, UavOperation::Store> },
+		{ "uavStoreRaw2dRandom", uavRaw<2, Address::Random, UavOperation::Store> },
+		{ "uavStoreRaw3dInvariant", uavRaw<3, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreRaw3dLinear", uavRaw<3, Address::Linear, UavOperation::Store> },
+		{ "uavStoreRaw3dRandom", uavRaw<3, Address::Random, UavOperation::Store> },
+		{ "uavStoreRaw4dInvariant", uavRaw<4, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreRaw4dLinear", uavRaw<4, Address::Linear, UavOperation::Store> },
+		{ "uavStoreRaw4dRandom", uavRaw<4, Address::Random, UavOperation::Store> },
+
+		{ "uavRmwRaw1dInvariant", uavRaw<1, Address::Invariant, UavOperation::LoadModifyStore> },
+		{ "uavRmwRaw1dLinear", uavRaw<1, Address::Linear, UavOperation::LoadModifyStore> },
+		{ "uavRmwRaw1dRandom", uavRaw<1, Address::Random, UavOperation::LoadModifyStore> },
+		{ "uavRmwRaw2dInvariant", uavRaw<2, Address::Invariant, UavOperation::LoadModifyStore> },
+		{ "uavRmwRaw2dLinear", uavRaw<2, Address::Linear, UavOperation::LoadModifyStore> },
+		{ "uavRmwRaw2dRandom", uavRaw<2, Address::Random, UavOperation::LoadModifyStore> },
+		{ "uavRmwRaw3dInvariant", uavRaw<3, Address::Invariant, UavOperation::LoadModifyStore> },
+		{ "uavRmwRaw3dLinear", uavRaw<3, Address::Linear, UavOperation::LoadModifyStore> },
+		{ "uavRmwRaw3dRandom", uavRaw<3, Address::Random, UavOperation::LoadModifyStore> },
+		{ "uavRmwRaw4dInvariant", uavRaw<4, Address::Invariant, UavOperation::LoadModifyStore> },
+		{ "uavRmwRaw4dLinear", uavRaw<4, Address::Linear, UavOperation::LoadModifyStore> },
+		{ "uavRmwRaw4dRandom", uavRaw<4, Address::Random, UavOperation::LoadModifyStore> },
+
+		{ "uavLoadStructured1dInvariant", uavStructured<1, Address::Invariant, UavOperation::Load> },
+		{ "uavLoadStructured1dLinear", uavStructured<1, Address::Linear, UavOperation::Load> },
+		{ "uavLoadStructured1dRandom", uavStructured<1, Address::Random, UavOperation::Load> },
+		{ "uavLoadStructured2dInvariant", uavStructured<2, Address::Invariant, UavOperation::Load> },
+		{ "uavLoadStructured2dLinear", uavStructured<2, Address::Linear, UavOperation::Load> },
+		{ "uavLoadStructured2dRandom", uavStructured<2, Address::Random, UavOperation::Load> },
+		{ "uavLoadStructured4dInvariant", uavStructured<4, Address::Invariant, UavOperation::Load> },
+		{ "uavLoadStructured4dLinear", uavStructured<4, Address::Linear, UavOperation::Load> },
+		{ "uavLoadStructured4dRandom", uavStructured<4, Address::Random, UavOperation::Load> },
+
+		{ "uavStoreStructured1dInvariant", uavStructured<1, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreStructured1dLinear", uavStructured<1, Address::Linear, UavOperation::Store> },
+		{ "uavStoreStructured1dRandom", uavStructured<1, Address::Random, UavOperation::Store> },
+		{ "uavStoreStructured2dInvariant", uavStructured<2, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreStructured2dLinear", uavStructured<2, Address::Linear, UavOperation::Store> },
+		{ "uavStoreStructured2dRandom", uavStructured<2, Address::Random, UavOperation::Store> },
+		{ "uavStoreStructured4dInvariant", uavStructured<4, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreStructured4dLinear", uavStructured<4, Address::Linear, UavOperation::Store> },
+		{ "uavStoreStructured4dRandom", uavStructured<4, Address::Random, UavOperation::Store> },
+
+		{ "uavRmwStructured1dInvariant", uavStructured<1, Address::Invariant, UavOperation::LoadModifyStore> },
+		{ "uavRmwStructured1dLinear", uavStructured<1, Address::Linear, UavOperation::LoadModifyStore> },
+		{ "uavRmwStructured1dRandom", uavStructured<1, Address::Random, UavOperation::LoadModifyStore> },
+		{ "uavRmwStructured2dInvariant", uavStructured<2, Address::Invariant, UavOperation::LoadModifyStore> },
+		{ "uavRmwStructured2dLinear", uavStructured<2, Address::Linear, UavOperation::LoadModifyStore> },
+		{ "uavRmwStructured2dRandom", uavStructured<2, Address::Random, UavOperation::LoadModifyStore> },
+		{ "uavRmwStructured4dInvariant", uavStructured<4, Address::Invariant, UavOperation::LoadModifyStore> },
+		{ "uavRmwStructured4dLinear", uavStructured<4, Address::Linear, UavOperation::LoadModifyStore> },
+		{ "uavRmwStructured4dRandom", uavStructured<4, Address::Random, UavOperation::LoadModifyStore> },
+
+		{ "uavLoadTex1dInvariant", uavTex<1, Address::Invariant, UavOperation::Load> },
+		{ "uavLoadTex1dLinear", uavTex<1, Address::Linear, UavOperation::Load> },
+		{ "uavLoadTex1dRandom", uavTex<1, Address::Random, UavOperation::Load> },
+
+		{ "uavStoreTex1dInvariant", uavTex<1, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreTex1dLinear", uavTex<1, Address::Linear, UavOperation::Store> },
+		{ "uavStoreTex1dRandom", uavTex<1, Address::Random, UavOperation::Store> },
+		{ "uavStoreTex2dInvariant", uavTex<2, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreTex2dLinear", uavTex<2, Address::Linear, UavOperation::Store> },
+		{ "uavStoreTex2dRandom", uavTex<2, Address::Random, UavOperation::Store> },
+		{ "uavStoreTex4dInvariant", uavTex<4, Address::Invariant, UavOperation::Store> },
+		{ "uavStoreTex4dLinear", uavTex<4, Address::Linear, UavOperation::Store> },
+		{ "uavStoreTex4dRandom", uavTex<4, Address::Random, UavOperation::Store> },
+
+		{ "uavRmwTex1dInvariant", uavTex<1, Address::Invariant, UavOperation::LoadModifyStore> },
+		{ "uavRmwTex1dLinear", uavTex<1, Address::Linear, UavOperation::LoadModifyStore> },
+		{ "uavRmwTex1dRandom", uavTex<1, Address::Random, UavOperation::LoadModifyStore> },
+
+		{ "loadGroupshared1dStride1", loadGroupshared<1, Address::Linear, 1> },
+		{ "loadGroupshared1dStride2", loadGroupshared<1, Address::Linear, 2> },
+		{ "loadGroupshared1dStride4", loadGroupshared<1, Address::Linear, 4> },
+		{ "loadGroupshared1dStride8", loadGroupshared<1, Address::Linear, 8> },
+		{ "loadGroupshared1dStride16", loadGroupshared<1, Address::Linear, 16> },
+		{ "loadGroupshared1dStride32", loadGroupshared<1, Address::Linear, 32> },
+		{ "loadGroupshared1dInvariant", loadGroupshared<1, Address::Invariant> },
+		{ "loadGroupshared1dRandom", loadGroupshared<1, Address::Random> },
+
+		{ "loadGroupshared2dStride2", loadGroupshared<2, Address::Linear, 2> },
+		{ "loadGroupshared2dStride4", loadGroupshared<2, Address::Linear, 4> },
+		{ "loadGroupshared2dStride8", loadGroupshared<2, Address::Linear, 8> },
+		{ "loadGroupshared2dStride16", loadGroupshared<2, Address::Linear, 16> },
+		{ "loadGroupshared2dStride32", loadGroupshared<2, Address::Linear, 32> },
+		{ "loadGroupshared2dInvariant", loadGroupshared<2, Address::Invariant> },
+		{ "loadGroupshared2dRandom", loadGroupshared<2, Address::Random> },
+
+		{ "loadGroupshared4dStride4", loadGroupshared<4, Address::Linear, 4> },
+		{ "loadGroupshared4dStride8", loadGroupshared<4, Address::Linear, 8> },
+		{ "loadGroupshared4dStride16", loadGroupshared<4, Address::Linear, 16> },
+		{ "loadGroupshared4dStride32", loadGroupshared<4, Address::Linear, 32> },
+		{ "loadGroupshared4dInvariant", loadGroupshared<4, Address::Invariant> },
+		{ "loadGroupshared4dRandom", loadGroupshared<4, Address::Random> },
+
+		{ "atomicAddGroupshared1dInvariant", atomicGroupshared<AtomicOperation::Add, Address::Invariant> },
+		{ "atomicAddGroupshared1dWave", atomicGroupshared<AtomicOperation::Add, Address::Wave> },
+		{ "atomicAddGroupshared1dLinear", atomicGroupshared<AtomicOperation::Add, Address::Linear> },
+		{ "atomicAddGroupshared1dRandom", atomicGroupshared<AtomicOperation::Add, Address::Random> },
+
+		{ "atomicAddRaw1dInvariant", atomicBuffer<AtomicOperation::Add, Address::Invariant> },
+		{ "atomicAddRaw1dWave", atomicBuffer<AtomicOperation::Add, Address::Wave> },
+		{ "atomicAddRaw1dLinear", atomicBuffer<AtomicOperation::Add, Address::Linear> },
+		{ "atomicAddRaw1dRandom", atomicBuffer<AtomicOperation::Add, Address::Random> },
+
+		{ "atomicAddTyped1dInvariant", atomicBuffer<AtomicOperation::Add, Address::Invariant> },
+		{ "atomicAddTyped1dWave", atomicBuffer<AtomicOperation::Add, Address::Wave> },
+		{ "atomicAddTyped1dLinear", atomicBuffer<AtomicOperation::Add, Address::Linear> },
+		{ "atomicAddTyped1dRandom", atomicBuffer<AtomicOperation::Add, Address::Random> },
+
+		{ "atomicMinGroupshared1dInvariant", atomicGroupshared<AtomicOperation::Min, Address::Invariant> },
+		{ "atomicMinGroupshared1dWave", atomicGroupshared<AtomicOperation::Min, Address::Wave> },
+		{ "atomicMinGroupshared1dLinear", atomicGroupshared<AtomicOperation::Min, Address::Linear> },
+		{ "atomicMinGroupshared1dRandom", atomicGroupshared<AtomicOperation::Min, Address::Random> },
+
+		{ "atomicMinRaw1dInvariant", atomicBuffer<AtomicOperation::Min, Address::Invariant> },
+		{ "atomicMinRaw1dWave", atomicBuffer<AtomicOperation::Min, Address::Wave> },
+		{ "atomicMinRaw1dLinear", atomicBuffer<AtomicOperation::Min, Address::Linear> },
+		{ "atomicMinRaw1dRandom", atomicBuffer<AtomicOperation::Min, Address::Random> },
+
+		{ "atomicMinTyped1dInvariant", atomicBuffer<AtomicOperation::Min, Address::Invariant> },
+		{ "atomicMinTyped1dWave", atomicBuffer<AtomicOperation::Min, Address::Wave> },
+		{ "atomicMinTyped1dLinear", atomicBuffer<AtomicOperation::Min, Address::Linear> },
+		{ "atomicMinTyped1dRandom", atomicBuffer<AtomicOperation::Min, Address::Random> },
+
+		{ "atomicMaxGroupshared1dInvariant", atomicGroupshared<AtomicOperation::Max, Address::Invariant> },
+		{ "atomicMaxGroupshared1dWave", atomicGroupshared<AtomicOperation::Max, Address::Wave> },
+		{ "atomicMaxGroupshared1dLinear", atomicGroupshared<AtomicOperation::Max, Address::Linear> },
+		{ "atomicMaxGroupshared1dRandom", atomicGroupshared<AtomicOperation::Max, Address::Random> },
+
+		{ "atomicMaxRaw1dInvariant", atomicBuffer<AtomicOperation::Max, Address::Invariant> },
+		{ "atomicMaxRaw1dWave", atomicBuffer<AtomicOperation::Max, Address::Wave> },
+		{ "atomicMaxRaw1dLinear", atomicBuffer<AtomicOperation::Max, Address::Linear> },
+		{ "atomicMaxRaw1dRandom", atomicBuffer<AtomicOperation::Max, Address::Random> },
+
+		{ "atomicMaxTyped1dInvariant", atomicBuffer<AtomicOperation::Max, Address::Invariant> },
+		{ "atomicMaxTyped1dWave", atomicBuffer<AtomicOperation::Max, Address::Wave> },
+		{ "atomicMaxTyped1dLinear", atomicBuffer<AtomicOperation::Max, Address::Linear> },
+		{ "atomicMaxTyped1dRandom", atomicBuffer<AtomicOperation::Max, Address::Random> },
+
+		{ "atomicCmpXchgGroupshared1dInvariant", atomicGroupshared<AtomicOperation::CompareExchange, Address::Invariant> },
+		{ "atomicCmpXchgGroupshared1dWave", atomicGroupshared<AtomicOperation::CompareExchange, Address::Wave> },
+		{ "atomicCmpXchgGroupshared1dLinear", atomicGroupshared<AtomicOperation::CompareExchange, Address::Linear> },
+		{ "atomicCmpXchgGroupshared1dRandom", atomicGroupshared<AtomicOperation::CompareExchange, Address::Random> },
+
+		{ "atomicCmpXchgRaw1dInvariant", atomicBuffer<AtomicOperation::CompareExchange, Address::Invariant> },
+		{ "atomicCmpXchgRaw1dWave", atomicBuffer<AtomicOperation::CompareExchange, Address::Wave> },
+		{ "atomicCmpXchgRaw1dLinear", atomicBuffer<AtomicOperation::CompareExchange, Address::Linear> },
+		{ "atomicCmpXchgRaw1dRandom", atomicBuffer<AtomicOperation::CompareExchange, Address::Random> },
+
+		{ "atomicCmpXchgTyped1dInvariant", atomicBuffer<AtomicOperation::CompareExchange, Address::Invariant> },
+		{ "atomicCmpXchgTyped1dWave", atomicBuffer<AtomicOperation::CompareExchange, Address::Wave> },
+		{ "atomicCmpXchgTyped1dLinear", atomicBuffer<AtomicOperation::CompareExchange, Address::Linear> },
+		{ "atomicCmpXchgTyped1dRandom", atomicBuffer<AtomicOperation::CompareExchange, Address::Random> },
+
+		{ "aluFp32Fma", alu<AluOperation::Fp32Fma> },
+		{ "aluFp16Fma", alu<AluOperation::Fp16Fma> },
+		{ "aluInt32Mad", alu<AluOperation::Int32Mad> },
+		{ "aluRsqrt", alu<AluOperation::Transcendental> },
+	};
+
+	auto it = kernels.find(name);
+	return it != kernels.end() ? it->second : nullptr;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "device.h"
+#include <array>
+#include <string>
+
+// Buffer or texture view as seen by a CPU kernel
+struct CpuView
+{
+	enum class Type
+	{
+		Typed,
+		Raw,
+		Structured,
+		Texture
+	};
+
+	Type type = Type::Typed;
+	uint8_t* data = nullptr;
+	size_t bytes = 0;
+	Format format = Format::R32_FLOAT;
+	unsigned numElements = 0;
+	unsigned stride = 0;
+	uint3 dimensions;		// Textures only. Mip 0 size.
+	unsigned mips = 1;		// Textures only. Stored one after another, mip 0 first.
+};
+
+// Resources bound to a CPU dispatch. Same slots as the HLSL registers.
+struct CpuBindings
+{
+	std::array<const uint8_t*, 4> cbs = {};
+	std::array<const CpuView*, 4> srvs = {};
+	std::array<const CpuView*, 4> uavs = {};
+	std::array<Device::SamplerType, 4> samplers = {};
+};
+
+// Executes one thread group. The thread loop is split at each group barrier, so all threads of
+// the group have finished the previous phase before any thread starts the next one.
+typedef void (*CpuKernel)(const CpuBindings& bindings, uint3 groupId);
+
+// C++ ports of the shaders, looked up with the same name as the shader file
+CpuKernel findCpuKernel(const std::string& name);
@@ -0,0 +1,156 @@
+#include "device.h"
+#include "file.h"
+#include "cpu.h"
+#ifdef _WIN32
+#include "directx.h"
+#include "window.h"
+#endif
+#ifdef PERFTEST_VULKAN
+#include "vulkan.h"
+#endif
+#include "json.h"
+#include <map>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+unsigned formatBytes(Format format)
+{
+	switch (format)
+	{
+	case Format::R8_UNORM: return 1;
+	case Format::R8G8_UNORM: return 2;
+	case Format::R8G8B8A8_UNORM: return 4;
+	case Format::R16_FLOAT: return 2;
+	case Format::R16G16_FLOAT: return 4;
+	case Format::R16G16B16A16_FLOAT: return 8;
+	case Format::R32_FLOAT: return 4;
+	case Format::R32G32_FLOAT: return 8;
+	case Format::R32G32B32A32_FLOAT: return 16;
+	case Format::R32_UINT: return 4;
+	}
+
+	assert(false);
+	return 0;
+}
+
+// shaders/manifest.json is written by shaderGen. It maps shader files to blobs in the compiled shader cache.
+static const std::map<std::string, std::string>& shaderManifest()
+{
+	static const std::map<std::string, std::string> manifest = []
+	{
+		std::map<std::string, std::string> out;
+		std::vector<unsigned char> text;
+		JsonValue root;
+		if (!readFile("shaders/manifest.json", text) || !parseJson(std::string(text.begin(), text.end()), root))
+			return out;
+
+		const JsonValue* shaders = root.find("shaders");
+		if (shaders && shaders->type == JsonValue::Type::Object)
+		{
+			for (size_t i = 0; i < shaders->keys.size(); ++i)
+				out[shaders->keys[i]] = shaders->elements[i].string;
+		}
+		return out;
+	}();
+	return manifest;
+}
+
+// Shaders missing from the manifest (Visual Studio build) are loaded from shaders/
+static std::string shaderPath(const std::string& file)
+{
+	auto it = shaderManifest().find(file);
+	return it != shaderManifest().end() ? it->second : "shaders/" + file;
+}
+
+ComputeShader* Device::loadComputeShader(const std::string& name)
+{
+	// Mapped, the driver reads the bytecode straight from the page cache
+	std::string path = shaderPath(name + shaderFileExtension());
+	MappedFile blob(path);
+	if (!blob.valid() || blob.size() == 0)
+		failShaderLoad(name, (path + (blob.valid() ? " is empty" : " is missing, not in the manifest or not built")).c_str());
+	return createComputeShader(blob.data(), blob.size());
+}
+
+void Device::failShaderLoad(const std::string& name, const char* reason)
+{
+	printf("Can't load shader %s: %s\n", name.c_str(), reason);
+	fflush(stdout);
+	_Exit(1);
+}
+
+bool Device::readShaderBinary(const std::string& name, std::vector<unsigned char>& bytes)
+{
+	if (*shaderFileExtension() == '\0')
+		return false;
+	return readFile(shaderPath(name + shaderFileExtension()), bytes);
+}
+
+const char* backendName(Backend backend)
+{
+	switch (backend)
+	{
+	case Backend::DirectX11: return "DirectX 11";
+	case Backend::Vulkan: return "Vulkan";
+	case Backend::Cpu: return "CPU";
+	}
+
+	return "Unknown";
+}
+
+bool isBackendAvailable(Backend backend)
+{
+	switch (backend)
+	{
+	case Backend::Cpu: return true;
+#ifdef _WIN32
+	case Backend::DirectX11: return true;
+#endif
+#ifdef PERFTEST_VULKAN
+	case Backend::Vulkan: return true;
+#endif
+	default: return false;
+	}
+}
+
+std::vector<std::string> enumerateAdapters(Backend backend)
+{
+	switch (backend)
+	{
+	case Backend::Cpu: return enumerateCpuAdapters();
+#ifdef _WIN32
+	case Backend::DirectX11: return enumerateDirectXAdapters();
+#endif
+#ifdef PERFTEST_VULKAN
+	case Backend::Vulkan: return enumerateVulkanAdapters();
+#endif
+	default: return {};
+	}
+}
+
+Device* createDevice(Backend backend, unsigned adapterIndex, uint2 resolution, bool headless)
+{
+	switch (backend)
+	{
+	case Backend::Cpu:
+		return new CpuDevice();
+#ifdef _WIN32
+	case Backend::DirectX11:
+	{
+		std::vector<com_ptr<IDXGIAdapter>> adapters = enumerateAdapters();
+		if (adapterIndex >= adapters.size())
+			return nullptr;
+
+		HWND window = headless ? nullptr : createWindow(resolution);
+		return new DirectXDevice(window, resolution, adapters[adapterIndex]);
+	}
+#endif
+#ifdef PERFTEST_VULKAN
+	case Backend::Vulkan:
+		return new VulkanDevice(adapterIndex, headless);
+#endif
+	default:
+		return nullptr;
+	}
+}
@@ -0,0 +1,207 @@
+#pragma once
+#include "datatypes.h"
+#include <vector>
+#include <string>
+#include <functional>
+#include <initializer_list>
+
+// Backend-neutral resource handles. Backends derive from these and own the API objects.
+// Release() matches the COM convention, so handles can be stored in com_ptr.
+class DeviceObject
+{
+public:
+	virtual ~DeviceObject() {}
+	void Release() { delete this; }
+};
+
+class Buffer : public DeviceObject {};
+class Texture : public DeviceObject {};
+class ShaderResourceView : public DeviceObject {};
+class UnorderedAccessView : public DeviceObject {};
+class SamplerState : public DeviceObject {};
+class ComputeShader : public DeviceObject {};
+class CommandList : public DeviceObject {};
+
+enum class Format
+{
+	R8_UNORM,
+	R8G8_UNORM,
+	R8G8B8A8_UNORM,
+	R16_FLOAT,
+	R16G16_FLOAT,
+	R16G16B16A16_FLOAT,
+	R32_FLOAT,
+	R32G32_FLOAT,
+	R32G32B32A32_FLOAT,
+	R32_UINT
+};
+
+unsigned formatBytes(Format format);
+
+enum class Backend
+{
+	DirectX11,
+	Vulkan,
+	Cpu
+};
+
+const char* backendName(Backend backend);
+
+struct QueryHandle
+{
+	unsigned queryIndex;
+};
+
+// GPU time between the start and end of a query. Ids are chosen by the caller, usually the index of the case.
+struct QueryResult
+{
+	unsigned id;
+	float millis;
+	int64_t startNanos;		// GPU start on the steady_clock timeline, 0 until calibrateTimestamps has succeeded
+};
+
+class Device
+{
+public:
+
+	enum class BufferType
+	{
+		Default,
+		Structured,
+		ByteAddress
+	};
+
+	// CPU visible copy source or target, D3D11_USAGE_STAGING
+	enum class StagingType
+	{
+		Upload,
+		Readback
+	};
+
+	enum class SamplerType
+	{
+		Nearest,
+		Bilinear,
+		Trilinear
+	};
+
+	virtual ~Device() {}
+
+	// Create resources
+	virtual ComputeShader* createComputeShader(const unsigned char* shaderBytes, size_t size) = 0;
+
+	// Loads shaders/<name><shaderFileExtension()> and creates the shader. Thread safe, like the create functions
+	// of ID3D11Device, so shaders can be loaded on a thread pool while another thread dispatches.
+	// A missing shader ends the process with a message, see failShaderLoad.
+	virtual ComputeShader* loadComputeShader(const std::string& name);
+
+	// Bytecode of the shader loadComputeShader loads. False when the backend has no shader binaries.
+	bool readShaderBinary(const std::string& name, std::vector<unsigned char>& bytes);
+
+	virtual Buffer* createConstantBuffer(unsigned bytes) = 0;
+	virtual Buffer* createBuffer(unsigned numElements, unsigned strideBytes, BufferType type = BufferType::Default) = 0;
+	virtual Texture* createTexture2d(uint2 dimensions, Format format, unsigned mips) = 0;
+	virtual Texture* createTexture3d(uint3 dimensions, Format format, unsigned mips) = 0;
+	virtual SamplerState* createSampler(SamplerType type) = 0;
+
+	// Transfer sources and targets. Dynamic buffers are CPU written shader resources (D3D11_USAGE_DYNAMIC).
+	virtual Buffer* createDynamicBuffer(unsigned bytes) = 0;
+	virtual Buffer* createStagingBuffer(unsigned bytes, StagingType type) = 0;
+
+	virtual UnorderedAccessView* createUAV(Texture* texture) = 0;
+	virtual UnorderedAccessView* createTypedUAV(Buffer* buffer, unsigned numElements, Format format) = 0;
+	virtual UnorderedAccessView* createStructuredUAV(Buffer* buffer, unsigned numElements, unsigned stride) = 0;
+	virtual UnorderedAccessView* createByteAddressUAV(Buffer* buffer, unsigned numElements) = 0;
+
+	virtual ShaderResourceView* createSRV(Texture* texture) = 0;
+	virtual ShaderResourceView* createTypedSRV(Buffer* buffer, unsigned numElements, Format format) = 0;
+	virtual ShaderResourceView* createStructuredSRV(Buffer* buffer, unsigned numElements, unsigned stride) = 0;
+	virtual ShaderResourceView* createByteAddressSRV(Buffer* buffer, unsigned numElements) = 0;
+
+	// Data update
+	template <typename T>
+	void updateConstantBuffer(Buffer* cbuffer, const T& cb)
+	{
+		updateConstantBuffer(cbuffer, &cb, sizeof(cb));
+	}
+
+	virtual void updateConstantBuffer(Buffer* cbuffer, const void* data, size_t bytes) = 0;
+
+	// Map + memcpy of a dynamic or upload staging buffer. Dynamic buffers are renamed like Map(WRITE_DISCARD).
+	virtual void writeBuffer(Buffer* buffer, const void* data, size_t bytes) = 0;
+
+	// UpdateSubresource of a buffer created by createBuffer. The copy runs on the GPU timeline like a dispatch.
+	virtual void updateBuffer(Buffer* buffer, const void* data, size_t bytes) = 0;
+
+	// Map(READ) + memcpy of a readback staging buffer. Submits the recorded commands and waits for them.
+	virtual void readBuffer(Buffer* buffer, void* data, size_t bytes) = 0;
+
+	// Commands. Groups per dimension are limited to maxDispatchGroups.
+	static const unsigned maxDispatchGroups = 65535;		// D3D11 limit and Vulkan minimum of maxComputeWorkGroupCount
+	virtual void dispatch(ComputeShader* shader, uint3 resolution, uint3 groupSize,
+							std::initializer_list<Buffer*> cbs,
+							std::initializer_list<ShaderResourceView*> srvs,
+							std::initializer_list<UnorderedAccessView*> uavs = {},
+							std::initializer_list<SamplerState*> samplers = {}) = 0;
+	virtual void copyBuffer(Buffer* destination, Buffer* source, size_t bytes) = 0;
+	virtual void presentFrame() = 0;
+
+	// Command lists are recorded on other threads and executed in order on the device thread: D3D11 deferred contexts,
+	// Vulkan secondary command buffers. A list is recorded by one thread at a time, and recorded and executed
+	// at most once per frame. Recording runs begin, dispatches, end.
+	virtual CommandList* createCommandList() = 0;
+	virtual void beginCommandList(CommandList* list) = 0;
+	virtual void recordDispatch(CommandList* list, ComputeShader* shader, uint3 resolution, uint3 groupSize,
+								std::initializer_list<Buffer*> cbs,
+								std::initializer_list<ShaderResourceView*> srvs,
+								std::initializer_list<UnorderedAccessView*> uavs = {},
+								std::initializer_list<SamplerState*> samplers = {}) = 0;
+	virtual void endCommandList(CommandList* list) = 0;
+	virtual void executeCommandList(CommandList* list) = 0;
+
+	// Creates the pipeline state a dispatch with these bindings needs ahead of time. Thread safe.
+	// Backends that create everything in createComputeShader do nothing.
+	virtual void prepareDispatch(ComputeShader* shader,
+								 std::initializer_list<Buffer*> cbs,
+								 std::initializer_list<ShaderResourceView*> srvs,
+								 std::initializer_list<UnorderedAccessView*> uavs = {},
+								 std::initializer_list<SamplerState*> samplers = {}) {}
+
+	// Performance querys. Timestamp pairs come from a pool resolved a frame at a time, up to 4096 queries per frame.
+	// processPerformanceResults appends the finished queries in issue order and doesn't wait for unfinished frames.
+	// Queries of a frame whose timestamps were disjoint are dropped.
+	virtual QueryHandle startPerformanceQuery(unsigned id) = 0;
+	virtual void endPerformanceQuery(QueryHandle queryHandle) = 0;
+	virtual void processPerformanceResults(std::vector<QueryResult>& results) = 0;
+
+	// Maps GPU timestamps to steady_clock nanoseconds for QueryResult::startNanos. Waits for the GPU.
+	// Returns false when the backend can't read its timestamp clock.
+	virtual bool calibrateTimestamps() = 0;
+
+	// Shader binaries are loaded from shaders/<name><extension>
+	virtual const char* shaderFileExtension() const = 0;
+
+	// Reported with the results. Empty when the backend has no driver.
+	virtual std::string driverVersion() = 0;
+
+	// Dispatches bind only the slots that differ from the previous dispatch and leave them bound. Disabled, every dispatch
+	// binds and unbinds all its slots. Returns false when the backend has no binding cache.
+	virtual bool setBindingCache(bool enabled) { return false; }
+
+	// Shader Model 6 wave intrinsics in compute shaders: basic, ballot and shuffle subgroup operations on Vulkan
+	virtual bool supportsWaveIntrinsics() const { return false; }
+
+	// Typed UAV of the format on a buffer or a texture. Required for every Format in D3D11, optional for narrow formats on Vulkan.
+	virtual bool supportsTypedUAV(Format format, bool texture) const { return true; }
+
+protected:
+	// A missing shader is a broken build, not a case to skip. Prints the shader and the reason and exits without
+	// running destructors, the loading threads may still be using the device.
+	static void failShaderLoad(const std::string& name, const char* reason);
+};
+
+// Backend factory. Backends that aren't compiled in return an empty adapter list and a null device.
+// Headless devices have no window or swap chain: presentFrame() submits the frame and waits for it to finish.
+bool isBackendAvailable(Backend backend);
+std::vector<std::string> enumerateAdapters(Backend backend);
+Device* createDevice(Backend backend, unsigned adapterIndex, uint2 resolution, bool headless);
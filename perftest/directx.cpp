@@ -1,5 +1,8 @@
 #include "directx.h"
 #include <assert.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
 
 std::vector<com_ptr<IDXGIAdapter>> enumerateAdapters()
 {
@@ -20,6 +23,21 @@ std::vector<com_ptr<IDXGIAdapter>> enumerateAdapters()
 	return adapters;
 }
 
+std::vector<std::string> enumerateDirectXAdapters()
+{
+	std::vector<std::string> names;
+	for (auto&& adapter : enumerateAdapters())
+	{
+		DXGI_ADAPTER_DESC desc;
+		adapter->GetDesc(&desc);
+
+		char name[128];
+		WideCharToMultiByte(CP_UTF8, 0, desc.Description, -1, name, sizeof(name), nullptr, nullptr);
+		names.push_back(name);
+	}
+	return names;
+}
+
 DirectXDevice::DirectXDevice(HWND window, uint2 resolution, IDXGIAdapter* adapter) : 
 	windowHandle(window),
 	resolution(resolution)
@@ -28,37 +46,62 @@ DirectXDevice::DirectXDevice(HWND window, uint2 resolution, IDXGIAdapter* adapte
 	UINT flags = D3D11_CREATE_DEVICE_DEBUG;
 	D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_0;
 
-	DXGI_SWAP_CHAIN_DESC swapDesc;
-	ZeroMemory(&swapDesc, sizeof(DXGI_SWAP_CHAIN_DESC));
-	swapDesc.BufferDesc.Width = resolution.x;
-	swapDesc.BufferDesc.Height = resolution.y;
-	swapDesc.BufferDesc.RefreshRate.Numerator = 60;
-	swapDesc.BufferDesc.RefreshRate.Denominator = 1;
-	swapDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	swapDesc.SampleDesc.Count = 1;
-	swapDesc.BufferUsage = DXGI_USAGE_UNORDERED_ACCESS | DXGI_USAGE_RENDER_TARGET_OUTPUT; // RT needed for GDI text output
-	swapDesc.BufferCount = 1;
-	swapDesc.OutputWindow = window;
-	swapDesc.Windowed = true;
-	swapDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
-	swapDesc.Flags = 0;
-
-	HRESULT result = D3D11CreateDeviceAndSwapChain(
-		adapter,
-		D3D_DRIVER_TYPE_UNKNOWN,
-		nullptr, // software rasterizer
-		flags,
-		&featureLevel,
-		1, // num feature levels
-		D3D11_SDK_VERSION, // sdk version
-		&swapDesc,
-		&swapChain,
-		&device,
-		nullptr, // selected feature level
-		&deviceContext);
+	HRESULT result;
+	if (window)
+	{
+		DXGI_SWAP_CHAIN_DESC swapDesc;
+		ZeroMemory(&swapDesc, sizeof(DXGI_SWAP_CHAIN_DESC));
+		swapDesc.BufferDesc.Width = resolution.x;
+		swapDesc.BufferDesc.Height = resolution.y;
+		swapDesc.BufferDesc.RefreshRate.Numerator = 60;
+		swapDesc.BufferDesc.RefreshRate.Denominator = 1;
+		swapDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		swapDesc.SampleDesc.Count = 1;
+		swapDesc.BufferUsage = DXGI_USAGE_UNORDERED_ACCESS | DXGI_USAGE_RENDER_TARGET_OUTPUT; // RT needed for GDI text output
+		swapDesc.BufferCount = 1;
+		swapDesc.OutputWindow = window;
+		swapDesc.Windowed = true;
+		swapDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+		swapDesc.Flags = 0;
+
+		result = D3D11CreateDeviceAndSwapChain(
+			adapter,
+			D3D_DRIVER_TYPE_UNKNOWN,
+			nullptr, // software rasterizer
+			flags,
+			&featureLevel,
+			1, // num feature levels
+			D3D11_SDK_VERSION, // sdk version
+			&swapDesc,
+			&swapChain,
+			&device,
+			nullptr, // selected feature level
+			&deviceContext);
+	}
+	else
+	{
+		result = D3D11CreateDevice(
+			adapter,
+			D3D_DRIVER_TYPE_UNKNOWN,
+			nullptr, // software rasterizer
+			flags,
+			&featureLevel,
+			1, // num feature levels
+			D3D11_SDK_VERSION, // sdk version
+			&device,
+			nullptr, // selected feature level
+			&deviceContext);
+	}
 
 	assert(SUCCEEDED(result));
 
+	// Event query signals when all previously submitted commands have finished. Headless frames wait on it, and so does
+	// the timestamp calibration of windowed runs.
+	D3D11_QUERY_DESC fenceDesc;
+	ZeroMemory(&fenceDesc, sizeof(fenceDesc));
+	fenceDesc.Query = D3D11_QUERY_EVENT;
+	device->CreateQuery(&fenceDesc, &frameFence);
+
 	D3D11_VIEWPORT viewport;
 	viewport.Height = (float)resolution.y;
 	viewport.Width = (float)resolution.x;
@@ -69,16 +112,15 @@ DirectXDevice::DirectXDevice(HWND window, uint2 resolution, IDXGIAdapter* adapte
 	deviceContext->RSSetViewports(1, &viewport);
 
 	// Queries
-	for (auto &&q : queries)
-	{
-		D3D11_QUERY_DESC desc;
-		ZeroMemory(&desc, sizeof(desc));
-		desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
-		device->CreateQuery(&desc, &q.disjoint);
-		desc.Query = D3D11_QUERY_TIMESTAMP;
-		device->CreateQuery(&desc, &q.start);
-		device->CreateQuery(&desc, &q.end);
-	}
+	D3D11_QUERY_DESC desc;
+	ZeroMemory(&desc, sizeof(desc));
+	desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+	for (auto &&frame : queryFrames)
+		device->CreateQuery(&desc, &frame.disjoint);
+	desc.Query = D3D11_QUERY_TIMESTAMP;
+	for (auto &&timestamp : timestamps)
+		device->CreateQuery(&desc, &timestamp);
+	resolvedQueries.reserve(queryIds.size());
 }
 
 ID3D11UnorderedAccessView* DirectXDevice::createBackBufferUAV()
@@ -144,7 +186,52 @@ ID3D11RenderTargetView* DirectXDevice::createBackBufferRTV()
 	return view;
 }
 
-ID3D11Buffer* DirectXDevice::createConstantBuffer(unsigned bytes)
+DXGI_FORMAT dxgiFormat(Format format)
+{
+	switch (format)
+	{
+	case Format::R8_UNORM: return DXGI_FORMAT_R8_UNORM;
+	case Format::R8G8_UNORM: return DXGI_FORMAT_R8G8_UNORM;
+	case Format::R8G8B8A8_UNORM: return DXGI_FORMAT_R8G8B8A8_UNORM;
+	case Format::R16_FLOAT: return DXGI_FORMAT_R16_FLOAT;
+	case Format::R16G16_FLOAT: return DXGI_FORMAT_R16G16_FLOAT;
+	case Format::R16G16B16A16_FLOAT: return DXGI_FORMAT_R16G16B16A16_FLOAT;
+	case Format::R32_FLOAT: return DXGI_FORMAT_R32_FLOAT;
+	case Format::R32G32_FLOAT: return DXGI_FORMAT_R32G32_FLOAT;
+	case Format::R32G32B32A32_FLOAT: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+	case Format::R32_UINT: return DXGI_FORMAT_R32_UINT;
+	}
+
+	assert(false);
+	return DXGI_FORMAT_UNKNOWN;
+}
+
+static ID3D11Buffer* d3dBuffer(Buffer* buffer)
+{
+	return buffer ? static_cast<DirectXBuffer*>(buffer)->buffer : nullptr;
+}
+
+static ID3D11Resource* d3dTexture(Texture* texture)
+{
+	return texture ? static_cast<DirectXTexture*>(texture)->texture : nullptr;
+}
+
+static ID3D11ShaderResourceView* d3dView(ShaderResourceView* view)
+{
+	return view ? static_cast<DirectXSRV*>(view)->view : nullptr;
+}
+
+static ID3D11UnorderedAccessView* d3dView(UnorderedAccessView* view)
+{
+	return view ? static_cast<DirectXUAV*>(view)->view : nullptr;
+}
+
+static ID3D11SamplerState* d3dSampler(SamplerState* sampler)
+{
+	return sampler ? static_cast<DirectXSampler*>(sampler)->sampler : nullptr;
+}
+
+Buffer* DirectXDevice::createConstantBuffer(unsigned bytes)
 {
 	D3D11_BUFFER_DESC desc;
 	desc.ByteWidth = bytes;
@@ -154,13 +241,13 @@ ID3D11Buffer* DirectXDevice::createConstantBuffer(unsigned bytes)
 	desc.MiscFlags = 0;
 	desc.StructureByteStride = 0;
 
-	ID3D11Buffer *buffer = nullptr;
-	HRESULT result = device->CreateBuffer(&desc, nullptr, &buffer);
+	DirectXBuffer *buffer = new DirectXBuffer;
+	HRESULT result = device->CreateBuffer(&desc, nullptr, &buffer->buffer);
 	assert(SUCCEEDED(result));
 	return buffer;
 }
 
-ID3D11Buffer* DirectXDevice::createBuffer(unsigned numElements, unsigned strideBytes, BufferType type)
+Buffer* DirectXDevice::createBuffer(unsigned numElements, unsigned strideBytes, BufferType type)
 {
 	D3D11_BUFFER_DESC desc;
 	desc.ByteWidth = strideBytes * numElements;
@@ -170,19 +257,51 @@ ID3D11Buffer* DirectXDevice::createBuffer(unsigned numElements, unsigned strideB
 	desc.CPUAccessFlags = 0;
 	desc.MiscFlags = 0;
 
-	if (type == BufferType::Structured) 
+	if (type == BufferType::Structured)
 		desc.MiscFlags |= D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
 
 	if (type == BufferType::ByteAddress)
 		desc.MiscFlags |= D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
 
-	ID3D11Buffer *buffer = nullptr;
-	HRESULT result = device->CreateBuffer(&desc, nullptr, &buffer);
+	DirectXBuffer *buffer = new DirectXBuffer;
+	HRESULT result = device->CreateBuffer(&desc, nullptr, &buffer->buffer);
+	assert(SUCCEEDED(result));
+	return buffer;
+}
+
+Buffer* DirectXDevice::createDynamicBuffer(unsigned bytes)
+{
+	D3D11_BUFFER_DESC desc;
+	desc.ByteWidth = bytes;
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	desc.MiscFlags = 0;
+	desc.StructureByteStride = 0;
+
+	DirectXBuffer *buffer = new DirectXBuffer;
+	HRESULT result = device->CreateBuffer(&desc, nullptr, &buffer->buffer);
 	assert(SUCCEEDED(result));
 	return buffer;
 }
 
-ID3D11Texture2D* DirectXDevice::createTexture2d(uint2 dimensions, DXGI_FORMAT format, unsigned mips)
+Buffer* DirectXDevice::createStagingBuffer(unsigned bytes, StagingType type)
+{
+	D3D11_BUFFER_DESC desc;
+	desc.ByteWidth = bytes;
+	desc.Usage = D3D11_USAGE_STAGING;
+	desc.BindFlags = 0;
+	desc.CPUAccessFlags = type == StagingType::Upload ? D3D11_CPU_ACCESS_WRITE : D3D11_CPU_ACCESS_READ;
+	desc.MiscFlags = 0;
+	desc.StructureByteStride = 0;
+
+	DirectXBuffer *buffer = new DirectXBuffer;
+	HRESULT result = device->CreateBuffer(&desc, nullptr, &buffer->buffer);
+	assert(SUCCEEDED(result));
+	return buffer;
+}
+
+Texture* DirectXDevice::createTexture2d(uint2 dimensions, Format format, unsigned mips)
 {
 	D3D11_TEXTURE2D_DESC desc;
 	desc.Width = dimensions.x;
@@ -191,7 +310,7 @@ ID3D11Texture2D* DirectXDevice::createTexture2d(uint2 dimensions, DXGI_FORMAT fo
 	desc.SampleDesc.Count = 1;
 	desc.SampleDesc.Quality = 0;
 	desc.MipLevels = mips;
-	desc.Format = format;
+	desc.Format = dxgiFormat(format);
 	desc.Usage = D3D11_USAGE_DEFAULT;
 	desc.BindFlags = D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE;
 	desc.CPUAccessFlags = 0;
@@ -200,17 +319,20 @@ ID3D11Texture2D* DirectXDevice::createTexture2d(uint2 dimensions, DXGI_FORMAT fo
 	ID3D11Texture2D *texture = nullptr;
 	HRESULT result = device->CreateTexture2D(&desc, nullptr, &texture);
 	assert(SUCCEEDED(result));
-	return texture;
+
+	DirectXTexture *out = new DirectXTexture;
+	out->texture = texture;
+	return out;
 }
 
-ID3D11Texture3D* DirectXDevice::createTexture3d(uint3 dimensions, DXGI_FORMAT format, unsigned mips)
+Texture* DirectXDevice::createTexture3d(uint3 dimensions, Format format, unsigned mips)
 {
 	D3D11_TEXTURE3D_DESC desc;
 	desc.Width = dimensions.x;
 	desc.Height = dimensions.y;
 	desc.Depth = dimensions.z;
 	desc.MipLevels = mips;
-	desc.Format = format;
+	desc.Format = dxgiFormat(format);
 	desc.Usage = D3D11_USAGE_DEFAULT;
 	desc.BindFlags = D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE;
 	desc.CPUAccessFlags = 0;
@@ -219,18 +341,21 @@ ID3D11Texture3D* DirectXDevice::createTexture3d(uint3 dimensions, DXGI_FORMAT fo
 	ID3D11Texture3D *texture = nullptr;
 	HRESULT result = device->CreateTexture3D(&desc, nullptr, &texture);
 	assert(SUCCEEDED(result));
-	return texture;
+
+	DirectXTexture *out = new DirectXTexture;
+	out->texture = texture;
+	return out;
 }
 
-ID3D11UnorderedAccessView* DirectXDevice::createUAV(ID3D11Resource *buffer)
+UnorderedAccessView* DirectXDevice::createUAV(Texture *texture)
 {
-	ID3D11UnorderedAccessView *view = nullptr;
-	HRESULT result = device->CreateUnorderedAccessView(buffer, nullptr, &view);
+	DirectXUAV *view = new DirectXUAV;
+	HRESULT result = device->CreateUnorderedAccessView(d3dTexture(texture), nullptr, &view->view);
 	assert(SUCCEEDED(result));
 	return view;
 }
 
-ID3D11UnorderedAccessView* DirectXDevice::createByteAddressUAV(ID3D11Resource *buffer, unsigned numElements)
+UnorderedAccessView* DirectXDevice::createByteAddressUAV(Buffer *buffer, unsigned numElements)
 {
 	D3D11_UNORDERED_ACCESS_VIEW_DESC desc;
 	desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
@@ -239,50 +364,65 @@ ID3D11UnorderedAccessView* DirectXDevice::createByteAddressUAV(ID3D11Resource *b
 	desc.Buffer.NumElements = numElements;
 	desc.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_RAW;
 
-	ID3D11UnorderedAccessView *view = nullptr;
-	HRESULT result = device->CreateUnorderedAccessView(buffer, &desc, &view);
+	DirectXUAV *view = new DirectXUAV;
+	HRESULT result = device->CreateUnorderedAccessView(d3dBuffer(buffer), &desc, &view->view);
 	assert(SUCCEEDED(result));
 	return view;
 }
 
-ID3D11UnorderedAccessView* DirectXDevice::createTypedUAV(ID3D11Resource *buffer, unsigned numElements, DXGI_FORMAT format)
+UnorderedAccessView* DirectXDevice::createStructuredUAV(Buffer* buffer, unsigned numElements, unsigned stride)
 {
 	D3D11_UNORDERED_ACCESS_VIEW_DESC desc;
 	desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
-	desc.Format = format;
+	desc.Format = DXGI_FORMAT_UNKNOWN;
 	desc.Buffer.FirstElement = 0;
 	desc.Buffer.NumElements = numElements;
 	desc.Buffer.Flags = 0;
 
-	ID3D11UnorderedAccessView *view = nullptr;
-	HRESULT result = device->CreateUnorderedAccessView(buffer, &desc, &view);
+	DirectXUAV *view = new DirectXUAV;
+	HRESULT result = device->CreateUnorderedAccessView(d3dBuffer(buffer), &desc, &view->view);
 	assert(SUCCEEDED(result));
 	return view;
 }
 
-ID3D11ShaderResourceView* DirectXDevice::createSRV(ID3D11Resource *resource)
+UnorderedAccessView* DirectXDevice::createTypedUAV(Buffer *buffer, unsigned numElements, Format format)
 {
-	ID3D11ShaderResourceView *view = nullptr;
-	HRESULT result = device->CreateShaderResourceView(resource, nullptr, &view);
+	D3D11_UNORDERED_ACCESS_VIEW_DESC desc;
+	desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+	desc.Format = dxgiFormat(format);
+	desc.Buffer.FirstElement = 0;
+	desc.Buffer.NumElements = numElements;
+	desc.Buffer.Flags = 0;
+
+	DirectXUAV *view = new DirectXUAV;
+	HRESULT result = device->CreateUnorderedAccessView(d3dBuffer(buffer), &desc, &view->view);
 	assert(SUCCEEDED(result));
 	return view;
 }
 
-ID3D11ShaderResourceView* DirectXDevice::createTypedSRV(ID3D11Resource *buffer, unsigned numElements, DXGI_FORMAT format)
+ShaderResourceView* DirectXDevice::createSRV(Texture *texture)
+{
+	DirectXSRV *view = new DirectXSRV;
+	HRESULT result = device->CreateShaderResourceView(d3dTexture(texture), nullptr, &view->view);
+	assert(SUCCEEDED(result));
+	return view;
+}
+
+ShaderResourceView* DirectXDevice::createTypedSRV(Buffer *buffer, unsigned numElements, Format format)
 {
 	D3D11_SHADER_RESOURCE_VIEW_DESC desc;
 	desc.ViewDimension = D3D_SRV_DIMENSION_BUFFER;
-	desc.Format = format;
+	desc.Format = dxgiFormat(format);
 	desc.Buffer.FirstElement = 0;
 	desc.Buffer.NumElements = numElements;
 
-	ID3D11ShaderResourceView *view = nullptr;
-	HRESULT result = device->CreateShaderResourceView(buffer, &desc, &view);
+	DirectXSRV *view = new DirectXSRV;
+	HRESULT result = device->CreateShaderResourceView(d3dBuffer(buffer), &desc, &view->view);
 	assert(SUCCEEDED(result));
 	return view;
 }
 
-ID3D11ShaderResourceView* DirectXDevice::createStructuredSRV(ID3D11Resource* buffer, unsigned numElements, unsigned stride)
+ShaderResourceView* DirectXDevice::createStructuredSRV(Buffer* buffer, unsigned numElements, unsigned stride)
 {
 	D3D11_SHADER_RESOURCE_VIEW_DESC desc;
 	desc.ViewDimension = D3D_SRV_DIMENSION_BUFFER;
@@ -290,13 +430,13 @@ ID3D11ShaderResourceView* DirectXDevice::createStructuredSRV(ID3D11Resource* buf
 	desc.Buffer.FirstElement = 0;
 	desc.Buffer.NumElements = numElements;
 
-	ID3D11ShaderResourceView *view = nullptr;
-	HRESULT result = device->CreateShaderResourceView(buffer, &desc, &view);
+	DirectXSRV *view = new DirectXSRV;
+	HRESULT result = device->CreateShaderResourceView(d3dBuffer(buffer), &desc, &view->view);
 	assert(SUCCEEDED(result));
 	return view;
 }
 
-ID3D11ShaderResourceView* DirectXDevice::createByteAddressSRV(ID3D11Resource *buffer, unsigned numElements)
+ShaderResourceView* DirectXDevice::createByteAddressSRV(Buffer *buffer, unsigned numElements)
 {
 	D3D11_SHADER_RESOURCE_VIEW_DESC desc;
 	desc.ViewDimension = D3D11_SRV_DIMENSION_BUFFEREX;
@@ -305,13 +445,13 @@ ID3D11ShaderResourceView* DirectXDevice::createByteAddressSRV(ID3D11Resource *bu
 	desc.BufferEx.NumElements = numElements;
 	desc.BufferEx.Flags = D3D11_BUFFEREX_SRV_FLAG_RAW;
 
-	ID3D11ShaderResourceView *view = nullptr;
-	HRESULT result = device->CreateShaderResourceView(buffer, &desc, &view);
+	DirectXSRV *view = new DirectXSRV;
+	HRESULT result = device->CreateShaderResourceView(d3dBuffer(buffer), &desc, &view->view);
 	assert(SUCCEEDED(result));
 	return view;
 }
 
-ID3D11SamplerState* DirectXDevice::createSampler(SamplerType type)
+SamplerState* DirectXDevice::createSampler(SamplerType type)
 {
 	D3D11_SAMPLER_DESC desc;
 	ZeroMemory(&desc, sizeof(desc));
@@ -324,7 +464,7 @@ ID3D11SamplerState* DirectXDevice::createSampler(SamplerType type)
 
 	switch (type)
 	{
-	case SamplerType::Nearest: 
+	case SamplerType::Nearest:
 		desc.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
 		break;
 
@@ -337,92 +477,275 @@ ID3D11SamplerState* DirectXDevice::createSampler(SamplerType type)
 		break;
 	}
 
-	ID3D11SamplerState *sampler = nullptr;
-	HRESULT result = device->CreateSamplerState(&desc, &sampler);
+	DirectXSampler *sampler = new DirectXSampler;
+	HRESULT result = device->CreateSamplerState(&desc, &sampler->sampler);
 	assert(SUCCEEDED(result));
 	return sampler;
 }
 
-ID3D11ComputeShader* DirectXDevice::createComputeShader(const std::vector<unsigned char> &shaderBytes)
+ComputeShader* DirectXDevice::createComputeShader(const unsigned char* shaderBytes, size_t size)
 {
-	ID3D11ComputeShader* shader = nullptr;
-	HRESULT result = device->CreateComputeShader(shaderBytes.data(), shaderBytes.size(), nullptr, &shader);
+	DirectXComputeShader* shader = new DirectXComputeShader;
+	HRESULT result = device->CreateComputeShader(shaderBytes, size, nullptr, &shader->shader);
 	assert(SUCCEEDED(result));
 	return shader;
 }
 
-void DirectXDevice::dispatch(ID3D11ComputeShader *shader, uint3 resolution, uint3 groupSize,
-								std::initializer_list<ID3D11Buffer*> cbs,
-								std::initializer_list<ID3D11ShaderResourceView*> srvs,
-								std::initializer_list<ID3D11UnorderedAccessView*> uavs,
-								std::initializer_list<ID3D11SamplerState*> samplers)
+void DirectXDevice::updateConstantBuffer(Buffer* cbuffer, const void* data, size_t bytes)
 {
-	// Set resources
-	if(cbs.size())
+	D3D11_MAPPED_SUBRESOURCE map;
+	deviceContext->Map(d3dBuffer(cbuffer), 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
+	memcpy(map.pData, data, bytes);
+	deviceContext->Unmap(d3dBuffer(cbuffer), 0);
+}
+
+void DirectXDevice::writeBuffer(Buffer* buffer, const void* data, size_t bytes)
+{
+	// Staging buffers can't be discarded, the map waits for copies still reading them
+	D3D11_BUFFER_DESC desc;
+	d3dBuffer(buffer)->GetDesc(&desc);
+	D3D11_MAP mapType = desc.Usage == D3D11_USAGE_DYNAMIC ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE;
+
+	D3D11_MAPPED_SUBRESOURCE map;
+	HRESULT result = deviceContext->Map(d3dBuffer(buffer), 0, mapType, 0, &map);
+	assert(SUCCEEDED(result));
+	memcpy(map.pData, data, bytes);
+	deviceContext->Unmap(d3dBuffer(buffer), 0);
+}
+
+void DirectXDevice::updateBuffer(Buffer* buffer, const void* data, size_t bytes)
+{
+	D3D11_BOX box = { 0, 0, 0, static_cast<UINT>(bytes), 1, 1 };
+	deviceContext->UpdateSubresource(d3dBuffer(buffer), 0, &box, data, 0, 0);
+}
+
+void DirectXDevice::readBuffer(Buffer* buffer, void* data, size_t bytes)
+{
+	// Map flushes the recorded commands and blocks until the copies writing the buffer are done
+	D3D11_MAPPED_SUBRESOURCE map;
+	HRESULT result = deviceContext->Map(d3dBuffer(buffer), 0, D3D11_MAP_READ, 0, &map);
+	assert(SUCCEEDED(result));
+	memcpy(data, map.pData, bytes);
+	deviceContext->Unmap(d3dBuffer(buffer), 0);
+}
+
+void DirectXDevice::dispatch(ComputeShader *shader, uint3 resolution, uint3 groupSize,
+								std::initializer_list<Buffer*> cbs,
+								std::initializer_list<ShaderResourceView*> srvs,
+								std::initializer_list<UnorderedAccessView*> uavs,
+								std::initializer_list<SamplerState*> samplers)
+{
+	// Set the slots that changed, [first, last) of each array
+	ID3D11Buffer* cbarray[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+	unsigned first = static_cast<unsigned>(cbs.size()), last = 0, slot = 0;
+	for(auto cb : cbs)
 	{
-		ID3D11Buffer* cbarray[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
-		int slot = 0;
-		for(auto cb : cbs)
-			cbarray[slot++] = cb;
-		deviceContext->CSSetConstantBuffers(0, static_cast<UINT>(cbs.size()), cbarray);
+		cbarray[slot] = d3dBuffer(cb);
+		if(cbarray[slot] != boundCBs[slot])
+		{
+			first = std::min(first, slot);
+			last = slot + 1;
+			boundCBs[slot] = cbarray[slot];
+		}
+		slot++;
 	}
+	if(first < last)
+		deviceContext->CSSetConstantBuffers(first, last - first, cbarray + first);
 
-	if(srvs.size())
+	ID3D11SamplerState *samplerarray[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
+	first = static_cast<unsigned>(samplers.size()), last = 0, slot = 0;
+	for(auto sampler : samplers)
 	{
-		ID3D11ShaderResourceView* srvarray[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
-		int slot = 0;
-		for(auto srv : srvs)
-			srvarray[slot++] = srv;
-		deviceContext->CSSetShaderResources(0, static_cast<UINT>(srvs.size()), srvarray);
+		samplerarray[slot] = d3dSampler(sampler);
+		if(samplerarray[slot] != boundSamplers[slot])
+		{
+			first = std::min(first, slot);
+			last = slot + 1;
+			boundSamplers[slot] = samplerarray[slot];
+		}
+		slot++;
 	}
-
-	if(uavs.size())
+	if(first < last)
+		deviceContext->CSSetSamplers(first, last - first, samplerarray + first);
+
+	// Views are compared as a whole. Binding a UAV silently unbinds SRVs of the same resource (and the other way
+	// around fails), so a changed view set replaces the old one from empty slots.
+	ID3D11ShaderResourceView* srvarray[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+	ID3D11UnorderedAccessView* uavarray[D3D11_1_UAV_SLOT_COUNT];
+	bool viewsChanged = srvs.size() != boundSRVCount || uavs.size() != boundUAVCount;
+	slot = 0;
+	for(auto srv : srvs)
 	{
-		ID3D11UnorderedAccessView* uavarray[D3D11_1_UAV_SLOT_COUNT];
-		int slot = 0;
-		for(auto uav : uavs)
-			uavarray[slot++] = uav;
-		deviceContext->CSSetUnorderedAccessViews(0, static_cast<UINT>(uavs.size()), uavarray, nullptr);
+		srvarray[slot] = d3dView(srv);
+		viewsChanged |= srvarray[slot] != boundSRVs[slot];
+		slot++;
 	}
-
-	if(samplers.size())
+	slot = 0;
+	for(auto uav : uavs)
 	{
-		ID3D11SamplerState *samplerarray[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
-		int slot = 0;
-		for(auto sampler : samplers)
-			samplerarray[slot++] = sampler;
-		deviceContext->CSSetSamplers(0, static_cast<UINT>(samplers.size()), samplerarray);
+		uavarray[slot] = d3dView(uav);
+		viewsChanged |= uavarray[slot] != boundUAVs[slot];
+		slot++;
+	}
+	if(viewsChanged)
+	{
+		ID3D11ShaderResourceView* nullsrvs[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT] = { 0 };
+		ID3D11UnorderedAccessView* nulluavs[D3D11_1_UAV_SLOT_COUNT] = { 0 };
+		if(boundSRVCount)
+			deviceContext->CSSetShaderResources(0, boundSRVCount, nullsrvs);
+		if(boundUAVCount)
+			deviceContext->CSSetUnorderedAccessViews(0, boundUAVCount, nulluavs, nullptr);
+
+		boundSRVCount = static_cast<unsigned>(srvs.size());
+		boundUAVCount = static_cast<unsigned>(uavs.size());
+		std::copy(srvarray, srvarray + boundSRVCount, boundSRVs.begin());
+		std::copy(uavarray, uavarray + boundUAVCount, boundUAVs.begin());
+		if(boundSRVCount)
+			deviceContext->CSSetShaderResources(0, boundSRVCount, srvarray);
+		if(boundUAVCount)
+			deviceContext->CSSetUnorderedAccessViews(0, boundUAVCount, uavarray, nullptr);
 	}
 
 	// Render
+	ID3D11ComputeShader* d3dShader = static_cast<DirectXComputeShader*>(shader)->shader;
+	if(d3dShader != boundShader)
+	{
+		deviceContext->CSSetShader(d3dShader, nullptr, 0);
+		boundShader = d3dShader;
+	}
 	uint3 groups = divRoundUp(resolution, groupSize);
-	deviceContext->CSSetShader(shader, nullptr, 0);
+	assert(groups.x <= maxDispatchGroups && groups.y <= maxDispatchGroups && groups.z <= maxDispatchGroups);
 	deviceContext->Dispatch(groups.x, groups.y, groups.z);
 
-	// Remove resources
-	if(cbs.size())
-	{
-		ID3D11Buffer* cbarray[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT] = { 0 };
-		deviceContext->CSSetConstantBuffers(0, static_cast<UINT>(cbs.size()), cbarray);
-	}
+	// Without the cache every dispatch starts from and leaves empty slots
+	if(!bindingCache)
+		unbindComputeState();
+}
+
+void DirectXDevice::unbindComputeState()
+{
+	ID3D11Buffer* cbarray[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT] = { 0 };
+	ID3D11SamplerState *samplerarray[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT] = { 0 };
+	ID3D11ShaderResourceView* srvarray[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT] = { 0 };
+	ID3D11UnorderedAccessView* uavarray[D3D11_1_UAV_SLOT_COUNT] = { 0 };
+	// Slots up to the last bound one
+	UINT cbCount = 0, samplerCount = 0;
+	for(UINT slot = 0; slot < boundCBs.size(); ++slot)
+		cbCount = boundCBs[slot] ? slot + 1 : cbCount;
+	for(UINT slot = 0; slot < boundSamplers.size(); ++slot)
+		samplerCount = boundSamplers[slot] ? slot + 1 : samplerCount;
+
+	if(cbCount)
+		deviceContext->CSSetConstantBuffers(0, cbCount, cbarray);
+	if(samplerCount)
+		deviceContext->CSSetSamplers(0, samplerCount, samplerarray);
+	if(boundSRVCount)
+		deviceContext->CSSetShaderResources(0, boundSRVCount, srvarray);
+	if(boundUAVCount)
+		deviceContext->CSSetUnorderedAccessViews(0, boundUAVCount, uavarray, nullptr);
+
+	// The shader stays bound, but is set again by the next dispatch
+	forgetBindings();
+}
+
+void DirectXDevice::forgetBindings()
+{
+	boundShader = nullptr;
+	boundCBs.fill(nullptr);
+	boundSamplers.fill(nullptr);
+	boundSRVs.fill(nullptr);
+	boundUAVs.fill(nullptr);
+	boundSRVCount = 0;
+	boundUAVCount = 0;
+}
+
+bool DirectXDevice::setBindingCache(bool enabled)
+{
+	bindingCache = enabled;
+	if(!enabled)
+		unbindComputeState();
+	return true;
+}
+
+CommandList* DirectXDevice::createCommandList()
+{
+	DirectXCommandList* list = new DirectXCommandList();
+	HRESULT result = device->CreateDeferredContext(0, &list->context);
+	assert(SUCCEEDED(result));
+	return list;
+}
 
+void DirectXDevice::recordDispatch(CommandList* list, ComputeShader* shader, uint3 resolution, uint3 groupSize,
+								   std::initializer_list<Buffer*> cbs,
+								   std::initializer_list<ShaderResourceView*> srvs,
+								   std::initializer_list<UnorderedAccessView*> uavs,
+								   std::initializer_list<SamplerState*> samplers)
+{
+	// No binding cache. Views are unbound after the dispatch, a stale UAV would unbind a later SRV of its resource.
+	ID3D11DeviceContext* context = static_cast<DirectXCommandList*>(list)->context;
+
+	ID3D11Buffer* cbarray[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+	ID3D11SamplerState* samplerarray[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
+	ID3D11ShaderResourceView* srvarray[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT] = { 0 };
+	ID3D11UnorderedAccessView* uavarray[D3D11_1_UAV_SLOT_COUNT] = { 0 };
+	int slot = 0;
+	for(auto cb : cbs)
+		cbarray[slot++] = d3dBuffer(cb);
+	slot = 0;
+	for(auto sampler : samplers)
+		samplerarray[slot++] = d3dSampler(sampler);
+	slot = 0;
+	for(auto srv : srvs)
+		srvarray[slot++] = d3dView(srv);
+	slot = 0;
+	for(auto uav : uavs)
+		uavarray[slot++] = d3dView(uav);
+
+	if(cbs.size())
+		context->CSSetConstantBuffers(0, static_cast<UINT>(cbs.size()), cbarray);
+	if(samplers.size())
+		context->CSSetSamplers(0, static_cast<UINT>(samplers.size()), samplerarray);
 	if(srvs.size())
-	{
-		ID3D11ShaderResourceView* srvarray[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT] = { 0 };
-		deviceContext->CSSetShaderResources(0, static_cast<UINT>(srvs.size()), srvarray);
-	}
+		context->CSSetShaderResources(0, static_cast<UINT>(srvs.size()), srvarray);
+	if(uavs.size())
+		context->CSSetUnorderedAccessViews(0, static_cast<UINT>(uavs.size()), uavarray, nullptr);
+
+	uint3 groups = divRoundUp(resolution, groupSize);
+	assert(groups.x <= maxDispatchGroups && groups.y <= maxDispatchGroups && groups.z <= maxDispatchGroups);
+	context->CSSetShader(static_cast<DirectXComputeShader*>(shader)->shader, nullptr, 0);
+	context->Dispatch(groups.x, groups.y, groups.z);
 
+	std::fill(srvarray, srvarray + srvs.size(), nullptr);
+	std::fill(uavarray, uavarray + uavs.size(), nullptr);
+	if(srvs.size())
+		context->CSSetShaderResources(0, static_cast<UINT>(srvs.size()), srvarray);
 	if(uavs.size())
-	{
-		ID3D11UnorderedAccessView* uavarray[D3D11_1_UAV_SLOT_COUNT] = { 0 };
-		deviceContext->CSSetUnorderedAccessViews(0, static_cast<UINT>(uavs.size()), uavarray, nullptr);
-	}
+		context->CSSetUnorderedAccessViews(0, static_cast<UINT>(uavs.size()), uavarray, nullptr);
+}
 
-	if(samplers.size())
-	{
-		ID3D11SamplerState *samplerarray[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT] = { 0 };
-		deviceContext->CSSetSamplers(0, static_cast<UINT>(samplers.size()), samplerarray);
-	}
+void DirectXDevice::endCommandList(CommandList* list)
+{
+	DirectXCommandList* dxList = static_cast<DirectXCommandList*>(list);
+	if(dxList->commands)
+		dxList->commands->Release();
+	dxList->commands = nullptr;
+
+	// The deferred context starts the next list from the default state
+	HRESULT result = dxList->context->FinishCommandList(FALSE, &dxList->commands);
+	assert(SUCCEEDED(result));
+}
+
+void DirectXDevice::executeCommandList(CommandList* list)
+{
+	// Not restoring the state is cheaper. The immediate context is left in the default state, nothing is bound.
+	deviceContext->ExecuteCommandList(static_cast<DirectXCommandList*>(list)->commands, FALSE);
+	forgetBindings();
+}
+
+void DirectXDevice::copyBuffer(Buffer* destination, Buffer* source, size_t bytes)
+{
+	D3D11_BOX box = { 0, 0, 0, static_cast<UINT>(bytes), 1, 1 };
+	deviceContext->CopySubresourceRegion(d3dBuffer(destination), 0, 0, 0, 0, d3dBuffer(source), 0, &box);
 }
 
 void DirectXDevice::clear(ID3D11RenderTargetView *rtv, const float4 &color)
@@ -450,24 +773,56 @@ void DirectXDevice::setRenderTargets(std::initializer_list<ID3D11RenderTargetVie
 
 void DirectXDevice::presentFrame()
 {
-	const bool vsync = false;
-	swapChain->Present(vsync ? 1 : 0, 0);
+	// One disjoint query covers the frame's timestamps. The next frame slot must have been read before it's reused.
+	QueryFrame& queryFrame = queryFrames[queryFrameIndex];
+	if (queryFrame.active)
+	{
+		deviceContext->End(queryFrame.disjoint);
+		queryFrame.end = queryCounter;
+		queryFrame.active = false;
+		queryFrame.pending = true;
+		queryFrameIndex = (queryFrameIndex + 1) % queryFrames.size();
+		if (queryFrames[queryFrameIndex].pending)
+			resolveQueryFrame(true);
+	}
+
+	if (swapChain)
+	{
+		const bool vsync = false;
+		swapChain->Present(vsync ? 1 : 0, 0);
+		return;
+	}
+
+	// Headless: submit and wait, so that the frame's queries can be resolved right away
+	deviceContext->End(frameFence);
+	BOOL done = FALSE;
+	while (deviceContext->GetData(frameFence, &done, sizeof(done), 0) != S_OK)
+	{
+	}
 }
 
-void DirectXDevice::clearUAV(ID3D11UnorderedAccessView* uav, std::array<float, 4> color)
+void DirectXDevice::clearUAV(UnorderedAccessView* uav, std::array<float, 4> color)
 {
-	deviceContext->ClearUnorderedAccessViewFloat(uav, color.data());
+	deviceContext->ClearUnorderedAccessViewFloat(d3dView(uav), color.data());
 }
 
-QueryHandle DirectXDevice::startPerformanceQuery(unsigned id, const std::string& name)
+QueryHandle DirectXDevice::startPerformanceQuery(unsigned id)
 {
-	PerformanceQuery& query = queries[queryCounter % queries.size()];	
-	
-	query.id = id;
-	query.name = name;
-	deviceContext->Begin(query.disjoint);
-	deviceContext->End(query.start);	// NOTE: timestamp queries don't use Begin(), only End()
-	
+	QueryFrame& frame = queryFrames[queryFrameIndex];
+	if (!frame.active)
+	{
+		deviceContext->Begin(frame.disjoint);
+		frame.begin = queryCounter;
+		frame.active = true;
+	}
+
+	// Pairs still waiting to be read would be overwritten
+	assert(queryCounter - (queryFrames[queryFrameResolve].pending ? queryFrames[queryFrameResolve].begin : frame.begin) < queryIds.size());
+
+	unsigned index = queryCounter % queryIds.size();
+	queryIds[index] = id;
+	deviceContext->End(timestamps[index * 2]);	// NOTE: timestamp queries don't use Begin(), only End()
+
 	QueryHandle out {queryCounter};
 	queryCounter++;
 	return out;
@@ -475,39 +830,106 @@ QueryHandle DirectXDevice::startPerformanceQuery(unsigned id, const std::string&
 
 void DirectXDevice::endPerformanceQuery(QueryHandle queryHandle)
 {
-	PerformanceQuery& query = queries[queryHandle.queryIndex % queries.size()];
-
-	deviceContext->End(query.end);	// NOTE: timestamp queries don't use Begin(), only End()
-	deviceContext->End(query.disjoint);
+	unsigned index = queryHandle.queryIndex % queryIds.size();
+	deviceContext->End(timestamps[index * 2 + 1]);
 }
 
-void DirectXDevice::processPerformanceResults(const std::function<void(float, unsigned, std::string&)>& functor)
+bool DirectXDevice::resolveQueryFrame(bool wait)
 {
-	while(true)
+	QueryFrame& frame = queryFrames[queryFrameResolve];
+
+	// Only the disjoint query is polled. It ends after the frame's timestamps, so they are ready when it is.
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+	while (deviceContext->GetData(frame.disjoint, &disjoint, sizeof(disjoint), 0) != S_OK)
 	{
-		PerformanceQuery& query = queries[queryProcessCounter % queries.size()];
+		if (!wait)
+			return false;
+	}
 
-		D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
-		bool succDisjoint = deviceContext->GetData(query.disjoint, &disjoint, sizeof(disjoint), 0) == S_OK;
+	for (unsigned query = frame.begin; query < frame.end && !disjoint.Disjoint; ++query)
+	{
+		unsigned index = query % queryIds.size();
+		UINT64 start = 0, end = 0;
+		HRESULT startResult = deviceContext->GetData(timestamps[index * 2], &start, sizeof(start), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+		HRESULT endResult = deviceContext->GetData(timestamps[index * 2 + 1], &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+		assert(startResult == S_OK && endResult == S_OK);
+
+		float delta = (float(end - start) / float(disjoint.Frequency)) * 1000.0f;
+		int64_t startNanos = timestampsCalibrated ? int64_t(double(start) * 1e9 / double(disjoint.Frequency)) + timestampOffsetNanos : 0;
+		resolvedQueries.push_back({ queryIds[index], delta, startNanos });
+	}
 
-		UINT64 start = 0;
-		UINT64 end = 0;
-		bool succStart = deviceContext->GetData(query.start, &start, sizeof(start), 0) == S_OK;
-		bool succEnd = deviceContext->GetData(query.end, &end, sizeof(end), 0) == S_OK;
+	frame.pending = false;
+	queryFrameResolve = (queryFrameResolve + 1) % queryFrames.size();
+	return true;
+}
 
-		// Wait until all queries are ready
-		if (!succDisjoint || !succStart || !succEnd)
-			break;
+void DirectXDevice::processPerformanceResults(std::vector<QueryResult>& results)
+{
+	while (queryFrames[queryFrameResolve].pending && resolveQueryFrame(false))
+	{
+	}
 
-		if (!disjoint.Disjoint)
-		{
-			UINT64 d = end - start;
-			float delta = (float(d) / float(disjoint.Frequency)) * 1000.0f;
+	results.insert(results.end(), resolvedQueries.begin(), resolvedQueries.end());
+	resolvedQueries.clear();
+}
 
-			// Call functor to process results
-			functor(delta, query.id, query.name);
-		}
+// D3D11 has no clock calibration like D3D12 GetClockCalibration. A timestamp is written on an idle GPU, its CPU time
+// is the midpoint between the flush and the poll that sees it. Accurate to the submission latency.
+bool DirectXDevice::calibrateTimestamps()
+{
+	deviceContext->End(frameFence);
+	BOOL done = FALSE;
+	while (deviceContext->GetData(frameFence, &done, sizeof(done), 0) != S_OK)
+	{
+	}
 
-		queryProcessCounter++;
+	com_ptr<ID3D11Query> disjoint, timestamp;
+	D3D11_QUERY_DESC desc;
+	ZeroMemory(&desc, sizeof(desc));
+	desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+	device->CreateQuery(&desc, &disjoint);
+	desc.Query = D3D11_QUERY_TIMESTAMP;
+	device->CreateQuery(&desc, &timestamp);
+
+	deviceContext->Begin(disjoint);
+	deviceContext->End(timestamp);
+	deviceContext->End(disjoint);
+
+	auto before = std::chrono::steady_clock::now();
+	deviceContext->Flush();
+	UINT64 ticks = 0;
+	while (deviceContext->GetData(timestamp, &ticks, sizeof(ticks), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+	{
 	}
+	auto after = std::chrono::steady_clock::now();
+
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointData;
+	while (deviceContext->GetData(disjoint, &disjointData, sizeof(disjointData), 0) != S_OK)
+	{
+	}
+	if (disjointData.Disjoint)
+		return false;
+
+	int64_t cpuNanos = std::chrono::duration_cast<std::chrono::nanoseconds>((before + (after - before) / 2).time_since_epoch()).count();
+	timestampOffsetNanos = cpuNanos - int64_t(double(ticks) * 1e9 / double(disjointData.Frequency));
+	timestampsCalibrated = true;
+	return true;
+}
+
+std::string DirectXDevice::driverVersion()
+{
+	com_ptr<IDXGIDevice> dxgiDevice;
+	com_ptr<IDXGIAdapter> adapter;
+	if (FAILED(device->QueryInterface(__uuidof(IDXGIDevice), (void**)&dxgiDevice)) || FAILED(dxgiDevice->GetAdapter(&adapter)))
+		return "";
+
+	// User mode driver version
+	LARGE_INTEGER version;
+	if (FAILED(adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &version)))
+		return "";
+
+	char text[64];
+	snprintf(text, sizeof(text), "%u.%u.%u.%u", HIWORD(version.HighPart), LOWORD(version.HighPart), HIWORD(version.LowPart), LOWORD(version.LowPart));
+	return text;
 }
@@ -1,5 +1,5 @@
 #pragma once
-#include "datatypes.h"
+#include "device.h"
 #include "com_ptr.h"
 #include <windows.h>
 #include <d3d11.h>
@@ -7,90 +7,140 @@
 #include <array>
 #include <functional>
 
-struct QueryHandle
+// DirectX implementations of the backend-neutral handles
+class DirectXBuffer : public Buffer
 {
-	unsigned queryIndex;
+public:
+	com_ptr<ID3D11Buffer> buffer;
 };
 
-struct PerformanceQuery
+class DirectXTexture : public Texture
 {
-	com_ptr<ID3D11Query> disjoint;
-	com_ptr<ID3D11Query> start;
-	com_ptr<ID3D11Query> end;
+public:
+	com_ptr<ID3D11Resource> texture;
+};
 
-	unsigned id;
-	std::string name;
+class DirectXSRV : public ShaderResourceView
+{
+public:
+	com_ptr<ID3D11ShaderResourceView> view;
 };
 
-std::vector<com_ptr<IDXGIAdapter>> enumerateAdapters();
+class DirectXUAV : public UnorderedAccessView
+{
+public:
+	com_ptr<ID3D11UnorderedAccessView> view;
+};
 
-class DirectXDevice
+class DirectXSampler : public SamplerState
 {
 public:
+	com_ptr<ID3D11SamplerState> sampler;
+};
 
-	enum class BufferType
-	{
-		Default,
-		Structured,
-		ByteAddress
-	};
+class DirectXComputeShader : public ComputeShader
+{
+public:
+	com_ptr<ID3D11ComputeShader> shader;
+};
 
-	enum class SamplerType
+class DirectXCommandList : public CommandList
+{
+public:
+	~DirectXCommandList()
 	{
-		Nearest,
-		Bilinear,
-		Trilinear
-	};
+		if (commands)
+			commands->Release();
+	}
 
+	com_ptr<ID3D11DeviceContext> context;		// Deferred
+	ID3D11CommandList* commands = nullptr;		// Replaced by every FinishCommandList
+};
+
+// Timestamp pairs of the queries issued in one frame, [begin, end) of the query counter, under one disjoint query
+struct QueryFrame
+{
+	com_ptr<ID3D11Query> disjoint;
+	unsigned begin = 0;
+	unsigned end = 0;
+	bool active = false;		// Disjoint query begun, frame not presented yet
+	bool pending = false;		// Presented, results not read yet
+};
+
+std::vector<com_ptr<IDXGIAdapter>> enumerateAdapters();
+std::vector<std::string> enumerateDirectXAdapters();
+
+DXGI_FORMAT dxgiFormat(Format format);
+
+class DirectXDevice : public Device
+{
+public:
+
+	// Null window creates a headless device without a swap chain. Frames are then submitted and waited on with an event query.
 	DirectXDevice(HWND window, uint2 resolution, IDXGIAdapter* adapter = nullptr);
 
 	// Create resources
 	ID3D11UnorderedAccessView* createBackBufferUAV();
 	ID3D11DepthStencilView* createDepthStencilView(uint2 size);
-	ID3D11RenderTargetView* DirectXDevice::createBackBufferRTV();
-	ID3D11ComputeShader* createComputeShader(const std::vector<unsigned char>& shaderBytes);
-
-	ID3D11Buffer* createConstantBuffer(unsigned bytes);
-	ID3D11Buffer* createBuffer(unsigned numElements, unsigned strideBytes, BufferType type = BufferType::Default);
-	ID3D11Texture2D* createTexture2d(uint2 dimensions, DXGI_FORMAT format, unsigned mips);
-	ID3D11Texture3D* createTexture3d(uint3 dimensions, DXGI_FORMAT format, unsigned mips);
-	ID3D11SamplerState* createSampler(SamplerType type);
-
-	ID3D11UnorderedAccessView* createUAV(ID3D11Resource* resource);
-	ID3D11UnorderedAccessView* createTypedUAV(ID3D11Resource* buffer, unsigned numElements, DXGI_FORMAT format);
-	ID3D11UnorderedAccessView* createByteAddressUAV(ID3D11Resource* buffer, unsigned numElements);
-
-	ID3D11ShaderResourceView* createSRV(ID3D11Resource* buffer);
-	ID3D11ShaderResourceView* createTypedSRV(ID3D11Resource* buffer, unsigned numElements, DXGI_FORMAT format);
-	ID3D11ShaderResourceView* createStructuredSRV(ID3D11Resource* buffer, unsigned numElements, unsigned stride);
-	ID3D11ShaderResourceView* createByteAddressSRV(ID3D11Resource* buffer, unsigned numElements);
+	ID3D11RenderTargetView* createBackBufferRTV();
+	ComputeShader* createComputeShader(const unsigned char* shaderBytes, size_t size) override;
+
+	Buffer* createConstantBuffer(unsigned bytes) override;
+	Buffer* createBuffer(unsigned numElements, unsigned strideBytes, BufferType type = BufferType::Default) override;
+	Texture* createTexture2d(uint2 dimensions, Format format, unsigned mips) override;
+	Texture* createTexture3d(uint3 dimensions, Format format, unsigned mips) override;
+	SamplerState* createSampler(SamplerType type) override;
+	Buffer* createDynamicBuffer(unsigned bytes) override;
+	Buffer* createStagingBuffer(unsigned bytes, StagingType type) override;
+
+	UnorderedAccessView* createUAV(Texture* texture) override;
+	UnorderedAccessView* createTypedUAV(Buffer* buffer, unsigned numElements, Format format) override;
+	UnorderedAccessView* createStructuredUAV(Buffer* buffer, unsigned numElements, unsigned stride) override;
+	UnorderedAccessView* createByteAddressUAV(Buffer* buffer, unsigned numElements) override;
+
+	ShaderResourceView* createSRV(Texture* texture) override;
+	ShaderResourceView* createTypedSRV(Buffer* buffer, unsigned numElements, Format format) override;
+	ShaderResourceView* createStructuredSRV(Buffer* buffer, unsigned numElements, unsigned stride) override;
+	ShaderResourceView* createByteAddressSRV(Buffer* buffer, unsigned numElements) override;
 
 	// Data update
-	template <typename T>
-	void updateConstantBuffer(ID3D11Buffer* cbuffer, const T& cb)
-	{
-		D3D11_MAPPED_SUBRESOURCE map;
-		deviceContext->Map(cbuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
-		memcpy(map.pData, &cb, sizeof(cb));
-		deviceContext->Unmap(cbuffer, 0);
-	}
+	using Device::updateConstantBuffer;
+	void updateConstantBuffer(Buffer* cbuffer, const void* data, size_t bytes) override;
+	void writeBuffer(Buffer* buffer, const void* data, size_t bytes) override;
+	void updateBuffer(Buffer* buffer, const void* data, size_t bytes) override;
+	void readBuffer(Buffer* buffer, void* data, size_t bytes) override;
 
 	// Commands
 	void clear(ID3D11RenderTargetView* rtv, const float4& color);
 	void clearDepth(ID3D11DepthStencilView *depthStencilView);
 	void setRenderTargets(std::initializer_list<ID3D11RenderTargetView*> rtvs, ID3D11DepthStencilView* depthStencilView);
-	void dispatch(ID3D11ComputeShader* shader, uint3 resolution, uint3 groupSize,
-					std::initializer_list<ID3D11Buffer*> cbs,
-					std::initializer_list<ID3D11ShaderResourceView*> srvs,
-					std::initializer_list<ID3D11UnorderedAccessView*> uavs = {},
-					std::initializer_list<ID3D11SamplerState*> samplers = {});
-	void presentFrame();
-	void clearUAV(ID3D11UnorderedAccessView* uav, std::array<float, 4> color);
+	void dispatch(ComputeShader* shader, uint3 resolution, uint3 groupSize,
+					std::initializer_list<Buffer*> cbs,
+					std::initializer_list<ShaderResourceView*> srvs,
+					std::initializer_list<UnorderedAccessView*> uavs = {},
+					std::initializer_list<SamplerState*> samplers = {}) override;
+	void copyBuffer(Buffer* destination, Buffer* source, size_t bytes) override;
+	void presentFrame() override;
+	CommandList* createCommandList() override;
+	void beginCommandList(CommandList* list) override {}
+	void recordDispatch(CommandList* list, ComputeShader* shader, uint3 resolution, uint3 groupSize,
+						std::initializer_list<Buffer*> cbs,
+						std::initializer_list<ShaderResourceView*> srvs,
+						std::initializer_list<UnorderedAccessView*> uavs = {},
+						std::initializer_list<SamplerState*> samplers = {}) override;
+	void endCommandList(CommandList* list) override;
+	void executeCommandList(CommandList* list) override;
+	void clearUAV(UnorderedAccessView* uav, std::array<float, 4> color);
 
 	// Performance querys
-	QueryHandle startPerformanceQuery(unsigned id, const std::string& name);
-	void endPerformanceQuery(QueryHandle queryHandle);
-	void processPerformanceResults(const std::function<void(float, unsigned, std::string&)>& functor);
+	QueryHandle startPerformanceQuery(unsigned id) override;
+	void endPerformanceQuery(QueryHandle queryHandle) override;
+	void processPerformanceResults(std::vector<QueryResult>& results) override;
+	bool calibrateTimestamps() override;
+
+	const char* shaderFileExtension() const override { return ".cso"; }
+	std::string driverVersion() override;
+	bool setBindingCache(bool enabled) override;
 
 	// Device and window
 	HWND getWindowHandle() { return windowHandle; }
@@ -108,9 +158,33 @@ private:
 	com_ptr<IDXGISwapChain> swapChain;
 	com_ptr<ID3D11Device> device;
 	com_ptr<ID3D11DeviceContext> deviceContext;
-
-	// Queries
-	std::array<PerformanceQuery, 4096> queries;
+	com_ptr<ID3D11Query> frameFence;
+
+	// Compute bindings left by the last dispatch. The context holds a reference to bound objects,
+	// so a cached pointer can't be reused by a new object while it's bound.
+	bool bindingCache = true;
+	ID3D11ComputeShader* boundShader = nullptr;
+	std::array<ID3D11Buffer*, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT> boundCBs = {};
+	std::array<ID3D11SamplerState*, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT> boundSamplers = {};
+	std::array<ID3D11ShaderResourceView*, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT> boundSRVs = {};
+	std::array<ID3D11UnorderedAccessView*, D3D11_1_UAV_SLOT_COUNT> boundUAVs = {};
+	unsigned boundSRVCount = 0;
+	unsigned boundUAVCount = 0;
+
+	void unbindComputeState();
+	void forgetBindings();
+
+	// Reads the results of the oldest pending frame. Returns false when it hasn't finished and wait isn't set.
+	bool resolveQueryFrame(bool wait);
+
+	// Queries. Two timestamps per query, a ring shared by the frames in flight. Frames outnumber the DXGI frame latency.
+	std::array<com_ptr<ID3D11Query>, 8192 * 2> timestamps;
+	std::array<unsigned, 8192> queryIds;
+	std::array<QueryFrame, 8> queryFrames;
+	unsigned queryFrameIndex = 0;		// Frame issuing queries
+	unsigned queryFrameResolve = 0;		// Oldest pending frame
 	unsigned queryCounter = 0;
-	unsigned queryProcessCounter = 0;
+	std::vector<QueryResult> resolvedQueries;		// Read while waiting for a frame slot, returned by the next processPerformanceResults
+	bool timestampsCalibrated = false;
+	int64_t timestampOffsetNanos = 0;				// steady_clock minus GPU clock
 };
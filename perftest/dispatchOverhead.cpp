@@ -0,0 +1,275 @@
+#include "dispatchOverhead.h"
+#include "testCases.h"
+#include "threadPool.h"
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <stdio.h>
+
+void runDispatchOverhead(Device& device, unsigned numWarmUpRuns, unsigned numRuns,
+						 const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results)
+{
+	const unsigned dispatchesPerRun = 1000;
+	const uint3 groupSize(256, 1, 1);
+
+	// Uniform loads of the fixed cases, a group finishes in a few microseconds. Both views are Buffer<float> compatible.
+	const TestCase narrow = { ResourceType::TypedBuffer, Format::R8_UNORM, 1, AccessPattern::Uniform, ConstantsType::Aligned };
+	const TestCase wide = { ResourceType::TypedBuffer, Format::R32_FLOAT, 1, AccessPattern::Uniform, ConstantsType::Aligned };
+	const TestCase linear = { ResourceType::TypedBuffer, Format::R8_UNORM, 1, AccessPattern::Linear, ConstantsType::Aligned };
+
+	TestResources resources(device);
+	com_ptr<ComputeShader> uniformShader, linearShader;
+	Buffer* cb = resources.constants(narrow);
+	UnorderedAccessView* output = resources.output();
+	resources.source(narrow);
+	resources.source(wide);
+
+	// Dispatch i of a run
+	struct OverheadCase
+	{
+		const char* name;
+		std::function<void(unsigned)> dispatch;
+	};
+	const OverheadCase cases[] =
+	{
+		{ "same bindings", [&](unsigned)
+		{
+			device.dispatch(uniformShader, groupSize, groupSize, { cb }, { resources.source(narrow) }, { output });
+		} },
+		{ "alternating views", [&](unsigned i)
+		{
+			device.dispatch(uniformShader, groupSize, groupSize, { cb }, { resources.source(i & 1 ? wide : narrow) }, { output });
+		} },
+		{ "alternating shaders", [&](unsigned i)
+		{
+			device.dispatch(i & 1 ? linearShader : uniformShader, groupSize, groupSize, { cb }, { resources.source(narrow) }, { output });
+		} },
+	};
+
+	// Off first, the factor of the on point is the saving
+	bool hasCache = device.setBindingCache(false);
+	const char* modes[] = { " cache off", " cache on" };
+
+	unsigned pointId = 0;
+	for (const OverheadCase& test : cases)
+	{
+		std::vector<CaseResult> cpuResults, gpuResults;
+		for (unsigned mode = hasCache ? 0 : 1; mode < 2; ++mode)
+		{
+			std::string cpuSeries = std::string("Dispatch overhead ") + test.name + " CPU";
+			std::string gpuSeries = std::string("Dispatch overhead ") + test.name + " GPU";
+			const char* suffix = hasCache ? modes[mode] : "";
+			bool selectCpu = selectCase(cpuSeries + suffix);
+			bool selectGpu = selectCase(gpuSeries + suffix);
+			if (!selectCpu && !selectGpu)
+				continue;
+
+			if (!uniformShader)
+			{
+				uniformShader = device.loadComputeShader(narrow.shaderName());
+				linearShader = device.loadComputeShader(linear.shaderName());
+			}
+			device.setBindingCache(mode == 1);
+
+			CaseResult cpuResult = { cpuSeries + suffix, groupSize, groupSize, double(dispatchesPerRun), 0, SampleBuffer(numRuns) };
+			cpuResult.series = cpuSeries;
+			cpuResult.sweepPoint = true;
+			cpuResult.overhead = true;
+			cpuResult.rateUnit = "dispatches";
+			CaseResult gpuResult = cpuResult;
+			gpuResult.name = gpuSeries + suffix;
+			gpuResult.series = gpuSeries;
+			gpuResult.samples = SampleBuffer(numRuns);
+
+			// Windowed frames report later, queries of the previous point are told apart by id
+			std::vector<QueryResult> queryResults;
+			unsigned cpuRuns = 0, gpuReceived = 0;
+			while (cpuRuns < numWarmUpRuns + numRuns || gpuReceived < numWarmUpRuns + numRuns)
+			{
+				auto start = std::chrono::steady_clock::now();
+				QueryHandle query = device.startPerformanceQuery(pointId);
+				for (unsigned i = 0; i < dispatchesPerRun; ++i)
+					test.dispatch(i);
+				device.endPerformanceQuery(query);
+				auto end = std::chrono::steady_clock::now();
+				device.presentFrame();
+
+				if (cpuRuns++ >= numWarmUpRuns && cpuRuns <= numWarmUpRuns + numRuns)
+					cpuResult.samples.add(std::chrono::duration<float, std::milli>(end - start).count());
+
+				queryResults.clear();
+				device.processPerformanceResults(queryResults);
+				for (const QueryResult& queryResult : queryResults)
+				{
+					if (queryResult.id == pointId && gpuReceived++ >= numWarmUpRuns && gpuReceived <= numWarmUpRuns + numRuns)
+						gpuResult.samples.add(queryResult.millis);
+				}
+			}
+			pointId++;
+
+			if (selectCpu)
+				cpuResults.push_back(std::move(cpuResult));
+			if (selectGpu)
+				gpuResults.push_back(std::move(gpuResult));
+			printf("X");
+		}
+
+		// Points of a series are consecutive
+		for (auto&& result : cpuResults)
+			results.push_back(std::move(result));
+		for (auto&& result : gpuResults)
+			results.push_back(std::move(result));
+	}
+	device.setBindingCache(true);
+}
+
+void runRecordingScaling(Device& device, unsigned numWarmUpRuns, unsigned numRuns,
+						 const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results)
+{
+	const unsigned dispatchesPerRun = 1024;
+	const uint3 groupSize(256, 1, 1);
+	const TestCase narrow = { ResourceType::TypedBuffer, Format::R8_UNORM, 1, AccessPattern::Uniform, ConstantsType::Aligned };
+	const TestCase wide = { ResourceType::TypedBuffer, Format::R32_FLOAT, 1, AccessPattern::Uniform, ConstantsType::Aligned };
+
+	unsigned maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	std::vector<unsigned> threadCounts;
+	for (unsigned threads = 1; threads < maxThreads; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+
+	const char* series[] = { "Command recording", "Command list submit", "Command list GPU" };
+
+	TestResources resources(device);
+	com_ptr<ComputeShader> shader;
+	Buffer* cb = resources.constants(narrow);
+	UnorderedAccessView* output = resources.output();
+	ShaderResourceView* sources[] = { resources.source(narrow), resources.source(wide) };
+	std::vector<com_ptr<CommandList>> lists;
+
+	// Series of a thread count are collected separately, so points of a series are consecutive
+	std::vector<CaseResult> seriesResults[3];
+	unsigned pointId = 0;
+	for (unsigned threads : threadCounts)
+	{
+		std::string suffix = " " + std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+		bool selected[3];
+		for (unsigned i = 0; i < 3; ++i)
+			selected[i] = selectCase(series[i] + suffix);
+		if (!selected[0] && !selected[1] && !selected[2])
+			continue;
+
+		if (!shader)
+		{
+			shader = device.loadComputeShader(narrow.shaderName());
+			for (ShaderResourceView* source : sources)
+				device.prepareDispatch(shader, { cb }, { source }, { output });
+		}
+		while (lists.size() < threads)
+			lists.emplace_back(device.createCommandList());
+
+		std::vector<CaseResult> points;
+		for (unsigned i = 0; i < 3; ++i)
+		{
+			CaseResult result = { series[i] + suffix, groupSize, groupSize, double(dispatchesPerRun), 0, SampleBuffer(numRuns) };
+			result.series = series[i];
+			result.sweepPoint = true;
+			result.recordingThreads = threads;
+			result.rateUnit = "dispatches";
+			points.push_back(std::move(result));
+		}
+
+		// Thread i records dispatches [i * n / threads, (i + 1) * n / threads) of the stream
+		ThreadPool pool(threads);
+		auto record = [&](unsigned thread)
+		{
+			CommandList* list = lists[thread];
+			device.beginCommandList(list);
+			for (unsigned i = thread * dispatchesPerRun / threads; i < (thread + 1) * dispatchesPerRun / threads; ++i)
+				device.recordDispatch(list, shader, groupSize, groupSize, { cb }, { sources[i & 1] }, { output });
+			device.endCommandList(list);
+		};
+
+		// Windowed frames report later, queries of the previous point are told apart by id
+		std::vector<QueryResult> queryResults;
+		unsigned cpuRuns = 0, gpuReceived = 0;
+		while (cpuRuns < numWarmUpRuns + numRuns || gpuReceived < numWarmUpRuns + numRuns)
+		{
+			auto start = std::chrono::steady_clock::now();
+			pool.parallelFor(threads, record);
+			auto recorded = std::chrono::steady_clock::now();
+
+			QueryHandle query = device.startPerformanceQuery(pointId);
+			for (unsigned i = 0; i < threads; ++i)
+				device.executeCommandList(lists[i]);
+			device.endPerformanceQuery(query);
+			auto submitted = std::chrono::steady_clock::now();
+			device.presentFrame();
+
+			if (cpuRuns++ >= numWarmUpRuns && cpuRuns <= numWarmUpRuns + numRuns)
+			{
+				points[0].samples.add(std::chrono::duration<float, std::milli>(recorded - start).count());
+				points[1].samples.add(std::chrono::duration<float, std::milli>(submitted - recorded).count());
+			}
+
+			queryResults.clear();
+			device.processPerformanceResults(queryResults);
+			for (const QueryResult& queryResult : queryResults)
+			{
+				if (queryResult.id == pointId && gpuReceived++ >= numWarmUpRuns && gpuReceived <= numWarmUpRuns + numRuns)
+					points[2].samples.add(queryResult.millis);
+			}
+		}
+		pointId++;
+
+		for (unsigned i = 0; i < 3; ++i)
+		{
+			if (selected[i])
+				seriesResults[i].push_back(std::move(points[i]));
+		}
+		printf("X");
+	}
+
+	for (auto&& seriesResult : seriesResults)
+	{
+		for (auto&& result : seriesResult)
+			results.push_back(std::move(result));
+	}
+}
+
+void printDispatchOverhead(const std::vector<CaseResult>& results)
+{
+	const std::string* series = nullptr;
+	for (auto&& result : results)
+	{
+		if (!result.overhead || result.stats.count == 0)
+			continue;
+
+		if (!series || *series != result.series)
+		{
+			series = &result.series;
+			printf("\n%s:", series->c_str());
+		}
+		std::string mode = result.name.size() > series->size() ? result.name.substr(series->size() + 1) : "no cache";
+		printf(" %s %.0f", mode.c_str(), 1.0 / result.elementsPerNs());
+	}
+	printf("\n");
+}
+
+void printRecordingScaling(const std::vector<CaseResult>& results)
+{
+	const std::string* series = nullptr;
+	for (auto&& result : results)
+	{
+		if (result.recordingThreads == 0 || result.stats.count == 0)
+			continue;
+
+		if (!series || *series != result.series)
+		{
+			series = &result.series;
+			printf("\n%s:", series->c_str());
+		}
+		printf(" %u: %.0f %.2fx %.0f%%", result.recordingThreads, 1.0 / result.elementsPerNs(), result.relative,
+			   100.0 * result.relative / result.recordingThreads);
+	}
+	printf("\n");
+}
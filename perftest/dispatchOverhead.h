@@ -0,0 +1,25 @@
+#pragma once
+#include "device.h"
+#include "results.h"
+#include <functional>
+
+// Dispatch overhead. Runs of 1000 dispatches of a single 256 thread group, with the same bindings every time,
+// alternating views and alternating shaders. Each case has a CPU series, the time to record the dispatches, and
+// a GPU series, a query around them. Backends with a binding cache run with it disabled and enabled.
+// Points are named "Dispatch overhead <case> CPU|GPU [cache off|cache on]", e.g. "Dispatch overhead same bindings GPU cache on".
+// selectCase is called once per point.
+void runDispatchOverhead(Device& device, unsigned numWarmUpRuns, unsigned numRuns,
+						 const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results);
+
+// Command recording scaling. A stream of 1024 single group dispatches alternating between two views is split evenly between
+// 1, 2, 4... up to all hardware threads, each recording its part into its own command list. The device thread then executes
+// the lists in order. Series are "Command recording" (CPU time until every list is recorded), "Command list submit"
+// (CPU time of executing the lists) and "Command list GPU" (a query around them). Points are named "<series> <threads> threads".
+void runRecordingScaling(Device& device, unsigned numWarmUpRuns, unsigned numRuns,
+						 const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results);
+
+// ns per dispatch of each point, one line per series
+void printDispatchOverhead(const std::vector<CaseResult>& results);
+
+// Per thread count: ns per dispatch, speedup over one thread and scaling efficiency (speedup / threads), one line per series
+void printRecordingScaling(const std::vector<CaseResult>& results);
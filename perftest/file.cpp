@@ -1,6 +1,15 @@
 #include "file.h"
 #include <assert.h>
 #include <cstdio>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 long fileSize(FILE *f)
 {
@@ -10,21 +19,94 @@ long fileSize(FILE *f)
 	return size;
 }
 
+bool readFile(const std::string& filename, std::vector<unsigned char>& outVec)
+{
+	FILE *f = nullptr;
+#ifdef _MSC_VER
+	fopen_s(&f, filename.c_str(), "rb");
+#else
+	f = fopen(filename.c_str(), "rb");
+#endif
+	if (!f)
+		return false;
+
+	long size = fileSize(f);
+	outVec.resize(size);
+#ifdef _MSC_VER
+	fread_s(outVec.data(), size, sizeof(unsigned char), size, f);
+#else
+	size_t read = fread(outVec.data(), sizeof(unsigned char), size, f);
+	outVec.resize(read);
+#endif
+	fclose(f);
+	return true;
+}
+
 std::vector<unsigned char> loadFile(const std::string& filename)
 {
 	std::vector<unsigned char> outVec;
+	if (!readFile(filename, outVec))
+		assert(false);
+	return outVec;
+}
 
-	FILE *f = nullptr;
-	fopen_s(&f, filename.c_str(), "rb");
-	assert(f);
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename)
+{
+	HANDLE handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return;
+	file = handle;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0)
+		return;
 
-	if(f)
+	mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+		return;
+
+	bytes = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	length = bytes ? size_t(fileSize.QuadPart) : 0;
+}
+
+MappedFile::~MappedFile()
+{
+	if (bytes)
+		UnmapViewOfFile(bytes);
+	if (mapping)
+		CloseHandle(mapping);
+	if (file)
+		CloseHandle(file);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename)
+{
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+
+	// The mapping stays valid after the descriptor is closed
+	struct stat status;
+	if (fstat(fd, &status) == 0 && status.st_size > 0)
 	{
-		long size = fileSize(f);
-		outVec.resize(size);
-		fread_s(outVec.data(), size, sizeof(unsigned char), size, f);
-		fclose(f);
+		void* address = mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (address != MAP_FAILED)
+		{
+			bytes = static_cast<const unsigned char*>(address);
+			length = size_t(status.st_size);
+		}
 	}
+	close(fd);
+}
 
-	return outVec;
+MappedFile::~MappedFile()
+{
+	if (bytes)
+		munmap(const_cast<unsigned char*>(bytes), length);
 }
+
+#endif
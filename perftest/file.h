@@ -4,3 +4,29 @@
 #include <string>
 
 std::vector<unsigned char> loadFile(const std::string& filename);
+
+// Returns false when the file can't be opened
+bool readFile(const std::string& filename, std::vector<unsigned char>& outVec);
+
+// Read-only memory mapping of a whole file. Invalid when the file can't be opened.
+class MappedFile
+{
+public:
+	MappedFile(const std::string& filename);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool valid() const { return bytes != nullptr; }
+	const unsigned char* data() const { return bytes; }
+	size_t size() const { return length; }
+
+private:
+	const unsigned char* bytes = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	void* file = nullptr;
+	void* mapping = nullptr;
+#endif
+};
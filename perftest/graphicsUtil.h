@@ -1,10 +1,7 @@
 #pragma once
-#include "directx.h"
-#include "file.h"
+#include "device.h"
 
-inline ID3D11ComputeShader *loadComputeShader(DirectXDevice &dx, const std::string &filename)
+inline ComputeShader *loadComputeShader(Device &dx, const std::string &name)
 {
-	auto shaderBlob = loadFile(filename);
-	return dx.createComputeShader(shaderBlob);
+	return dx.loadComputeShader(name);
 }
-
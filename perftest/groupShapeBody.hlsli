@@ -0,0 +1,75 @@
+#include "hash.hlsli"
+#include "loadConstantsGPU.h"
+
+RWBuffer<float> output : register(u0);
+
+cbuffer CB0 : register(b0)
+{
+	LoadConstants loadConstants;
+};
+
+// GROUP_WIDTH x GROUP_HEIGHT, 32 to 1024 threads
+#define THREAD_GROUP_SIZE (GROUP_WIDTH * GROUP_HEIGHT)
+
+// Addresses wrap inside the views of the fixed cases, so every shape reads the same L1 resident data.
+// 1024 typed and structured elements, 256 Load4 of the 4 KB raw view, 32x32 texels.
+#if defined(LOAD_TEX)
+#define ELEMENT_MASK 31
+#elif defined(LOAD_RAW)
+#define ELEMENT_MASK 255
+#else
+#define ELEMENT_MASK 1023
+#endif
+
+groupshared float dummyLDS[THREAD_GROUP_SIZE];
+
+[numthreads(GROUP_WIDTH, GROUP_HEIGHT, 1)]
+void main(uint3 tid : SV_DispatchThreadID, uint3 gid : SV_GroupThreadID, uint gix : SV_GroupIndex)
+{
+	float4 value = 0.0;
+
+#if defined(LOAD_TEX)
+	// Group rows are texture rows. 1D groups read a single row of 16x16 texel blocks.
+#if defined(LOAD_LINEAR)
+	uint2 htid = gid.xy;
+#elif defined(LOAD_RANDOM)
+	uint2 htid = uint2((hash1(gid.x) & 0x4), (hash1(gid.y) & 0x4));
+#endif
+#else
+	// Buffers use the flattened group index like the fixed cases
+#if defined(LOAD_LINEAR)
+	uint htid = gix;
+#elif defined(LOAD_RANDOM)
+	uint htid = hash1(gix) & 0xf;
+#endif
+#endif
+
+	[loop]
+	for (int i = 0; i < 256; ++i)
+	{
+		// Mask with runtime constant to prevent unwanted compiler optimizations
+#if defined(LOAD_TEX)
+		uint2 elemIdx = ((htid + uint2(i & 15, i >> 4)) & ELEMENT_MASK) | loadConstants.elementsMask;
+		value += sourceData[elemIdx].xyzw;
+#elif defined(LOAD_RAW)
+		uint address = (((htid + i) & ELEMENT_MASK) * 16) | loadConstants.elementsMask;
+		value += sourceData.Load4(address).xyzw;
+#else
+		uint elemIdx = ((htid + i) & ELEMENT_MASK) | loadConstants.elementsMask;
+		value += sourceData[elemIdx].xyzw;
+#endif
+	}
+
+	// Linear write to LDS (no bank conflicts). Significantly faster than memory loads.
+	dummyLDS[gix] = value.x + value.y + value.z + value.w;
+
+	GroupMemoryBarrierWithGroupSync();
+
+	// This branch is never taken, but the compiler doesn't know it
+	// Optimizer would remove all the memory loads if the data wouldn't be potentially used
+	[branch]
+	if (loadConstants.writeIndex != 0xffffffff)
+	{
+		output[tid.x + tid.y] = dummyLDS[loadConstants.writeIndex & (THREAD_GROUP_SIZE - 1)];
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+// Half precision float conversion for the CPU paths
+
+inline float halfToFloat(uint16_t h)
+{
+	uint32_t sign = (h & 0x8000u) << 16;
+	uint32_t exponent = (h >> 10) & 0x1f;
+	uint32_t mantissa = h & 0x3ff;
+
+	uint32_t bits;
+	if (exponent == 0x1f)
+	{
+		// Inf and NaN
+		bits = sign | 0x7f800000u | (mantissa << 13);
+	}
+	else if (exponent != 0)
+	{
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	}
+	else if (mantissa == 0)
+	{
+		bits = sign;
+	}
+	else
+	{
+		// Denormal. Normalize the mantissa.
+		exponent = 113;
+		while (!(mantissa & 0x400))
+		{
+			mantissa <<= 1;
+			exponent--;
+		}
+		bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+	}
+
+	float f;
+	memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+inline uint16_t floatToHalf(float f)
+{
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000u;
+	int exponent = int((bits >> 23) & 0xff) - 112;
+	uint32_t mantissa = bits & 0x7fffff;
+
+	if (((bits >> 23) & 0xff) == 0xff)
+		return uint16_t(sign | 0x7c00u | (mantissa ? 0x200u : 0u));
+	if (exponent >= 0x1f)
+		return uint16_t(sign | 0x7c00u);
+	if (exponent <= 0)
+		return uint16_t(sign);	// Denormals flush to zero
+
+	// Round to nearest. Mantissa overflow carries into the exponent.
+	return uint16_t(sign | ((uint32_t(exponent) << 10) + ((mantissa + 0x1000) >> 13)));
+}
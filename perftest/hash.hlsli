@@ -16,3 +16,13 @@ uint hash1(uint c)
   return c;
 }
 
+// Bijection of [0, mask], mask + 1 is a power of two. Odd multiplies and xor shifts are invertible on the masked bits.
+// Shift is at least one, about half the bits of the mask.
+uint permute(uint c, uint mask, uint shift)
+{
+  c = (c * 0x3504f333 + 0x9e3779b9) & mask;
+  c ^= c >> shift;
+  c = (c * 741103597) & mask;
+  c ^= c >> shift;
+  return c;
+}
@@ -0,0 +1,247 @@
+#include "json.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const JsonValue* JsonValue::find(const std::string& key) const
+{
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		if (keys[i] == key)
+			return &elements[i];
+	}
+	return nullptr;
+}
+
+class JsonParser
+{
+public:
+	JsonParser(const std::string& text) : p(text.c_str()), end(text.c_str() + text.size()) {}
+
+	bool parseDocument(JsonValue& out)
+	{
+		if (!parseValue(out))
+			return false;
+		skipSpace();
+		return p == end;
+	}
+
+private:
+	void skipSpace()
+	{
+		while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+			p++;
+	}
+
+	bool consume(const char* literal)
+	{
+		size_t length = strlen(literal);
+		if (size_t(end - p) < length || strncmp(p, literal, length) != 0)
+			return false;
+		p += length;
+		return true;
+	}
+
+	bool parseValue(JsonValue& out)
+	{
+		skipSpace();
+		if (p == end)
+			return false;
+
+		switch (*p)
+		{
+		case '{': return parseObject(out);
+		case '[': return parseArray(out);
+		case '"': out.type = JsonValue::Type::String; return parseString(out.string);
+		case 't': out.type = JsonValue::Type::Bool; out.boolean = true; return consume("true");
+		case 'f': out.type = JsonValue::Type::Bool; out.boolean = false; return consume("false");
+		case 'n': out.type = JsonValue::Type::Null; return consume("null");
+		default: return parseNumber(out);
+		}
+	}
+
+	bool parseNumber(JsonValue& out)
+	{
+		// Copy, the text isn't null terminated at the number
+		char buffer[64];
+		size_t length = 0;
+		while (p + length < end && length < sizeof(buffer) - 1 && strchr("+-0123456789.eE", p[length]))
+		{
+			buffer[length] = p[length];
+			length++;
+		}
+		buffer[length] = 0;
+
+		char* parsedEnd = nullptr;
+		out.type = JsonValue::Type::Number;
+		out.number = strtod(buffer, &parsedEnd);
+		if (length == 0 || parsedEnd != buffer + length)
+			return false;
+		p += length;
+		return true;
+	}
+
+	bool parseString(std::string& out)
+	{
+		p++;	// Opening quote
+		while (p < end && *p != '"')
+		{
+			if (*p != '\\')
+			{
+				out += *p++;
+				continue;
+			}
+
+			if (++p == end)
+				return false;
+			switch (*p++)
+			{
+			case '"': out += '"'; break;
+			case '\\': out += '\\'; break;
+			case '/': out += '/'; break;
+			case 'b': out += '\b'; break;
+			case 'f': out += '\f'; break;
+			case 'n': out += '\n'; break;
+			case 'r': out += '\r'; break;
+			case 't': out += '\t'; break;
+			case 'u':
+			{
+				// Basic multilingual plane to UTF-8
+				if (end - p < 4)
+					return false;
+				char hex[5] = { p[0], p[1], p[2], p[3], 0 };
+				unsigned c = unsigned(strtoul(hex, nullptr, 16));
+				p += 4;
+				if (c < 0x80)
+				{
+					out += char(c);
+				}
+				else if (c < 0x800)
+				{
+					out += char(0xc0 | (c >> 6));
+					out += char(0x80 | (c & 0x3f));
+				}
+				else
+				{
+					out += char(0xe0 | (c >> 12));
+					out += char(0x80 | ((c >> 6) & 0x3f));
+					out += char(0x80 | (c & 0x3f));
+				}
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+
+		if (p == end)
+			return false;
+		p++;	// Closing quote
+		return true;
+	}
+
+	bool parseArray(JsonValue& out)
+	{
+		out.type = JsonValue::Type::Array;
+		p++;
+		skipSpace();
+		if (p < end && *p == ']')
+		{
+			p++;
+			return true;
+		}
+
+		while (true)
+		{
+			out.elements.emplace_back();
+			if (!parseValue(out.elements.back()))
+				return false;
+
+			skipSpace();
+			if (p < end && *p == ',')
+			{
+				p++;
+				continue;
+			}
+			return consume("]");
+		}
+	}
+
+	bool parseObject(JsonValue& out)
+	{
+		out.type = JsonValue::Type::Object;
+		p++;
+		skipSpace();
+		if (p < end && *p == '}')
+		{
+			p++;
+			return true;
+		}
+
+		while (true)
+		{
+			skipSpace();
+			if (p == end || *p != '"')
+				return false;
+
+			out.keys.emplace_back();
+			if (!parseString(out.keys.back()))
+				return false;
+
+			skipSpace();
+			if (!consume(":"))
+				return false;
+
+			out.elements.emplace_back();
+			if (!parseValue(out.elements.back()))
+				return false;
+
+			skipSpace();
+			if (p < end && *p == ',')
+			{
+				p++;
+				continue;
+			}
+			return consume("}");
+		}
+	}
+
+	const char* p;
+	const char* end;
+};
+
+bool parseJson(const std::string& text, JsonValue& out)
+{
+	out = JsonValue();
+	JsonParser parser(text);
+	return parser.parseDocument(out);
+}
+
+std::string jsonString(const std::string& text)
+{
+	std::string out = "\"";
+	for (char c : text)
+	{
+		switch (c)
+		{
+		case '"': out += "\\\""; break;
+		case '\\': out += "\\\\"; break;
+		case '\n': out += "\\n"; break;
+		case '\r': out += "\\r"; break;
+		case '\t': out += "\\t"; break;
+		default:
+			if (uint8_t(c) < 0x20)
+			{
+				char escaped[8];
+				snprintf(escaped, sizeof(escaped), "\\u%04x", unsigned(uint8_t(c)));
+				out += escaped;
+			}
+			else
+			{
+				out += c;
+			}
+		}
+	}
+	return out + "\"";
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Minimal JSON document, enough to read back the result files
+struct JsonValue
+{
+	enum class Type
+	{
+		Null,
+		Bool,
+		Number,
+		String,
+		Array,
+		Object
+	};
+
+	Type type = Type::Null;
+	bool boolean = false;
+	double number = 0.0;
+	std::string string;
+	std::vector<JsonValue> elements;		// Array elements or object values
+	std::vector<std::string> keys;			// Object keys, same order as elements
+
+	// Object member or null
+	const JsonValue* find(const std::string& key) const;
+};
+
+// Returns false on syntax errors
+bool parseJson(const std::string& text, JsonValue& out);
+
+// Quoted and escaped string literal
+std::string jsonString(const std::string& text);
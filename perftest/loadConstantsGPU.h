@@ -1,6 +1,6 @@
 // SHARED HEADER BETWEEN CPU AND GPU
 #ifdef __cplusplus
-#include "dataTypes.h"
+#include "datatypes.h"
 #endif
 
 struct LoadConstants
@@ -20,3 +20,22 @@ struct LoadConstantsWithArray
 
 	float4 benchmarkArray[1024];	// 16 KB test array (fits inside L1$)
 };
+
+struct SweepConstants
+{
+	uint elementsMask;		// Runtime address mask. Needed to prevent compiler combining narrow raw buffer loads from single thread.
+	uint writeIndex;		// Runtime write mask. Always 0xffffffff (= never write). But the compiler doesn't know this :)
+	uint dispatchWidth;		// Threads per dispatch row
+	uint padding;
+
+	uint2 addressMask;		// Working set size in elements - 1, power of two. Buffers use x.
+	uint2 padding2;
+};
+
+struct ChaseConstants
+{
+	uint addressMask;		// Working set size in elements - 1, power of two
+	uint startMask;			// Chain position of the previous dispatch is masked to a valid element, the state buffer starts undefined
+	uint permuteShift;		// Init pass: xor shift of the permutation, about half the address bits
+	uint textureWidthLog2;	// Init pass, textures: element index to texel
+};
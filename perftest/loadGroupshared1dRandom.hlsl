@@ -0,0 +1,3 @@
+#define LOAD_WIDTH 1
+#define LOAD_RANDOM
+#include "loadGroupsharedBody.hlsli"
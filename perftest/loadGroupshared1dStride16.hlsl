@@ -0,0 +1,3 @@
+#define LOAD_WIDTH 1
+#define LDS_STRIDE 16
+#include "loadGroupsharedBody.hlsli"
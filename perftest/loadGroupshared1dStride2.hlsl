@@ -0,0 +1,3 @@
+#define LOAD_WIDTH 1
+#define LDS_STRIDE 2
+#include "loadGroupsharedBody.hlsli"
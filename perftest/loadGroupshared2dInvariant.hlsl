@@ -0,0 +1,3 @@
+#define LOAD_WIDTH 2
+#define LOAD_INVARIANT
+#include "loadGroupsharedBody.hlsli"
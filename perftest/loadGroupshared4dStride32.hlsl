@@ -0,0 +1,3 @@
+#define LOAD_WIDTH 4
+#define LDS_STRIDE 32
+#include "loadGroupsharedBody.hlsli"
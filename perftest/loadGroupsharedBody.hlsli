@@ -0,0 +1,69 @@
+#include "hash.hlsli"
+#include "loadConstantsGPU.h"
+
+RWBuffer<float> output : register(u0);
+
+cbuffer CB0 : register(b0)
+{
+	LoadConstants loadConstants;
+};
+
+#define THREAD_GROUP_SIZE 256
+#define LDS_ELEMENTS (4096 / LOAD_WIDTH)	// 16 KB
+
+#if LOAD_WIDTH == 1
+groupshared uint ldsData[LDS_ELEMENTS];
+#elif LOAD_WIDTH == 2
+groupshared uint2 ldsData[LDS_ELEMENTS];
+#elif LOAD_WIDTH == 4
+groupshared uint4 ldsData[LDS_ELEMENTS];
+#endif
+
+[numthreads(THREAD_GROUP_SIZE, 1, 1)]
+void main(uint3 tid : SV_DispatchThreadID, uint gix : SV_GroupIndex)
+{
+	// Contents come from the cbuffer, the compiler can't know them
+	for (uint j = gix; j < LDS_ELEMENTS; j += THREAD_GROUP_SIZE)
+	{
+		ldsData[j] = j + loadConstants.readStartAddress;
+	}
+
+	GroupMemoryBarrierWithGroupSync();
+
+#if defined(LOAD_INVARIANT)
+	// Broadcast: all threads access the same address
+	uint htid = 0;
+#elif defined(LDS_STRIDE)
+	// LDS_STRIDE dwords between neighbour threads. 32 banks of 4 bytes.
+	uint htid = gix * (LDS_STRIDE / LOAD_WIDTH);
+#elif defined(LOAD_RANDOM)
+	// Scattered: one address per thread, random banks. Odd multiplier, so the low bits are a permutation.
+	uint htid = hash1(gix);
+#endif
+
+	uint4 value = 0;
+
+	[loop]
+	for (int i = 0; i < 256; ++i)
+	{
+		// The pattern moves by one element per iteration, its bank conflicts stay the same
+		// Mask with runtime constant to prevent unwanted compiler optimizations
+		uint elemIdx = ((htid + i) & (LDS_ELEMENTS - 1)) | loadConstants.elementsMask;
+
+#if LOAD_WIDTH == 1
+		value += ldsData[elemIdx].xxxx;
+#elif LOAD_WIDTH == 2
+		value += ldsData[elemIdx].xyxy;
+#elif LOAD_WIDTH == 4
+		value += ldsData[elemIdx].xyzw;
+#endif
+	}
+
+	// This branch is never taken, but the compiler doesn't know it
+	// Optimizer would remove all the groupshared loads if the data wouldn't be potentially used
+	[branch]
+	if (loadConstants.writeIndex != 0xffffffff)
+	{
+		output[tid.x + tid.y] = value.x + value.y + value.z + value.w;
+	}
+}
@@ -1,4 +1,4 @@
 #define LOAD_WIDTH 1
 #define LOAD_LINEAR
 Texture2D<float> sourceData : register(t0);
-#include "loadTexBody.hlsli"
\ No newline at end of file
+#include "loadTexBody.hlsli"
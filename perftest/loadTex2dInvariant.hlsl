@@ -1,4 +1,4 @@
 #define LOAD_WIDTH 2
 #define LOAD_INVARIANT
 Texture2D<float2> sourceData : register(t0);
-#include "loadTexBody.hlsli"
\ No newline at end of file
+#include "loadTexBody.hlsli"
@@ -1,4 +1,4 @@
 #define LOAD_WIDTH 1
 #define LOAD_LINEAR
 Buffer<float> sourceData : register(t0);
-#include "loadTypedBody.hlsli"
\ No newline at end of file
+#include "loadTypedBody.hlsli"
@@ -1,337 +1,889 @@
+#ifdef _WIN32
+#define NOMINMAX
 #include "window.h"
-#include "directx.h"
-#include "graphicsUtil.h"
-#include "loadConstantsGPU.h"
+#endif
+#include "device.h"
+#include "com_ptr.h"
+#include "cpuDecode.h"
+#include "testCases.h"
+#include "statistics.h"
+#include "results.h"
+#include "sweep.h"
+#include "dispatchOverhead.h"
+#include "roofline.h"
+#include "shaderLoader.h"
+#include "shaderAnalysis.h"
+#include "trace.h"
+#include <chrono>
 #include <map>
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <thread>
+#include <string.h>
+#include <stdlib.h>
 
 class BenchTest
 {
 public:
-	BenchTest(DirectXDevice& dx, ID3D11UnorderedAccessView* output) : dx(dx), output(output), testCaseNumber(0)
+	BenchTest(Device& dx) : dx(dx)
 	{
 	}
 
-	void testCase(ID3D11ComputeShader* shader, ID3D11Buffer* cb, ID3D11ShaderResourceView* source, const std::string& name)
+	// Untimed while shaders are loading, those frames don't produce samples
+	void testCase(unsigned id, ComputeShader* shader, Buffer* cb, ShaderResourceView* source, UnorderedAccessView* target,
+				  SamplerState* sampler, bool timed)
 	{
-		const uint3 workloadThreadCount(1024, 1024, 1);
-		const uint3 workloadGroupSize(256, 1, 1);
+		if (!timed)
+		{
+			dx.dispatch(shader, workloadThreadCount, workloadGroupSize, { cb }, { source }, { target }, { sampler });
+			return;
+		}
 
-		QueryHandle query = dx.startPerformanceQuery(testCaseNumber, name);
-		dx.dispatch(shader, workloadThreadCount, workloadGroupSize, { cb }, { source }, { output }, {});
+		QueryHandle query = dx.startPerformanceQuery(id);
+		dx.dispatch(shader, workloadThreadCount, workloadGroupSize, { cb }, { source }, { target }, { sampler });
 		dx.endPerformanceQuery(query);
+	}
 
-		testCaseNumber++;
+	static double loadsPerDispatch()
+	{
+		return double(workloadThreadCount.x) * workloadThreadCount.y * workloadThreadCount.z * loadsPerThread;
 	}
 
+	static const uint3 workloadThreadCount;
+	static const uint3 workloadGroupSize;
+
 private:
-	DirectXDevice& dx;
-	ID3D11UnorderedAccessView* output;
-	unsigned testCaseNumber;
+	static const unsigned loadsPerThread = 256;		// Loop count of the shaders
+
+	Device& dx;
 };
 
+const uint3 BenchTest::workloadThreadCount(1024, 1024, 1);
+const uint3 BenchTest::workloadGroupSize(256, 1, 1);
 
-int main(int argc, char *argv[])
+// Bytes with an optional K, M or G suffix
+static bool parseSize(const char* text, uint64_t& bytes)
 {
-	// Enumerate adapters
-	std::vector<com_ptr<IDXGIAdapter>> adapters = enumerateAdapters();
-	printf("PerfTest\nTo select adapter, use: PerfTest.exe [ADAPTER_INDEX]\n\n");
-	printf("Adapters found:\n");
-	int index = 0;
-	for (auto&& adapter : adapters)
+	char suffix = 0;
+	unsigned long long value = 0;
+	int fields = sscanf(text, "%llu%c", &value, &suffix);
+	if (fields < 1)
+		return false;
+
+	switch (suffix)
+	{
+	case 0: bytes = value; break;
+	case 'K': case 'k': bytes = value << 10; break;
+	case 'M': case 'm': bytes = value << 20; break;
+	case 'G': case 'g': bytes = value << 30; break;
+	default: return false;
+	}
+	return true;
+}
+
+// The whole argument is the number
+static bool parseFloat(const char* text, float& value)
+{
+	char* end = nullptr;
+	value = strtof(text, &end);
+	return end != text && *end == '\0';
+}
+
+static bool parseInt(const char* text, int& value)
+{
+	char* end = nullptr;
+	value = int(strtol(text, &end, 10));
+	return end != text && *end == '\0';
+}
+
+static void printUsage()
+{
+	printf("To select adapter, use: PerfTest.exe [ADAPTER_INDEX] [--dx11|--vulkan|--cpu] [--headless] [--cpu-decode]\n"
+		   "To select cases, use: [--filter REGEX] [--filter-glob GLOB] [--shard INDEX/COUNT] [--baseline CASE_NAME]\n"
+		   "To sample until the confidence intervals are narrow enough, use: [--ci PERCENT] [--time-budget SECONDS]\n"
+		   "To normalize each case to baseline dispatches around it against clock changes, use: [--stability] [--drift-threshold PERCENT]\n"
+		   "To sweep working set sizes, group shapes, dependent load latency or transfers instead of the fixed cases, use: [--sweep] [--sweep-max SIZE] [--group-sweep] [--latency] [--transfer]\n"
+		   "To measure the CPU and GPU cost of tiny dispatches or multithreaded command recording instead, use: [--dispatch-overhead] [--recording-scaling]\n"
+		   "To measure ALU and bandwidth ceilings of the adapter instead, use: [--roofline] [--roofline-json FILE] [--roofline-svg FILE]\n"
+		   "To save or check results, use: [--json FILE] [--csv FILE] [--compare PREVIOUS_JSON_FILE] [--threshold PERCENT] [--gate either|threshold|significance|both]\n"
+		   "To record a Chrome trace of the frame loop and the GPU queries, use: [--trace FILE]\n\n");
+}
+
+// Groupshared load times relative to the first case of their width, the densest stride. Stride N runs N times slower
+// when every access is an N way bank conflict.
+static void printBankConflicts(const std::vector<CaseResult>& results)
+{
+	const CaseResult* first = nullptr;
+	for (auto&& result : results)
 	{
-		DXGI_ADAPTER_DESC desc;
-		adapter->GetDesc(&desc);
-		printf("%d: %S\n", index++, desc.Description);
+		if (result.series.empty() || result.sweepPoint || result.stats.count == 0)
+			continue;
+
+		if (!first)
+			printf("\nGroupshared bank conflict factors, time relative to the densest access:");
+		if (!first || first->series != result.series)
+		{
+			first = &result;
+			printf("\n%s:", result.series.c_str());
+		}
+		printf(" %s %.2fx", result.name.c_str() + result.series.size() + 1, result.stats.median / first->stats.median);
 	}
+	if (first)
+		printf("\n");
+}
+
+// Every SRV, cbuffer and groupshared load body issues 256 loads of LOAD_WIDTH components per thread. Wave broadcasts
+// load on some lanes only, UAV and atomic cases have their own mix of accesses.
+static void checkKernelLoads(Device& device, const TestCase& test, const std::string& shaderName, CaseResult& result)
+{
+	bool load = test.operation == Operation::Load || test.operation == Operation::SampleLevel ||
+				test.operation == Operation::SampleGrad || test.operation == Operation::Gather;
+	std::vector<unsigned char> bytes;
+	if (!load || test.wave != WaveBroadcast::None || !device.readShaderBinary(shaderName, bytes))
+		return;
+
+	LoadSource source = LoadSource::Resource;
+	if (test.resource == ResourceType::ConstantBuffer)
+		source = LoadSource::ConstantBuffer;
+	else if (test.resource == ResourceType::Groupshared)
+		source = LoadSource::Groupshared;
+
+	ShaderLoads loads;
+	result.expectedLoads = 256;
+	result.expectedComponents = 256 * test.loadWidth;
+	result.loadsCounted = countShaderLoads(bytes.data(), bytes.size(), source, loads);
+	result.foundLoads = loads.loads;
+	result.foundComponents = loads.components;
+}
+
+int main(int argc, char *argv[])
+{
+	auto processStart = std::chrono::steady_clock::now();
+
+	// Backend defaults to DirectX on Windows and Vulkan elsewhere. CPU reference when neither is available.
+#ifdef _WIN32
+	Backend backend = Backend::DirectX11;
+#else
+	Backend backend = isBackendAvailable(Backend::Vulkan) ? Backend::Vulkan : Backend::Cpu;
+#endif
 
 	// Command line index can be used to select adapter
 	int selectedAdapterIdx = 0;
-	if (argc == 2)
+	bool headless = false;
+	bool cpuDecode = false;
+	std::string compareToCase = "Buffer<RGBA8>.Load random";
+	CaseFilter filter;
+	float targetCI = 0.0f;				// Adaptive sampling when set
+	float timeBudgetSeconds = 60.0f;
+	std::string jsonFile, csvFile, compareFile, traceFile;
+	float regressionThreshold = 0.05f;
+	CompareGate compareGate = CompareGate::Either;
+	bool sweep = false;
+	uint64_t sweepMaxBytes = 256 << 20;
+	bool groupSweep = false;
+	bool latency = false;
+	bool transfer = false;
+	bool dispatchOverhead = false;
+	bool recordingScaling = false;
+	bool roofline = false;
+	std::string rooflineJsonFile, rooflineSvgFile;
+	bool stability = false;
+	float driftThreshold = 0.05f;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--dx11") == 0)
+			backend = Backend::DirectX11;
+		else if (strcmp(argv[i], "--vulkan") == 0)
+			backend = Backend::Vulkan;
+		else if (strcmp(argv[i], "--cpu") == 0)
+			backend = Backend::Cpu;
+		else if (strcmp(argv[i], "--headless") == 0)
+			headless = true;
+		else if (strcmp(argv[i], "--cpu-decode") == 0)
+			cpuDecode = true;
+		else if (strcmp(argv[i], "--sweep") == 0)
+			sweep = true;
+		else if (strcmp(argv[i], "--group-sweep") == 0)
+			groupSweep = true;
+		else if (strcmp(argv[i], "--latency") == 0)
+			latency = true;
+		else if (strcmp(argv[i], "--transfer") == 0)
+			transfer = true;
+		else if (strcmp(argv[i], "--dispatch-overhead") == 0)
+			dispatchOverhead = true;
+		else if (strcmp(argv[i], "--recording-scaling") == 0)
+			recordingScaling = true;
+		else if (strcmp(argv[i], "--roofline") == 0)
+			roofline = true;
+		else if (strcmp(argv[i], "--sweep-max") == 0 && i + 1 < argc)
+		{
+			if (!parseSize(argv[++i], sweepMaxBytes) || sweepMaxBytes < 4096)
+			{
+				printf("--sweep-max expects a size of at least 4K, for example --sweep-max 1G\n");
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			filter.setRegex(argv[++i]);
+		else if (strcmp(argv[i], "--filter-glob") == 0 && i + 1 < argc)
+			filter.setGlob(argv[++i]);
+		else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+			compareToCase = argv[++i];
+		else if (strcmp(argv[i], "--ci") == 0 && i + 1 < argc)
+		{
+			if (!parseFloat(argv[++i], targetCI))
+			{
+				printf("--ci expects a number, got %s\n\n", argv[i]);
+				printUsage();
+				return 1;
+			}
+			targetCI /= 100.0f;
+		}
+		else if (strcmp(argv[i], "--time-budget") == 0 && i + 1 < argc)
+		{
+			if (!parseFloat(argv[++i], timeBudgetSeconds))
+			{
+				printf("--time-budget expects a number, got %s\n\n", argv[i]);
+				printUsage();
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--stability") == 0)
+			stability = true;
+		else if (strcmp(argv[i], "--drift-threshold") == 0 && i + 1 < argc)
+		{
+			if (!parseFloat(argv[++i], driftThreshold))
+			{
+				printf("--drift-threshold expects a number, got %s\n\n", argv[i]);
+				printUsage();
+				return 1;
+			}
+			driftThreshold /= 100.0f;
+		}
+		else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+			jsonFile = argv[++i];
+		else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+			csvFile = argv[++i];
+		else if (strcmp(argv[i], "--roofline-json") == 0 && i + 1 < argc)
+			rooflineJsonFile = argv[++i];
+		else if (strcmp(argv[i], "--roofline-svg") == 0 && i + 1 < argc)
+			rooflineSvgFile = argv[++i];
+		else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+			traceFile = argv[++i];
+		else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc)
+			compareFile = argv[++i];
+		else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+		{
+			if (!parseFloat(argv[++i], regressionThreshold))
+			{
+				printf("--threshold expects a number, got %s\n\n", argv[i]);
+				printUsage();
+				return 1;
+			}
+			regressionThreshold /= 100.0f;
+		}
+		else if (strcmp(argv[i], "--gate") == 0 && i + 1 < argc)
+		{
+			const char* gate = argv[++i];
+			if (strcmp(gate, "either") == 0)
+				compareGate = CompareGate::Either;
+			else if (strcmp(gate, "threshold") == 0)
+				compareGate = CompareGate::Threshold;
+			else if (strcmp(gate, "significance") == 0)
+				compareGate = CompareGate::Significance;
+			else if (strcmp(gate, "both") == 0)
+				compareGate = CompareGate::Both;
+			else
+			{
+				printf("--gate expects either, threshold, significance or both, got %s\n\n", gate);
+				printUsage();
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--shard") == 0 && i + 1 < argc)
+		{
+			unsigned shardIndex = 0, shardCount = 0;
+			if (sscanf(argv[++i], "%u/%u", &shardIndex, &shardCount) != 2 || shardIndex >= shardCount)
+			{
+				printf("--shard expects INDEX/COUNT with INDEX < COUNT, for example --shard 0/4\n");
+				return 1;
+			}
+			filter.setShard(shardIndex, shardCount);
+		}
+		else if (!parseInt(argv[i], selectedAdapterIdx))
+		{
+			printf("Unknown argument %s\n\n", argv[i]);
+			printUsage();
+			return 1;
+		}
+	}
+
+	printf("PerfTest\n");
+	printUsage();
+	if (!isBackendAvailable(backend))
 	{
-		selectedAdapterIdx = std::stoi(argv[1]);
-		selectedAdapterIdx = min(max(0, selectedAdapterIdx), (int)adapters.size() - 1);
+		printf("%s backend is not available in this build\n", backendName(backend));
+		return 1;
 	}
+
+	// Enumerate adapters
+	std::vector<std::string> adapters = enumerateAdapters(backend);
+	printf("%s adapters found:\n", backendName(backend));
+	int index = 0;
+	for (auto&& adapter : adapters)
+	{
+		printf("%d: %s\n", index++, adapter.c_str());
+	}
+
+	if (adapters.empty())
+		return 1;
+
+	selectedAdapterIdx = std::min(std::max(0, selectedAdapterIdx), (int)adapters.size() - 1);
 	printf("Using adapter %d\n", selectedAdapterIdx);
 
 	// Init systems
 	uint2 resolution(256, 256);
-	HWND window = createWindow(resolution);
-	DirectXDevice dx(window, resolution, adapters[selectedAdapterIdx]);
-
-	// Load shaders 
-	com_ptr<ID3D11ComputeShader> shaderLoadTyped1dInvariant = loadComputeShader(dx, "shaders/loadTyped1dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTyped1dLinear = loadComputeShader(dx, "shaders/loadTyped1dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTyped1dRandom = loadComputeShader(dx, "shaders/loadTyped1dRandom.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTyped2dInvariant = loadComputeShader(dx, "shaders/loadTyped2dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTyped2dLinear = loadComputeShader(dx, "shaders/loadTyped2dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTyped2dRandom = loadComputeShader(dx, "shaders/loadTyped2dRandom.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTyped4dInvariant = loadComputeShader(dx, "shaders/loadTyped4dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTyped4dLinear = loadComputeShader(dx, "shaders/loadTyped4dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTyped4dRandom = loadComputeShader(dx, "shaders/loadTyped4dRandom.cso");
-
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw1dInvariant = loadComputeShader(dx, "shaders/loadRaw1dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw1dLinear = loadComputeShader(dx, "shaders/loadRaw1dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw1dRandom = loadComputeShader(dx, "shaders/loadRaw1dRandom.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw2dInvariant = loadComputeShader(dx, "shaders/loadRaw2dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw2dLinear = loadComputeShader(dx, "shaders/loadRaw2dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw2dRandom = loadComputeShader(dx, "shaders/loadRaw2dRandom.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw3dInvariant = loadComputeShader(dx, "shaders/loadRaw3dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw3dLinear = loadComputeShader(dx, "shaders/loadRaw3dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw3dRandom = loadComputeShader(dx, "shaders/loadRaw3dRandom.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw4dInvariant = loadComputeShader(dx, "shaders/loadRaw4dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw4dLinear = loadComputeShader(dx, "shaders/loadRaw4dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadRaw4dRandom = loadComputeShader(dx, "shaders/loadRaw4dRandom.cso");
-
-	com_ptr<ID3D11ComputeShader> shaderLoadTex1dInvariant = loadComputeShader(dx, "shaders/loadTex1dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTex1dLinear = loadComputeShader(dx, "shaders/loadTex1dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTex1dRandom = loadComputeShader(dx, "shaders/loadTex1dRandom.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTex2dInvariant = loadComputeShader(dx, "shaders/loadTex2dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTex2dLinear = loadComputeShader(dx, "shaders/loadTex2dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTex2dRandom = loadComputeShader(dx, "shaders/loadTex2dRandom.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTex4dInvariant = loadComputeShader(dx, "shaders/loadTex4dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTex4dLinear = loadComputeShader(dx, "shaders/loadTex4dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadTex4dRandom = loadComputeShader(dx, "shaders/loadTex4dRandom.cso");
-
-	com_ptr<ID3D11ComputeShader> shaderLoadConstant4dInvariant = loadComputeShader(dx, "shaders/loadConstant4dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadConstant4dLinear = loadComputeShader(dx, "shaders/loadConstant4dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadConstant4dRandom = loadComputeShader(dx, "shaders/loadConstant4dRandom.cso");
-
-	com_ptr<ID3D11ComputeShader> shaderLoadStructured1dInvariant = loadComputeShader(dx, "shaders/loadStructured1dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadStructured1dLinear = loadComputeShader(dx, "shaders/loadStructured1dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadStructured1dRandom = loadComputeShader(dx, "shaders/loadStructured1dRandom.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadStructured2dInvariant = loadComputeShader(dx, "shaders/loadStructured2dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadStructured2dLinear = loadComputeShader(dx, "shaders/loadStructured2dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadStructured2dRandom = loadComputeShader(dx, "shaders/loadStructured2dRandom.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadStructured4dInvariant = loadComputeShader(dx, "shaders/loadStructured4dInvariant.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadStructured4dLinear = loadComputeShader(dx, "shaders/loadStructured4dLinear.cso");
-	com_ptr<ID3D11ComputeShader> shaderLoadStructured4dRandom = loadComputeShader(dx, "shaders/loadStructured4dRandom.cso");
-
-	// Create buffers and output UAV
-	com_ptr<ID3D11Buffer> bufferOutput = dx.createBuffer(2048, 4, DirectXDevice::BufferType::ByteAddress);
-	com_ptr<ID3D11Buffer> bufferInput = dx.createBuffer(1024, 16, DirectXDevice::BufferType::ByteAddress);
-	com_ptr<ID3D11Buffer> bufferInputStructured4 = dx.createBuffer(1024, 4, DirectXDevice::BufferType::Structured);
-	com_ptr<ID3D11Buffer> bufferInputStructured8 = dx.createBuffer(1024, 8, DirectXDevice::BufferType::Structured);
-	com_ptr<ID3D11Buffer> bufferInputStructured16 = dx.createBuffer(1024, 16, DirectXDevice::BufferType::Structured);
-	com_ptr<ID3D11UnorderedAccessView> outputUAV = dx.createTypedUAV(bufferOutput, 2048, DXGI_FORMAT_R32_FLOAT);
-
-	// SRVs for benchmarking different buffer view formats/types
-	com_ptr<ID3D11ShaderResourceView> typedSRV_R8 = dx.createTypedSRV(bufferInput, 1024, DXGI_FORMAT_R8_UNORM);
-	com_ptr<ID3D11ShaderResourceView> typedSRV_R16F = dx.createTypedSRV(bufferInput, 1024, DXGI_FORMAT_R16_FLOAT);
-	com_ptr<ID3D11ShaderResourceView> typedSRV_R32F = dx.createTypedSRV(bufferInput, 1024, DXGI_FORMAT_R32_FLOAT);
-	com_ptr<ID3D11ShaderResourceView> typedSRV_RG8 = dx.createTypedSRV(bufferInput, 1024, DXGI_FORMAT_R8G8_UNORM);
-	com_ptr<ID3D11ShaderResourceView> typedSRV_RG16F = dx.createTypedSRV(bufferInput, 1024, DXGI_FORMAT_R16G16_FLOAT);
-	com_ptr<ID3D11ShaderResourceView> typedSRV_RG32F = dx.createTypedSRV(bufferInput, 1024, DXGI_FORMAT_R32G32_FLOAT);
-	com_ptr<ID3D11ShaderResourceView> typedSRV_RGBA8 = dx.createTypedSRV(bufferInput, 1024, DXGI_FORMAT_R8G8B8A8_UNORM);
-	com_ptr<ID3D11ShaderResourceView> typedSRV_RGBA16F = dx.createTypedSRV(bufferInput, 1024, DXGI_FORMAT_R16G16B16A16_FLOAT);
-	com_ptr<ID3D11ShaderResourceView> typedSRV_RGBA32F = dx.createTypedSRV(bufferInput, 1024, DXGI_FORMAT_R32G32B32A32_FLOAT);
-	com_ptr<ID3D11ShaderResourceView> structuredSRV_R32F = dx.createStructuredSRV(bufferInputStructured4, 1024, 4);
-	com_ptr<ID3D11ShaderResourceView> structuredSRV_RG32F = dx.createStructuredSRV(bufferInputStructured8, 1024, 8);
-	com_ptr<ID3D11ShaderResourceView> structuredSRV_RGBA32F = dx.createStructuredSRV(bufferInputStructured16, 1024, 16);
-	com_ptr<ID3D11ShaderResourceView> byteAddressSRV = dx.createByteAddressSRV(bufferInput, 1024);
-
-	// Create input textures
-	com_ptr<ID3D11Texture2D> texR8 = dx.createTexture2d(uint2(32, 32), DXGI_FORMAT_R8_UNORM, 1);
-	com_ptr<ID3D11Texture2D> texR16F = dx.createTexture2d(uint2(32, 32), DXGI_FORMAT_R16_FLOAT, 1);
-	com_ptr<ID3D11Texture2D> texR32F = dx.createTexture2d(uint2(32, 32), DXGI_FORMAT_R32_FLOAT, 1);
-	com_ptr<ID3D11Texture2D> texRG8 = dx.createTexture2d(uint2(32, 32), DXGI_FORMAT_R8G8_UNORM, 1);
-	com_ptr<ID3D11Texture2D> texRG16F = dx.createTexture2d(uint2(32, 32), DXGI_FORMAT_R16G16_FLOAT, 1);
-	com_ptr<ID3D11Texture2D> texRG32F = dx.createTexture2d(uint2(32, 32), DXGI_FORMAT_R32G32_FLOAT, 1);
-	com_ptr<ID3D11Texture2D> texRGBA8 = dx.createTexture2d(uint2(32, 32), DXGI_FORMAT_R8G8B8A8_UNORM, 1);
-	com_ptr<ID3D11Texture2D> texRGBA16F = dx.createTexture2d(uint2(32, 32), DXGI_FORMAT_R16G16B16A16_FLOAT, 1);
-	com_ptr<ID3D11Texture2D> texRGBA32F = dx.createTexture2d(uint2(32, 32), DXGI_FORMAT_R32G32B32A32_FLOAT, 1);
-
-	// Texture SRVs
-	com_ptr<ID3D11ShaderResourceView> texSRV_R8 = dx.createSRV(texR8);
-	com_ptr<ID3D11ShaderResourceView> texSRV_R16F = dx.createSRV(texR16F);
-	com_ptr<ID3D11ShaderResourceView> texSRV_R32F = dx.createSRV(texR32F);
-	com_ptr<ID3D11ShaderResourceView> texSRV_RG8 = dx.createSRV(texRG8);
-	com_ptr<ID3D11ShaderResourceView> texSRV_RG16F = dx.createSRV(texRG16F);
-	com_ptr<ID3D11ShaderResourceView> texSRV_RG32F = dx.createSRV(texRG32F);
-	com_ptr<ID3D11ShaderResourceView> texSRV_RGBA8 = dx.createSRV(texRGBA8);
-	com_ptr<ID3D11ShaderResourceView> texSRV_RGBA16F = dx.createSRV(texRGBA16F);
-	com_ptr<ID3D11ShaderResourceView> texSRV_RGBA32F = dx.createSRV(texRGBA32F);
-
-	// Setup the constant buffer
-	LoadConstants loadConstants;
-	com_ptr<ID3D11Buffer> loadCB = dx.createConstantBuffer(sizeof(LoadConstants));
-	com_ptr<ID3D11Buffer> loadCBUnaligned = dx.createConstantBuffer(sizeof(LoadConstants));
-	loadConstants.elementsMask = 0;				// Dummy mask to prevent unwanted compiler optimizations
-	loadConstants.writeIndex = 0xffffffff;		// Never write
-	loadConstants.readStartAddress = 0;			// Aligned
-	dx.updateConstantBuffer(loadCB, loadConstants);
-	loadConstants.readStartAddress = 4;			// Unaligned
-	dx.updateConstantBuffer(loadCBUnaligned, loadConstants);
-	
-	// Setup constant buffer with float4 array for constant buffer load benchmarking
-	LoadConstantsWithArray loadConstantsWithArray;
-	com_ptr<ID3D11Buffer> loadWithArrayCB = dx.createConstantBuffer(sizeof(LoadConstantsWithArray));
-	loadConstantsWithArray.elementsMask = 0;				// Dummy mask to prevent unwanted compiler optimizations
-	loadConstantsWithArray.writeIndex = 0xffffffff;			// Never write
-	loadConstantsWithArray.readStartAddress = 0;			// Aligned
-	memset(loadConstantsWithArray.benchmarkArray, 0, sizeof(loadConstantsWithArray.benchmarkArray));
-	dx.updateConstantBuffer(loadWithArrayCB, loadConstantsWithArray);
-
-	const unsigned numWarmUpFramesBeforeBenchmark = 30;
-	const unsigned numBenchmarkFrames = 30;
-	const unsigned maxTestCases = 200;
-
-	printf("\nRunning %d warm-up frames and %d benchmark frames:\n", numWarmUpFramesBeforeBenchmark, numBenchmarkFrames);
-
-	struct TestCaseTiming
+	std::unique_ptr<Device> device(createDevice(backend, selectedAdapterIdx, resolution, headless));
+	if (!device)
+		return 1;
+	Device& dx = *device;
+
+	if (!traceFile.empty())
+	{
+		traceStart();
+		if (!dx.calibrateTimestamps())
+			printf("Can't calibrate the %s timestamps, the trace has no GPU timeline\n", backendName(backend));
+	}
+
+	// Pick cases. The baseline case always runs, every shard reports factors against the same case.
+	// The sweeps have their own cases.
+	struct SelectedCase
 	{
 		std::string name;
-		float totalTime;
+		Buffer* cb;
+		ShaderResourceView* source;
+		UnorderedAccessView* target;		// UAV cases access the target instead of the output
+		SamplerState* sampler;
+		unsigned loadBytes;
+		bool atomic;
+		std::string series;
+		const TestCase* test;
 	};
 
-	std::array<TestCaseTiming, maxTestCases> timingResults;
+	TestResources resources(dx);
+	std::vector<SelectedCase> selectedCases;
+	std::vector<std::string> shaderNames;
+	unsigned skippedWaveCases = 0;
+	unsigned skippedUavCases = 0;
+	for (const TestCase& test : testCases())
+	{
+		if (sweep || groupSweep || latency || transfer || dispatchOverhead || recordingScaling || roofline)
+			break;
+
+		std::string name = test.name();
+		bool selected = filter.select(name);
+
+		// D3D11 has no Shader Model 6
+		if (test.wave != WaveBroadcast::None && !dx.supportsWaveIntrinsics())
+		{
+			skippedWaveCases += selected;
+			continue;
+		}
+
+		// Vulkan storage images and texel buffers of narrow formats are optional
+		bool uav = test.operation == Operation::UavLoad || test.operation == Operation::UavStore || test.operation == Operation::UavLoadModifyStore;
+		bool typed = test.resource == ResourceType::TypedBuffer || test.resource == ResourceType::Texture2D;
+		if (uav && typed && !dx.supportsTypedUAV(test.format, test.resource == ResourceType::Texture2D))
+		{
+			skippedUavCases += selected;
+			continue;
+		}
+
+		if (selected || name == compareToCase)
+		{
+			UnorderedAccessView* target = resources.target(test);
+			selectedCases.push_back({ name, resources.constants(test), resources.source(test), target ? target : resources.output(),
+									 resources.sampler(test), test.loadBytes(), test.atomic(), test.series(), &test });
+			shaderNames.push_back(test.shaderName());
+		}
+	}
+	if (skippedWaveCases > 0)
+		printf("Skipping %u wave intrinsic cases, this %s adapter has no wave intrinsics\n", skippedWaveCases, backendName(backend));
+	if (skippedUavCases > 0)
+		printf("Skipping %u UAV cases, this %s adapter has no typed UAVs of their formats\n", skippedUavCases, backendName(backend));
+
+	// Resources are created above on this thread. Shaders and pipelines are created on the loader threads,
+	// the frame loop starts with the first ready case.
+	ShaderLoader loader(dx, shaderNames, [&](unsigned index, ComputeShader* shader)
+	{
+		const SelectedCase& test = selectedCases[index];
+		dx.prepareDispatch(shader, { test.cb }, { test.source }, { test.target }, { test.sampler });
+	});
+	loader.waitForAny();
+	float firstDispatchMillis = 0.0f;
+
+	const unsigned numBenchmarkFrames = 30;		// Samples per case without --ci
+	const unsigned maxSamples = 1000;			// Per case, preallocated. Also limits adaptive sampling.
+	const unsigned adaptiveCheckInterval = 10;	// Frames between confidence interval checks
+
+	std::vector<CaseResult> results;
+	results.reserve(selectedCases.size());
+	for (auto&& test : selectedCases)
+	{
+		results.push_back({ test.name, BenchTest::workloadThreadCount, BenchTest::workloadGroupSize, BenchTest::loadsPerDispatch(), test.loadBytes,
+							SampleBuffer(maxSamples) });
+		if (test.atomic)
+			results.back().rateUnit = "ops";
+		results.back().series = test.series;
+	}
+
+	StatisticsCalculator calculator(maxSamples);
+	std::vector<QueryResult> queryResults;
+
+	// Stability mode brackets every case with two dispatches of the baseline case. Their query ids follow the cases.
+	unsigned referenceIndex = unsigned(selectedCases.size());
+	for (unsigned i = 0; i < selectedCases.size(); ++i)
+	{
+		if (selectedCases[i].name == compareToCase)
+			referenceIndex = i;
+	}
+	if (stability && referenceIndex == selectedCases.size())
+	{
+		if (!selectedCases.empty())
+			printf("Baseline case %s isn't available, running without drift compensation\n", compareToCase.c_str());
+		stability = false;
+	}
+	const unsigned referenceQueryBase = unsigned(selectedCases.size());
+	DriftCompensator drift(unsigned(selectedCases.size()), maxSamples, driftThreshold);
+
+	if (targetCI > 0.0f && !sweep && !groupSweep && !latency && !transfer && !dispatchOverhead && !recordingScaling && !roofline)
+		printf("\nRunning %d cases until the %.0f%% confidence intervals are within %.1f%% of the median or %.0f s have passed:\n",
+			   (int)selectedCases.size(), calculator.confidence() * 100.0f, targetCI * 100.0f, timeBudgetSeconds);
+	else if (!sweep && !groupSweep && !latency && !transfer && !dispatchOverhead && !recordingScaling && !roofline)
+		printf("\nRunning %d cases, warm-up frames until frame times are stable and %d benchmark frames:\n", (int)selectedCases.size(), numBenchmarkFrames);
 
 	// Frame loop
-	MessageStatus status = MessageStatus::Default;
-	unsigned frameNumber = 0;
-	do
+	WarmUpDetector warmUp;
+	bool warmingUp = true;
+	unsigned warmUpFramesChecked = 0;
+	unsigned benchmarkFrames = 0;
+	auto benchmarkStart = std::chrono::steady_clock::now();
+	bool exitRequested = false;
+	bool finished = selectedCases.empty();
+	while (!exitRequested && !finished)
 	{
-		dx.processPerformanceResults([&](float timeMillis, unsigned id, std::string& name)
+		TRACE_SCOPE("Frame");
+
+		// Warm-up starts when every case runs
+		bool loading = !loader.allReady();
+		BenchTest bench(dx);
+		auto dispatchReference = [&](unsigned id)
+		{
+			const SelectedCase& reference = selectedCases[referenceIndex];
+			bench.testCase(id, loader.shader(referenceIndex), reference.cb, reference.source, reference.target, reference.sampler, true);
+		};
+
 		{
-			if (frameNumber >= numWarmUpFramesBeforeBenchmark)
+			TRACE_SCOPE("Record dispatches");
+			for (unsigned i = 0; i < selectedCases.size(); ++i)
 			{
-				if (timingResults[id].name == "")
+				const SelectedCase& test = selectedCases[i];
+				if (!loader.isReady(i))
+					continue;
+
+				if (firstDispatchMillis == 0.0f)
+					firstDispatchMillis = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - processStart).count();
+				if (stability && !loading)
+					dispatchReference(referenceQueryBase + i * 2);
+				bench.testCase(i, loader.shader(i), test.cb, test.source, test.target, test.sampler, !loading);
+				if (stability && !loading)
+					dispatchReference(referenceQueryBase + i * 2 + 1);
+			}
+		}
+
+		{
+			TRACE_SCOPE("Present");
+			dx.presentFrame();
+		}
+
+		// Headless frames have finished at this point. Otherwise this picks up results of earlier frames.
+		{
+			TRACE_SCOPE("Resolve queries");
+			queryResults.clear();
+			dx.processPerformanceResults(queryResults);
+		}
+		for (const QueryResult& queryResult : queryResults)
+		{
+			if (queryResult.id >= referenceQueryBase)
+			{
+				unsigned index = (queryResult.id - referenceQueryBase) / 2;
+				if ((queryResult.id - referenceQueryBase) % 2 == 0)
+					drift.addBefore(index, queryResult.millis);
+				else
+					drift.addAfter(index, queryResult.millis);
+				if (traceEnabled && queryResult.startNanos != 0)
+					traceGpu("Reference", queryResult.startNanos, queryResult.millis);
+				continue;
+			}
+
+			results[queryResult.id].samples.add(queryResult.millis);
+			if (stability)
+				drift.addCase(queryResult.id, queryResult.millis);
+			if (traceEnabled && queryResult.startNanos != 0)
+				traceGpu(selectedCases[queryResult.id].name, queryResult.startNanos, queryResult.millis);
+		}
+
+#ifdef _WIN32
+		if (backend == Backend::DirectX11 && !headless)
+		{
+			TRACE_SCOPE("Message pump");
+			exitRequested = messagePump() == MessageStatus::Exit;
+		}
+#endif
+
+		if (loading)
+		{
+			printf("-");
+			continue;
+		}
+
+		unsigned minSamples = maxSamples;
+		for (auto&& result : results)
+		{
+			minSamples = std::min(minSamples, result.samples.size());
+		}
+
+		if (warmingUp)
+		{
+			// Frame time is the sum of the case times. A frame is complete when every case has reported it.
+			for (; warmingUp && warmUpFramesChecked < minSamples; ++warmUpFramesChecked)
+			{
+				float frameTime = 0.0f;
+				for (auto&& result : results)
 				{
-					timingResults[id] = { name, 0 };
+					frameTime += result.samples[warmUpFramesChecked];
 				}
-				timingResults[id].totalTime += timeMillis;
+				warmingUp = !warmUp.addFrame(frameTime);
 			}
-		});
 
-		BenchTest bench(dx, outputUAV);
-
-		bench.testCase(shaderLoadTyped1dInvariant, loadCB, typedSRV_R8, "Buffer<R8>.Load uniform");
-		bench.testCase(shaderLoadTyped1dLinear, loadCB, typedSRV_R8, "Buffer<R8>.Load linear");
-		bench.testCase(shaderLoadTyped1dRandom, loadCB, typedSRV_R8, "Buffer<R8>.Load random");
-		bench.testCase(shaderLoadTyped2dInvariant, loadCB, typedSRV_RG8, "Buffer<RG8>.Load uniform");
-		bench.testCase(shaderLoadTyped2dLinear, loadCB, typedSRV_RG8, "Buffer<RG8>.Load linear");
-		bench.testCase(shaderLoadTyped2dRandom, loadCB, typedSRV_RG8, "Buffer<RG8>.Load random");
-		bench.testCase(shaderLoadTyped4dInvariant, loadCB, typedSRV_RGBA8, "Buffer<RGBA8>.Load uniform");
-		bench.testCase(shaderLoadTyped4dLinear, loadCB, typedSRV_RGBA8, "Buffer<RGBA8>.Load linear");
-		bench.testCase(shaderLoadTyped4dRandom, loadCB, typedSRV_RGBA8, "Buffer<RGBA8>.Load random");
-
-		bench.testCase(shaderLoadTyped1dInvariant, loadCB, typedSRV_R16F, "Buffer<R16f>.Load uniform");
-		bench.testCase(shaderLoadTyped1dLinear, loadCB, typedSRV_R16F, "Buffer<R16f>.Load linear");
-		bench.testCase(shaderLoadTyped1dRandom, loadCB, typedSRV_R16F, "Buffer<R16f>.Load random");
-		bench.testCase(shaderLoadTyped2dInvariant, loadCB, typedSRV_RG16F, "Buffer<RG16f>.Load uniform");
-		bench.testCase(shaderLoadTyped2dLinear, loadCB, typedSRV_RG16F, "Buffer<RG16f>.Load linear");
-		bench.testCase(shaderLoadTyped2dRandom, loadCB, typedSRV_RG16F, "Buffer<RG16f>.Load random");
-		bench.testCase(shaderLoadTyped4dInvariant, loadCB, typedSRV_RGBA16F, "Buffer<RGBA16f>.Load uniform");
-		bench.testCase(shaderLoadTyped4dLinear, loadCB, typedSRV_RGBA16F, "Buffer<RGBA16f>.Load linear");
-		bench.testCase(shaderLoadTyped4dRandom, loadCB, typedSRV_RGBA16F, "Buffer<RGBA16f>.Load random");
-
-		bench.testCase(shaderLoadTyped1dInvariant, loadCB, typedSRV_R32F, "Buffer<R32f>.Load uniform");
-		bench.testCase(shaderLoadTyped1dLinear, loadCB, typedSRV_R32F, "Buffer<R32f>.Load linear");
-		bench.testCase(shaderLoadTyped1dRandom, loadCB, typedSRV_R32F, "Buffer<R32f>.Load random");
-		bench.testCase(shaderLoadTyped2dInvariant, loadCB, typedSRV_RG32F, "Buffer<RG32f>.Load uniform");
-		bench.testCase(shaderLoadTyped2dLinear, loadCB, typedSRV_RG32F, "Buffer<RG32f>.Load linear");
-		bench.testCase(shaderLoadTyped2dRandom, loadCB, typedSRV_RG32F, "Buffer<RG32f>.Load random");
-		bench.testCase(shaderLoadTyped4dInvariant, loadCB, typedSRV_RGBA32F, "Buffer<RGBA32f>.Load uniform");
-		bench.testCase(shaderLoadTyped4dLinear, loadCB, typedSRV_RGBA32F, "Buffer<RGBA32f>.Load linear");
-		bench.testCase(shaderLoadTyped4dRandom, loadCB, typedSRV_RGBA32F, "Buffer<RGBA32f>.Load random");
-
-		bench.testCase(shaderLoadRaw1dInvariant, loadCB, byteAddressSRV, "ByteAddressBuffer.Load uniform");
-		bench.testCase(shaderLoadRaw1dLinear, loadCB, byteAddressSRV, "ByteAddressBuffer.Load linear");
-		bench.testCase(shaderLoadRaw1dRandom, loadCB, byteAddressSRV, "ByteAddressBuffer.Load random");
-		bench.testCase(shaderLoadRaw2dInvariant, loadCB, byteAddressSRV, "ByteAddressBuffer.Load2 uniform");
-		bench.testCase(shaderLoadRaw2dLinear, loadCB, byteAddressSRV, "ByteAddressBuffer.Load2 linear");
-		bench.testCase(shaderLoadRaw2dRandom, loadCB, byteAddressSRV, "ByteAddressBuffer.Load2 random");
-		bench.testCase(shaderLoadRaw3dInvariant, loadCB, byteAddressSRV, "ByteAddressBuffer.Load3 uniform");
-		bench.testCase(shaderLoadRaw3dLinear, loadCB, byteAddressSRV, "ByteAddressBuffer.Load3 linear");
-		bench.testCase(shaderLoadRaw3dRandom, loadCB, byteAddressSRV, "ByteAddressBuffer.Load3 random");
-		bench.testCase(shaderLoadRaw4dInvariant, loadCB, byteAddressSRV, "ByteAddressBuffer.Load4 uniform");
-		bench.testCase(shaderLoadRaw4dLinear, loadCB, byteAddressSRV, "ByteAddressBuffer.Load4 linear");
-		bench.testCase(shaderLoadRaw4dRandom, loadCB, byteAddressSRV, "ByteAddressBuffer.Load4 random");
-
-		bench.testCase(shaderLoadRaw2dInvariant, loadCBUnaligned, byteAddressSRV, "ByteAddressBuffer.Load2 unaligned uniform");
-		bench.testCase(shaderLoadRaw2dLinear, loadCBUnaligned, byteAddressSRV, "ByteAddressBuffer.Load2 unaligned linear");
-		bench.testCase(shaderLoadRaw2dRandom, loadCBUnaligned, byteAddressSRV, "ByteAddressBuffer.Load2 unaligned random");
-		bench.testCase(shaderLoadRaw4dInvariant, loadCBUnaligned, byteAddressSRV, "ByteAddressBuffer.Load4 unaligned uniform");
-		bench.testCase(shaderLoadRaw4dLinear, loadCBUnaligned, byteAddressSRV, "ByteAddressBuffer.Load4 unaligned linear");
-		bench.testCase(shaderLoadRaw4dRandom, loadCBUnaligned, byteAddressSRV, "ByteAddressBuffer.Load4 unaligned random");
-
-		bench.testCase(shaderLoadStructured1dInvariant, loadCB, structuredSRV_R32F, "StructuredBuffer<float>.Load uniform");
-		bench.testCase(shaderLoadStructured1dLinear, loadCB, structuredSRV_R32F, "StructuredBuffer<float>.Load linear");
-		bench.testCase(shaderLoadStructured1dRandom, loadCB, structuredSRV_R32F, "StructuredBuffer<float>.Load random");
-		bench.testCase(shaderLoadStructured2dInvariant, loadCB, structuredSRV_RG32F, "StructuredBuffer<float2>.Load uniform");
-		bench.testCase(shaderLoadStructured2dLinear, loadCB, structuredSRV_RG32F, "StructuredBuffer<float2>.Load linear");
-		bench.testCase(shaderLoadStructured2dRandom, loadCB, structuredSRV_RG32F, "StructuredBuffer<float2>.Load random");
-		bench.testCase(shaderLoadStructured4dInvariant, loadCB, structuredSRV_RGBA32F, "StructuredBuffer<float4>.Load uniform");
-		bench.testCase(shaderLoadStructured4dLinear, loadCB, structuredSRV_RGBA32F, "StructuredBuffer<float4>.Load linear");
-		bench.testCase(shaderLoadStructured4dRandom, loadCB, structuredSRV_RGBA32F, "StructuredBuffer<float4>.Load random");
-
-		bench.testCase(shaderLoadConstant4dInvariant, loadWithArrayCB, nullptr, "cbuffer{float4} load uniform");
-		bench.testCase(shaderLoadConstant4dLinear, loadWithArrayCB, nullptr, "cbuffer{float4} load linear");
-		bench.testCase(shaderLoadConstant4dRandom, loadWithArrayCB, nullptr, "cbuffer{float4} load random");
-
-		bench.testCase(shaderLoadTex1dInvariant, loadCB, texSRV_R8, "Texture2D<R8>.Load uniform");
-		bench.testCase(shaderLoadTex1dLinear, loadCB, texSRV_R8, "Texture2D<R8>.Load linear");
-		bench.testCase(shaderLoadTex1dRandom, loadCB, texSRV_R8, "Texture2D<R8>.Load random");
-		bench.testCase(shaderLoadTex2dInvariant, loadCB, texSRV_RG8, "Texture2D<RG8>.Load uniform");
-		bench.testCase(shaderLoadTex2dLinear, loadCB, texSRV_RG8, "Texture2D<RG8>.Load linear");
-		bench.testCase(shaderLoadTex2dRandom, loadCB, texSRV_RG8, "Texture2D<RG8>.Load random");
-		bench.testCase(shaderLoadTex4dInvariant, loadCB, texSRV_RGBA8, "Texture2D<RGBA8>.Load uniform");
-		bench.testCase(shaderLoadTex4dLinear, loadCB, texSRV_RGBA8, "Texture2D<RGBA8>.Load linear");
-		bench.testCase(shaderLoadTex4dRandom, loadCB, texSRV_RGBA8, "Texture2D<RGBA8>.Load random");
-
-		bench.testCase(shaderLoadTex1dInvariant, loadCB, texSRV_R16F, "Texture2D<R16F>.Load uniform");
-		bench.testCase(shaderLoadTex1dLinear, loadCB, texSRV_R16F, "Texture2D<R16F>.Load linear");
-		bench.testCase(shaderLoadTex1dRandom, loadCB, texSRV_R16F, "Texture2D<R16F>.Load random");
-		bench.testCase(shaderLoadTex2dInvariant, loadCB, texSRV_RG16F, "Texture2D<RG16F>.Load uniform");
-		bench.testCase(shaderLoadTex2dLinear, loadCB, texSRV_RG16F, "Texture2D<RG16F>.Load linear");
-		bench.testCase(shaderLoadTex2dRandom, loadCB, texSRV_RG16F, "Texture2D<RG16F>.Load random");
-		bench.testCase(shaderLoadTex4dInvariant, loadCB, texSRV_RGBA16F, "Texture2D<RGBA16F>.Load uniform");
-		bench.testCase(shaderLoadTex4dLinear, loadCB, texSRV_RGBA16F, "Texture2D<RGBA16F>.Load linear");
-		bench.testCase(shaderLoadTex4dRandom, loadCB, texSRV_RGBA16F, "Texture2D<RGBA16F>.Load random");
-
-		bench.testCase(shaderLoadTex1dInvariant, loadCB, texSRV_R32F, "Texture2D<R32F>.Load uniform");
-		bench.testCase(shaderLoadTex1dLinear, loadCB, texSRV_R32F, "Texture2D<R32F>.Load linear");
-		bench.testCase(shaderLoadTex1dRandom, loadCB, texSRV_R32F, "Texture2D<R32F>.Load random");
-		bench.testCase(shaderLoadTex2dInvariant, loadCB, texSRV_RG32F, "Texture2D<RG32F>.Load uniform");
-		bench.testCase(shaderLoadTex2dLinear, loadCB, texSRV_RG32F, "Texture2D<RG32F>.Load linear");
-		bench.testCase(shaderLoadTex2dRandom, loadCB, texSRV_RG32F, "Texture2D<RG32F>.Load random");
-		bench.testCase(shaderLoadTex4dInvariant, loadCB, texSRV_RGBA32F, "Texture2D<RGBA32F>.Load uniform");
-		bench.testCase(shaderLoadTex4dLinear, loadCB, texSRV_RGBA32F, "Texture2D<RGBA32F>.Load linear");
-		bench.testCase(shaderLoadTex4dRandom, loadCB, texSRV_RGBA32F, "Texture2D<RGBA32F>.Load random");
-
-		dx.presentFrame();
-
-		status = messagePump();
-
-		frameNumber++;
-		if (frameNumber < numWarmUpFramesBeforeBenchmark)
-		{
+			if (!warmingUp)
+			{
+				for (auto&& result : results)
+				{
+					result.samples.clear();
+				}
+				drift.clear();
+				benchmarkStart = std::chrono::steady_clock::now();
+			}
 			printf(".");
+			continue;
 		}
-		else
+
+		benchmarkFrames++;
+		printf("X");
+
+		if (targetCI <= 0.0f)
 		{
-			printf("X");
+			finished = minSamples >= numBenchmarkFrames;
+		}
+		else if (benchmarkFrames % adaptiveCheckInterval == 0 && minSamples > 0)
+		{
+			bool converged = true;
+			for (auto&& result : results)
+			{
+				if (calculator.compute(result.samples).relativeCI() > targetCI)
+				{
+					converged = false;
+					break;
+				}
+			}
+
+			float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - benchmarkStart).count();
+			finished = converged || elapsed >= timeBudgetSeconds || minSamples == maxSamples;
 		}
 	}
-	while (status != MessageStatus::Exit && frameNumber < numBenchmarkFrames + numWarmUpFramesBeforeBenchmark);
 
-	// Find comparison case
-	float compareToTime = 1.0f;
-	std::string compareToCase = "Buffer<RGBA8>.Load random";
-	printf("\n\nPerformance compared to %s\n\n", compareToCase.c_str());
-	for (auto&& row : timingResults)
+	// Samples of the frame loop are replaced by the drift compensated ones, in ms of the median reference
+	float referenceMillis = drift.referenceMedian();
+	if (stability)
+	{
+		for (unsigned i = 0; i < selectedCases.size(); ++i)
+		{
+			results[i].samples = drift.normalized(i, referenceMillis);
+		}
+	}
+
+	// Still loading when exit was requested during warm-up
+	float shaderLoadMillis = loader.allReady() ? loader.loadMillis() : 0.0f;
+	if (!selectedCases.empty())
+	{
+		printf("\n%d warm-up frames, %d benchmark frames", (int)warmUp.frames(), (int)benchmarkFrames);
+		printf("\nStartup: first dispatch after %.1f ms, %u shaders ready after %.1f ms on %u threads",
+			   firstDispatchMillis, loader.uniqueShaders(), shaderLoadMillis, loader.threads());
+	}
+
+	if (sweep && !exitRequested)
+	{
+		printf("\nSweeping working sets from 4KB to %s, %d benchmark frames per size:\n", sizeName(sweepMaxBytes).c_str(), numBenchmarkFrames);
+
+		runWorkingSetSweep(dx, sweepMaxBytes, 2, numBenchmarkFrames, [&](const std::string& name)
+		{
+			return filter.select(name);
+		}, results);
+	}
+
+	if (groupSweep && !exitRequested)
+	{
+		printf("\nSweeping group shapes from 32 to 1024 threads and dispatches from 32K to 1M threads, %d benchmark frames per point:\n",
+			   numBenchmarkFrames);
+
+		runGroupShapeSweep(dx, 2, numBenchmarkFrames, [&](const std::string& name)
+		{
+			return filter.select(name);
+		}, results);
+	}
+
+	if (latency && !exitRequested)
+	{
+		printf("\nChasing pointers through working sets from 4KB to %s, %d benchmark frames per size:\n", sizeName(sweepMaxBytes).c_str(),
+			   numBenchmarkFrames);
+
+		runLatencySweep(dx, sweepMaxBytes, 2, numBenchmarkFrames, [&](const std::string& name)
+		{
+			return filter.select(name);
+		}, results);
+	}
+
+	if (transfer && !exitRequested)
+	{
+		printf("\nTransferring 64B to %s, %d benchmark frames per size:\n", sizeName(sweepMaxBytes).c_str(), numBenchmarkFrames);
+
+		runTransferSuite(dx, sweepMaxBytes, 2, numBenchmarkFrames, [&](const std::string& name)
+		{
+			return filter.select(name);
+		}, results);
+	}
+
+	if (dispatchOverhead && !exitRequested)
+	{
+		printf("\nDispatching single groups, %d benchmark frames of 1000 dispatches per case:\n", numBenchmarkFrames);
+
+		runDispatchOverhead(dx, 2, numBenchmarkFrames, [&](const std::string& name)
+		{
+			return filter.select(name);
+		}, results);
+	}
+
+	if (recordingScaling && !exitRequested)
+	{
+		printf("\nRecording 1024 dispatches on 1 to %u threads, %d benchmark frames per thread count:\n",
+			   std::max(std::thread::hardware_concurrency(), 1u), numBenchmarkFrames);
+
+		runRecordingScaling(dx, 2, numBenchmarkFrames, [&](const std::string& name)
+		{
+			return filter.select(name);
+		}, results);
+	}
+
+	if (roofline && !exitRequested)
+	{
+		printf("\nMeasuring ALU ceilings and float4 load bandwidth from 4KB to %s, %d benchmark frames per point:\n",
+			   sizeName(sweepMaxBytes).c_str(), numBenchmarkFrames);
+
+		runRoofline(dx, sweepMaxBytes, 2, numBenchmarkFrames, [&](const std::string& name)
+		{
+			return filter.select(name);
+		}, results);
+	}
+
+	// CPU decode cases go to the same table. Timed on the CPU, a single warm-up run is enough.
+	if (cpuDecode && !exitRequested)
+	{
+		printf("\n\nRunning CPU decode cases:\n");
+
+		runCpuDecodeSuite(1, numBenchmarkFrames, [&](const std::string& name)
+		{
+			return filter.select(name) || name == compareToCase;
+		},
+		[&](const std::string& name, const float* samples, unsigned numSamples, double loadsPerRun, unsigned loadBytes)
+		{
+			results.push_back({ name, uint3(), uint3(), loadsPerRun, loadBytes, SampleBuffer(numSamples) });
+			for (unsigned i = 0; i < numSamples; ++i)
+			{
+				results.back().samples.add(samples[i]);
+			}
+			printf("X");
+		});
+	}
+
+	for (auto&& result : results)
+	{
+		result.stats = calculator.compute(result.samples);
+	}
+
+	// Merged or removed loads make a case look faster than it is
+	for (unsigned i = 0; i < selectedCases.size(); ++i)
 	{
-		if (row.name == compareToCase)
+		checkKernelLoads(dx, *selectedCases[i].test, shaderNames[i], results[i]);
+	}
+
+	// Find comparison case. Cases are compared by load rate of the median, CPU cases run fewer loads than a dispatch.
+	double compareToRate = 1.0;
+	bool compareToFound = false;
+	for (auto&& result : results)
+	{
+		if (result.name == compareToCase && result.stats.count > 0)
 		{
-			compareToTime = row.totalTime;
+			compareToRate = result.loadsPerRun / result.stats.median;
+			compareToFound = true;
 			break;
 		}
 	}
 
-	// Print results
-	for (auto&& row : timingResults)
+	if (compareToFound)
+		printf("\n\nPerformance compared to %s\n\n", compareToCase.c_str());
+	else if (sweep || groupSweep || latency || transfer || dispatchOverhead || recordingScaling || roofline)
+		printf("\n\nPerformance compared to the first point of each sweep series\n\n");
+	else
+		printf("\n\nBaseline case %s did not run, factors are relative to 1 load/ms\n\n", compareToCase.c_str());
+
+	// Sweep points are relative to the first point of their series
+	double seriesRate = 1.0;
+	const std::string* series = nullptr;
+	for (auto&& result : results)
+	{
+		if (result.stats.count == 0)
+			continue;
+
+		double rate = result.loadsPerRun / result.stats.median;
+		if (!result.sweepPoint)
+		{
+			result.relative = rate / compareToRate;
+			continue;
+		}
+
+		if (!series || *series != result.series)
+		{
+			series = &result.series;
+			seriesRate = rate;
+		}
+		result.relative = rate / seriesRate;
+	}
+
+	// Print results. Times are the median of the samples.
+	for (auto&& result : results)
+	{
+		const SampleStatistics& stats = result.stats;
+		if (stats.count == 0)
+		{
+			printf("%s: no samples\n", result.name.c_str());
+			continue;
+		}
+
+		// Loads per thread found in the compiled kernel and in the shader source
+		char loads[96] = "";
+		if (result.expectedLoads > 0 && !result.loadsCounted)
+			snprintf(loads, sizeof(loads), " loads not counted");
+		else if (result.expectedLoads > 0)
+			snprintf(loads, sizeof(loads), " loads %u/%u components %u/%u%s", result.foundLoads, result.expectedLoads,
+					 result.foundComponents, result.expectedComponents, result.loadsMissing() ? " MISSING" : "");
+
+		double elementsPerNs = result.elementsPerNs();
+		printf("%s: %.3fms %.3fx %.3f %s/ns %.3f GB/s (min %.3f p90 %.3f p99 %.3f stddev %.3f, %.0f%% CI %.3f-%.3f, %u samples)%s\n",
+			   result.name.c_str(), stats.median, result.relative, elementsPerNs, result.rateUnit, elementsPerNs * result.loadBytes,
+			   stats.min, stats.p90, stats.p99, stats.stddev, calculator.confidence() * 100.0f, stats.ciLow, stats.ciHigh, stats.count, loads);
+	}
+
+	unsigned missingLoads = unsigned(std::count_if(results.begin(), results.end(), [](const CaseResult& result) { return result.loadsMissing(); }));
+	if (missingLoads > 0)
+		printf("\nWarning: the compiled kernels of %u cases have fewer loads than the shader source (MISSING above), "
+			   "the compiler merged or removed them and their rates aren't comparable\n", missingLoads);
+
+	if (sweep)
+	{
+		printf("\nWorking set sweep, GB/s:");
+		printSweepCurves(results);
+	}
+	if (groupSweep)
+	{
+		printf("\nGroup shape sweep, rows are group shapes, columns are dispatch sizes:");
+		printGroupShapeHeatmaps(results);
+	}
+	if (latency)
+	{
+		printf("\nDependent load latency, ns per load:");
+		printLatencyCurves(results);
+	}
+	if (transfer)
+	{
+		printf("\nTransfers, median time and GB/s per size:");
+		printTransferCurves(results);
+	}
+	if (dispatchOverhead)
+	{
+		printf("\nDispatch overhead, ns per dispatch:");
+		printDispatchOverhead(results);
+	}
+	if (recordingScaling)
+	{
+		printf("\nCommand recording scaling, threads: ns per dispatch, speedup and efficiency:");
+		printRecordingScaling(results);
+	}
+	if (roofline)
+	{
+		printf("\nRoofline:");
+		printRoofline(results);
+	}
+	printBankConflicts(results);
+
+	if (stability)
+	{
+		printf("\nDrift compensated against %s dispatches around each case, median reference %.3f ms\n", compareToCase.c_str(), referenceMillis);
+		for (unsigned i = 0; i < selectedCases.size(); ++i)
+		{
+			if (drift.driftedFrames(i) > 0)
+				printf("Warning: the reference drifted more than %.1f%% around %s in %u of %u frames (max %.1f%%)\n", drift.threshold() * 100.0f,
+					   selectedCases[i].name.c_str(), drift.driftedFrames(i), drift.frames(i), drift.maxDrift(i) * 100.0f);
+		}
+	}
+
+	RunInfo info = { backendName(backend), adapters[selectedAdapterIdx], dx.driverVersion(), compareToCase, calculator.confidence(),
+					  firstDispatchMillis, shaderLoadMillis };
+	if (!jsonFile.empty() && !writeResultsJson(jsonFile, info, results))
+	{
+		printf("Can't write %s\n", jsonFile.c_str());
+		return 1;
+	}
+	if (!csvFile.empty() && !writeResultsCsv(csvFile, info, results))
+	{
+		printf("Can't write %s\n", csvFile.c_str());
+		return 1;
+	}
+	if (roofline && !rooflineJsonFile.empty() && !writeRooflineJson(rooflineJsonFile, adapters[selectedAdapterIdx], results))
+	{
+		printf("Can't write %s\n", rooflineJsonFile.c_str());
+		return 1;
+	}
+	if (roofline && !rooflineSvgFile.empty() && !writeRooflineSvg(rooflineSvgFile, adapters[selectedAdapterIdx], results))
+	{
+		printf("Can't write %s\n", rooflineSvgFile.c_str());
+		return 1;
+	}
+	if (!traceFile.empty() && !writeTrace(traceFile))
+	{
+		printf("Can't write %s\n", traceFile.c_str());
+		return 1;
+	}
+
+	// Exit code 2 on regressions, nightly jobs gate on it
+	if (!compareFile.empty())
 	{
-		if (row.name == "") break;
-		printf("%s: %.3fms %.3fx\n", row.name.c_str(), row.totalTime, compareToTime / row.totalTime);
+		int regressions = compareResults(compareFile, results, regressionThreshold, compareGate);
+		if (regressions < 0)
+			return 1;
+		if (regressions > 0)
+			return 2;
 	}
 
 	return 0;
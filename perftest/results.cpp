@@ -0,0 +1,228 @@
+#include "results.h"
+#include "json.h"
+#include <stdio.h>
+#include <math.h>
+#include <map>
+
+static FILE* openFile(const std::string& filename, const char* mode)
+{
+	FILE* f = nullptr;
+#ifdef _MSC_VER
+	fopen_s(&f, filename.c_str(), mode);
+#else
+	f = fopen(filename.c_str(), mode);
+#endif
+	return f;
+}
+
+bool writeResultsJson(const std::string& filename, const RunInfo& info, const std::vector<CaseResult>& results)
+{
+	FILE* f = openFile(filename, "w");
+	if (!f)
+		return false;
+
+	fprintf(f, "{\n");
+	fprintf(f, "\t\"backend\": %s,\n", jsonString(info.backend).c_str());
+	fprintf(f, "\t\"adapter\": %s,\n", jsonString(info.adapter).c_str());
+	fprintf(f, "\t\"driverVersion\": %s,\n", jsonString(info.driverVersion).c_str());
+	fprintf(f, "\t\"baseline\": %s,\n", jsonString(info.baseline).c_str());
+	fprintf(f, "\t\"confidence\": %g,\n", info.confidence);
+	fprintf(f, "\t\"timeToFirstDispatchMs\": %g,\n", info.firstDispatchMillis);
+	fprintf(f, "\t\"shaderLoadMs\": %g,\n", info.shaderLoadMillis);
+	fprintf(f, "\t\"cases\": [");
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const CaseResult& result = results[i];
+		const SampleStatistics& stats = result.stats;
+
+		// Times in ms
+		fprintf(f, "%s\n\t\t{\n", i ? "," : "");
+		fprintf(f, "\t\t\t\"name\": %s,\n", jsonString(result.name).c_str());
+		fprintf(f, "\t\t\t\"threads\": [%u, %u, %u],\n", result.threads.x, result.threads.y, result.threads.z);
+		fprintf(f, "\t\t\t\"groupSize\": [%u, %u, %u],\n", result.groupSize.x, result.groupSize.y, result.groupSize.z);
+		fprintf(f, "\t\t\t\"series\": %s,\n", jsonString(result.series).c_str());
+		fprintf(f, "\t\t\t\"workingSetBytes\": %llu,\n", (unsigned long long)result.workingSetBytes);
+		fprintf(f, "\t\t\t\"loadsPerRun\": %.17g,\n", result.loadsPerRun);
+		fprintf(f, "\t\t\t\"loadBytes\": %u,\n", result.loadBytes);
+		fprintf(f, "\t\t\t\"count\": %u,\n", stats.count);
+		fprintf(f, "\t\t\t\"median\": %.9g,\n", stats.median);
+		fprintf(f, "\t\t\t\"min\": %.9g,\n", stats.min);
+		fprintf(f, "\t\t\t\"mean\": %.9g,\n", stats.mean);
+		fprintf(f, "\t\t\t\"p90\": %.9g,\n", stats.p90);
+		fprintf(f, "\t\t\t\"p99\": %.9g,\n", stats.p99);
+		fprintf(f, "\t\t\t\"stddev\": %.9g,\n", stats.stddev);
+		fprintf(f, "\t\t\t\"ciLow\": %.9g,\n", stats.ciLow);
+		fprintf(f, "\t\t\t\"ciHigh\": %.9g,\n", stats.ciHigh);
+		fprintf(f, "\t\t\t\"relative\": %.9g,\n", result.relative);
+		fprintf(f, "\t\t\t\"elementsPerNs\": %.9g,\n", result.elementsPerNs());
+		fprintf(f, "\t\t\t\"gigabytesPerSecond\": %.9g,\n", result.elementsPerNs() * result.loadBytes);
+		fprintf(f, "\t\t\t\"samples\": [");
+		for (unsigned s = 0; s < result.samples.size(); ++s)
+		{
+			fprintf(f, "%s%.9g", s ? ", " : "", result.samples[s]);
+		}
+		fprintf(f, "]\n\t\t}");
+	}
+
+	fprintf(f, "\n\t]\n}\n");
+	bool ok = ferror(f) == 0;
+	fclose(f);
+	return ok;
+}
+
+// Quoted when it contains separators or quotes
+static std::string csvField(const std::string& text)
+{
+	if (text.find_first_of(",\"\n\r") == std::string::npos)
+		return text;
+
+	std::string out = "\"";
+	for (char c : text)
+	{
+		if (c == '"')
+			out += '"';
+		out += c;
+	}
+	return out + "\"";
+}
+
+bool writeResultsCsv(const std::string& filename, const RunInfo& info, const std::vector<CaseResult>& results)
+{
+	FILE* f = openFile(filename, "w");
+	if (!f)
+		return false;
+
+	// Run info is repeated per row, every row stands alone when files are concatenated
+	fprintf(f, "backend,adapter,driver_version,baseline,name,threads_x,threads_y,threads_z,group_x,group_y,group_z,"
+			   "series,working_set_bytes,loads_per_run,load_bytes,samples,median_ms,min_ms,mean_ms,p90_ms,p99_ms,stddev_ms,ci_low_ms,ci_high_ms,"
+			   "relative,elements_per_ns,gb_per_s\n");
+
+	std::string runFields = csvField(info.backend) + "," + csvField(info.adapter) + "," + csvField(info.driverVersion) + "," + csvField(info.baseline);
+	for (const CaseResult& result : results)
+	{
+		const SampleStatistics& stats = result.stats;
+		fprintf(f, "%s,%s,%u,%u,%u,%u,%u,%u,%s,%llu,%.17g,%u,%u,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g\n",
+				runFields.c_str(), csvField(result.name).c_str(),
+				result.threads.x, result.threads.y, result.threads.z, result.groupSize.x, result.groupSize.y, result.groupSize.z,
+				csvField(result.series).c_str(), (unsigned long long)result.workingSetBytes, result.loadsPerRun, result.loadBytes,
+				stats.count, stats.median, stats.min, stats.mean, stats.p90, stats.p99, stats.stddev, stats.ciLow, stats.ciHigh, result.relative, result.elementsPerNs(), result.elementsPerNs() * result.loadBytes);
+	}
+
+	bool ok = ferror(f) == 0;
+	fclose(f);
+	return ok;
+}
+
+struct PreviousResult
+{
+	double median;
+	double ciLow;
+	double ciHigh;
+};
+
+static bool loadPreviousResults(const std::string& filename, std::map<std::string, PreviousResult>& out)
+{
+	FILE* f = openFile(filename, "rb");
+	if (!f)
+		return false;
+
+	std::string text;
+	char buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), f)) > 0)
+	{
+		text.append(buffer, read);
+	}
+	fclose(f);
+
+	JsonValue root;
+	if (!parseJson(text, root))
+		return false;
+
+	const JsonValue* cases = root.find("cases");
+	if (!cases || cases->type != JsonValue::Type::Array)
+		return false;
+
+	for (const JsonValue& value : cases->elements)
+	{
+		const JsonValue* name = value.find("name");
+		const JsonValue* median = value.find("median");
+		const JsonValue* ciLow = value.find("ciLow");
+		const JsonValue* ciHigh = value.find("ciHigh");
+		if (!name || !median || !ciLow || !ciHigh)
+			return false;
+
+		out[name->string] = { median->number, ciLow->number, ciHigh->number };
+	}
+	return true;
+}
+
+static const char* gateName(CompareGate gate)
+{
+	switch (gate)
+	{
+	case CompareGate::Either: return "threshold or significance";
+	case CompareGate::Threshold: return "threshold";
+	case CompareGate::Significance: return "significance";
+	case CompareGate::Both: return "threshold and significance";
+	}
+	return "";
+}
+
+// Beyond the threshold and significant in one direction
+static bool passesGate(bool beyondThreshold, bool significant, CompareGate gate)
+{
+	switch (gate)
+	{
+	case CompareGate::Either: return beyondThreshold || significant;
+	case CompareGate::Threshold: return beyondThreshold;
+	case CompareGate::Significance: return significant;
+	case CompareGate::Both: return beyondThreshold && significant;
+	}
+	return false;
+}
+
+int compareResults(const std::string& filename, const std::vector<CaseResult>& results, float threshold, CompareGate gate)
+{
+	std::map<std::string, PreviousResult> previous;
+	if (!loadPreviousResults(filename, previous))
+	{
+		printf("\nCan't read results to compare against from %s\n", filename.c_str());
+		return -1;
+	}
+
+	printf("\nCompared to %s, regression threshold %.1f%%, gate %s:\n\n", filename.c_str(), threshold * 100.0f, gateName(gate));
+
+	int regressions = 0, improvements = 0, missing = 0;
+	for (const CaseResult& result : results)
+	{
+		auto it = previous.find(result.name);
+		if (it == previous.end() || result.stats.count == 0 || it->second.median <= 0.0)
+		{
+			missing++;
+			continue;
+		}
+
+		// Significant when the confidence intervals of the medians are disjoint
+		const PreviousResult& before = it->second;
+		const SampleStatistics& now = result.stats;
+		double change = now.median / before.median - 1.0;
+		bool slower = change > 0.0 && passesGate(change > threshold, now.ciLow > before.ciHigh, gate);
+		bool faster = change < 0.0 && passesGate(-change > threshold, now.ciHigh < before.ciLow, gate);
+
+		if (slower)
+			regressions++;
+		if (faster)
+			improvements++;
+
+		if (slower || faster)
+		{
+			printf("%s %s: %.3fms -> %.3fms (%+.1f%%)\n", slower ? "REGRESSION" : "improvement", result.name.c_str(),
+				   before.median, now.median, change * 100.0);
+		}
+	}
+
+	printf("\n%d regressions, %d improvements, %d cases without previous results\n", regressions, improvements, missing);
+	return regressions;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "datatypes.h"
+#include "statistics.h"
+#include <string>
+#include <vector>
+
+struct CaseResult
+{
+	std::string name;
+	uint3 threads;				// Dispatch shape, zero for CPU decode cases
+	uint3 groupSize;
+	double loadsPerRun;
+	unsigned loadBytes;
+	SampleBuffer samples;
+	SampleStatistics stats;
+	double relative = 0.0;		// Load rate relative to the baseline case. Sweeps: to the first point of the series.
+	std::string series;			// Sweeps: case without the point. Groupshared loads: cases of one width.
+	bool sweepPoint = false;	// Working set, group shape, latency, transfer or dispatch overhead series
+	bool latency = false;		// Dependent loads of a single thread, reported in ns per load
+	bool transfer = false;		// Upload or readback, loads are bytes
+	bool overhead = false;		// Dispatch overhead, loads are dispatches
+	bool alu = false;			// Roofline compute ceiling, loads are ALU ops
+	unsigned recordingThreads = 0;	// Command recording scaling, threads recording command lists
+	uint64_t workingSetBytes = 0;
+	const char* rateUnit = "elements";		// Loads are elements, atomic cases count ops
+
+	// Loads per thread in the compiled kernel (shaderAnalysis.h) against the shader source. Zero expected when not checked.
+	unsigned expectedLoads = 0;
+	unsigned expectedComponents = 0;
+	unsigned foundLoads = 0;
+	unsigned foundComponents = 0;
+	bool loadsCounted = false;		// The kernel could be analyzed
+
+	// Of the median, bytes per ns is GB/s
+	double elementsPerNs() const { return stats.median > 0.0f ? loadsPerRun / (double(stats.median) * 1e6) : 0.0; }
+
+	// The compiler merged or removed loads, the rate isn't comparable
+	bool loadsMissing() const { return loadsCounted && (foundLoads < expectedLoads || foundComponents < expectedComponents); }
+};
+
+// Where the results come from, written with them
+struct RunInfo
+{
+	std::string backend;
+	std::string adapter;
+	std::string driverVersion;
+	std::string baseline;
+	float confidence;
+	float firstDispatchMillis;		// Process start to the first dispatch
+	float shaderLoadMillis;			// Shader loading on the loader threads
+};
+
+// Return false when the file can't be written
+bool writeResultsJson(const std::string& filename, const RunInfo& info, const std::vector<CaseResult>& results);
+bool writeResultsCsv(const std::string& filename, const RunInfo& info, const std::vector<CaseResult>& results);
+
+// Which differences of the medians count as a regression or an improvement
+enum class CompareGate
+{
+	Either,				// More than the threshold or significant
+	Threshold,			// More than the threshold (fraction)
+	Significance,		// The confidence intervals of the two medians don't overlap
+	Both				// More than the threshold and significant
+};
+
+// Compares the medians against a file written by writeResultsJson and prints a report.
+// Returns the number of regressions, -1 when the file can't be read.
+int compareResults(const std::string& filename, const std::vector<CaseResult>& results, float threshold, CompareGate gate);
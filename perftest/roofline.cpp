@@ -0,0 +1,381 @@
+#include "roofline.h"
+#include "sweep.h"
+#include "loadConstantsGPU.h"
+#include "json.h"
+#include "com_ptr.h"
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Linear float4 loads, the widest loads of the sweep reach the highest bandwidth
+static const char* const bandwidthSeries[] = { "Buffer<RGBA32f>.Load linear", "ByteAddressBuffer.Load4 linear" };
+
+// Additions per load of the working set sweep kernels, value += 4 components
+static const double sweepOpsPerLoad = 4.0;
+
+// aluBody.hlsli: 256 iterations of 4 chains of 4 components
+static const double aluOpsPerChainStep = 256.0 * 4.0 * 4.0;
+
+// Sweep point ids stay below, a late result of the last sweep point is never taken for an ALU point
+static const unsigned aluPointId = 1u << 20;
+
+struct AluCase
+{
+	const char* name;
+	const char* shader;
+	double opsPerStep;		// FMA and multiply-add count two
+	const char* rateUnit;
+};
+
+static const AluCase aluCases[] =
+{
+	{ "ALU fp32 FMA", "aluFp32Fma", 2.0, "flops" },
+	{ "ALU fp16 FMA", "aluFp16Fma", 2.0, "flops" },
+	{ "ALU int32 multiply-add", "aluInt32Mad", 2.0, "ops" },
+	{ "ALU rsqrt", "aluRsqrt", 1.0, "ops" },
+};
+
+void runRoofline(Device& device, uint64_t maxBytes, unsigned numWarmUpRuns, unsigned numRuns,
+				 const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results)
+{
+	// Bandwidth first, --sweep may have measured the same points already
+	runWorkingSetSweep(device, maxBytes, numWarmUpRuns, numRuns, [&](const std::string& name)
+	{
+		bool bandwidth = std::any_of(std::begin(bandwidthSeries), std::end(bandwidthSeries), [&](const char* series)
+		{
+			return name.compare(0, strlen(series), series) == 0 && name.size() > strlen(series) && name[strlen(series)] == ' ';
+		});
+		bool measured = std::any_of(results.begin(), results.end(), [&](const CaseResult& result) { return result.name == name; });
+		return bandwidth && !measured && selectCase(name);
+	}, results);
+
+	// Same dispatch as the fixed cases
+	const uint3 threads(1024, 1024, 1);
+	const uint3 groupSize(256, 1, 1);
+
+	com_ptr<Buffer> outputBuffer = device.createBuffer(2048, 4, Device::BufferType::ByteAddress);
+	com_ptr<UnorderedAccessView> output = device.createTypedUAV(outputBuffer, 2048, Format::R32_FLOAT);
+
+	LoadConstants loadConstants;
+	loadConstants.elementsMask = 0;				// a = 1, b = 0 at runtime
+	loadConstants.writeIndex = 0xffffffff;		// Never write
+	loadConstants.readStartAddress = 0;
+	loadConstants.padding = 0;
+	com_ptr<Buffer> cb = device.createConstantBuffer(sizeof(LoadConstants));
+	device.updateConstantBuffer(cb, loadConstants);
+
+	unsigned pointId = aluPointId;
+	for (const AluCase& test : aluCases)
+	{
+		if (!selectCase(test.name))
+			continue;
+
+		com_ptr<ComputeShader> shader = device.loadComputeShader(test.shader);
+
+		double opsPerRun = double(threads.x) * threads.y * aluOpsPerChainStep * test.opsPerStep;
+		CaseResult result = { test.name, threads, groupSize, opsPerRun, 0, SampleBuffer(numRuns) };
+		result.series = "ALU";
+		result.sweepPoint = true;
+		result.alu = true;
+		result.rateUnit = test.rateUnit;
+
+		runSweepPoint(device, pointId++, [&] { device.dispatch(shader, threads, groupSize, { cb }, {}, { output }); },
+					  numWarmUpRuns, numRuns, result);
+		results.push_back(std::move(result));
+		printf("X");
+	}
+}
+
+struct Ceiling
+{
+	std::string name;
+	double value;				// G ops/s or GB/s
+	uint64_t workingSetBytes;	// Bandwidth ceilings
+};
+
+struct RooflinePoint
+{
+	std::string name;
+	std::string series;
+	double opsPerByte;
+	double gigaOpsPerSecond;
+};
+
+struct Roofline
+{
+	std::vector<Ceiling> compute;
+	std::vector<Ceiling> bandwidth;		// Cache, memory
+	std::vector<RooflinePoint> points;
+
+	double peakCompute() const
+	{
+		double peak = 0.0;
+		for (const Ceiling& ceiling : compute)
+			peak = std::max(peak, ceiling.value);
+		return peak;
+	}
+};
+
+static Roofline buildRoofline(const std::vector<CaseResult>& results)
+{
+	Roofline roofline;
+	Ceiling cache = { "Cache", 0.0, 0 };
+	Ceiling memory = { "Memory", 0.0, 0 };
+	for (const CaseResult& result : results)
+	{
+		if (result.stats.count == 0)
+			continue;
+
+		if (result.alu)
+		{
+			// Names without "ALU "
+			roofline.compute.push_back({ result.name.substr(4), result.elementsPerNs(), 0 });
+			continue;
+		}
+		if (result.workingSetBytes == 0 || result.latency || result.transfer || result.loadBytes == 0)
+			continue;
+
+		double bandwidth = result.elementsPerNs() * result.loadBytes;
+		if (bandwidth > cache.value)
+		{
+			cache.value = bandwidth;
+			cache.workingSetBytes = result.workingSetBytes;
+		}
+		if (result.workingSetBytes > memory.workingSetBytes || (result.workingSetBytes == memory.workingSetBytes && bandwidth > memory.value))
+		{
+			memory.value = bandwidth;
+			memory.workingSetBytes = result.workingSetBytes;
+		}
+		roofline.points.push_back({ result.name, result.series, sweepOpsPerLoad / result.loadBytes, result.elementsPerNs() * sweepOpsPerLoad });
+	}
+
+	if (cache.value > 0.0)
+	{
+		roofline.bandwidth.push_back(cache);
+		roofline.bandwidth.push_back(memory);
+	}
+	return roofline;
+}
+
+void printRoofline(const std::vector<CaseResult>& results)
+{
+	Roofline roofline = buildRoofline(results);
+
+	printf("\nCompute ceilings:\n");
+	for (const Ceiling& ceiling : roofline.compute)
+		printf("%s: %.1f G ops/s\n", ceiling.name.c_str(), ceiling.value);
+
+	printf("\nBandwidth ceilings:\n");
+	for (const Ceiling& ceiling : roofline.bandwidth)
+		printf("%s: %.1f GB/s at %s\n", ceiling.name.c_str(), ceiling.value, sizeName(ceiling.workingSetBytes).c_str());
+
+	// Rows are bandwidth ceilings, columns compute ceilings
+	if (!roofline.compute.empty() && !roofline.bandwidth.empty())
+	{
+		printf("\nRidge points, ops/byte:\n%8s", "");
+		for (const Ceiling& compute : roofline.compute)
+			printf(" %22s", compute.name.c_str());
+		printf("\n");
+		for (const Ceiling& bandwidth : roofline.bandwidth)
+		{
+			printf("%8s", bandwidth.name.c_str());
+			for (const Ceiling& compute : roofline.compute)
+				printf(" %22.2f", compute.value / bandwidth.value);
+			printf("\n");
+		}
+	}
+
+	// Attainable is the lower of the highest compute ceiling and the cache bandwidth at the point's intensity
+	double peakCompute = roofline.peakCompute();
+	double peakBandwidth = roofline.bandwidth.empty() ? 0.0 : roofline.bandwidth[0].value;
+	if (!roofline.points.empty())
+		printf("\nLoad kernels, ops/byte, G flops/s and %% of the roof:\n");
+	for (const RooflinePoint& point : roofline.points)
+	{
+		double roof = peakBandwidth * point.opsPerByte;
+		if (peakCompute > 0.0)
+			roof = std::min(roof, peakCompute);
+		printf("%s: %.3f %.2f %.0f%%\n", point.name.c_str(), point.opsPerByte, point.gigaOpsPerSecond,
+			   roof > 0.0 ? 100.0 * point.gigaOpsPerSecond / roof : 0.0);
+	}
+}
+
+static FILE* openFile(const std::string& filename)
+{
+	FILE* f = nullptr;
+#ifdef _MSC_VER
+	fopen_s(&f, filename.c_str(), "w");
+#else
+	f = fopen(filename.c_str(), "w");
+#endif
+	return f;
+}
+
+bool writeRooflineJson(const std::string& filename, const std::string& adapter, const std::vector<CaseResult>& results)
+{
+	FILE* f = openFile(filename);
+	if (!f)
+		return false;
+
+	Roofline roofline = buildRoofline(results);
+	fprintf(f, "{\n");
+	fprintf(f, "\t\"adapter\": %s,\n", jsonString(adapter).c_str());
+
+	fprintf(f, "\t\"compute\": [");
+	for (size_t i = 0; i < roofline.compute.size(); ++i)
+	{
+		const Ceiling& ceiling = roofline.compute[i];
+		fprintf(f, "%s\n\t\t{ \"name\": %s, \"gigaOpsPerSecond\": %.9g }", i ? "," : "", jsonString(ceiling.name).c_str(), ceiling.value);
+	}
+	fprintf(f, "\n\t],\n");
+
+	fprintf(f, "\t\"bandwidth\": [");
+	for (size_t i = 0; i < roofline.bandwidth.size(); ++i)
+	{
+		const Ceiling& ceiling = roofline.bandwidth[i];
+		fprintf(f, "%s\n\t\t{ \"name\": %s, \"workingSetBytes\": %llu, \"gigabytesPerSecond\": %.9g }", i ? "," : "",
+				jsonString(ceiling.name).c_str(), (unsigned long long)ceiling.workingSetBytes, ceiling.value);
+	}
+	fprintf(f, "\n\t],\n");
+
+	fprintf(f, "\t\"points\": [");
+	for (size_t i = 0; i < roofline.points.size(); ++i)
+	{
+		const RooflinePoint& point = roofline.points[i];
+		fprintf(f, "%s\n\t\t{ \"name\": %s, \"series\": %s, \"opsPerByte\": %.9g, \"gigaOpsPerSecond\": %.9g }", i ? "," : "",
+				jsonString(point.name).c_str(), jsonString(point.series).c_str(), point.opsPerByte, point.gigaOpsPerSecond);
+	}
+	fprintf(f, "\n\t]\n}\n");
+
+	bool ok = ferror(f) == 0;
+	fclose(f);
+	return ok;
+}
+
+// Case names have angle brackets
+static std::string xmlText(const std::string& text)
+{
+	std::string out;
+	for (char c : text)
+	{
+		switch (c)
+		{
+		case '<': out += "&lt;"; break;
+		case '>': out += "&gt;"; break;
+		case '&': out += "&amp;"; break;
+		case '"': out += "&quot;"; break;
+		default: out += c;
+		}
+	}
+	return out;
+}
+
+bool writeRooflineSvg(const std::string& filename, const std::string& adapter, const std::vector<CaseResult>& results)
+{
+	FILE* f = openFile(filename);
+	if (!f)
+		return false;
+
+	Roofline roofline = buildRoofline(results);
+
+	// Plot area in pixels. Labels of the ceilings go to the right margin.
+	const double width = 900.0, height = 600.0;
+	const double left = 80.0, right = 220.0, top = 50.0, bottom = 60.0;
+	const double plotWidth = width - left - right, plotHeight = height - top - bottom;
+
+	// Powers of two of ops/byte around the points and the ridge points, decades of G ops/s
+	double peakCompute = roofline.peakCompute();
+	double minX = 1.0 / 16.0, maxX = 16.0, minY = 1e30, maxY = 0.0;
+	for (const RooflinePoint& point : roofline.points)
+	{
+		minX = std::min(minX, point.opsPerByte);
+		maxX = std::max(maxX, point.opsPerByte);
+		minY = std::min(minY, point.gigaOpsPerSecond);
+		maxY = std::max(maxY, point.gigaOpsPerSecond);
+	}
+	for (const Ceiling& compute : roofline.compute)
+	{
+		minY = std::min(minY, compute.value);
+		maxY = std::max(maxY, compute.value);
+		for (const Ceiling& bandwidth : roofline.bandwidth)
+			maxX = std::max(maxX, compute.value / bandwidth.value);
+	}
+	int minXLog2 = int(floor(log2(minX))) - 1, maxXLog2 = int(ceil(log2(maxX))) + 1;
+	int maxYLog10 = maxY > 0.0 ? int(ceil(log10(maxY))) : 3;
+	int minYLog10 = std::min(maxYLog10 - 3, minY < 1e30 && minY > 0.0 ? int(floor(log10(minY))) : maxYLog10 - 3);
+
+	auto px = [&](double x) { return left + (log2(x) - minXLog2) / (maxXLog2 - minXLog2) * plotWidth; };
+	auto py = [&](double y) { return top + (maxYLog10 - log10(y)) / (maxYLog10 - minYLog10) * plotHeight; };
+
+	fprintf(f, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%.0f\" height=\"%.0f\" font-family=\"sans-serif\" font-size=\"12\">\n", width, height);
+	fprintf(f, "<rect width=\"100%%\" height=\"100%%\" fill=\"white\"/>\n");
+	fprintf(f, "<text x=\"%.0f\" y=\"25\" font-size=\"16\">Roofline, %s</text>\n", left, xmlText(adapter).c_str());
+
+	// Grid and axes
+	for (int x = minXLog2; x <= maxXLog2; ++x)
+	{
+		double value = ldexp(1.0, x);
+		fprintf(f, "<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"#ddd\"/>\n", px(value), top, px(value), top + plotHeight);
+		fprintf(f, "<text x=\"%.1f\" y=\"%.1f\" text-anchor=\"middle\">%g</text>\n", px(value), top + plotHeight + 18.0, value);
+	}
+	for (int y = minYLog10; y <= maxYLog10; ++y)
+	{
+		double value = pow(10.0, y);
+		fprintf(f, "<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"#ddd\"/>\n", left, py(value), left + plotWidth, py(value));
+		fprintf(f, "<text x=\"%.1f\" y=\"%.1f\" text-anchor=\"end\">%g</text>\n", left - 6.0, py(value) + 4.0, value);
+	}
+	fprintf(f, "<rect x=\"%.1f\" y=\"%.1f\" width=\"%.1f\" height=\"%.1f\" fill=\"none\" stroke=\"black\"/>\n", left, top, plotWidth, plotHeight);
+	fprintf(f, "<text x=\"%.1f\" y=\"%.1f\" text-anchor=\"middle\">ops/byte</text>\n", left + plotWidth / 2.0, height - 15.0);
+	fprintf(f, "<text transform=\"translate(20 %.1f) rotate(-90)\" text-anchor=\"middle\">G ops/s</text>\n", top + plotHeight / 2.0);
+
+	// Compute ceilings start at the cache bandwidth roof, bandwidth ceilings end at the highest compute ceiling
+	double loX = ldexp(1.0, minXLog2), hiX = ldexp(1.0, maxXLog2), loY = pow(10.0, minYLog10);
+	double peakBandwidth = roofline.bandwidth.empty() ? 0.0 : roofline.bandwidth[0].value;
+	for (const Ceiling& compute : roofline.compute)
+	{
+		double x0 = peakBandwidth > 0.0 ? std::max(loX, compute.value / peakBandwidth) : loX;
+		fprintf(f, "<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"#c00\" stroke-width=\"2\"/>\n",
+				px(x0), py(compute.value), px(hiX), py(compute.value));
+		fprintf(f, "<text x=\"%.1f\" y=\"%.1f\" fill=\"#c00\">%s %.1f G/s</text>\n", px(hiX) + 6.0, py(compute.value) + 4.0,
+				xmlText(compute.name).c_str(), compute.value);
+	}
+	for (const Ceiling& bandwidth : roofline.bandwidth)
+	{
+		double x0 = std::max(loX, loY / bandwidth.value);
+		double x1 = peakCompute > 0.0 ? std::min(hiX, peakCompute / bandwidth.value) : hiX;
+		if (x1 <= x0)
+			continue;
+		fprintf(f, "<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"#04c\" stroke-width=\"2\"/>\n",
+				px(x0), py(bandwidth.value * x0), px(x1), py(bandwidth.value * x1));
+		fprintf(f, "<text x=\"%.1f\" y=\"%.1f\" fill=\"#04c\">%s %.1f GB/s (%s)</text>\n", px(x0) + 6.0, py(bandwidth.value * x0) - 6.0,
+				xmlText(bandwidth.name).c_str(), bandwidth.value, sizeName(bandwidth.workingSetBytes).c_str());
+	}
+
+	// Points of one series share a color, the name and numbers show on hover
+	const char* const colors[] = { "#1b9e77", "#d95f02", "#7570b3", "#e7298a", "#66a61e", "#e6ab02" };
+	std::vector<std::string> series;
+	for (const RooflinePoint& point : roofline.points)
+	{
+		if (point.gigaOpsPerSecond <= 0.0)
+			continue;
+		auto it = std::find(series.begin(), series.end(), point.series);
+		size_t color = it - series.begin();
+		if (it == series.end())
+		{
+			series.push_back(point.series);
+			fprintf(f, "<circle cx=\"%.1f\" cy=\"%.1f\" r=\"4\" fill=\"%s\"/>\n", width - right + 10.0, height - bottom - 16.0 * series.size(),
+					colors[color % 6]);
+			fprintf(f, "<text x=\"%.1f\" y=\"%.1f\">%s</text>\n", width - right + 18.0, height - bottom - 16.0 * series.size() + 4.0,
+					xmlText(point.series).c_str());
+		}
+		fprintf(f, "<circle cx=\"%.1f\" cy=\"%.1f\" r=\"3\" fill=\"%s\"><title>%s: %.3f ops/byte, %.2f G flops/s</title></circle>\n",
+				px(point.opsPerByte), py(point.gigaOpsPerSecond), colors[color % 6], xmlText(point.name).c_str(),
+				point.opsPerByte, point.gigaOpsPerSecond);
+	}
+	fprintf(f, "</svg>\n");
+
+	bool ok = ferror(f) == 0;
+	fclose(f);
+	return ok;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "device.h"
+#include "results.h"
+#include <functional>
+
+// Roofline characterization. Compute ceilings are chains of fp32 FMA, fp16 FMA (min16float), int32 multiply-add and rsqrt
+// over the fixed case dispatch, operands come from the cbuffer like the load cases. Points are named "ALU <op>", e.g. "ALU fp32 FMA".
+// Bandwidth ceilings are the working set sweep points of the linear float4 buffer loads from 4 KB to maxBytes, skipped when
+// the results already have them. selectCase is called once per point.
+void runRoofline(Device& device, uint64_t maxBytes, unsigned numWarmUpRuns, unsigned numRuns,
+				 const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results);
+
+// Compute ceilings in G ops/s, cache (best point) and memory (largest working set) bandwidth in GB/s, the ridge points
+// and every working set sweep point as ops/byte against achieved G flops/s. The sweep kernels add 4 floats per load.
+void printRoofline(const std::vector<CaseResult>& results);
+
+// Same data as printRoofline. Return false when the file can't be written.
+bool writeRooflineJson(const std::string& filename, const std::string& adapter, const std::vector<CaseResult>& results);
+
+// Log-log plot of the ceilings and the sweep points
+bool writeRooflineSvg(const std::string& filename, const std::string& adapter, const std::vector<CaseResult>& results);
@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 1
+#define LOAD_RANDOM
+#define SAMPLE_GRAD
+Texture2D<float> sourceData : register(t0);
+#include "sampleTexBody.hlsli"
@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 2
+#define LOAD_LINEAR
+#define SAMPLE_GRAD
+Texture2D<float2> sourceData : register(t0);
+#include "sampleTexBody.hlsli"
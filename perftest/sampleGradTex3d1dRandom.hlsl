@@ -0,0 +1,6 @@
+#define LOAD_WIDTH 1
+#define LOAD_RANDOM
+#define SAMPLE_GRAD
+#define TEXTURE_3D
+Texture3D<float> sourceData : register(t0);
+#include "sampleTexBody.hlsli"
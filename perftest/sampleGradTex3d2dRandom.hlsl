@@ -0,0 +1,6 @@
+#define LOAD_WIDTH 2
+#define LOAD_RANDOM
+#define SAMPLE_GRAD
+#define TEXTURE_3D
+Texture3D<float2> sourceData : register(t0);
+#include "sampleTexBody.hlsli"
@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 2
+#define LOAD_LINEAR
+#define SAMPLE_LEVEL
+Texture2D<float2> sourceData : register(t0);
+#include "sampleTexBody.hlsli"
@@ -0,0 +1,6 @@
+#define LOAD_WIDTH 4
+#define LOAD_RANDOM
+#define SAMPLE_LEVEL
+#define TEXTURE_3D
+Texture3D<float4> sourceData : register(t0);
+#include "sampleTexBody.hlsli"
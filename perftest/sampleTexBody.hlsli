@@ -0,0 +1,102 @@
+#include "hash.hlsli"
+#include "loadConstantsGPU.h"
+
+RWBuffer<float> output : register(u0);
+SamplerState samplerState : register(s0);
+
+cbuffer CB0 : register(b0)
+{
+	LoadConstants loadConstants;
+};
+
+#define THREAD_GROUP_DIM 16
+
+// Full mip chains. Sized to stay in the L1 cache like the Load cases.
+#if defined(TEXTURE_3D)
+#define TEXTURE_SIZE 16
+#define COORD uint3
+#define UV float3
+#else
+#define TEXTURE_SIZE 32
+#define COORD uint2
+#define UV float2
+#endif
+
+// Fractional LOD: trilinear filtering blends two mips, point mip filtering rounds to one
+#define SAMPLE_LOD 0.5
+
+// Gradients of a 1.5 texel footprint, LOD ~0.58
+#define GRADIENT (1.5 / TEXTURE_SIZE)
+
+groupshared float dummyLDS[THREAD_GROUP_DIM][THREAD_GROUP_DIM];
+
+[numthreads(THREAD_GROUP_DIM, THREAD_GROUP_DIM, 1)]
+void main(uint3 tid : SV_DispatchThreadID, uint3 gid : SV_GroupThreadID)
+{
+	float4 value = 0.0;
+
+	[loop]
+	for (int y = 0; y < 16; ++y)
+	{
+		[loop]
+		for (int x = 0; x < 16; ++x)
+		{
+#if defined(LOAD_LINEAR)
+			// Coherent: neighbour threads access neighbour texels, like a full screen pass.
+			// Volumes are walked slice by slice.
+#if defined(TEXTURE_3D)
+			COORD texel = uint3(gid.x + x, gid.y, y);
+#else
+			COORD texel = gid.xy + uint2(x, y);
+#endif
+#elif defined(LOAD_RANDOM)
+			// Random texel per thread and iteration
+			uint h = hash2(uint2(gid.y * THREAD_GROUP_DIM + gid.x, y * 16 + x));
+#if defined(TEXTURE_3D)
+			COORD texel = uint3(h, h >> 8, h >> 16);
+#else
+			COORD texel = uint2(h, h >> 16);
+#endif
+#endif
+
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			texel = (texel & (TEXTURE_SIZE - 1)) | loadConstants.elementsMask;
+			UV uv = (UV(texel) + 0.5) / TEXTURE_SIZE;
+
+#if defined(TEXTURE_LOAD)
+			float4 texelValue = sourceData.Load(int4(texel, 0));
+#elif defined(SAMPLE_LEVEL)
+			float4 texelValue = sourceData.SampleLevel(samplerState, uv, SAMPLE_LOD);
+#elif defined(SAMPLE_GRAD)
+#if defined(TEXTURE_3D)
+			float4 texelValue = sourceData.SampleGrad(samplerState, uv, float3(GRADIENT, 0, 0), float3(0, GRADIENT, 0));
+#else
+			float4 texelValue = sourceData.SampleGrad(samplerState, uv, float2(GRADIENT, 0), float2(0, GRADIENT));
+#endif
+#elif defined(GATHER)
+			// Red channel of the 2x2 bilinear footprint
+			float4 texelValue = sourceData.GatherRed(samplerState, uv);
+#endif
+
+#if defined(GATHER) || LOAD_WIDTH == 4
+			value += texelValue.xyzw;
+#elif LOAD_WIDTH == 1
+			value += texelValue.xxxx;
+#elif LOAD_WIDTH == 2
+			value += texelValue.xyxy;
+#endif
+		}
+	}
+	// Linear write to LDS (no bank conflicts). Significantly faster than memory loads.
+	dummyLDS[gid.y][gid.x] = value.x + value.y + value.z + value.w;
+
+	GroupMemoryBarrierWithGroupSync();
+
+	// This branch is never taken, but the compiler doesn't know it
+	// Optimizer would remove all the memory loads if the data wouldn't be potentially used
+	[branch]
+	if (loadConstants.writeIndex != 0xffffffff)
+	{
+		output[tid.x + tid.y] = dummyLDS[(loadConstants.writeIndex >> 8) & 0xff][loadConstants.writeIndex & 0xff];
+	}
+}
@@ -0,0 +1,503 @@
+#include "shaderAnalysis.h"
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <stdint.h>
+#include <string.h>
+
+// Loads of a loop body, added to the enclosing loop trip count times. The outermost frame is the whole kernel.
+struct LoopFrame
+{
+	uint64_t loads = 0;
+	uint64_t components = 0;
+	uint32_t tripCount = 0;		// Zero until found
+	uint32_t candidate = 0;		// DXBC: immediate of the last compare before the first breakc
+	bool exitSeen = false;		// DXBC: first breakc passed
+	uint32_t merge = 0;			// SPIR-V: merge block of the loop
+};
+
+static bool closeLoop(std::vector<LoopFrame>& loops)
+{
+	LoopFrame loop = loops.back();
+	loops.pop_back();
+	if (loop.loads > 0 && loop.tripCount == 0)
+		return false;
+
+	loops.back().loads += loop.loads * loop.tripCount;
+	loops.back().components += loop.components * loop.tripCount;
+	return true;
+}
+
+static unsigned bitCount(uint32_t bits)
+{
+	unsigned count = 0;
+	for (; bits; bits &= bits - 1)
+		count++;
+	return count;
+}
+
+// DXBC, see d3d11TokenizedProgramFormat.hpp
+
+enum DxbcOpcode
+{
+	DxbcBreakc = 3,
+	DxbcEndLoop = 22,
+	DxbcIeq = 32,
+	DxbcIge = 33,
+	DxbcIlt = 34,
+	DxbcIne = 39,
+	DxbcLd = 45,
+	DxbcLdMs = 46,
+	DxbcLoop = 48,
+	DxbcCustomData = 53,
+	DxbcSample = 69,
+	DxbcSampleB = 74,
+	DxbcUlt = 79,
+	DxbcUge = 80,
+	DxbcGather4 = 109,
+	DxbcGather4C = 126,
+	DxbcGather4PoC = 128,
+	DxbcLdUavTyped = 163,
+	DxbcLdRaw = 165,
+	DxbcLdStructured = 167
+};
+
+enum DxbcOperandType
+{
+	DxbcImmediate32 = 4,
+	DxbcImmediate64 = 5,
+	DxbcResource = 7,
+	DxbcConstantBuffer = 8,
+	DxbcUav = 30,
+	DxbcGroupshared = 31
+};
+
+struct DxbcOperand
+{
+	uint32_t type = 0;
+	uint32_t components = 0;		// Write mask of a destination, distinct swizzle components of a source
+	uint32_t immediate = 0;			// First value of an immediate
+	bool relativeIndex = false;		// Register index from a temp, like cb0[r1.x + 1]
+};
+
+// Returns the tokens of the operand, zero when it runs past the end
+static size_t parseDxbcOperand(const uint32_t* tokens, size_t count, DxbcOperand& out)
+{
+	if (count == 0)
+		return 0;
+
+	uint32_t token = tokens[0];
+	size_t size = token & 0x80000000 ? 2 : 1;		// Extended operand token
+	uint32_t numComponents = token & 3;
+	uint32_t selection = (token >> 2) & 3;
+	out.type = (token >> 12) & 0xff;
+
+	if (numComponents == 1)
+		out.components = 1;
+	else if (numComponents == 2 && selection == 0)
+		out.components = bitCount((token >> 4) & 0xf);
+	else if (numComponents == 2 && selection == 1)
+	{
+		uint32_t used = 0;
+		for (int c = 0; c < 4; ++c)
+			used |= 1u << ((token >> (4 + c * 2)) & 3);
+		out.components = bitCount(used);
+	}
+	else if (numComponents == 2)
+		out.components = 1;
+
+	if (out.type == DxbcImmediate32 || out.type == DxbcImmediate64)
+	{
+		size_t values = (numComponents == 2 ? 4 : 1) * (out.type == DxbcImmediate64 ? 2 : 1);
+		if (size + values > count)
+			return 0;
+		out.immediate = tokens[size];
+		return size + values;
+	}
+
+	// Index representations: immediate 32, immediate 64, relative, immediate 32 + relative, immediate 64 + relative
+	uint32_t dimension = (token >> 20) & 3;
+	for (uint32_t d = 0; d < dimension; ++d)
+	{
+		uint32_t representation = (token >> (22 + d * 3)) & 7;
+		if (representation == 0 || representation == 3)
+			size += 1;
+		else if (representation == 1 || representation == 4)
+			size += 2;
+		if (representation >= 2)
+		{
+			DxbcOperand relative;
+			size_t relativeSize = size < count ? parseDxbcOperand(tokens + size, count - size, relative) : 0;
+			if (relativeSize == 0)
+				return 0;
+			size += relativeSize;
+			out.relativeIndex = true;
+		}
+	}
+	return size <= count ? size : 0;
+}
+
+// Declarations have tokens that aren't operands
+static bool isDxbcDeclaration(uint32_t opcode)
+{
+	return (opcode >= 88 && opcode <= 106) || (opcode >= 113 && opcode <= 116) || (opcode >= 143 && opcode <= 162) || opcode == DxbcCustomData;
+}
+
+static bool isDxbcLoad(uint32_t opcode)
+{
+	return opcode == DxbcLd || opcode == DxbcLdMs || (opcode >= DxbcSample && opcode <= DxbcSampleB) || opcode == DxbcGather4 ||
+		   (opcode >= DxbcGather4C && opcode <= DxbcGather4PoC) || opcode == DxbcLdUavTyped || opcode == DxbcLdRaw || opcode == DxbcLdStructured;
+}
+
+static bool isDxbcCompare(uint32_t opcode)
+{
+	return opcode == DxbcIeq || opcode == DxbcIge || opcode == DxbcIlt || opcode == DxbcIne || opcode == DxbcUlt || opcode == DxbcUge;
+}
+
+static bool countDxbcLoads(const std::vector<uint32_t>& program, LoadSource source, ShaderLoads& out)
+{
+	// Version and length tokens, then the instructions
+	if (program.size() < 2)
+		return false;
+	size_t length = std::min(size_t(program[1]), program.size());
+
+	std::vector<LoopFrame> loops(1);
+	loops[0].tripCount = 1;
+	for (size_t i = 2; i < length;)
+	{
+		uint32_t token = program[i];
+		uint32_t opcode = token & 0x7ff;
+		size_t size = opcode == DxbcCustomData ? (i + 1 < length ? program[i + 1] : 0) : (token >> 24) & 0x7f;
+		if (size == 0 || i + size > length)
+			return false;
+
+		// Operands follow the extended opcode tokens
+		size_t end = i + size;
+		size_t operand = i + 1;
+		for (uint32_t extended = token; (extended & 0x80000000) && operand < end;)
+			extended = program[operand++];
+
+		std::vector<DxbcOperand> operands;
+		if (!isDxbcDeclaration(opcode))
+		{
+			while (operand < end)
+			{
+				DxbcOperand parsed;
+				size_t operandSize = parseDxbcOperand(&program[operand], end - operand, parsed);
+				if (operandSize == 0)
+					break;
+				operands.push_back(parsed);
+				operand += operandSize;
+			}
+		}
+
+		LoopFrame& loop = loops.back();
+		if (opcode == DxbcLoop)
+			loops.push_back(LoopFrame());
+		else if (opcode == DxbcEndLoop)
+		{
+			if (loops.size() < 2 || !closeLoop(loops))
+				return false;
+		}
+		else if (opcode == DxbcBreakc && !loop.exitSeen)
+		{
+			// for (i = 0; i < N; ++i) compiles to a compare of the counter with N and a breakc at the top of the loop
+			loop.exitSeen = true;
+			loop.tripCount = loop.candidate;
+		}
+		else if (isDxbcCompare(opcode) && !loop.exitSeen)
+		{
+			for (const DxbcOperand& parsed : operands)
+			{
+				if (parsed.type == DxbcImmediate32)
+					loop.candidate = parsed.immediate;
+			}
+		}
+		else if (isDxbcLoad(opcode) && !operands.empty() && source != LoadSource::ConstantBuffer)
+		{
+			for (size_t o = 1; o < operands.size(); ++o)
+			{
+				uint32_t type = operands[o].type;
+				if (type != DxbcResource && type != DxbcUav && type != DxbcGroupshared)
+					continue;
+				if ((type == DxbcResource && source == LoadSource::Resource) || (type == DxbcGroupshared && source == LoadSource::Groupshared))
+				{
+					loop.loads++;
+					loop.components += operands[0].components;
+				}
+				break;
+			}
+		}
+
+		// cbuffer reads are operands of any instruction
+		if (source == LoadSource::ConstantBuffer)
+		{
+			for (size_t o = 1; o < operands.size(); ++o)
+			{
+				if (operands[o].type == DxbcConstantBuffer && operands[o].relativeIndex)
+				{
+					loops.back().loads++;
+					loops.back().components += operands[o].components;
+				}
+			}
+		}
+		i = end;
+	}
+
+	if (loops.size() != 1)
+		return false;
+	out.loads = unsigned(loops[0].loads);
+	out.components = unsigned(loops[0].components);
+	return true;
+}
+
+// SPIR-V, see the SPIR-V specification
+
+enum SpirvOpcode
+{
+	SpirvTypeBool = 20,
+	SpirvTypeInt = 21,
+	SpirvTypeFloat = 22,
+	SpirvTypeVector = 23,
+	SpirvTypePointer = 32,
+	SpirvConstant = 43,
+	SpirvVariable = 59,
+	SpirvLoad = 61,
+	SpirvAccessChain = 65,
+	SpirvPtrAccessChain = 67,
+	SpirvDecorate = 71,
+	SpirvImageSampleImplicitLod = 87,
+	SpirvImageSampleExplicitLod = 88,
+	SpirvImageFetch = 95,
+	SpirvImageGather = 96,
+	SpirvImageDrefGather = 97,
+	SpirvIEqual = 170,
+	SpirvINotEqual = 171,
+	SpirvUGreaterThan = 172,
+	SpirvSGreaterThan = 173,
+	SpirvUGreaterThanEqual = 174,
+	SpirvSGreaterThanEqual = 175,
+	SpirvULessThan = 176,
+	SpirvSLessThan = 177,
+	SpirvULessThanEqual = 178,
+	SpirvSLessThanEqual = 179,
+	SpirvLoopMerge = 246,
+	SpirvLabel = 248,
+	SpirvBranchConditional = 250
+};
+
+enum SpirvStorageClass
+{
+	SpirvUniform = 2,
+	SpirvWorkgroup = 4,
+	SpirvStorageBuffer = 12
+};
+
+static const uint32_t spirvBufferBlock = 3;		// Decoration of storage buffers in the Uniform class (SPIR-V 1.0)
+
+struct SpirvPointer
+{
+	uint32_t storage;
+	bool dynamic;		// Access chain with an index that isn't a constant
+};
+
+struct SpirvComparison
+{
+	uint32_t opcode;
+	uint32_t constant;		// Second operand
+};
+
+// Iterations of a loop whose conditional branch leaves to the merge block, counter from zero
+static uint32_t spirvTripCount(const SpirvComparison& comparison, bool exitOnTrue)
+{
+	switch (comparison.opcode)
+	{
+	case SpirvULessThan:
+	case SpirvSLessThan:
+	case SpirvINotEqual:
+		return exitOnTrue ? 0 : comparison.constant;
+	case SpirvULessThanEqual:
+	case SpirvSLessThanEqual:
+		return exitOnTrue ? 0 : comparison.constant + 1;
+	case SpirvUGreaterThanEqual:
+	case SpirvSGreaterThanEqual:
+	case SpirvIEqual:
+		return exitOnTrue ? comparison.constant : 0;
+	case SpirvUGreaterThan:
+	case SpirvSGreaterThan:
+		return exitOnTrue ? comparison.constant + 1 : 0;
+	}
+	return 0;
+}
+
+static bool countSpirvLoads(const std::vector<uint32_t>& words, LoadSource source, ShaderLoads& out)
+{
+	std::map<uint32_t, uint32_t> constants;
+	std::map<uint32_t, uint32_t> components;			// Scalar and vector types
+	std::map<uint32_t, uint32_t> pointees;				// Pointer types
+	std::map<uint32_t, uint32_t> pointerStorage;
+	std::set<uint32_t> bufferBlocks;
+	std::map<uint32_t, SpirvPointer> pointers;			// Variables and access chains
+	std::map<uint32_t, SpirvComparison> comparisons;
+
+	std::vector<LoopFrame> loops(1);
+	loops[0].tripCount = 1;
+	auto addLoad = [&](uint32_t type)
+	{
+		auto it = components.find(type);
+		loops.back().loads++;
+		loops.back().components += it != components.end() ? it->second : 0;
+	};
+
+	// Header: magic, version, generator, bound, schema
+	for (size_t i = 5; i < words.size();)
+	{
+		uint32_t wordCount = words[i] >> 16;
+		uint32_t opcode = words[i] & 0xffff;
+		if (wordCount == 0 || i + wordCount > words.size())
+			return false;
+		const uint32_t* op = &words[i + 1];
+		uint32_t operands = wordCount - 1;
+
+		switch (opcode)
+		{
+		case SpirvDecorate:
+			if (operands >= 2 && op[1] == spirvBufferBlock)
+				bufferBlocks.insert(op[0]);
+			break;
+		case SpirvTypeBool:
+		case SpirvTypeInt:
+		case SpirvTypeFloat:
+			if (operands >= 1)
+				components[op[0]] = 1;
+			break;
+		case SpirvTypeVector:
+			if (operands >= 3)
+				components[op[0]] = op[2];
+			break;
+		case SpirvTypePointer:
+			if (operands >= 3)
+			{
+				pointerStorage[op[0]] = op[1];
+				pointees[op[0]] = op[2];
+			}
+			break;
+		case SpirvConstant:
+			if (operands >= 3)
+				constants[op[1]] = op[2];
+			break;
+		case SpirvVariable:
+			if (operands >= 3)
+			{
+				uint32_t storage = op[2];
+				if (storage == SpirvUniform && bufferBlocks.count(pointees[op[0]]))
+					storage = SpirvStorageBuffer;
+				pointers[op[1]] = { storage, false };
+			}
+			break;
+		case SpirvAccessChain:
+		case SpirvAccessChain + 1:		// InBoundsAccessChain
+		case SpirvPtrAccessChain:
+			if (operands >= 3 && pointers.count(op[2]))
+			{
+				SpirvPointer pointer = pointers[op[2]];
+				for (uint32_t k = 3; k < operands; ++k)
+					pointer.dynamic |= constants.count(op[k]) == 0;
+				pointers[op[1]] = pointer;
+			}
+			break;
+		case SpirvLoad:
+			if (operands >= 3 && pointers.count(op[2]))
+			{
+				const SpirvPointer& pointer = pointers[op[2]];
+				if ((source == LoadSource::Resource && pointer.storage == SpirvStorageBuffer) ||
+					(source == LoadSource::ConstantBuffer && pointer.storage == SpirvUniform && pointer.dynamic) ||
+					(source == LoadSource::Groupshared && pointer.storage == SpirvWorkgroup))
+					addLoad(op[0]);
+			}
+			break;
+		case SpirvImageSampleImplicitLod:
+		case SpirvImageSampleExplicitLod:
+		case SpirvImageFetch:
+		case SpirvImageGather:
+		case SpirvImageDrefGather:
+			if (operands >= 2 && source == LoadSource::Resource)
+				addLoad(op[0]);
+			break;
+		case SpirvLoopMerge:
+			if (operands >= 2)
+			{
+				LoopFrame loop;
+				loop.merge = op[0];
+				loops.push_back(loop);
+			}
+			break;
+		case SpirvBranchConditional:
+			if (operands >= 3 && loops.size() > 1 && loops.back().tripCount == 0 && comparisons.count(op[0]))
+			{
+				LoopFrame& loop = loops.back();
+				if (op[1] == loop.merge || op[2] == loop.merge)
+					loop.tripCount = spirvTripCount(comparisons[op[0]], op[1] == loop.merge);
+			}
+			break;
+		case SpirvLabel:
+			while (operands >= 1 && loops.size() > 1 && loops.back().merge == op[0])
+			{
+				if (!closeLoop(loops))
+					return false;
+			}
+			break;
+		default:
+			if (opcode >= SpirvIEqual && opcode <= SpirvSLessThanEqual && operands >= 4 && constants.count(op[3]))
+				comparisons[op[1]] = { opcode, constants[op[3]] };
+			break;
+		}
+		i += wordCount;
+	}
+
+	if (loops.size() != 1)
+		return false;
+	out.loads = unsigned(loops[0].loads);
+	out.components = unsigned(loops[0].components);
+	return true;
+}
+
+bool countShaderLoads(const unsigned char* bytes, size_t size, LoadSource source, ShaderLoads& out)
+{
+	auto read32 = [&](size_t offset)
+	{
+		uint32_t value = 0;
+		if (offset + 4 <= size)
+			memcpy(&value, bytes + offset, 4);
+		return value;
+	};
+
+	// SPIR-V module
+	if (size >= 20 && size % 4 == 0 && read32(0) == 0x07230203)
+	{
+		std::vector<uint32_t> words(size / 4);
+		memcpy(words.data(), bytes, size);
+		return countSpirvLoads(words, source, out);
+	}
+
+	// DXBC container: magic, checksum, version, size, chunk count and offsets. The program is the SHEX (SM5) or SHDR chunk.
+	if (size < 32 || memcmp(bytes, "DXBC", 4) != 0)
+		return false;
+
+	uint32_t chunkCount = read32(28);
+	for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+	{
+		size_t offset = read32(32 + chunk * 4);
+		if (offset + 8 > size)
+			return false;
+		if (memcmp(bytes + offset, "SHEX", 4) != 0 && memcmp(bytes + offset, "SHDR", 4) != 0)
+			continue;
+
+		size_t chunkSize = std::min(size_t(read32(offset + 4)), size - offset - 8);
+		std::vector<uint32_t> program(chunkSize / 4);
+		memcpy(program.data(), bytes + offset + 8, program.size() * 4);
+		return countDxbcLoads(program, source, out);
+	}
+	return false;
+}
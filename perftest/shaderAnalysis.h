@@ -0,0 +1,22 @@
+#pragma once
+#include <stddef.h>
+
+// Memory the loads of a kernel read
+enum class LoadSource
+{
+	Resource,			// SRV loads, samples and gathers: DXBC t# registers, SPIR-V sampled images, texel buffers and storage buffers
+	ConstantBuffer,		// Dynamically indexed cbuffer reads
+	Groupshared
+};
+
+// Loads per thread of a compiled kernel. Components are the 32 bit values the loads return.
+struct ShaderLoads
+{
+	unsigned loads = 0;
+	unsigned components = 0;
+};
+
+// Counts the loads of one source in DXBC (SHEX/SHDR chunk) or SPIR-V bytecode. A load inside counted loops counts once per
+// iteration, the trip count is the constant the loop compares its counter against, the counter starting at zero.
+// Returns false for other blobs and when a loop with loads has no constant trip count.
+bool countShaderLoads(const unsigned char* bytes, size_t size, LoadSource source, ShaderLoads& out);
@@ -0,0 +1,469 @@
+// Offline shader permutation generator and compiled shader cache.
+//
+// shaders.json declares the permutations as a matrix: each shader entry names a body (.hlsli), the axes
+// it is expanded over and the defines and declaration of the wrapper. Axis values are sets of variables,
+// "{variable}" in the name, defines and declaration is replaced by the value of the permutation.
+//
+// --write-sources DIR writes the wrapper .hlsl files (the Visual Studio build compiles these).
+// --compile COMPILER compiles every permutation with dxc into a content-addressed cache. Blobs are named
+// by a hash of the wrapper, the included files, the compiler arguments and the compiler version, so only
+// changed permutations are compiled again. --manifest FILE maps "<name><extension>" to the cached blobs,
+// Device::loadComputeShader reads it at startup.
+
+#include "json.h"
+#include "file.h"
+#include "threadPool.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+struct Permutation
+{
+	std::string name;
+	std::string source;		// Wrapper text
+};
+
+// dxc targets. Register shifts flatten the HLSL register spaces to one descriptor set (see vulkan.h).
+struct Target
+{
+	const char* name;
+	const char* extension;
+	const char* arguments;
+};
+
+static const Target targets[] =
+{
+	{ "spirv", ".spv", "-spirv -T cs_6_0 -E main -fspv-target-env=vulkan1.1 -fvk-b-shift 0 0 -fvk-t-shift 16 0 -fvk-u-shift 32 0 -fvk-s-shift 48 0" },
+	{ "dxil", ".dxil", "-T cs_6_0 -E main" },
+};
+
+static bool readText(const std::string& filename, std::string& text)
+{
+	std::vector<unsigned char> bytes;
+	if (!readFile(filename, bytes))
+		return false;
+	text.assign(bytes.begin(), bytes.end());
+	return true;
+}
+
+static bool writeText(const std::string& filename, const std::string& text)
+{
+	FILE* f = fopen(filename.c_str(), "wb");
+	if (!f)
+		return false;
+	bool ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+	return fclose(f) == 0 && ok;
+}
+
+// Unchanged files keep their timestamps
+static bool writeIfChanged(const std::string& filename, const std::string& text, bool& written)
+{
+	std::string previous;
+	written = !readText(filename, previous) || previous != text;
+	return !written || writeText(filename, text);
+}
+
+static bool fileExists(const std::string& filename)
+{
+	FILE* f = fopen(filename.c_str(), "rb");
+	if (f)
+		fclose(f);
+	return f != nullptr;
+}
+
+static std::string substitute(const std::string& text, const std::map<std::string, std::string>& variables)
+{
+	std::string out;
+	size_t pos = 0;
+	while (pos < text.size())
+	{
+		size_t open = text.find('{', pos);
+		size_t close = open == std::string::npos ? open : text.find('}', open);
+		if (close == std::string::npos)
+			break;
+
+		auto it = variables.find(text.substr(open + 1, close - open - 1));
+		out += text.substr(pos, open - pos);
+		out += it != variables.end() ? it->second : text.substr(open, close - open + 1);
+		pos = close + 1;
+	}
+	return out + text.substr(pos);
+}
+
+static const std::string& memberString(const JsonValue& value, const char* key)
+{
+	static const std::string empty;
+	const JsonValue* member = value.find(key);
+	return member && member->type == JsonValue::Type::String ? member->string : empty;
+}
+
+// Cartesian product of the axes of one shader entry. The first axis varies slowest.
+static bool expandShader(const JsonValue& shader, const JsonValue& axes, std::vector<Permutation>& out)
+{
+	const std::string& name = memberString(shader, "name");
+	const std::string& body = memberString(shader, "body");
+	const std::string& declaration = memberString(shader, "declaration");
+	const JsonValue* defines = shader.find("defines");
+	const JsonValue* shaderAxes = shader.find("axes");
+	if (name.empty() || body.empty())
+	{
+		printf("Shader entry without a name or body\n");
+		return false;
+	}
+
+	std::vector<const JsonValue*> values;
+	if (shaderAxes)
+	{
+		for (const JsonValue& axisName : shaderAxes->elements)
+		{
+			const JsonValue* axis = axes.find(axisName.string);
+			if (!axis || axis->type != JsonValue::Type::Array || axis->elements.empty())
+			{
+				printf("%s: unknown axis %s\n", name.c_str(), axisName.string.c_str());
+				return false;
+			}
+			values.push_back(axis);
+		}
+	}
+
+	std::vector<size_t> index(values.size(), 0);
+	for (;;)
+	{
+		std::map<std::string, std::string> variables;
+		for (size_t a = 0; a < values.size(); ++a)
+		{
+			const JsonValue& value = values[a]->elements[index[a]];
+			for (size_t k = 0; k < value.keys.size(); ++k)
+				variables[value.keys[k]] = value.elements[k].string;
+		}
+
+		Permutation permutation;
+		permutation.name = substitute(name, variables);
+		if (defines)
+		{
+			for (const JsonValue& define : defines->elements)
+				permutation.source += "#define " + substitute(define.string, variables) + "\n";
+		}
+		if (!declaration.empty())
+			permutation.source += substitute(declaration, variables) + "\n";
+		permutation.source += "#include \"" + body + "\"\n";
+		out.push_back(permutation);
+
+		// Next combination, last axis first
+		size_t a = values.size();
+		while (a > 0 && ++index[a - 1] == values[a - 1]->elements.size())
+			index[--a] = 0;
+		if (a == 0)
+			break;
+	}
+	return true;
+}
+
+static bool expandMatrix(const std::string& filename, std::vector<Permutation>& out)
+{
+	std::string text;
+	JsonValue root;
+	if (!readText(filename, text) || !parseJson(text, root))
+	{
+		printf("Can't read the permutation matrix %s\n", filename.c_str());
+		return false;
+	}
+
+	const JsonValue* axes = root.find("axes");
+	const JsonValue* shaders = root.find("shaders");
+	if (!axes || !shaders || shaders->type != JsonValue::Type::Array)
+	{
+		printf("%s needs \"axes\" and \"shaders\"\n", filename.c_str());
+		return false;
+	}
+
+	std::set<std::string> names;
+	for (const JsonValue& shader : shaders->elements)
+	{
+		if (!expandShader(shader, *axes, out))
+			return false;
+	}
+	for (const Permutation& permutation : out)
+	{
+		if (!names.insert(permutation.name).second)
+		{
+			printf("Permutation %s is declared twice\n", permutation.name.c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+// FNV-1a, 64 bit
+static uint64_t hashBytes(uint64_t hash, const std::string& bytes)
+{
+	for (char c : bytes)
+	{
+		hash ^= uint8_t(c);
+		hash *= 0x100000001b3ull;
+	}
+	// Length separates consecutive fields
+	hash ^= bytes.size();
+	hash *= 0x100000001b3ull;
+	return hash;
+}
+
+// Hashes the name and contents of every file included by the text, recursively, in include order
+static bool hashIncludes(const std::string& directory, const std::string& text, std::set<std::string>& visited,
+						 std::map<std::string, std::string>& contents, uint64_t& hash)
+{
+	size_t pos = 0;
+	while ((pos = text.find("#include", pos)) != std::string::npos)
+	{
+		size_t open = text.find('"', pos);
+		size_t lineEnd = text.find('\n', pos);
+		pos += 8;
+		if (open == std::string::npos || open > lineEnd)
+			continue;
+		size_t close = text.find('"', open + 1);
+		if (close == std::string::npos || close > lineEnd)
+			continue;
+
+		std::string include = text.substr(open + 1, close - open - 1);
+		if (!visited.insert(include).second)
+			continue;
+
+		auto it = contents.find(include);
+		if (it == contents.end())
+		{
+			std::string included;
+			if (!readText(directory + "/" + include, included))
+			{
+				printf("Can't read include %s\n", include.c_str());
+				return false;
+			}
+			it = contents.emplace(include, included).first;
+		}
+
+		hash = hashBytes(hashBytes(hash, include), it->second);
+		if (!hashIncludes(directory, it->second, visited, contents, hash))
+			return false;
+	}
+	return true;
+}
+
+// Runs a command and returns its exit code, stdout and stderr go to output
+static int runCommand(const std::string& command, std::string& output)
+{
+	FILE* pipe = popen((command + " 2>&1").c_str(), "r");
+	if (!pipe)
+		return -1;
+
+	char buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), pipe)) > 0)
+		output.append(buffer, read);
+	return pclose(pipe);
+}
+
+static std::string quote(const std::string& path)
+{
+	return "\"" + path + "\"";
+}
+
+static std::string directoryOf(const std::string& path)
+{
+	size_t slash = path.find_last_of("/\\");
+	return slash == std::string::npos ? "." : path.substr(0, slash);
+}
+
+static int writeSources(const std::vector<Permutation>& permutations, const std::string& directory)
+{
+	unsigned written = 0;
+	for (const Permutation& permutation : permutations)
+	{
+		bool changed = false;
+		if (!writeIfChanged(directory + "/" + permutation.name + ".hlsl", permutation.source, changed))
+		{
+			printf("Can't write %s/%s.hlsl\n", directory.c_str(), permutation.name.c_str());
+			return 1;
+		}
+		written += changed;
+	}
+	printf("%u permutations, %u wrappers written to %s\n", unsigned(permutations.size()), written, directory.c_str());
+	return 0;
+}
+
+struct CompileJob
+{
+	std::string name;		// Manifest key, <name><extension>
+	std::string source;
+	std::string arguments;
+	std::string blob;		// Cache path
+};
+
+static int compile(const std::vector<Permutation>& permutations, const std::string& sourceDirectory, const std::string& compiler,
+				   const std::vector<const Target*>& selectedTargets, const std::string& cacheDirectory,
+				   const std::string& manifestFile, unsigned numThreads)
+{
+	std::string version;
+	if (runCommand(quote(compiler) + " --version", version) != 0)
+	{
+		printf("Can't run %s --version:\n%s\n", compiler.c_str(), version.c_str());
+		return 1;
+	}
+
+	std::vector<CompileJob> jobs;
+	std::vector<size_t> misses;
+	std::map<std::string, std::string> includes;
+	for (const Target* target : selectedTargets)
+	{
+		for (const Permutation& permutation : permutations)
+		{
+			uint64_t hash = hashBytes(hashBytes(hashBytes(0xcbf29ce484222325ull, version), target->arguments), permutation.source);
+			std::set<std::string> visited;
+			if (!hashIncludes(sourceDirectory, permutation.source, visited, includes, hash))
+				return 1;
+
+			char key[17];
+			snprintf(key, sizeof(key), "%016llx", (unsigned long long)hash);
+
+			CompileJob job;
+			job.name = permutation.name + target->extension;
+			job.source = permutation.source;
+			job.arguments = target->arguments;
+			job.blob = cacheDirectory + "/" + key + target->extension;
+			if (!fileExists(job.blob))
+				misses.push_back(jobs.size());
+			jobs.push_back(job);
+		}
+	}
+
+	// Each job writes its own wrapper and temporary file, and renames the blob into place when it's complete
+	std::mutex printMutex;
+	std::atomic<unsigned> failures(0);
+	ThreadPool threadPool(numThreads);
+	threadPool.parallelFor(unsigned(misses.size()), [&](unsigned index)
+	{
+		const CompileJob& job = jobs[misses[index]];
+		std::string wrapper = job.blob + ".hlsl";
+		std::string temporary = job.blob + ".tmp";
+
+		std::string output;
+		bool ok = writeText(wrapper, job.source) &&
+				  runCommand(quote(compiler) + " " + job.arguments + " -I " + quote(sourceDirectory) +
+							 " -Fo " + quote(temporary) + " " + quote(wrapper), output) == 0 &&
+				  rename(temporary.c_str(), job.blob.c_str()) == 0;
+		remove(wrapper.c_str());
+
+		std::lock_guard<std::mutex> lock(printMutex);
+		if (ok)
+		{
+			printf("Compiled %s\n", job.name.c_str());
+		}
+		else
+		{
+			remove(temporary.c_str());
+			printf("Compiling %s failed:\n%s\n", job.name.c_str(), output.c_str());
+			failures++;
+		}
+	});
+
+	if (failures > 0)
+	{
+		printf("%u of %u permutations failed to compile\n", unsigned(failures), unsigned(jobs.size()));
+		return 1;
+	}
+
+	std::string manifest = "{\n\t\"compiler\": " + jsonString(version.substr(0, version.find_first_of("\r\n"))) + ",\n\t\"shaders\": {";
+	for (size_t i = 0; i < jobs.size(); ++i)
+	{
+		manifest += std::string(i ? "," : "") + "\n\t\t" + jsonString(jobs[i].name) + ": " + jsonString(jobs[i].blob);
+	}
+	manifest += "\n\t}\n}\n";
+
+	bool changed = false;
+	if (!writeIfChanged(manifestFile, manifest, changed))
+	{
+		printf("Can't write %s\n", manifestFile.c_str());
+		return 1;
+	}
+
+	printf("%u permutations, %u compiled, %u from the cache\n", unsigned(jobs.size()), unsigned(misses.size()),
+		   unsigned(jobs.size() - misses.size()));
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: shaderGen MATRIX_JSON [--write-sources DIR]\n"
+			   "                 [--compile DXC --target spirv|dxil --cache DIR --manifest FILE [-j THREADS]]\n");
+		return 1;
+	}
+
+	std::string matrixFile = argv[1];
+	std::string sourcesDirectory, compiler, cacheDirectory, manifestFile;
+	std::vector<const Target*> selectedTargets;
+	unsigned numThreads = std::thread::hardware_concurrency();
+	for (int i = 2; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--write-sources") == 0 && i + 1 < argc)
+			sourcesDirectory = argv[++i];
+		else if (strcmp(argv[i], "--compile") == 0 && i + 1 < argc)
+			compiler = argv[++i];
+		else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+			cacheDirectory = argv[++i];
+		else if (strcmp(argv[i], "--manifest") == 0 && i + 1 < argc)
+			manifestFile = argv[++i];
+		else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+			numThreads = std::max(1, atoi(argv[++i]));
+		else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc)
+		{
+			const char* name = argv[++i];
+			const Target* target = nullptr;
+			for (const Target& t : targets)
+			{
+				if (strcmp(t.name, name) == 0)
+					target = &t;
+			}
+			if (!target)
+			{
+				printf("Unknown target %s, expected spirv or dxil\n", name);
+				return 1;
+			}
+			selectedTargets.push_back(target);
+		}
+		else
+		{
+			printf("Unknown argument %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	std::vector<Permutation> permutations;
+	if (!expandMatrix(matrixFile, permutations))
+		return 1;
+
+	if (!sourcesDirectory.empty() && writeSources(permutations, sourcesDirectory) != 0)
+		return 1;
+
+	if (!compiler.empty())
+	{
+		if (selectedTargets.empty() || cacheDirectory.empty() || manifestFile.empty())
+		{
+			printf("--compile needs --target, --cache and --manifest\n");
+			return 1;
+		}
+		return compile(permutations, directoryOf(matrixFile), compiler, selectedTargets, cacheDirectory, manifestFile, numThreads);
+	}
+	return 0;
+}
@@ -0,0 +1,72 @@
+#include "shaderLoader.h"
+#include "threadPool.h"
+#include "trace.h"
+#include <algorithm>
+#include <map>
+
+ShaderLoader::ShaderLoader(Device& device, const std::vector<std::string>& shaderNames, PrepareFunc prepare, unsigned numThreads) :
+	ready(new std::atomic<bool>[shaderNames.size()]), numReady(0), numThreads(std::max(numThreads, 1u)), start(std::chrono::steady_clock::now())
+{
+	std::vector<std::string> names;
+	std::map<std::string, unsigned> slotOfName;
+	for (unsigned i = 0; i < shaderNames.size(); ++i)
+	{
+		auto inserted = slotOfName.emplace(shaderNames[i], static_cast<unsigned>(names.size()));
+		if (inserted.second)
+		{
+			names.push_back(shaderNames[i]);
+			users.emplace_back();
+		}
+		slots.push_back(inserted.first->second);
+		users[inserted.first->second].push_back(i);
+		ready[i] = false;
+	}
+	shaders.resize(names.size());
+	finish = start;
+
+	// The calling thread keeps dispatching, so loading runs on a thread of its own. It joins the pool work.
+	thread = std::thread([this, &device, names, prepare]()
+	{
+		load(device, names, prepare);
+	});
+}
+
+ShaderLoader::~ShaderLoader()
+{
+	thread.join();
+}
+
+void ShaderLoader::load(Device& device, const std::vector<std::string>& names, const PrepareFunc& prepare)
+{
+	ThreadPool threadPool(numThreads);
+	threadPool.parallelFor(static_cast<unsigned>(names.size()), [&](unsigned slot)
+	{
+		TRACE_SCOPE("Load shader");
+		ComputeShader* shader = device.loadComputeShader(names[slot]);
+		shaders[slot] = shader;
+
+		for (unsigned index : users[slot])
+		{
+			prepare(index, shader);
+
+			// Finish time is written before the last case is published, allReady() makes it visible
+			std::lock_guard<std::mutex> lock(mutex);
+			if (numReady.load() + 1 == slots.size())
+				finish = std::chrono::steady_clock::now();
+			ready[index].store(true, std::memory_order_release);
+			numReady.fetch_add(1, std::memory_order_release);
+			readyChanged.notify_all();
+		}
+	});
+}
+
+void ShaderLoader::waitForAny()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	readyChanged.wait(lock, [this]() { return numReady.load() > 0 || slots.empty(); });
+}
+
+float ShaderLoader::loadMillis() const
+{
+	return std::chrono::duration<float, std::milli>(finish - start).count();
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "device.h"
+#include "com_ptr.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loads the shaders of a case list on a thread pool while the caller keeps dispatching the cases that are ready.
+// Each shader is loaded once. prepare(index, shader) runs on a loading thread for every case using the shader
+// (pipeline creation), then the case is marked ready.
+class ShaderLoader
+{
+public:
+	typedef std::function<void(unsigned, ComputeShader*)> PrepareFunc;
+
+	ShaderLoader(Device& device, const std::vector<std::string>& shaderNames, PrepareFunc prepare,
+				 unsigned numThreads = std::thread::hardware_concurrency());
+	~ShaderLoader();		// Waits for the loading threads
+
+	bool isReady(unsigned index) const { return ready[index].load(std::memory_order_acquire); }
+	ComputeShader* shader(unsigned index) const { return shaders[slots[index]]; }		// After isReady
+	bool allReady() const { return numReady.load(std::memory_order_acquire) == slots.size(); }
+
+	// Blocks until at least one case is ready, or every shader has been loaded
+	void waitForAny();
+
+	unsigned threads() const { return numThreads; }
+	unsigned uniqueShaders() const { return static_cast<unsigned>(shaders.size()); }
+	float loadMillis() const;		// Until every case was ready, valid after allReady()
+
+private:
+	void load(Device& device, const std::vector<std::string>& names, const PrepareFunc& prepare);
+
+	std::vector<unsigned> slots;						// Case -> unique shader
+	std::vector<std::vector<unsigned>> users;			// Unique shader -> cases
+	std::vector<com_ptr<ComputeShader>> shaders;
+	std::unique_ptr<std::atomic<bool>[]> ready;
+	std::atomic<unsigned> numReady;
+	unsigned numThreads;
+
+	std::chrono::steady_clock::time_point start;
+	std::chrono::steady_clock::time_point finish;
+	std::mutex mutex;
+	std::condition_variable readyChanged;
+	std::thread thread;
+};
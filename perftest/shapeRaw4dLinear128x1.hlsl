@@ -0,0 +1,7 @@
+#define LOAD_WIDTH 4
+#define LOAD_LINEAR
+#define GROUP_WIDTH 128
+#define GROUP_HEIGHT 1
+#define LOAD_RAW
+ByteAddressBuffer sourceData : register(t0);
+#include "groupShapeBody.hlsli"
@@ -0,0 +1,7 @@
+#define LOAD_WIDTH 4
+#define LOAD_RANDOM
+#define GROUP_WIDTH 16
+#define GROUP_HEIGHT 16
+#define LOAD_RAW
+ByteAddressBuffer sourceData : register(t0);
+#include "groupShapeBody.hlsli"
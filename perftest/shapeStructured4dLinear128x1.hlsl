@@ -0,0 +1,6 @@
+#define LOAD_WIDTH 4
+#define LOAD_LINEAR
+#define GROUP_WIDTH 128
+#define GROUP_HEIGHT 1
+StructuredBuffer<float4> sourceData : register(t0);
+#include "groupShapeBody.hlsli"
@@ -0,0 +1,6 @@
+#define LOAD_WIDTH 4
+#define LOAD_RANDOM
+#define GROUP_WIDTH 32
+#define GROUP_HEIGHT 32
+StructuredBuffer<float4> sourceData : register(t0);
+#include "groupShapeBody.hlsli"
@@ -0,0 +1,188 @@
+#include "statistics.h"
+#include <algorithm>
+#include <math.h>
+#include <assert.h>
+
+// Nearest rank percentile of sorted samples
+static float percentile(const float* sorted, unsigned count, float p)
+{
+	unsigned rank = unsigned(ceil(p * count));
+	return sorted[std::min(std::max(rank, 1u), count) - 1];
+}
+
+// Reorders the samples
+static float median(float* samples, unsigned count)
+{
+	float* middle = samples + count / 2;
+	std::nth_element(samples, middle, samples + count);
+	if (count & 1)
+		return *middle;
+
+	// Even count: average with the largest value of the lower half
+	float lower = *std::max_element(samples, middle);
+	return (lower + *middle) * 0.5f;
+}
+
+StatisticsCalculator::StatisticsCalculator(unsigned maxSamples, unsigned bootstrapResamples, float confidence) :
+	resamples(bootstrapResamples), confidenceLevel(confidence)
+{
+	sorted.reserve(maxSamples);
+	resample.resize(maxSamples);
+	medians.resize(bootstrapResamples);
+}
+
+SampleStatistics StatisticsCalculator::compute(const float* samples, unsigned count)
+{
+	SampleStatistics stats;
+	stats.count = count;
+	if (count == 0)
+		return stats;
+
+	assert(count <= resample.size());
+	sorted.assign(samples, samples + count);
+	std::sort(sorted.begin(), sorted.end());
+
+	stats.min = sorted[0];
+	stats.median = count & 1 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) * 0.5f;
+	stats.p90 = percentile(sorted.data(), count, 0.90f);
+	stats.p99 = percentile(sorted.data(), count, 0.99f);
+
+	double sum = 0.0;
+	for (unsigned i = 0; i < count; ++i)
+		sum += samples[i];
+	double mean = sum / count;
+
+	double squares = 0.0;
+	for (unsigned i = 0; i < count; ++i)
+		squares += (samples[i] - mean) * (samples[i] - mean);
+
+	stats.mean = float(mean);
+	stats.stddev = count > 1 ? float(sqrt(squares / (count - 1))) : 0.0f;
+
+	// Bootstrap: median of each resample drawn with replacement. Xorshift32, fixed seed.
+	uint32_t rng = 0x9e3779b9u;
+	for (unsigned r = 0; r < resamples; ++r)
+	{
+		for (unsigned i = 0; i < count; ++i)
+		{
+			rng ^= rng << 13;
+			rng ^= rng >> 17;
+			rng ^= rng << 5;
+			resample[i] = samples[uint64_t(rng) * count >> 32];
+		}
+		medians[r] = median(resample.data(), count);
+	}
+	std::sort(medians.begin(), medians.end());
+
+	float tail = (1.0f - confidenceLevel) * 0.5f;
+	stats.ciLow = percentile(medians.data(), resamples, tail);
+	stats.ciHigh = percentile(medians.data(), resamples, 1.0f - tail);
+	return stats;
+}
+
+WarmUpDetector::WarmUpDetector(unsigned window, float maxVariation, unsigned maxFrames) :
+	history(window * 2), window(window), maxVariation(maxVariation), maxFrames(maxFrames)
+{
+}
+
+bool WarmUpDetector::addFrame(float time)
+{
+	history[numFrames % history.size()] = time;
+	numFrames++;
+
+	if (numFrames >= maxFrames)
+		return true;
+	if (numFrames < history.size())
+		return false;
+
+	// Windows in the ring: previous = oldest half, last = newest half
+	double previousSum = 0.0, lastSum = 0.0;
+	for (unsigned i = 0; i < window; ++i)
+	{
+		previousSum += history[(numFrames + i) % history.size()];
+		lastSum += history[(numFrames + window + i) % history.size()];
+	}
+	double previousMean = previousSum / window;
+	double lastMean = lastSum / window;
+
+	double squares = 0.0;
+	for (unsigned i = 0; i < window; ++i)
+	{
+		double delta = history[(numFrames + window + i) % history.size()] - lastMean;
+		squares += delta * delta;
+	}
+	double stddev = sqrt(squares / (window - 1));
+
+	return stddev <= maxVariation * lastMean && fabs(lastMean - previousMean) <= maxVariation * lastMean;
+}
+
+DriftCompensator::DriftCompensator(unsigned numCases, unsigned maxSamples, float driftThreshold) :
+	cases(numCases), maxSamples(maxSamples), driftThreshold(driftThreshold)
+{
+	for (auto&& c : cases)
+		c.ratios.reserve(maxSamples);
+	references.reserve(size_t(numCases) * maxSamples * 2);
+}
+
+void DriftCompensator::addBefore(unsigned index, float referenceMillis)
+{
+	Case& c = cases[index];
+	c.before = referenceMillis;
+	c.hasBefore = true;
+	c.hasTime = false;
+}
+
+void DriftCompensator::addCase(unsigned index, float millis)
+{
+	Case& c = cases[index];
+	c.time = millis;
+	c.hasTime = c.hasBefore;
+}
+
+void DriftCompensator::addAfter(unsigned index, float referenceMillis)
+{
+	Case& c = cases[index];
+	bool complete = c.hasBefore && c.hasTime;
+	c.hasBefore = false;
+	c.hasTime = false;
+	if (!complete || c.ratios.size() == maxSamples)
+		return;
+
+	float reference = (c.before + referenceMillis) * 0.5f;
+	if (reference <= 0.0f)
+		return;
+
+	float drift = fabsf(referenceMillis - c.before) / reference;
+	c.maxDrift = std::max(c.maxDrift, drift);
+	c.drifted += drift > driftThreshold;
+	c.ratios.push_back(c.time / reference);
+	references.push_back(c.before);
+	references.push_back(referenceMillis);
+}
+
+void DriftCompensator::clear()
+{
+	for (auto&& c : cases)
+	{
+		c.ratios.clear();
+		c.drifted = 0;
+		c.maxDrift = 0.0f;
+	}
+	references.clear();
+}
+
+float DriftCompensator::referenceMedian() const
+{
+	if (references.empty())
+		return 0.0f;
+	std::vector<float> scratch(references);
+	return median(scratch.data(), unsigned(scratch.size()));
+}
+
+SampleBuffer DriftCompensator::normalized(unsigned index, float referenceMillis) const
+{
+	SampleBuffer samples(maxSamples);
+	for (float ratio : cases[index].ratios)
+		samples.add(ratio * referenceMillis);
+	return samples;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+
+// Summary of the timing samples of one case, in ms
+struct SampleStatistics
+{
+	unsigned count = 0;
+	float min = 0.0f;
+	float median = 0.0f;
+	float p90 = 0.0f;
+	float p99 = 0.0f;
+	float mean = 0.0f;
+	float stddev = 0.0f;
+	float ciLow = 0.0f;			// Bootstrap confidence interval of the median
+	float ciHigh = 0.0f;
+
+	// Confidence interval width relative to the median
+	float relativeCI() const { return median > 0.0f ? (ciHigh - ciLow) / median : 0.0f; }
+};
+
+// Fixed capacity sample storage. Memory is allocated up front, adding samples in the frame loop never allocates.
+// Samples past the capacity are dropped.
+class SampleBuffer
+{
+public:
+	explicit SampleBuffer(unsigned capacity = 0) { samples.reserve(capacity); }
+
+	void add(float sample)
+	{
+		if (samples.size() < samples.capacity())
+			samples.push_back(sample);
+	}
+
+	void clear() { samples.clear(); }
+	bool full() const { return samples.size() == samples.capacity(); }
+	unsigned size() const { return unsigned(samples.size()); }
+	const float* data() const { return samples.data(); }
+	float operator[](unsigned index) const { return samples[index]; }
+
+private:
+	std::vector<float> samples;
+};
+
+// Order statistics, standard deviation and a percentile bootstrap confidence interval of the median.
+// Scratch memory is allocated once. The resampling generator is seeded per call, results are deterministic.
+class StatisticsCalculator
+{
+public:
+	StatisticsCalculator(unsigned maxSamples, unsigned bootstrapResamples = 1000, float confidence = 0.95f);
+
+	SampleStatistics compute(const float* samples, unsigned count);
+	SampleStatistics compute(const SampleBuffer& samples) { return compute(samples.data(), samples.size()); }
+
+	float confidence() const { return confidenceLevel; }
+
+private:
+	std::vector<float> sorted;
+	std::vector<float> resample;
+	std::vector<float> medians;
+	unsigned resamples;
+	float confidenceLevel;
+};
+
+// Decides when warm-up is over: the last window of frame times varies less than maxVariation
+// (stddev / mean) and its mean has stopped drifting from the previous window. Gives up after maxFrames.
+class WarmUpDetector
+{
+public:
+	WarmUpDetector(unsigned window = 10, float maxVariation = 0.05f, unsigned maxFrames = 100);
+
+	// Returns true once warm-up is over
+	bool addFrame(float time);
+
+	unsigned frames() const { return numFrames; }
+
+private:
+	std::vector<float> history;		// Ring of the last two windows
+	unsigned window;
+	float maxVariation;
+	unsigned maxFrames;
+	unsigned numFrames = 0;
+};
+
+// Stability mode: each case runs between two dispatches of a reference kernel in the same frame. A sample is the case time
+// divided by the mean of its two references, which cancels GPU (or CPU) clock changes between frames. The samples are
+// scaled back to ms by the median reference time. References more than driftThreshold apart count as drifted frames.
+class DriftCompensator
+{
+public:
+	DriftCompensator(unsigned numCases, unsigned maxSamples, float driftThreshold = 0.05f);
+
+	// Results of one frame in issue order. A case without both of its references is dropped.
+	void addBefore(unsigned index, float referenceMillis);
+	void addCase(unsigned index, float millis);
+	void addAfter(unsigned index, float referenceMillis);
+
+	// Drops the warm-up frames
+	void clear();
+
+	// Samples of a case in ms of the given reference time, usually referenceMedian()
+	float referenceMedian() const;
+	SampleBuffer normalized(unsigned index, float referenceMillis) const;
+
+	unsigned frames(unsigned index) const { return unsigned(cases[index].ratios.size()); }
+	unsigned driftedFrames(unsigned index) const { return cases[index].drifted; }
+	float maxDrift(unsigned index) const { return cases[index].maxDrift; }
+	float threshold() const { return driftThreshold; }
+
+private:
+	struct Case
+	{
+		float before = 0.0f;
+		float time = 0.0f;
+		bool hasBefore = false;
+		bool hasTime = false;
+		std::vector<float> ratios;
+		unsigned drifted = 0;
+		float maxDrift = 0.0f;
+	};
+
+	std::vector<Case> cases;
+	std::vector<float> references;
+	unsigned maxSamples;
+	float driftThreshold;
+};
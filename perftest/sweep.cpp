@@ -0,0 +1,638 @@
+#include "sweep.h"
+#include "testCases.h"
+#include "com_ptr.h"
+#include "loadConstantsGPU.h"
+#include "trace.h"
+#include <map>
+#include <algorithm>
+#include <utility>
+#include <random>
+#include <chrono>
+#include <stdio.h>
+
+// Largest buffer view. D3D11 limit for typed views, also the usual Vulkan maxTexelBufferElements.
+static const uint64_t maxViewElements = 1u << 27;
+static const unsigned maxTextureDimension = 16384;
+static const uint64_t minWorkingSetBytes = 4096;
+
+// Uniform loads read a single address, they don't have a working set. Cbuffers can't grow past 64 KB.
+static std::vector<TestCase> declareSweepCases()
+{
+	std::vector<TestCase> cases;
+
+	// Format and components per load
+	struct SweepFormat
+	{
+		Format format;
+		unsigned width;
+	};
+
+	const SweepFormat formats[] =
+	{
+		{ Format::R8_UNORM, 1 }, { Format::R8G8_UNORM, 2 }, { Format::R8G8B8A8_UNORM, 4 },
+		{ Format::R16_FLOAT, 1 }, { Format::R16G16_FLOAT, 2 }, { Format::R16G16B16A16_FLOAT, 4 },
+		{ Format::R32_FLOAT, 1 }, { Format::R32G32_FLOAT, 2 }, { Format::R32G32B32A32_FLOAT, 4 },
+	};
+	const SweepFormat floatFormats[] = { { Format::R32_FLOAT, 1 }, { Format::R32G32_FLOAT, 2 }, { Format::R32G32B32A32_FLOAT, 4 } };
+
+	for (AccessPattern access : { AccessPattern::Linear, AccessPattern::Random })
+	{
+		for (const SweepFormat& format : formats)
+			cases.push_back({ ResourceType::TypedBuffer, format.format, format.width, access, ConstantsType::Aligned });
+		for (unsigned width : { 1, 2, 4 })
+			cases.push_back({ ResourceType::ByteAddressBuffer, Format::R32_UINT, width, access, ConstantsType::Aligned });
+		for (const SweepFormat& format : floatFormats)
+			cases.push_back({ ResourceType::StructuredBuffer, format.format, format.width, access, ConstantsType::Aligned });
+		for (const SweepFormat& format : formats)
+			cases.push_back({ ResourceType::Texture2D, format.format, format.width, access, ConstantsType::Aligned });
+	}
+	return cases;
+}
+
+// "32K", "1M"
+static std::string threadCountName(unsigned threads)
+{
+	if (threads >= (1u << 20))
+		return std::to_string(threads >> 20) + "M";
+	return std::to_string(threads >> 10) + "K";
+}
+
+// dispatch() records one run. Warm-up runs are dropped. Windowed frames report later, results of the previous point are told apart by id.
+void runSweepPoint(Device& device, unsigned pointId, const std::function<void()>& dispatch, unsigned numWarmUpRuns, unsigned numRuns,
+				   CaseResult& result)
+{
+	std::vector<QueryResult> queryResults;
+	unsigned received = 0;
+	while (received < numWarmUpRuns + numRuns)
+	{
+		TRACE_SCOPE("Frame");
+		QueryHandle query = device.startPerformanceQuery(pointId);
+		dispatch();
+		device.endPerformanceQuery(query);
+		device.presentFrame();
+
+		queryResults.clear();
+		device.processPerformanceResults(queryResults);
+		for (const QueryResult& queryResult : queryResults)
+		{
+			if (queryResult.id == pointId && received++ >= numWarmUpRuns)
+				result.samples.add(queryResult.millis);
+			if (traceEnabled && queryResult.id == pointId && queryResult.startNanos != 0)
+				traceGpu(result.name, queryResult.startNanos, queryResult.millis);
+		}
+	}
+}
+
+std::string sizeName(uint64_t bytes)
+{
+	if (bytes >= (1u << 30))
+		return std::to_string(bytes >> 30) + "GB";
+	if (bytes >= (1u << 20))
+		return std::to_string(bytes >> 20) + "MB";
+	if (bytes >= (1u << 10))
+		return std::to_string(bytes >> 10) + "KB";
+	return std::to_string(bytes) + "B";
+}
+
+void runWorkingSetSweep(Device& device, uint64_t maxBytes, unsigned numWarmUpRuns, unsigned numRuns,
+						const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results)
+{
+	// Same dispatch and loads per thread as the fixed cases
+	const uint3 threads(1024, 1024, 1);
+	const double loadsPerRun = double(threads.x) * threads.y * 256;
+
+	com_ptr<Buffer> outputBuffer = device.createBuffer(2048, 4, Device::BufferType::ByteAddress);
+	com_ptr<UnorderedAccessView> output = device.createTypedUAV(outputBuffer, 2048, Format::R32_FLOAT);
+	std::map<std::string, com_ptr<ComputeShader>> shaders;
+
+	unsigned pointId = 0;
+	for (const TestCase& test : declareSweepCases())
+	{
+		std::string series = test.name();
+		unsigned elementBytes = test.loadBytes();
+		bool texture = test.resource == ResourceType::Texture2D;
+		uint3 groupSize = texture ? uint3(16, 16, 1) : uint3(256, 1, 1);
+
+		for (uint64_t bytes = minWorkingSetBytes; bytes <= maxBytes; bytes *= 2)
+		{
+			// Elements are powers of two, addresses wrap with a mask
+			uint64_t elements = bytes / elementBytes;
+			uint2 dimensions(int(elements), 1);
+			if (texture)
+			{
+				unsigned widthLog2 = 0;
+				while ((uint64_t(1) << (widthLog2 * 2)) < elements)
+					widthLog2++;
+				dimensions = uint2(1 << widthLog2, int(elements >> widthLog2));
+				if (dimensions.x > maxTextureDimension)
+					break;
+			}
+			else if ((test.resource == ResourceType::ByteAddressBuffer ? bytes / 4 : elements) > maxViewElements)
+			{
+				break;
+			}
+
+			std::string name = series + " " + sizeName(bytes);
+			if (!selectCase(name))
+				continue;
+
+			std::string shaderName = "sweep" + test.shaderName().substr(4);
+			com_ptr<ComputeShader>& shader = shaders[shaderName];
+			if (!shader)
+				shader = device.loadComputeShader(shaderName);
+
+			SweepConstants sweepConstants;
+			sweepConstants.elementsMask = 0;			// Dummy mask to prevent unwanted compiler optimizations
+			sweepConstants.writeIndex = 0xffffffff;		// Never write
+			sweepConstants.dispatchWidth = threads.x;
+			sweepConstants.padding = 0;
+			sweepConstants.addressMask = uint2(dimensions.x - 1, dimensions.y - 1);
+			sweepConstants.padding2 = uint2();
+
+			com_ptr<Buffer> cb = device.createConstantBuffer(sizeof(SweepConstants));
+			device.updateConstantBuffer(cb, sweepConstants);
+
+			com_ptr<Buffer> buffer;
+			com_ptr<Texture> tex;
+			com_ptr<ShaderResourceView> source;
+			unsigned numElements = unsigned(elements);
+			switch (test.resource)
+			{
+			case ResourceType::TypedBuffer:
+				buffer = device.createBuffer(numElements, elementBytes, Device::BufferType::ByteAddress);
+				source = device.createTypedSRV(buffer, numElements, test.format);
+				break;
+			case ResourceType::ByteAddressBuffer:
+				buffer = device.createBuffer(unsigned(bytes / 4), 4, Device::BufferType::ByteAddress);
+				source = device.createByteAddressSRV(buffer, unsigned(bytes / 4));
+				break;
+			case ResourceType::StructuredBuffer:
+				buffer = device.createBuffer(numElements, elementBytes, Device::BufferType::Structured);
+				source = device.createStructuredSRV(buffer, numElements, elementBytes);
+				break;
+			case ResourceType::Texture2D:
+				tex = device.createTexture2d(dimensions, test.format, 1);
+				source = device.createSRV(tex);
+				break;
+			case ResourceType::ConstantBuffer:
+			case ResourceType::Texture3D:
+			case ResourceType::Groupshared:
+				break;
+			}
+
+			CaseResult result = { name, threads, groupSize, loadsPerRun, elementBytes, SampleBuffer(numRuns) };
+			result.series = series;
+			result.sweepPoint = true;
+			result.workingSetBytes = bytes;
+
+			runSweepPoint(device, pointId++, [&] { device.dispatch(shader, threads, groupSize, { cb }, { source }, { output }); },
+						  numWarmUpRuns, numRuns, result);
+			results.push_back(std::move(result));
+			printf("X");
+		}
+	}
+}
+
+void runGroupShapeSweep(Device& device, unsigned numWarmUpRuns, unsigned numRuns,
+						const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results)
+{
+	// Rows of the dispatch. Divisible by every group height, no partial groups.
+	const unsigned dispatchWidth = 1024;
+	const unsigned dispatchHeights[] = { 32, 128, 512, 1024 };
+
+	// 32 to 1024 threads, 1D and 2D. The fixed cases use 256x1 for buffers and 16x16 for textures.
+	const uint3 groupShapes[] =
+	{
+		uint3(32, 1, 1), uint3(64, 1, 1), uint3(128, 1, 1), uint3(256, 1, 1), uint3(512, 1, 1), uint3(1024, 1, 1),
+		uint3(8, 4, 1), uint3(8, 8, 1), uint3(16, 8, 1), uint3(16, 16, 1), uint3(32, 16, 1), uint3(32, 32, 1),
+	};
+
+	// Width 4 loads of the fixed cases. Their views are reused, so every point reads the same L1 resident data.
+	std::vector<TestCase> cases;
+	for (AccessPattern access : { AccessPattern::Linear, AccessPattern::Random })
+	{
+		cases.push_back({ ResourceType::TypedBuffer, Format::R8G8B8A8_UNORM, 4, access, ConstantsType::Aligned });
+		cases.push_back({ ResourceType::ByteAddressBuffer, Format::R32_UINT, 4, access, ConstantsType::Aligned });
+		cases.push_back({ ResourceType::StructuredBuffer, Format::R32G32B32A32_FLOAT, 4, access, ConstantsType::Aligned });
+		cases.push_back({ ResourceType::Texture2D, Format::R8G8B8A8_UNORM, 4, access, ConstantsType::Aligned });
+	}
+
+	TestResources resources(device);
+	unsigned pointId = 0;
+	for (const TestCase& test : cases)
+	{
+		std::string series = test.name();
+		for (uint3 groupSize : groupShapes)
+		{
+			std::string shape = std::to_string(groupSize.x) + "x" + std::to_string(groupSize.y);
+			com_ptr<ComputeShader> shader;
+
+			for (unsigned height : dispatchHeights)
+			{
+				uint3 threads(dispatchWidth, height, 1);
+				std::string name = series + " " + shape + " " + threadCountName(dispatchWidth * height) + " threads";
+				if (!selectCase(name))
+					continue;
+
+				if (!shader)
+					shader = device.loadComputeShader("shape" + test.shaderName().substr(4) + shape);
+
+				CaseResult result = { name, threads, groupSize, double(dispatchWidth) * height * 256, test.loadBytes(), SampleBuffer(numRuns) };
+				result.series = series;
+				result.sweepPoint = true;
+
+				runSweepPoint(device, pointId++, [&]
+				{
+					device.dispatch(shader, threads, groupSize, { resources.constants(test) }, { resources.source(test) }, { resources.output() });
+				},
+				numWarmUpRuns, numRuns, result);
+				results.push_back(std::move(result));
+				printf("X");
+			}
+		}
+	}
+}
+
+void runLatencySweep(Device& device, uint64_t maxBytes, unsigned numWarmUpRuns, unsigned numRuns,
+					 const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results)
+{
+	// Dependent loads of the single thread of chaseBody.hlsli
+	const unsigned chaseSteps = 1024;
+	const unsigned maxConstantBytes = 65536;
+
+	// R32 uint elements. Cbuffer elements are uint4, dynamic component indexing would add instructions to the chain.
+	struct ChaseCase
+	{
+		const char* name;
+		const char* shader;
+		ResourceType resource;
+		unsigned elementBytes;
+	};
+
+	const ChaseCase cases[] =
+	{
+		{ "Buffer<R32u>.Load chase", "Typed", ResourceType::TypedBuffer, 4 },
+		{ "ByteAddressBuffer.Load chase", "Raw", ResourceType::ByteAddressBuffer, 4 },
+		{ "StructuredBuffer<uint>.Load chase", "Structured", ResourceType::StructuredBuffer, 4 },
+		{ "cbuffer{uint4} load chase", "Constant", ResourceType::ConstantBuffer, 16 },
+		{ "Texture2D<R32u>.Load chase", "Tex", ResourceType::Texture2D, 4 },
+	};
+
+	// Chain position, carried over between the runs of a point. Masked to a valid element by the shader.
+	com_ptr<Buffer> stateBuffer = device.createBuffer(1, 4, Device::BufferType::ByteAddress);
+	com_ptr<UnorderedAccessView> state = device.createTypedUAV(stateBuffer, 1, Format::R32_UINT);
+
+	// The cbuffer chain is a random cyclic permutation (Sattolo), the other resources are filled by the init shaders
+	std::mt19937 random(1234);
+	std::vector<uint4> chain;
+
+	unsigned pointId = 0;
+	for (const ChaseCase& test : cases)
+	{
+		com_ptr<ComputeShader> shader;
+		com_ptr<ComputeShader> initShader;
+		bool texture = test.resource == ResourceType::Texture2D;
+
+		for (uint64_t bytes = minWorkingSetBytes; bytes <= maxBytes; bytes *= 2)
+		{
+			uint64_t elements = bytes / test.elementBytes;
+			unsigned widthLog2 = 0;
+			if (texture)
+			{
+				while ((uint64_t(1) << (widthLog2 * 2)) < elements)
+					widthLog2++;
+				if ((1u << widthLog2) > maxTextureDimension)
+					break;
+			}
+			else if (test.resource == ResourceType::ConstantBuffer ? bytes > maxConstantBytes : elements > maxViewElements)
+			{
+				break;
+			}
+
+			std::string name = std::string(test.name) + " " + sizeName(bytes);
+			if (!selectCase(name))
+				continue;
+
+			if (!shader)
+			{
+				shader = device.loadComputeShader(std::string("chase") + test.shader);
+				if (test.resource != ResourceType::ConstantBuffer)
+					initShader = device.loadComputeShader(std::string("chaseInit") + test.shader);
+			}
+
+			unsigned numElements = unsigned(elements);
+			uint2 dimensions(1 << widthLog2, int(elements >> widthLog2));
+
+			unsigned addressBits = 0;
+			while ((uint64_t(1) << addressBits) < elements)
+				addressBits++;
+
+			// Start of the chain masked to a valid address encoding of chaseBody.hlsli
+			ChaseConstants chaseConstants;
+			chaseConstants.addressMask = numElements - 1;
+			chaseConstants.startMask = numElements - 1;
+			chaseConstants.permuteShift = std::max(addressBits / 2, 1u);
+			chaseConstants.textureWidthLog2 = widthLog2;
+			if (test.resource == ResourceType::ByteAddressBuffer)
+				chaseConstants.startMask = (numElements - 1) * 4;
+			else if (texture)
+				chaseConstants.startMask = (dimensions.x - 1) | ((dimensions.y - 1) << 16);
+
+			com_ptr<Buffer> cb = device.createConstantBuffer(sizeof(ChaseConstants));
+			device.updateConstantBuffer(cb, chaseConstants);
+
+			com_ptr<Buffer> buffer;
+			com_ptr<Buffer> chainBuffer;
+			com_ptr<Texture> tex;
+			com_ptr<ShaderResourceView> source;
+			com_ptr<UnorderedAccessView> target;
+			switch (test.resource)
+			{
+			case ResourceType::TypedBuffer:
+				buffer = device.createBuffer(numElements, 4, Device::BufferType::ByteAddress);
+				source = device.createTypedSRV(buffer, numElements, Format::R32_UINT);
+				target = device.createTypedUAV(buffer, numElements, Format::R32_UINT);
+				break;
+			case ResourceType::ByteAddressBuffer:
+				buffer = device.createBuffer(numElements, 4, Device::BufferType::ByteAddress);
+				source = device.createByteAddressSRV(buffer, numElements);
+				target = device.createByteAddressUAV(buffer, numElements);
+				break;
+			case ResourceType::StructuredBuffer:
+				buffer = device.createBuffer(numElements, 4, Device::BufferType::Structured);
+				source = device.createStructuredSRV(buffer, numElements, 4);
+				target = device.createStructuredUAV(buffer, numElements, 4);
+				break;
+			case ResourceType::Texture2D:
+				tex = device.createTexture2d(dimensions, Format::R32_UINT, 1);
+				source = device.createSRV(tex);
+				target = device.createUAV(tex);
+				break;
+			case ResourceType::ConstantBuffer:
+			{
+				// Unused elements of the 64 KB chain stay zero, the chain never reaches them
+				chain.assign(maxConstantBytes / sizeof(uint4), uint4());
+				std::vector<unsigned> order(numElements);
+				for (unsigned i = 0; i < numElements; ++i)
+					order[i] = i;
+				for (unsigned i = numElements - 1; i > 0; --i)
+					std::swap(order[i], order[std::uniform_int_distribution<unsigned>(0, i - 1)(random)]);
+				for (unsigned i = 0; i < numElements; ++i)
+					chain[i].x = order[i];
+
+				chainBuffer = device.createConstantBuffer(maxConstantBytes);
+				device.updateConstantBuffer(chainBuffer, chain.data(), maxConstantBytes);
+				break;
+			}
+			default:
+				break;
+			}
+
+			// One thread per element, rows of 1024 in slices of 1024 rows. 128M elements are 128 slices.
+			if (initShader)
+			{
+				unsigned rows = std::max(numElements / 1024, 1u);
+				uint3 initThreads(std::min(numElements, 1024u), std::min(rows, 1024u), std::max(rows / 1024, 1u));
+				device.dispatch(initShader, initThreads, uint3(256, 1, 1), { cb }, {}, { target });
+			}
+
+			CaseResult result = { name, uint3(1, 1, 1), uint3(1, 1, 1), double(chaseSteps), test.elementBytes, SampleBuffer(numRuns) };
+			result.series = test.name;
+			result.sweepPoint = true;
+			result.latency = true;
+			result.workingSetBytes = bytes;
+
+			runSweepPoint(device, pointId++, [&]
+			{
+				device.dispatch(shader, uint3(1, 1, 1), uint3(1, 1, 1), { cb, chainBuffer }, { source }, { state });
+			},
+			numWarmUpRuns, numRuns, result);
+			results.push_back(std::move(result));
+			printf("X");
+		}
+	}
+}
+
+void runTransferSuite(Device& device, uint64_t maxBytes, unsigned numWarmUpRuns, unsigned numRuns,
+					  const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results)
+{
+	// record() is timed on the CPU and, with gpu set, by a query around it. read() runs after the frame is submitted
+	// and adds to the CPU time.
+	struct Transfer
+	{
+		const char* name;
+		bool gpu;
+		std::function<void()> record;
+		std::function<void()> read;
+	};
+
+	unsigned pointId = 0;
+	for (unsigned op = 0; op < 4; ++op)
+	{
+		std::vector<CaseResult> cpuResults, gpuResults;
+		for (uint64_t bytes = 64; bytes <= maxBytes; bytes *= 4)
+		{
+			size_t size = size_t(bytes);
+			com_ptr<Buffer> buffer, staging;
+			std::vector<uint8_t> hostData(size, 0x5a);
+			Transfer transfer;
+			switch (op)
+			{
+			case 0:
+				transfer = { "Map(WRITE_DISCARD) dynamic", false, [&] { device.writeBuffer(buffer, hostData.data(), size); } };
+				break;
+			case 1:
+				transfer = { "UpdateSubresource default", true, [&] { device.updateBuffer(buffer, hostData.data(), size); } };
+				break;
+			case 2:
+				transfer = { "Staging to default copy", true, [&]
+				{
+					device.writeBuffer(staging, hostData.data(), size);
+					device.copyBuffer(buffer, staging, size);
+				} };
+				break;
+			case 3:
+				transfer = { "Default to staging readback", true, [&] { device.copyBuffer(staging, buffer, size); },
+							 [&] { device.readBuffer(staging, hostData.data(), size); } };
+				break;
+			}
+
+			std::string cpuName = std::string(transfer.name) + " CPU " + sizeName(bytes);
+			std::string gpuName = std::string(transfer.name) + " GPU " + sizeName(bytes);
+			bool selectCpu = selectCase(cpuName);
+			bool selectGpu = transfer.gpu && selectCase(gpuName);
+			if (!selectCpu && !selectGpu)
+				continue;
+
+			if (op == 0)
+				buffer = device.createDynamicBuffer(unsigned(bytes));
+			else
+				buffer = device.createBuffer(unsigned(bytes / 4), 4, Device::BufferType::ByteAddress);
+			if (op >= 2)
+				staging = device.createStagingBuffer(unsigned(bytes), op == 2 ? Device::StagingType::Upload : Device::StagingType::Readback);
+
+			// Bytes are the elements, GB/s is bytes per ns
+			CaseResult cpuResult = { cpuName, uint3(), uint3(), double(bytes), 1, SampleBuffer(numRuns) };
+			cpuResult.series = std::string(transfer.name) + " CPU";
+			cpuResult.sweepPoint = true;
+			cpuResult.transfer = true;
+			cpuResult.workingSetBytes = bytes;
+			cpuResult.rateUnit = "bytes";
+			CaseResult gpuResult = cpuResult;
+			gpuResult.name = gpuName;
+			gpuResult.samples = SampleBuffer(numRuns);
+			gpuResult.series = std::string(transfer.name) + " GPU";
+
+			// Windowed frames report later, queries of the previous point are told apart by id
+			std::vector<QueryResult> queryResults;
+			unsigned cpuRuns = 0, gpuReceived = 0;
+			while (cpuRuns < numWarmUpRuns + numRuns || (selectGpu && gpuReceived < numWarmUpRuns + numRuns))
+			{
+				auto start = std::chrono::steady_clock::now();
+				QueryHandle query = device.startPerformanceQuery(pointId);
+				transfer.record();
+				device.endPerformanceQuery(query);
+				auto recorded = std::chrono::steady_clock::now();
+				device.presentFrame();
+
+				auto readStart = std::chrono::steady_clock::now();
+				if (transfer.read)
+					transfer.read();
+				auto end = std::chrono::steady_clock::now();
+
+				if (cpuRuns++ >= numWarmUpRuns && cpuRuns <= numWarmUpRuns + numRuns)
+					cpuResult.samples.add(std::chrono::duration<float, std::milli>((recorded - start) + (end - readStart)).count());
+
+				queryResults.clear();
+				device.processPerformanceResults(queryResults);
+				for (const QueryResult& queryResult : queryResults)
+				{
+					if (queryResult.id == pointId && gpuReceived++ >= numWarmUpRuns && gpuReceived <= numWarmUpRuns + numRuns)
+						gpuResult.samples.add(queryResult.millis);
+				}
+			}
+			pointId++;
+
+			if (selectCpu)
+				cpuResults.push_back(std::move(cpuResult));
+			if (selectGpu)
+				gpuResults.push_back(std::move(gpuResult));
+			printf("X");
+		}
+
+		// Points of a series are consecutive
+		for (auto&& result : cpuResults)
+			results.push_back(std::move(result));
+		for (auto&& result : gpuResults)
+			results.push_back(std::move(result));
+	}
+}
+
+void printGroupShapeHeatmaps(const std::vector<CaseResult>& results)
+{
+	// Points of one series are consecutive. Rows are group shapes, columns dispatch sizes, both in sweep order.
+	for (size_t first = 0; first < results.size();)
+	{
+		const CaseResult& start = results[first];
+		size_t end = first + 1;
+		while (end < results.size() && results[end].sweepPoint && results[end].series == start.series)
+			end++;
+
+		if (!start.sweepPoint || start.workingSetBytes != 0 || start.overhead || start.recordingThreads || start.alu)
+		{
+			first = end;
+			continue;
+		}
+
+		std::vector<unsigned> heights;
+		std::vector<uint3> shapes;
+		double best = 0.0;
+		for (size_t i = first; i < end; ++i)
+		{
+			const CaseResult& point = results[i];
+			if (std::find(heights.begin(), heights.end(), point.threads.y) == heights.end())
+				heights.push_back(point.threads.y);
+			if (std::find_if(shapes.begin(), shapes.end(), [&](uint3 s) { return s.x == point.groupSize.x && s.y == point.groupSize.y; }) == shapes.end())
+				shapes.push_back(point.groupSize);
+			best = std::max(best, point.elementsPerNs());
+		}
+		std::sort(heights.begin(), heights.end());
+
+		printf("\n%s, %% of the best point (%.1f GB/s):\n%9s", start.series.c_str(), best * start.loadBytes, "");
+		for (unsigned height : heights)
+			printf(" %6s", threadCountName(start.threads.x * height).c_str());
+		printf("\n");
+
+		for (uint3 shape : shapes)
+		{
+			printf("%9s", (std::to_string(shape.x) + "x" + std::to_string(shape.y)).c_str());
+			for (unsigned height : heights)
+			{
+				auto point = std::find_if(results.begin() + first, results.begin() + end, [&](const CaseResult& r)
+				{
+					return r.threads.y == height && r.groupSize.x == shape.x && r.groupSize.y == shape.y;
+				});
+				if (point == results.begin() + end || best == 0.0)
+					printf(" %6s", "-");
+				else
+					printf(" %5.0f%%", 100.0 * point->elementsPerNs() / best);
+			}
+			printf("\n");
+		}
+		first = end;
+	}
+}
+
+void printSweepCurves(const std::vector<CaseResult>& results)
+{
+	const std::string* series = nullptr;
+	for (auto&& result : results)
+	{
+		if (result.workingSetBytes == 0 || result.latency || result.transfer)
+			continue;
+
+		if (!series || *series != result.series)
+		{
+			series = &result.series;
+			printf("\n%s:", series->c_str());
+		}
+		printf(" %s %.1f", sizeName(result.workingSetBytes).c_str(), result.elementsPerNs() * result.loadBytes);
+	}
+	printf("\n");
+}
+
+void printLatencyCurves(const std::vector<CaseResult>& results)
+{
+	const std::string* series = nullptr;
+	for (auto&& result : results)
+	{
+		if (!result.latency || result.stats.count == 0)
+			continue;
+
+		if (!series || *series != result.series)
+		{
+			series = &result.series;
+			printf("\n%s:", series->c_str());
+		}
+		printf(" %s %.1f", sizeName(result.workingSetBytes).c_str(), 1.0 / result.elementsPerNs());
+	}
+	printf("\n");
+}
+
+void printTransferCurves(const std::vector<CaseResult>& results)
+{
+	const std::string* series = nullptr;
+	for (auto&& result : results)
+	{
+		if (!result.transfer || result.stats.count == 0)
+			continue;
+
+		if (!series || *series != result.series)
+		{
+			series = &result.series;
+			printf("\n%s:", series->c_str());
+		}
+		printf(" %s %.1fus %.2fGB/s", sizeName(result.workingSetBytes).c_str(), result.stats.median * 1000.0f, result.elementsPerNs());
+	}
+	printf("\n");
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "device.h"
+#include "results.h"
+#include <functional>
+
+// Working set sweep. Buffer and texture loads over working sets growing by powers of two from 4 KB to maxBytes,
+// addresses span the whole working set. Each resource exists only while its point runs.
+// Points are named "<case> <size>", e.g. "Buffer<RGBA8>.Load linear 64KB". selectCase is called once per point.
+void runWorkingSetSweep(Device& device, uint64_t maxBytes, unsigned numWarmUpRuns, unsigned numRuns,
+						const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results);
+
+// Group shape sweep. Width 4 loads of the fixed cases compiled for groups of 32 to 1024 threads, 1D and 2D,
+// each over dispatches of 32K to 1M threads. Points are named "<case> <group> <threads> threads",
+// e.g. "Texture2D<RGBA8>.Load linear 16x16 1M threads". selectCase is called once per point.
+void runGroupShapeSweep(Device& device, unsigned numWarmUpRuns, unsigned numRuns,
+						const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results);
+
+// Dependent load latency. A single thread follows a random cyclic permutation through typed, raw, structured and
+// texture R32 uint resources of 4 KB to maxBytes, and through cbuffers of up to 64 KB. Each load's address is the value
+// of the previous load. Points are named "<case> <size>", e.g. "Buffer<R32u>.Load chase 64KB".
+void runLatencySweep(Device& device, uint64_t maxBytes, unsigned numWarmUpRuns, unsigned numRuns,
+					 const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results);
+
+// Transfers of 64 B to maxBytes, growing by 4x: Map(WRITE_DISCARD) of a dynamic buffer, UpdateSubresource of a default
+// buffer, staging to default copies and default to staging readback. Each has a CPU series, the time of the calls,
+// and except for Map a GPU series, a query around the copy. Points are named "<transfer> CPU|GPU <size>",
+// e.g. "Staging to default copy GPU 1MB". selectCase is called for both series of a point.
+void runTransferSuite(Device& device, uint64_t maxBytes, unsigned numWarmUpRuns, unsigned numRuns,
+					  const std::function<bool(const std::string&)>& selectCase, std::vector<CaseResult>& results);
+
+// Runs one point: numWarmUpRuns dropped runs and numRuns samples of dispatch(), one query around each run. pointId
+// tells the queries of this point apart from the late results of the previous one.
+void runSweepPoint(Device& device, unsigned pointId, const std::function<void()>& dispatch, unsigned numWarmUpRuns, unsigned numRuns,
+				   CaseResult& result);
+
+// Per series, load rate of each group shape (rows) and dispatch size (columns) relative to its best point
+void printGroupShapeHeatmaps(const std::vector<CaseResult>& results);
+
+// GB/s per working set size, one line per series
+void printSweepCurves(const std::vector<CaseResult>& results);
+
+// ns per dependent load per working set size, one line per series
+void printLatencyCurves(const std::vector<CaseResult>& results);
+
+// µs and GB/s of the median per transfer size, one line per series
+void printTransferCurves(const std::vector<CaseResult>& results);
+
+// "64B", "4KB", "64MB", "1GB"
+std::string sizeName(uint64_t bytes);
@@ -0,0 +1,71 @@
+#include "hash.hlsli"
+#include "loadConstantsGPU.h"
+
+RWBuffer<float> output : register(u0);
+
+cbuffer CB0 : register(b0)
+{
+	SweepConstants sweepConstants;
+};
+
+#define THREAD_GROUP_SIZE 256
+
+// Odd number of groups between the blocks a group reads in consecutive iterations.
+// Visits every block of a power of two working set before reading the same block again.
+#define BLOCK_STRIDE (THREAD_GROUP_SIZE * 4099)
+
+groupshared float dummyLDS[THREAD_GROUP_SIZE];
+
+[numthreads(THREAD_GROUP_SIZE, 1, 1)]
+void main(uint3 tid : SV_DispatchThreadID, uint gix : SV_GroupIndex)
+{
+	float4 value = 0.0;
+
+	uint threadIndex = tid.y * sweepConstants.dispatchWidth + tid.x;
+
+	[loop]
+	for (int i = 0; i < 256; ++i)
+	{
+#if defined(LOAD_LINEAR)
+		// Group loads a contiguous block to allow memory coalescing
+		uint elemIdx = threadIndex + i * BLOCK_STRIDE;
+#elif defined(LOAD_RANDOM)
+		// Random address anywhere in the working set to prevent memory coalescing
+		uint elemIdx = hash2(uint2(threadIndex, i));
+#endif
+
+		// Mask with runtime constant to prevent unwanted compiler optimizations
+		elemIdx = (elemIdx & sweepConstants.addressMask.x) | sweepConstants.elementsMask;
+
+#if defined(LOAD_RAW)
+#if LOAD_WIDTH == 1
+		value += sourceData.Load(elemIdx * 4).xxxx;
+#elif LOAD_WIDTH == 2
+		value += sourceData.Load2(elemIdx * 8).xyxy;
+#elif LOAD_WIDTH == 4
+		value += sourceData.Load4(elemIdx * 16).xyzw;
+#endif
+#else
+#if LOAD_WIDTH == 1
+		value += sourceData[elemIdx].xxxx;
+#elif LOAD_WIDTH == 2
+		value += sourceData[elemIdx].xyxy;
+#elif LOAD_WIDTH == 4
+		value += sourceData[elemIdx].xyzw;
+#endif
+#endif
+	}
+
+    // Linear write to LDS (no bank conflicts). Significantly faster than memory loads.
+	dummyLDS[gix] = value.x + value.y + value.z + value.w;
+
+	GroupMemoryBarrierWithGroupSync();
+
+	// This branch is never taken, but the compiler doesn't know it
+	// Optimizer would remove all the memory loads if the data wouldn't be potentially used
+	[branch]
+	if (sweepConstants.writeIndex != 0xffffffff)
+	{
+        output[tid.x + tid.y] = dummyLDS[sweepConstants.writeIndex];
+    }
+}
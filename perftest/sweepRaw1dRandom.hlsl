@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 1
+#define LOAD_RANDOM
+#define LOAD_RAW
+ByteAddressBuffer sourceData : register(t0);
+#include "sweepBufferBody.hlsli"
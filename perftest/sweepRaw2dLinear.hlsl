@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 2
+#define LOAD_LINEAR
+#define LOAD_RAW
+ByteAddressBuffer sourceData : register(t0);
+#include "sweepBufferBody.hlsli"
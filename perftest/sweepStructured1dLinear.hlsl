@@ -0,0 +1,4 @@
+#define LOAD_WIDTH 1
+#define LOAD_LINEAR
+StructuredBuffer<float> sourceData : register(t0);
+#include "sweepBufferBody.hlsli"
@@ -0,0 +1,4 @@
+#define LOAD_WIDTH 1
+#define LOAD_RANDOM
+Texture2D<float> sourceData : register(t0);
+#include "sweepTexBody.hlsli"
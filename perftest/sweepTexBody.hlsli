@@ -0,0 +1,60 @@
+#include "hash.hlsli"
+#include "loadConstantsGPU.h"
+
+RWBuffer<float> output : register(u0);
+
+cbuffer CB0 : register(b0)
+{
+	SweepConstants sweepConstants;
+};
+
+#define THREAD_GROUP_DIM 16
+
+// Odd number of groups between the tiles a group reads in consecutive iterations.
+// Walks diagonally through power of two textures without reading the same tile twice in a row.
+#define TILE_STRIDE uint2(THREAD_GROUP_DIM * 67, THREAD_GROUP_DIM * 131)
+
+groupshared float dummyLDS[THREAD_GROUP_DIM][THREAD_GROUP_DIM];
+
+[numthreads(THREAD_GROUP_DIM, THREAD_GROUP_DIM, 1)]
+void main(uint3 tid : SV_DispatchThreadID, uint3 gid : SV_GroupThreadID)
+{
+	float4 value = 0.0;
+
+	[loop]
+	for (int i = 0; i < 256; ++i)
+	{
+#if defined(LOAD_LINEAR)
+		// Group loads a contiguous tile
+		uint2 elemIdx = tid.xy + i * TILE_STRIDE;
+#elif defined(LOAD_RANDOM)
+		// Random texel anywhere in the working set
+		uint h = hash2(uint2(tid.x | (tid.y << 16), i));
+		uint2 elemIdx = uint2(h, h >> 16);
+#endif
+
+		// Mask with runtime constant to prevent unwanted compiler optimizations
+		elemIdx = (elemIdx & sweepConstants.addressMask) | sweepConstants.elementsMask;
+
+#if LOAD_WIDTH == 1
+		value += sourceData[elemIdx].xxxx;
+#elif LOAD_WIDTH == 2
+		value += sourceData[elemIdx].xyxy;
+#elif LOAD_WIDTH == 4
+		value += sourceData[elemIdx].xyzw;
+#endif
+	}
+
+    // Linear write to LDS (no bank conflicts). Significantly faster than memory loads.
+	dummyLDS[gid.y][gid.x] = value.x + value.y + value.z + value.w;
+
+	GroupMemoryBarrierWithGroupSync();
+
+	// This branch is never taken, but the compiler doesn't know it
+	// Optimizer would remove all the memory loads if the data wouldn't be potentially used
+	[branch]
+	if (sweepConstants.writeIndex != 0xffffffff)
+	{
+        output[tid.x + tid.y] = dummyLDS[(sweepConstants.writeIndex >> 8) & 0xff][sweepConstants.writeIndex & 0xff];
+    }
+}
@@ -0,0 +1,4 @@
+#define LOAD_WIDTH 2
+#define LOAD_RANDOM
+Buffer<float2> sourceData : register(t0);
+#include "sweepBufferBody.hlsli"
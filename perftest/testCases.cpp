@@ -0,0 +1,654 @@
+#include "testCases.h"
+#include "graphicsUtil.h"
+#include "loadConstantsGPU.h"
+#include <string.h>
+#include <assert.h>
+
+static const char* formatName(Format format)
+{
+	switch (format)
+	{
+	case Format::R8_UNORM: return "R8";
+	case Format::R8G8_UNORM: return "RG8";
+	case Format::R8G8B8A8_UNORM: return "RGBA8";
+	case Format::R16_FLOAT: return "R16f";
+	case Format::R16G16_FLOAT: return "RG16f";
+	case Format::R16G16B16A16_FLOAT: return "RGBA16f";
+	case Format::R32_FLOAT: return "R32f";
+	case Format::R32G32_FLOAT: return "RG32f";
+	case Format::R32G32B32A32_FLOAT: return "RGBA32f";
+	case Format::R32_UINT: return "R32u";
+	}
+	return "";
+}
+
+static const char* accessName(AccessPattern access)
+{
+	switch (access)
+	{
+	case AccessPattern::Uniform: return "uniform";
+	case AccessPattern::Wave: return "per-wave";
+	case AccessPattern::Linear: return "linear";
+	case AccessPattern::Random: return "random";
+	}
+	return "";
+}
+
+// Sampling cases call the linear pattern coherent
+static const char* uvName(AccessPattern access)
+{
+	return access == AccessPattern::Linear ? "coherent" : accessName(access);
+}
+
+static const char* samplerName(Device::SamplerType sampler)
+{
+	switch (sampler)
+	{
+	case Device::SamplerType::Nearest: return "nearest";
+	case Device::SamplerType::Bilinear: return "bilinear";
+	case Device::SamplerType::Trilinear: return "trilinear";
+	}
+	return "";
+}
+
+static const char* waveName(WaveBroadcast wave)
+{
+	switch (wave)
+	{
+	case WaveBroadcast::None: return "";
+	case WaveBroadcast::ReadLaneFirst: return "WaveReadLaneFirst";
+	case WaveBroadcast::ReadLaneAt: return "WaveReadLaneAt";
+	case WaveBroadcast::FirstLaneLoad: return "first lane load";
+	}
+	return "";
+}
+
+// Shader file suffix
+static const char* accessDefine(AccessPattern access)
+{
+	switch (access)
+	{
+	case AccessPattern::Uniform: return "Invariant";
+	case AccessPattern::Wave: return "Wave";
+	case AccessPattern::Linear: return "Linear";
+	case AccessPattern::Random: return "Random";
+	}
+	return "";
+}
+
+// Method called in the loop. Raw buffer methods are suffixed with the width.
+static std::string operationName(Operation operation, const std::string& width)
+{
+	switch (operation)
+	{
+	case Operation::Load:
+	case Operation::UavLoad: return "Load" + width;
+	case Operation::SampleLevel: return "SampleLevel";
+	case Operation::SampleGrad: return "SampleGrad";
+	case Operation::Gather: return "GatherRed";
+	case Operation::UavStore: return "Store" + width;
+	case Operation::UavLoadModifyStore: return "Load" + width + "+Store" + width;
+	case Operation::AtomicAdd: return "InterlockedAdd";
+	case Operation::AtomicMin: return "InterlockedMin";
+	case Operation::AtomicMax: return "InterlockedMax";
+	case Operation::AtomicCompareExchange: return "InterlockedCompareExchange";
+	}
+	return "";
+}
+
+std::string TestCase::name() const
+{
+	// The uniform case name with the broadcast appended, e.g. "Buffer<RGBA8>.Load uniform WaveReadLaneAt"
+	if (wave != WaveBroadcast::None)
+	{
+		TestCase invariant = *this;
+		invariant.wave = WaveBroadcast::None;
+		return invariant.name() + " " + waveName(wave);
+	}
+
+	std::string width = loadWidth > 1 ? std::to_string(loadWidth) : "";
+	std::string access = accessName(this->access);
+	std::string rw = operation == Operation::Load || sampled() ? "" : "RW";
+	std::string op = operationName(operation, "");
+
+	switch (resource)
+	{
+	case ResourceType::TypedBuffer:
+		return rw + "Buffer<" + formatName(format) + ">." + op + " " + access;
+	case ResourceType::ByteAddressBuffer:
+		return rw + "ByteAddressBuffer." + operationName(operation, width) + (constants == ConstantsType::Unaligned ? " unaligned " : " ") + access;
+	case ResourceType::StructuredBuffer:
+		return rw + "StructuredBuffer<float" + width + ">." + op + " " + access;
+	case ResourceType::ConstantBuffer:
+		return "cbuffer{float" + width + "} load " + access;
+	case ResourceType::Texture2D:
+	case ResourceType::Texture3D:
+	{
+		// Texture names have always used upper case F
+		std::string format = formatName(this->format);
+		if (format.back() == 'f')
+			format.back() = 'F';
+		std::string texture = rw + (resource == ResourceType::Texture2D ? "Texture2D<" : "Texture3D<") + format + ">." + op;
+		if (operation == Operation::SampleLevel || operation == Operation::SampleGrad)
+			return texture + " " + samplerName(sampler) + " " + uvName(this->access);
+		if (operation == Operation::Gather)
+			return texture + " " + uvName(this->access);
+		return texture + " " + access;
+	}
+	case ResourceType::Groupshared:
+		if (operation != Operation::Load)
+			return "groupshared." + op + " " + access;
+		if (this->access == AccessPattern::Linear)
+			return series() + " stride " + std::to_string(stride);
+		return series() + (this->access == AccessPattern::Uniform ? " broadcast" : " scattered");
+	}
+	return "";
+}
+
+std::string TestCase::series() const
+{
+	if (resource != ResourceType::Groupshared || operation != Operation::Load)
+		return "";
+	return "groupshared uint" + std::string(loadWidth > 1 ? std::to_string(loadWidth) : "") + ".Load";
+}
+
+std::string TestCase::shaderName() const
+{
+	const char* op = "";
+	switch (operation)
+	{
+	case Operation::Load: op = "load"; break;
+	case Operation::SampleLevel: op = "sampleLevel"; break;
+	case Operation::SampleGrad: op = "sampleGrad"; break;
+	case Operation::Gather: op = "gather"; break;
+	case Operation::UavLoad: op = "uavLoad"; break;
+	case Operation::UavStore: op = "uavStore"; break;
+	case Operation::UavLoadModifyStore: op = "uavRmw"; break;
+	case Operation::AtomicAdd: op = "atomicAdd"; break;
+	case Operation::AtomicMin: op = "atomicMin"; break;
+	case Operation::AtomicMax: op = "atomicMax"; break;
+	case Operation::AtomicCompareExchange: op = "atomicCmpXchg"; break;
+	}
+
+	// waveLoadBody.hlsli
+	switch (wave)
+	{
+	case WaveBroadcast::None: break;
+	case WaveBroadcast::ReadLaneFirst: op = "waveLaneFirst"; break;
+	case WaveBroadcast::ReadLaneAt: op = "waveLaneAt"; break;
+	case WaveBroadcast::FirstLaneLoad: op = "waveFirstLaneLoad"; break;
+	}
+
+	const char* type = "";
+	switch (resource)
+	{
+	case ResourceType::TypedBuffer: type = "Typed"; break;
+	case ResourceType::ByteAddressBuffer: type = "Raw"; break;
+	case ResourceType::StructuredBuffer: type = "Structured"; break;
+	case ResourceType::ConstantBuffer: type = "Constant"; break;
+	case ResourceType::Texture2D: type = "Tex"; break;
+	case ResourceType::Texture3D: type = "Tex3d"; break;
+	case ResourceType::Groupshared: type = "Groupshared"; break;
+	}
+	std::string access = stride ? "Stride" + std::to_string(stride) : accessDefine(this->access);
+	return op + std::string(type) + std::to_string(loadWidth) + "d" + access;
+}
+
+unsigned TestCase::loadBytes() const
+{
+	switch (resource)
+	{
+	case ResourceType::TypedBuffer:
+	case ResourceType::Texture2D:
+	case ResourceType::Texture3D:
+		return formatBytes(format);
+	default:
+		return loadWidth * 4;
+	}
+}
+
+bool TestCase::atomic() const
+{
+	switch (operation)
+	{
+	case Operation::AtomicAdd:
+	case Operation::AtomicMin:
+	case Operation::AtomicMax:
+	case Operation::AtomicCompareExchange:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool TestCase::sampled() const
+{
+	return operation == Operation::SampleLevel || operation == Operation::SampleGrad || operation == Operation::Gather;
+}
+
+static void addCases(std::vector<TestCase>& cases, ResourceType resource, Format format, unsigned loadWidth, ConstantsType constants = ConstantsType::Aligned)
+{
+	for (AccessPattern access : { AccessPattern::Uniform, AccessPattern::Linear, AccessPattern::Random })
+	{
+		cases.push_back({ resource, format, loadWidth, access, constants });
+
+		// Uniform loads are followed by their manual wave broadcast versions
+		if (access == AccessPattern::Uniform)
+		{
+			for (WaveBroadcast wave : { WaveBroadcast::ReadLaneFirst, WaveBroadcast::ReadLaneAt, WaveBroadcast::FirstLaneLoad })
+			{
+				TestCase waveCase = { resource, format, loadWidth, access, constants };
+				waveCase.wave = wave;
+				cases.push_back(waveCase);
+			}
+		}
+	}
+}
+
+// UAV cases next to the SRV cases of the same view. Typed UAV loads are limited to R32 formats (SM 5.0).
+static void addUavCases(std::vector<TestCase>& cases, ResourceType resource, Format format, unsigned loadWidth)
+{
+	bool typed = resource == ResourceType::TypedBuffer || resource == ResourceType::Texture2D;
+	bool loads = !typed || format == Format::R32_FLOAT;
+
+	for (Operation operation : { Operation::UavLoad, Operation::UavStore, Operation::UavLoadModifyStore })
+	{
+		if (operation != Operation::UavStore && !loads)
+			continue;
+
+		for (AccessPattern access : { AccessPattern::Uniform, AccessPattern::Linear, AccessPattern::Random })
+		{
+			cases.push_back({ resource, format, loadWidth, access, ConstantsType::Aligned, operation });
+		}
+	}
+}
+
+// Filtered sampling over a full mip chain, every sampler type. Gather is 2D only in SM 5.0, volumes get Load instead.
+static void addSampleCases(std::vector<TestCase>& cases, ResourceType resource, Format format, unsigned loadWidth)
+{
+	for (AccessPattern access : { AccessPattern::Linear, AccessPattern::Random })
+	{
+		if (resource == ResourceType::Texture3D)
+			cases.push_back({ resource, format, loadWidth, access, ConstantsType::Aligned });
+		else
+			cases.push_back({ resource, format, loadWidth, access, ConstantsType::Aligned, Operation::Gather });
+	}
+
+	for (Operation operation : { Operation::SampleLevel, Operation::SampleGrad })
+	{
+		for (Device::SamplerType sampler : { Device::SamplerType::Nearest, Device::SamplerType::Bilinear, Device::SamplerType::Trilinear })
+		{
+			for (AccessPattern access : { AccessPattern::Linear, AccessPattern::Random })
+			{
+				cases.push_back({ resource, format, loadWidth, access, ConstantsType::Aligned, operation, 0, sampler });
+			}
+		}
+	}
+}
+
+// Contention from one address for every thread to one address per thread
+static void addAtomicCases(std::vector<TestCase>& cases, ResourceType resource)
+{
+	for (Operation operation : { Operation::AtomicAdd, Operation::AtomicMin, Operation::AtomicMax, Operation::AtomicCompareExchange })
+	{
+		for (AccessPattern access : { AccessPattern::Uniform, AccessPattern::Wave, AccessPattern::Linear, AccessPattern::Random })
+		{
+			cases.push_back({ resource, Format::R32_UINT, 1, access, ConstantsType::Aligned, operation });
+		}
+	}
+}
+
+// Strides of at least the element width, then all threads on one address and one random address per thread.
+// 32 banks of 4 bytes: stride 32 puts every thread of a wave in the same bank.
+static void addGroupsharedCases(std::vector<TestCase>& cases, unsigned loadWidth)
+{
+	for (unsigned stride = loadWidth; stride <= 32; stride *= 2)
+	{
+		cases.push_back({ ResourceType::Groupshared, Format::R32_UINT, loadWidth, AccessPattern::Linear, ConstantsType::Aligned, Operation::Load, stride });
+	}
+	cases.push_back({ ResourceType::Groupshared, Format::R32_UINT, loadWidth, AccessPattern::Uniform, ConstantsType::Aligned });
+	cases.push_back({ ResourceType::Groupshared, Format::R32_UINT, loadWidth, AccessPattern::Random, ConstantsType::Aligned });
+}
+
+static std::vector<TestCase> declareTestCases()
+{
+	std::vector<TestCase> cases;
+
+	addCases(cases, ResourceType::TypedBuffer, Format::R8_UNORM, 1);
+	addUavCases(cases, ResourceType::TypedBuffer, Format::R8_UNORM, 1);
+	addCases(cases, ResourceType::TypedBuffer, Format::R8G8_UNORM, 2);
+	addUavCases(cases, ResourceType::TypedBuffer, Format::R8G8_UNORM, 2);
+	addCases(cases, ResourceType::TypedBuffer, Format::R8G8B8A8_UNORM, 4);
+	addUavCases(cases, ResourceType::TypedBuffer, Format::R8G8B8A8_UNORM, 4);
+	addCases(cases, ResourceType::TypedBuffer, Format::R16_FLOAT, 1);
+	addUavCases(cases, ResourceType::TypedBuffer, Format::R16_FLOAT, 1);
+	addCases(cases, ResourceType::TypedBuffer, Format::R16G16_FLOAT, 2);
+	addUavCases(cases, ResourceType::TypedBuffer, Format::R16G16_FLOAT, 2);
+	addCases(cases, ResourceType::TypedBuffer, Format::R16G16B16A16_FLOAT, 4);
+	addUavCases(cases, ResourceType::TypedBuffer, Format::R16G16B16A16_FLOAT, 4);
+	addCases(cases, ResourceType::TypedBuffer, Format::R32_FLOAT, 1);
+	addUavCases(cases, ResourceType::TypedBuffer, Format::R32_FLOAT, 1);
+	addCases(cases, ResourceType::TypedBuffer, Format::R32G32_FLOAT, 2);
+	addUavCases(cases, ResourceType::TypedBuffer, Format::R32G32_FLOAT, 2);
+	addCases(cases, ResourceType::TypedBuffer, Format::R32G32B32A32_FLOAT, 4);
+	addUavCases(cases, ResourceType::TypedBuffer, Format::R32G32B32A32_FLOAT, 4);
+
+	addCases(cases, ResourceType::ByteAddressBuffer, Format::R32_UINT, 1);
+	addUavCases(cases, ResourceType::ByteAddressBuffer, Format::R32_UINT, 1);
+	addCases(cases, ResourceType::ByteAddressBuffer, Format::R32_UINT, 2);
+	addUavCases(cases, ResourceType::ByteAddressBuffer, Format::R32_UINT, 2);
+	addCases(cases, ResourceType::ByteAddressBuffer, Format::R32_UINT, 3);
+	addUavCases(cases, ResourceType::ByteAddressBuffer, Format::R32_UINT, 3);
+	addCases(cases, ResourceType::ByteAddressBuffer, Format::R32_UINT, 4);
+	addUavCases(cases, ResourceType::ByteAddressBuffer, Format::R32_UINT, 4);
+	addCases(cases, ResourceType::ByteAddressBuffer, Format::R32_UINT, 2, ConstantsType::Unaligned);
+	addCases(cases, ResourceType::ByteAddressBuffer, Format::R32_UINT, 4, ConstantsType::Unaligned);
+
+	addCases(cases, ResourceType::StructuredBuffer, Format::R32_FLOAT, 1);
+	addUavCases(cases, ResourceType::StructuredBuffer, Format::R32_FLOAT, 1);
+	addCases(cases, ResourceType::StructuredBuffer, Format::R32G32_FLOAT, 2);
+	addUavCases(cases, ResourceType::StructuredBuffer, Format::R32G32_FLOAT, 2);
+	addCases(cases, ResourceType::StructuredBuffer, Format::R32G32B32A32_FLOAT, 4);
+	addUavCases(cases, ResourceType::StructuredBuffer, Format::R32G32B32A32_FLOAT, 4);
+
+	addCases(cases, ResourceType::ConstantBuffer, Format::R32G32B32A32_FLOAT, 4, ConstantsType::WithArray);
+
+	addCases(cases, ResourceType::Texture2D, Format::R8_UNORM, 1);
+	addUavCases(cases, ResourceType::Texture2D, Format::R8_UNORM, 1);
+	addCases(cases, ResourceType::Texture2D, Format::R8G8_UNORM, 2);
+	addUavCases(cases, ResourceType::Texture2D, Format::R8G8_UNORM, 2);
+	addCases(cases, ResourceType::Texture2D, Format::R8G8B8A8_UNORM, 4);
+	addUavCases(cases, ResourceType::Texture2D, Format::R8G8B8A8_UNORM, 4);
+	addCases(cases, ResourceType::Texture2D, Format::R16_FLOAT, 1);
+	addUavCases(cases, ResourceType::Texture2D, Format::R16_FLOAT, 1);
+	addCases(cases, ResourceType::Texture2D, Format::R16G16_FLOAT, 2);
+	addUavCases(cases, ResourceType::Texture2D, Format::R16G16_FLOAT, 2);
+	addCases(cases, ResourceType::Texture2D, Format::R16G16B16A16_FLOAT, 4);
+	addUavCases(cases, ResourceType::Texture2D, Format::R16G16B16A16_FLOAT, 4);
+	addCases(cases, ResourceType::Texture2D, Format::R32_FLOAT, 1);
+	addUavCases(cases, ResourceType::Texture2D, Format::R32_FLOAT, 1);
+	addCases(cases, ResourceType::Texture2D, Format::R32G32_FLOAT, 2);
+	addUavCases(cases, ResourceType::Texture2D, Format::R32G32_FLOAT, 2);
+	addCases(cases, ResourceType::Texture2D, Format::R32G32B32A32_FLOAT, 4);
+	addUavCases(cases, ResourceType::Texture2D, Format::R32G32B32A32_FLOAT, 4);
+
+	addSampleCases(cases, ResourceType::Texture2D, Format::R8_UNORM, 1);
+	addSampleCases(cases, ResourceType::Texture2D, Format::R8G8_UNORM, 2);
+	addSampleCases(cases, ResourceType::Texture2D, Format::R8G8B8A8_UNORM, 4);
+	addSampleCases(cases, ResourceType::Texture2D, Format::R16_FLOAT, 1);
+	addSampleCases(cases, ResourceType::Texture2D, Format::R16G16_FLOAT, 2);
+	addSampleCases(cases, ResourceType::Texture2D, Format::R16G16B16A16_FLOAT, 4);
+	addSampleCases(cases, ResourceType::Texture2D, Format::R32_FLOAT, 1);
+	addSampleCases(cases, ResourceType::Texture2D, Format::R32G32_FLOAT, 2);
+	addSampleCases(cases, ResourceType::Texture2D, Format::R32G32B32A32_FLOAT, 4);
+
+	addSampleCases(cases, ResourceType::Texture3D, Format::R8_UNORM, 1);
+	addSampleCases(cases, ResourceType::Texture3D, Format::R8G8_UNORM, 2);
+	addSampleCases(cases, ResourceType::Texture3D, Format::R8G8B8A8_UNORM, 4);
+	addSampleCases(cases, ResourceType::Texture3D, Format::R16_FLOAT, 1);
+	addSampleCases(cases, ResourceType::Texture3D, Format::R16G16_FLOAT, 2);
+	addSampleCases(cases, ResourceType::Texture3D, Format::R16G16B16A16_FLOAT, 4);
+	addSampleCases(cases, ResourceType::Texture3D, Format::R32_FLOAT, 1);
+	addSampleCases(cases, ResourceType::Texture3D, Format::R32G32_FLOAT, 2);
+	addSampleCases(cases, ResourceType::Texture3D, Format::R32G32B32A32_FLOAT, 4);
+
+	addGroupsharedCases(cases, 1);
+	addGroupsharedCases(cases, 2);
+	addGroupsharedCases(cases, 4);
+
+	addAtomicCases(cases, ResourceType::Groupshared);
+	addAtomicCases(cases, ResourceType::ByteAddressBuffer);
+	addAtomicCases(cases, ResourceType::TypedBuffer);
+
+	return cases;
+}
+
+const std::vector<TestCase>& testCases()
+{
+	static const std::vector<TestCase> cases = declareTestCases();
+	return cases;
+}
+
+void CaseFilter::setRegex(const std::string& pattern)
+{
+	searches.emplace_back(pattern);
+}
+
+void CaseFilter::setGlob(const std::string& pattern)
+{
+	// '*' and '?' are wildcards, everything else is literal
+	std::string regex;
+	for (char c : pattern)
+	{
+		if (c == '*')
+			regex += ".*";
+		else if (c == '?')
+			regex += '.';
+		else if (strchr("\\^$.|+()[]{}", c))
+			regex += std::string("\\") + c;
+		else
+			regex += c;
+	}
+	wholeMatches.emplace_back(regex);
+}
+
+void CaseFilter::setShard(unsigned index, unsigned count)
+{
+	assert(count > 0 && index < count);
+	shardIndex = index;
+	shardCount = count;
+}
+
+bool CaseFilter::matches(const std::string& name) const
+{
+	for (auto&& regex : searches)
+	{
+		if (!std::regex_search(name, regex))
+			return false;
+	}
+	for (auto&& regex : wholeMatches)
+	{
+		if (!std::regex_match(name, regex))
+			return false;
+	}
+	return true;
+}
+
+bool CaseFilter::select(const std::string& name)
+{
+	if (!matches(name))
+		return false;
+	return numMatches++ % shardCount == shardIndex;
+}
+
+TestResources::TestResources(Device& device) : device(device)
+{
+}
+
+Buffer* TestResources::constants(const TestCase& test)
+{
+	com_ptr<Buffer>& cb = constantBuffers[test.constants];
+	if (cb)
+		return cb;
+
+	if (test.constants == ConstantsType::WithArray)
+	{
+		// Setup constant buffer with float4 array for constant buffer load benchmarking
+		LoadConstantsWithArray loadConstantsWithArray;
+		loadConstantsWithArray.elementsMask = 0;				// Dummy mask to prevent unwanted compiler optimizations
+		loadConstantsWithArray.writeIndex = 0xffffffff;			// Never write
+		loadConstantsWithArray.readStartAddress = 0;			// Aligned
+		memset(static_cast<void*>(loadConstantsWithArray.benchmarkArray), 0, sizeof(loadConstantsWithArray.benchmarkArray));
+
+		cb = device.createConstantBuffer(sizeof(LoadConstantsWithArray));
+		device.updateConstantBuffer(cb, loadConstantsWithArray);
+	}
+	else
+	{
+		LoadConstants loadConstants;
+		loadConstants.elementsMask = 0;				// Dummy mask to prevent unwanted compiler optimizations
+		loadConstants.writeIndex = 0xffffffff;		// Never write
+		loadConstants.readStartAddress = test.constants == ConstantsType::Unaligned ? 4 : 0;
+		loadConstants.padding = 0;
+
+		cb = device.createConstantBuffer(sizeof(LoadConstants));
+		device.updateConstantBuffer(cb, loadConstants);
+	}
+	return cb;
+}
+
+// Typed and raw views share one 16 KB buffer
+Buffer* TestResources::inputBuffer()
+{
+	if (!input)
+		input = device.createBuffer(1024, 16, Device::BufferType::ByteAddress);
+	return input;
+}
+
+ShaderResourceView* TestResources::source(const TestCase& test)
+{
+	if (test.resource == ResourceType::ConstantBuffer || test.resource == ResourceType::Groupshared || (test.operation != Operation::Load && !test.sampled()))
+		return nullptr;
+
+	// 32x32 and 16x16x16 with full mip chains (sampleTexBody.hlsli)
+	if (test.sampled() || test.resource == ResourceType::Texture3D)
+	{
+		auto key = std::make_pair(test.resource, test.format);
+		com_ptr<ShaderResourceView>& view = mipChainViews[key];
+		if (view)
+			return view;
+
+		com_ptr<Texture>& texture = mipChainTextures[key];
+		if (test.resource == ResourceType::Texture3D)
+			texture = device.createTexture3d(uint3(16, 16, 16), test.format, 5);
+		else
+			texture = device.createTexture2d(uint2(32, 32), test.format, 6);
+		view = device.createSRV(texture);
+		return view;
+	}
+
+	com_ptr<ShaderResourceView>& view = views[std::make_pair(test.resource, test.format)];
+	if (view)
+		return view;
+
+	switch (test.resource)
+	{
+	case ResourceType::TypedBuffer:
+		view = device.createTypedSRV(inputBuffer(), 1024, test.format);
+		break;
+	case ResourceType::ByteAddressBuffer:
+		view = device.createByteAddressSRV(inputBuffer(), 1024);
+		break;
+	case ResourceType::StructuredBuffer:
+	{
+		unsigned stride = formatBytes(test.format);
+		com_ptr<Buffer>& buffer = structuredBuffers[stride];
+		if (!buffer)
+			buffer = device.createBuffer(1024, stride, Device::BufferType::Structured);
+		view = device.createStructuredSRV(buffer, 1024, stride);
+		break;
+	}
+	case ResourceType::Texture2D:
+	{
+		com_ptr<Texture>& texture = textures[test.format];
+		if (!texture)
+			texture = device.createTexture2d(uint2(32, 32), test.format, 1);
+		view = device.createSRV(texture);
+		break;
+	}
+	case ResourceType::ConstantBuffer:
+	case ResourceType::Texture3D:
+	case ResourceType::Groupshared:
+		break;
+	}
+	return view;
+}
+
+SamplerState* TestResources::sampler(const TestCase& test)
+{
+	if (!test.sampled())
+		return nullptr;
+
+	com_ptr<SamplerState>& sampler = samplers[test.sampler];
+	if (!sampler)
+		sampler = device.createSampler(test.sampler);
+	return sampler;
+}
+
+UnorderedAccessView* TestResources::output()
+{
+	if (!outputUAV)
+	{
+		outputBuffer = device.createBuffer(2048, 4, Device::BufferType::ByteAddress);
+		outputUAV = device.createTypedUAV(outputBuffer, 2048, Format::R32_FLOAT);
+	}
+	return outputUAV;
+}
+
+// Typed and raw UAV cases share one 16 KB buffer, separate from the SRV input
+Buffer* TestResources::targetBuffer()
+{
+	if (!uavBuffer)
+		uavBuffer = device.createBuffer(1024, 16, Device::BufferType::ByteAddress);
+	return uavBuffer;
+}
+
+// Atomic cases share one 4 MB buffer, one uint per thread of the dispatch (atomicBody.hlsli)
+Buffer* TestResources::atomicBuffer()
+{
+	if (!atomicTarget)
+		atomicTarget = device.createBuffer(1024 * 1024, 4, Device::BufferType::ByteAddress);
+	return atomicTarget;
+}
+
+UnorderedAccessView* TestResources::target(const TestCase& test)
+{
+	if (test.operation == Operation::Load || test.resource == ResourceType::Groupshared)
+		return nullptr;
+
+	if (test.atomic())
+	{
+		com_ptr<UnorderedAccessView>& view = atomicTargets[test.resource];
+		if (!view && test.resource == ResourceType::ByteAddressBuffer)
+			view = device.createByteAddressUAV(atomicBuffer(), 1024 * 1024);
+		else if (!view)
+			view = device.createTypedUAV(atomicBuffer(), 1024 * 1024, test.format);
+		return view;
+	}
+
+	com_ptr<UnorderedAccessView>& view = targets[std::make_pair(test.resource, test.format)];
+	if (view)
+		return view;
+
+	switch (test.resource)
+	{
+	case ResourceType::TypedBuffer:
+		view = device.createTypedUAV(targetBuffer(), 1024, test.format);
+		break;
+	case ResourceType::ByteAddressBuffer:
+		view = device.createByteAddressUAV(targetBuffer(), 1024);
+		break;
+	case ResourceType::StructuredBuffer:
+	{
+		unsigned stride = formatBytes(test.format);
+		com_ptr<Buffer>& buffer = structuredTargetBuffers[stride];
+		if (!buffer)
+			buffer = device.createBuffer(1024, stride, Device::BufferType::Structured);
+		view = device.createStructuredUAV(buffer, 1024, stride);
+		break;
+	}
+	case ResourceType::Texture2D:
+	{
+		com_ptr<Texture>& texture = targetTextures[test.format];
+		if (!texture)
+			texture = device.createTexture2d(uint2(32, 32), test.format, 1);
+		view = device.createUAV(texture);
+		break;
+	}
+	case ResourceType::ConstantBuffer:
+	case ResourceType::Texture3D:
+	case ResourceType::Groupshared:
+		break;
+	}
+	return view;
+}
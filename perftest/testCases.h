@@ -0,0 +1,140 @@
+#pragma once
+#include "device.h"
+#include "com_ptr.h"
+#include <map>
+#include <regex>
+#include <string>
+#include <vector>
+
+enum class ResourceType
+{
+	TypedBuffer,
+	ByteAddressBuffer,
+	StructuredBuffer,
+	ConstantBuffer,
+	Texture2D,
+	Texture3D,
+	Groupshared			// Atomics and stride sweep loads
+};
+
+enum class AccessPattern
+{
+	Uniform,		// All threads load the same address (shader LOAD_INVARIANT)
+	Wave,			// Atomics only: one address per 32 threads
+	Linear,
+	Random
+};
+
+enum class Operation
+{
+	Load,					// SRV or cbuffer load
+	SampleLevel,			// Texture sampling, full mip chain
+	SampleGrad,
+	Gather,
+	UavLoad,
+	UavStore,
+	UavLoadModifyStore,		// Store depends on the preceding load
+	AtomicAdd,				// Atomics are R32 uint, groupshared or UAV
+	AtomicMin,
+	AtomicMax,
+	AtomicCompareExchange
+};
+
+// Manual versions of the uniform load optimization some drivers do. Shader Model 6 / Vulkan subgroups.
+enum class WaveBroadcast
+{
+	None,
+	ReadLaneFirst,		// Every lane loads, WaveReadLaneFirst keeps the first lane's value
+	ReadLaneAt,			// Each lane loads one of the next wave width iterations, WaveReadLaneAt broadcasts them
+	FirstLaneLoad		// Only the first lane loads, WaveReadLaneFirst broadcasts
+};
+
+// LoadConstants buffer bound to b0
+enum class ConstantsType
+{
+	Aligned,
+	Unaligned,		// readStartAddress = 4
+	WithArray		// LoadConstantsWithArray, the source of the cbuffer cases
+};
+
+struct TestCase
+{
+	ResourceType resource;
+	Format format;				// View format. Structured buffers use the float format of the same size.
+	unsigned loadWidth;			// Components per load
+	AccessPattern access;
+	ConstantsType constants;
+	Operation operation = Operation::Load;
+	unsigned stride = 0;		// Groupshared linear loads: dwords between neighbour threads
+	Device::SamplerType sampler = Device::SamplerType::Nearest;		// SampleLevel and SampleGrad
+	WaveBroadcast wave = WaveBroadcast::None;						// Uniform loads only
+
+	std::string name() const;
+	std::string series() const;		// Groupshared loads of one width, compared to each other. Empty for other cases.
+	std::string shaderName() const;
+	unsigned loadBytes() const;
+	bool atomic() const;		// Rate is reported in ops instead of elements
+	bool sampled() const;		// Binds a sampler and a texture with a full mip chain
+};
+
+// Every case in results table order
+const std::vector<TestCase>& testCases();
+
+// Selects cases by name. Regex matches anywhere in the name, glob must match the whole name.
+// Sharding deals out the matching cases round robin: shard i of n runs matches i, i + n, i + 2n...
+class CaseFilter
+{
+public:
+	void setRegex(const std::string& pattern);
+	void setGlob(const std::string& pattern);
+	void setShard(unsigned index, unsigned count);
+
+	bool matches(const std::string& name) const;
+
+	// Call once per case, in a fixed order. Returns whether this process runs the case.
+	bool select(const std::string& name);
+
+private:
+	std::vector<std::regex> searches;
+	std::vector<std::regex> wholeMatches;
+	unsigned shardIndex = 0;
+	unsigned shardCount = 1;
+	unsigned numMatches = 0;
+};
+
+// Creates the buffers and views of the cases on first use. Cases sharing a resource share one instance.
+class TestResources
+{
+public:
+	TestResources(Device& device);
+
+	Buffer* constants(const TestCase& test);
+	ShaderResourceView* source(const TestCase& test);		// Null for cbuffer, groupshared and UAV cases
+	UnorderedAccessView* target(const TestCase& test);		// Null for SRV, cbuffer and groupshared cases
+	SamplerState* sampler(const TestCase& test);			// Null unless sampled
+	UnorderedAccessView* output();
+
+private:
+	Buffer* inputBuffer();
+	Buffer* targetBuffer();
+	Buffer* atomicBuffer();
+
+	Device& device;
+
+	std::map<ConstantsType, com_ptr<Buffer>> constantBuffers;
+	std::map<std::pair<ResourceType, Format>, com_ptr<ShaderResourceView>> views;
+	std::map<unsigned, com_ptr<Buffer>> structuredBuffers;
+	std::map<Format, com_ptr<Texture>> textures;
+	std::map<std::pair<ResourceType, Format>, com_ptr<ShaderResourceView>> mipChainViews;
+	std::map<std::pair<ResourceType, Format>, com_ptr<Texture>> mipChainTextures;
+	std::map<Device::SamplerType, com_ptr<SamplerState>> samplers;
+	com_ptr<Buffer> input;
+	std::map<std::pair<ResourceType, Format>, com_ptr<UnorderedAccessView>> targets;
+	std::map<unsigned, com_ptr<Buffer>> structuredTargetBuffers;
+	std::map<Format, com_ptr<Texture>> targetTextures;
+	com_ptr<Buffer> uavBuffer;
+	std::map<ResourceType, com_ptr<UnorderedAccessView>> atomicTargets;
+	com_ptr<Buffer> atomicTarget;
+	com_ptr<Buffer> outputBuffer;
+	com_ptr<UnorderedAccessView> outputUAV;
+};
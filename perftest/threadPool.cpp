@@ -0,0 +1,140 @@
+#include "threadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned numThreads) : remaining(0)
+{
+	numThreads = std::max(numThreads, 1u);
+	for (unsigned i = 0; i < numThreads; ++i)
+	{
+		queues.emplace_back(new Queue);
+	}
+
+	for (unsigned i = 1; i < numThreads; ++i)
+	{
+		threads.emplace_back([this, i]() { workerLoop(i); });
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		exiting = true;
+	}
+	wake.notify_all();
+
+	for (auto&& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::parallelFor(unsigned count, const std::function<void(unsigned)>& func)
+{
+	if (count == 0)
+		return;
+
+	// Even split. Uneven group costs are balanced by stealing.
+	unsigned numQueues = getNumThreads();
+	for (unsigned i = 0; i < numQueues; ++i)
+	{
+		Queue& queue = *queues[i];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.begin = unsigned(uint64_t(count) * i / numQueues);
+		queue.end = unsigned(uint64_t(count) * (i + 1) / numQueues);
+	}
+
+	remaining = count;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job = &func;
+		jobGeneration++;
+	}
+	wake.notify_all();
+
+	run(0, func);
+
+	// Workers may still be executing their last index
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this]() { return remaining == 0 && activeWorkers == 0; });
+	job = nullptr;
+}
+
+bool ThreadPool::pop(unsigned worker, unsigned& index)
+{
+	Queue& queue = *queues[worker];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.begin == queue.end)
+		return false;
+
+	index = queue.begin++;
+	return true;
+}
+
+bool ThreadPool::steal(unsigned worker, unsigned& index)
+{
+	unsigned numQueues = getNumThreads();
+	for (unsigned offset = 1; offset < numQueues; ++offset)
+	{
+		unsigned begin, end;
+		{
+			Queue& victim = *queues[(worker + offset) % numQueues];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (victim.begin == victim.end)
+				continue;
+
+			// Take the back half. The victim keeps working from the front.
+			begin = victim.begin + (victim.end - victim.begin) / 2;
+			end = victim.end;
+			victim.end = begin;
+		}
+
+		Queue& queue = *queues[worker];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		index = begin;
+		queue.begin = begin + 1;
+		queue.end = end;
+		return true;
+	}
+
+	return false;
+}
+
+void ThreadPool::run(unsigned worker, const std::function<void(unsigned)>& func)
+{
+	unsigned index;
+	while (pop(worker, index) || steal(worker, index))
+	{
+		func(index);
+		remaining--;
+	}
+}
+
+void ThreadPool::workerLoop(unsigned worker)
+{
+	uint64_t seenGeneration = 0;
+	while (true)
+	{
+		const std::function<void(unsigned)>* func;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&]() { return exiting || jobGeneration != seenGeneration; });
+			if (exiting)
+				return;
+
+			seenGeneration = jobGeneration;
+			func = job;
+			if (!func)
+				continue;
+			activeWorkers++;
+		}
+
+		run(worker, *func);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			activeWorkers--;
+		}
+		done.notify_all();
+	}
+}
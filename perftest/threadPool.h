@@ -0,0 +1,50 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <stdint.h>
+
+// Fixed size pool of worker threads. parallelFor() splits the index range evenly between the workers.
+// A worker that runs out of indices steals half of the remaining range of another worker.
+class ThreadPool
+{
+public:
+	ThreadPool(unsigned numThreads = std::thread::hardware_concurrency());
+	~ThreadPool();
+
+	unsigned getNumThreads() const { return static_cast<unsigned>(queues.size()); }
+
+	// Calls func(index) for every index in [0, count) and returns when all calls have finished.
+	// The calling thread works too, so a pool of N threads uses N - 1 extra threads.
+	void parallelFor(unsigned count, const std::function<void(unsigned)>& func);
+
+private:
+	struct Queue
+	{
+		std::mutex mutex;
+		unsigned begin = 0;
+		unsigned end = 0;
+	};
+
+	bool pop(unsigned worker, unsigned& index);
+	bool steal(unsigned worker, unsigned& index);
+	void run(unsigned worker, const std::function<void(unsigned)>& func);
+	void workerLoop(unsigned worker);
+
+	// Queue 0 belongs to the thread calling parallelFor()
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	const std::function<void(unsigned)>* job = nullptr;
+	uint64_t jobGeneration = 0;
+	unsigned activeWorkers = 0;
+	bool exiting = false;
+	std::atomic<unsigned> remaining;
+};
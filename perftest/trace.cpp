@@ -0,0 +1,96 @@
+#include "trace.h"
+#include "json.h"
+#include <chrono>
+#include <vector>
+#include <mutex>
+#include <set>
+#include <atomic>
+#include <stdio.h>
+
+bool traceEnabled = false;
+
+struct TraceEvent
+{
+	const char* name;		// CPU events: string literals, GPU events: in traceGpuNames
+	int64_t start;
+	int64_t duration;
+	unsigned thread;		// 0 is the GPU timeline
+};
+
+static std::mutex traceMutex;
+static std::vector<TraceEvent> traceEvents;
+static std::set<std::string> traceGpuNames;		// GPU queries repeat their names, each one is copied once
+static int64_t traceOrigin = 0;
+static std::atomic<unsigned> traceThreads(0);
+
+// Small thread ids in order of the first event, the main thread starts the trace and is 1
+static unsigned traceThread()
+{
+	static thread_local unsigned thread = ++traceThreads;
+	return thread;
+}
+
+void traceStart()
+{
+	traceEvents.reserve(1 << 16);
+	traceOrigin = traceNow();
+	traceThread();
+	traceEnabled = true;
+}
+
+int64_t traceNow()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void traceCpu(const char* name, int64_t startNanos, int64_t endNanos)
+{
+	unsigned thread = traceThread();
+	std::lock_guard<std::mutex> lock(traceMutex);
+	traceEvents.push_back({ name, startNanos, endNanos - startNanos, thread });
+}
+
+void traceGpu(const std::string& name, int64_t startNanos, float millis)
+{
+	std::lock_guard<std::mutex> lock(traceMutex);
+	const std::string& stored = *traceGpuNames.insert(name).first;
+	traceEvents.push_back({ stored.c_str(), startNanos, int64_t(double(millis) * 1000000.0), 0 });
+}
+
+// Complete ("X") events in microseconds from the start of the trace. CPU threads and the GPU are separate processes,
+// so that the GPU timeline sorts below the threads that feed it.
+bool writeTrace(const std::string& filename)
+{
+	FILE* f = nullptr;
+#ifdef _MSC_VER
+	fopen_s(&f, filename.c_str(), "w");
+#else
+	f = fopen(filename.c_str(), "w");
+#endif
+	if (!f)
+		return false;
+
+	std::lock_guard<std::mutex> lock(traceMutex);
+	fprintf(f, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+	fprintf(f, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"CPU\"}},\n");
+	fprintf(f, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 2, \"tid\": 0, \"args\": {\"name\": \"GPU\"}},\n");
+	fprintf(f, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 2, \"tid\": 0, \"args\": {\"name\": \"Queue\"}}");
+	for (unsigned thread = 1; thread <= traceThreads; ++thread)
+	{
+		std::string name = thread == 1 ? "Main" : "Worker " + std::to_string(thread - 1);
+		fprintf(f, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": %s}}",
+				thread, jsonString(name).c_str());
+	}
+
+	for (const TraceEvent& event : traceEvents)
+	{
+		fprintf(f, ",\n{\"name\": %s, \"ph\": \"X\", \"pid\": %d, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+				jsonString(event.name).c_str(), event.thread ? 1 : 2, event.thread,
+				double(event.start - traceOrigin) / 1000.0, double(event.duration) / 1000.0);
+	}
+	fprintf(f, "\n]}\n");
+
+	bool ok = ferror(f) == 0;
+	fclose(f);
+	return ok;
+}
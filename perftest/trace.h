@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <stdint.h>
+
+// Chrome trace event JSON (chrome://tracing, ui.perfetto.dev) of CPU scopes and GPU queries on one timeline.
+// Times are steady_clock nanoseconds. GPU timestamps are converted by the backend's clock calibration.
+// Recording is off until traceStart(), a disabled scope costs a predicted branch. PERFTEST_NO_TRACE compiles the scopes out.
+extern bool traceEnabled;
+
+void traceStart();
+int64_t traceNow();
+
+// CPU events keep the name pointer, names must outlive the trace (string literals). GPU event names are copied once.
+void traceCpu(const char* name, int64_t startNanos, int64_t endNanos);
+void traceGpu(const std::string& name, int64_t startNanos, float millis);
+
+bool writeTrace(const std::string& filename);
+
+class TraceScope
+{
+public:
+	explicit TraceScope(const char* name) : name(name), start(traceEnabled ? traceNow() : 0) {}
+
+	~TraceScope()
+	{
+		if (traceEnabled)
+			traceCpu(name, start, traceNow());
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char* name;
+	int64_t start;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#ifdef PERFTEST_NO_TRACE
+#define TRACE_SCOPE(name)
+#else
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#endif
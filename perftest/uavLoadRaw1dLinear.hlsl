@@ -0,0 +1,4 @@
+#define LOAD_WIDTH 1
+#define LOAD_LINEAR
+#define UAV_LOAD
+#include "uavRawBody.hlsli"
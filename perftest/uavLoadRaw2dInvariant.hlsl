@@ -0,0 +1,4 @@
+#define LOAD_WIDTH 2
+#define LOAD_INVARIANT
+#define UAV_LOAD
+#include "uavRawBody.hlsli"
@@ -0,0 +1,4 @@
+#define LOAD_WIDTH 2
+#define LOAD_RANDOM
+#define UAV_LOAD
+#include "uavRawBody.hlsli"
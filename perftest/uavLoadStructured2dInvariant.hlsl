@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 2
+#define LOAD_INVARIANT
+#define UAV_LOAD
+RWStructuredBuffer<float2> target : register(u0);
+#include "uavStructuredBody.hlsli"
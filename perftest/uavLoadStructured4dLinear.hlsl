@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 4
+#define LOAD_LINEAR
+#define UAV_LOAD
+RWStructuredBuffer<float4> target : register(u0);
+#include "uavStructuredBody.hlsli"
@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 1
+#define LOAD_INVARIANT
+#define UAV_LOAD
+RWTexture2D<float> target : register(u0);
+#include "uavTexBody.hlsli"
@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 1
+#define LOAD_RANDOM
+#define UAV_LOAD
+RWBuffer<float> target : register(u0);
+#include "uavTypedBody.hlsli"
@@ -0,0 +1,4 @@
+#define LOAD_WIDTH 4
+#define LOAD_RANDOM
+#define UAV_LOAD_MODIFY_STORE
+#include "uavRawBody.hlsli"
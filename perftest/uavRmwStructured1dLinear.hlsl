@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 1
+#define LOAD_LINEAR
+#define UAV_LOAD_MODIFY_STORE
+RWStructuredBuffer<float> target : register(u0);
+#include "uavStructuredBody.hlsli"
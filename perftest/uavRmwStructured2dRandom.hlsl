@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 2
+#define LOAD_RANDOM
+#define UAV_LOAD_MODIFY_STORE
+RWStructuredBuffer<float2> target : register(u0);
+#include "uavStructuredBody.hlsli"
@@ -0,0 +1,4 @@
+#define LOAD_WIDTH 1
+#define LOAD_INVARIANT
+#define UAV_STORE
+#include "uavRawBody.hlsli"
@@ -0,0 +1,4 @@
+#define LOAD_WIDTH 4
+#define LOAD_LINEAR
+#define UAV_STORE
+#include "uavRawBody.hlsli"
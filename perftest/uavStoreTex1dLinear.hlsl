@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 1
+#define LOAD_LINEAR
+#define UAV_STORE
+RWTexture2D<float> target : register(u0);
+#include "uavTexBody.hlsli"
@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 4
+#define LOAD_RANDOM
+#define UAV_STORE
+RWTexture2D<float4> target : register(u0);
+#include "uavTexBody.hlsli"
@@ -0,0 +1,71 @@
+#include "hash.hlsli"
+#include "loadConstantsGPU.h"
+
+cbuffer CB0 : register(b0)
+{
+	LoadConstants loadConstants;
+};
+
+#define THREAD_GROUP_SIZE 256
+
+groupshared float dummyLDS[THREAD_GROUP_SIZE];
+
+[numthreads(THREAD_GROUP_SIZE, 1, 1)]
+void main(uint3 tid : SV_DispatchThreadID, uint gix : SV_GroupIndex)
+{
+	float4 value = 0.0;
+
+#if defined(LOAD_INVARIANT)
+    // All threads access the same address. Index is wave invariant.
+	uint htid = 0;
+#elif defined(LOAD_LINEAR)
+	// Linearly increasing starting address to allow memory coalescing
+	uint htid = gix;
+#elif defined(LOAD_RANDOM)
+    // Randomize start address offset (0-15) to prevent memory coalescing
+	uint htid = (hash1(gix) & 0xf);
+#endif
+
+	[loop]
+	for (int i = 0; i < 256; ++i)
+	{
+		// Mask with runtime constant to prevent unwanted compiler optimizations
+		uint elemIdx = (htid + i) | loadConstants.elementsMask;
+
+#if defined(UAV_LOAD) || defined(UAV_LOAD_MODIFY_STORE)
+#if LOAD_WIDTH == 1
+		value += target[elemIdx].xxxx;
+#elif LOAD_WIDTH == 2
+		value += target[elemIdx].xyxy;
+#elif LOAD_WIDTH == 4
+		value += target[elemIdx].xyzw;
+#endif
+#else
+		// Stores are side effects, the compiler can't remove them
+		value += 1.0;
+#endif
+
+#if defined(UAV_STORE) || defined(UAV_LOAD_MODIFY_STORE)
+#if LOAD_WIDTH == 1
+		target[elemIdx] = value.x;
+#elif LOAD_WIDTH == 2
+		target[elemIdx] = value.xy;
+#elif LOAD_WIDTH == 4
+		target[elemIdx] = value;
+#endif
+#endif
+	}
+
+    // Linear write to LDS (no bank conflicts). Significantly faster than memory loads.
+	dummyLDS[gix] = value.x + value.y + value.z + value.w;
+
+	GroupMemoryBarrierWithGroupSync();
+
+	// This branch is never taken, but the compiler doesn't know it
+	// Optimizer would remove all the memory loads if the data wouldn't be potentially used
+	[branch]
+	if (loadConstants.writeIndex != 0xffffffff)
+	{
+        target[tid.x + tid.y] = dummyLDS[loadConstants.writeIndex];
+    }
+}
@@ -0,0 +1,70 @@
+#include "hash.hlsli"
+#include "loadConstantsGPU.h"
+
+cbuffer CB0 : register(b0)
+{
+	LoadConstants loadConstants;
+};
+
+#define THREAD_GROUP_DIM 16
+
+groupshared float dummyLDS[THREAD_GROUP_DIM][THREAD_GROUP_DIM];
+
+[numthreads(THREAD_GROUP_DIM, THREAD_GROUP_DIM, 1)]
+void main(uint3 tid : SV_DispatchThreadID, uint3 gid : SV_GroupThreadID)
+{
+	float4 value = 0.0;
+
+#if defined(LOAD_INVARIANT)
+    // All threads access the same address. Index is wave invariant.
+	uint2 htid = 0;
+#elif defined(LOAD_LINEAR)
+	// Linearly increasing starting address.
+	uint2 htid = gid.xy;
+#elif defined(LOAD_RANDOM)
+    // Randomize start address offset (0-3, 0-3)
+	uint2 htid = uint2((hash1(gid.x) & 0x4), (hash1(gid.y) & 0x4));
+#endif
+
+	[loop]
+	for (int y = 0; y < 16; ++y)
+	{
+		[loop]
+		for (int x = 0; x < 16; ++x)
+		{
+			// Mask with runtime constant to prevent unwanted compiler optimizations
+			uint2 elemIdx = (htid + uint2(x, y)) | loadConstants.elementsMask;
+
+#if defined(UAV_LOAD)
+			// Typed UAV loads are limited to single component 32 bit formats (SM 5.0)
+			value += target[elemIdx].xxxx;
+#elif defined(UAV_STORE)
+			// Stores are side effects, the compiler can't remove them
+			value += 1.0;
+#if LOAD_WIDTH == 1
+			target[elemIdx] = value.x;
+#elif LOAD_WIDTH == 2
+			target[elemIdx] = value.xy;
+#elif LOAD_WIDTH == 4
+			target[elemIdx] = value;
+#endif
+#elif defined(UAV_LOAD_MODIFY_STORE)
+			// Each store depends on the previous loads of the thread
+			value += target[elemIdx].xxxx;
+			target[elemIdx] = value.x;
+#endif
+		}
+	}
+    // Linear write to LDS (no bank conflicts). Significantly faster than memory loads.
+	dummyLDS[gid.y][gid.x] = value.x + value.y + value.z + value.w;
+
+	GroupMemoryBarrierWithGroupSync();
+
+	// This branch is never taken, but the compiler doesn't know it
+	// Optimizer would remove all the memory loads if the data wouldn't be potentially used
+	[branch]
+	if (loadConstants.writeIndex != 0xffffffff)
+	{
+        target[tid.xy] = dummyLDS[(loadConstants.writeIndex >> 8) & 0xff][loadConstants.writeIndex & 0xff];
+    }
+}
@@ -0,0 +1,1299 @@
+#include "vulkan.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+// Host time domain of std::chrono::steady_clock: QueryPerformanceCounter on Windows, CLOCK_MONOTONIC elsewhere
+#ifdef _WIN32
+const VkTimeDomainEXT steadyClockTimeDomain = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+#else
+const VkTimeDomainEXT steadyClockTimeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+#endif
+
+static VkFormat vkFormat(Format format)
+{
+	switch (format)
+	{
+	case Format::R8_UNORM: return VK_FORMAT_R8_UNORM;
+	case Format::R8G8_UNORM: return VK_FORMAT_R8G8_UNORM;
+	case Format::R8G8B8A8_UNORM: return VK_FORMAT_R8G8B8A8_UNORM;
+	case Format::R16_FLOAT: return VK_FORMAT_R16_SFLOAT;
+	case Format::R16G16_FLOAT: return VK_FORMAT_R16G16_SFLOAT;
+	case Format::R16G16B16A16_FLOAT: return VK_FORMAT_R16G16B16A16_SFLOAT;
+	case Format::R32_FLOAT: return VK_FORMAT_R32_SFLOAT;
+	case Format::R32G32_FLOAT: return VK_FORMAT_R32G32_SFLOAT;
+	case Format::R32G32B32A32_FLOAT: return VK_FORMAT_R32G32B32A32_SFLOAT;
+	case Format::R32_UINT: return VK_FORMAT_R32_UINT;
+	}
+
+	assert(false);
+	return VK_FORMAT_UNDEFINED;
+}
+
+static VkInstance createInstance()
+{
+	VkApplicationInfo appInfo = {};
+	appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+	appInfo.pApplicationName = "perftest";
+	appInfo.pEngineName = "perftest";
+	appInfo.apiVersion = VK_API_VERSION_1_1;
+
+	// Validation layer is the Vulkan equivalent of D3D11_CREATE_DEVICE_DEBUG. Only enabled when installed.
+	std::vector<const char*> layers;
+#ifndef NDEBUG
+	uint32_t layerCount = 0;
+	vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+	std::vector<VkLayerProperties> availableLayers(layerCount);
+	vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
+	for (auto&& layer : availableLayers)
+	{
+		if (strcmp(layer.layerName, "VK_LAYER_KHRONOS_validation") == 0)
+			layers.push_back("VK_LAYER_KHRONOS_validation");
+	}
+#endif
+
+	VkInstanceCreateInfo createInfo = {};
+	createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+	createInfo.pApplicationInfo = &appInfo;
+	createInfo.enabledLayerCount = static_cast<uint32_t>(layers.size());
+	createInfo.ppEnabledLayerNames = layers.data();
+
+	VkInstance instance = VK_NULL_HANDLE;
+	VkResult result = vkCreateInstance(&createInfo, nullptr, &instance);
+	assert(result == VK_SUCCESS);
+	return instance;
+}
+
+static std::vector<VkPhysicalDevice> enumeratePhysicalDevices(VkInstance instance)
+{
+	uint32_t count = 0;
+	vkEnumeratePhysicalDevices(instance, &count, nullptr);
+	std::vector<VkPhysicalDevice> physicalDevices(count);
+	vkEnumeratePhysicalDevices(instance, &count, physicalDevices.data());
+	return physicalDevices;
+}
+
+std::vector<std::string> enumerateVulkanAdapters()
+{
+	std::vector<std::string> names;
+
+	VkInstance instance = createInstance();
+	if (instance == VK_NULL_HANDLE)
+		return names;
+
+	for (auto physicalDevice : enumeratePhysicalDevices(instance))
+	{
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		names.push_back(properties.deviceName);
+	}
+
+	vkDestroyInstance(instance, nullptr);
+	return names;
+}
+
+VulkanBuffer::~VulkanBuffer()
+{
+	owner.waitIdle();
+	if (mapped)
+		vkUnmapMemory(owner.getDevice(), memory);
+	vkDestroyBuffer(owner.getDevice(), buffer, nullptr);
+	vkFreeMemory(owner.getDevice(), memory, nullptr);
+}
+
+VulkanCommandList::~VulkanCommandList()
+{
+	owner.waitIdle();
+	for (VkDescriptorPool pool : descriptorPools)
+		vkDestroyDescriptorPool(owner.getDevice(), pool, nullptr);
+	vkDestroyCommandPool(owner.getDevice(), commandPool, nullptr);
+}
+
+VulkanTexture::~VulkanTexture()
+{
+	owner.waitIdle();
+	vkDestroyImage(owner.getDevice(), image, nullptr);
+	vkFreeMemory(owner.getDevice(), memory, nullptr);
+}
+
+static void destroyDescriptor(VulkanDevice& owner, VulkanDescriptor& descriptor)
+{
+	owner.waitIdle();
+	if (descriptor.bufferView != VK_NULL_HANDLE)
+		vkDestroyBufferView(owner.getDevice(), descriptor.bufferView, nullptr);
+	if (descriptor.imageInfo.imageView != VK_NULL_HANDLE)
+		vkDestroyImageView(owner.getDevice(), descriptor.imageInfo.imageView, nullptr);
+}
+
+VulkanSRV::~VulkanSRV()
+{
+	destroyDescriptor(owner, descriptor);
+}
+
+VulkanUAV::~VulkanUAV()
+{
+	destroyDescriptor(owner, descriptor);
+}
+
+VulkanSampler::~VulkanSampler()
+{
+	owner.waitIdle();
+	vkDestroySampler(owner.getDevice(), sampler, nullptr);
+}
+
+VulkanComputeShader::~VulkanComputeShader()
+{
+	owner.waitIdle();
+	for (auto&& entry : pipelines)
+	{
+		vkDestroyPipeline(owner.getDevice(), entry.second.pipeline, nullptr);
+		vkDestroyPipelineLayout(owner.getDevice(), entry.second.layout, nullptr);
+		vkDestroyDescriptorSetLayout(owner.getDevice(), entry.second.setLayout, nullptr);
+	}
+	vkDestroyShaderModule(owner.getDevice(), module, nullptr);
+}
+
+VulkanDevice::VulkanDevice(unsigned adapterIndex, bool headless) :
+	headless(headless)
+{
+	instance = createInstance();
+
+	std::vector<VkPhysicalDevice> physicalDevices = enumeratePhysicalDevices(instance);
+	assert(adapterIndex < physicalDevices.size());
+	physicalDevice = physicalDevices[adapterIndex];
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+	// WaveReadLaneFirst, WaveReadLaneAt and WaveIsFirstLane of the wave intrinsic cases
+	if (properties.apiVersion >= VK_API_VERSION_1_1)
+	{
+		VkPhysicalDeviceSubgroupProperties subgroupProperties = {};
+		subgroupProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+		VkPhysicalDeviceProperties2 properties2 = {};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &subgroupProperties;
+		vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+		const VkSubgroupFeatureFlags waveOperations = VK_SUBGROUP_FEATURE_BASIC_BIT | VK_SUBGROUP_FEATURE_BALLOT_BIT | VK_SUBGROUP_FEATURE_SHUFFLE_BIT;
+		waveIntrinsics = (subgroupProperties.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) &&
+						 (subgroupProperties.supportedOperations & waveOperations) == waveOperations;
+	}
+
+	// Any compute capable queue with timestamp support
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+	queueFamily = queueFamilyCount;
+	for (uint32_t i = 0; i < queueFamilyCount; ++i)
+	{
+		if ((queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) && queueFamilies[i].timestampValidBits > 0)
+		{
+			queueFamily = i;
+			break;
+		}
+	}
+	assert(queueFamily < queueFamilyCount);
+
+	unsigned validBits = queueFamilies[queueFamily].timestampValidBits;
+	timestampMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+
+	// D3D11 returns zero for out of bounds buffer loads. Robust buffer access gives the same behavior.
+	// Typed UAVs are declared without a format by dxc, which needs the "without format" features.
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+	VkPhysicalDeviceFeatures features = {};
+	features.robustBufferAccess = supportedFeatures.robustBufferAccess;
+	features.shaderStorageImageReadWithoutFormat = supportedFeatures.shaderStorageImageReadWithoutFormat;
+	features.shaderStorageImageWriteWithoutFormat = supportedFeatures.shaderStorageImageWriteWithoutFormat;
+
+	float queuePriority = 1.0f;
+	VkDeviceQueueCreateInfo queueInfo = {};
+	queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+	queueInfo.queueFamilyIndex = queueFamily;
+	queueInfo.queueCount = 1;
+	queueInfo.pQueuePriorities = &queuePriority;
+
+	// Calibrated timestamps place the GPU queries of --trace on the CPU timeline
+	std::vector<const char*> extensions;
+	uint32_t extensionCount = 0;
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+	std::vector<VkExtensionProperties> extensionProperties(extensionCount);
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensionProperties.data());
+	for (auto&& extension : extensionProperties)
+	{
+		if (strcmp(extension.extensionName, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) == 0)
+			extensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+	}
+
+	VkDeviceCreateInfo deviceInfo = {};
+	deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceInfo.queueCreateInfoCount = 1;
+	deviceInfo.pQueueCreateInfos = &queueInfo;
+	deviceInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+	deviceInfo.ppEnabledExtensionNames = extensions.data();
+	deviceInfo.pEnabledFeatures = &features;
+
+	VkResult result = vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device);
+	assert(result == VK_SUCCESS);
+	vkGetDeviceQueue(device, queueFamily, 0, &queue);
+
+	if (!extensions.empty())
+	{
+		auto getTimeDomains = reinterpret_cast<PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT>(
+			vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT"));
+		uint32_t domainCount = 0;
+		if (getTimeDomains)
+			getTimeDomains(physicalDevice, &domainCount, nullptr);
+		std::vector<VkTimeDomainEXT> domains(domainCount);
+		if (domainCount > 0)
+			getTimeDomains(physicalDevice, &domainCount, domains.data());
+
+		bool hasDevice = std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_DEVICE_EXT) != domains.end();
+		bool hasHost = std::find(domains.begin(), domains.end(), steadyClockTimeDomain) != domains.end();
+		if (hasDevice && hasHost)
+			getCalibratedTimestamps = reinterpret_cast<PFN_vkGetCalibratedTimestampsEXT>(vkGetDeviceProcAddr(device, "vkGetCalibratedTimestampsEXT"));
+	}
+
+	VkCommandPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	poolInfo.queueFamilyIndex = queueFamily;
+	result = vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool);
+	assert(result == VK_SUCCESS);
+
+	// Frames
+	for (auto&& frame : frames)
+	{
+		VkCommandBufferAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = commandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+		result = vkAllocateCommandBuffers(device, &allocInfo, &frame.commandBuffer);
+		assert(result == VK_SUCCESS);
+
+		VkFenceCreateInfo fenceInfo = {};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		result = vkCreateFence(device, &fenceInfo, nullptr, &frame.fence);
+		assert(result == VK_SUCCESS);
+
+		frame.descriptorPool = createDescriptorPool();
+	}
+
+	// Queries
+	VkQueryPoolCreateInfo queryPoolInfo = {};
+	queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	queryPoolInfo.queryCount = static_cast<uint32_t>(frames.size() * queriesPerFrame * 2);
+	result = vkCreateQueryPool(device, &queryPoolInfo, nullptr, &queryPool);
+	assert(result == VK_SUCCESS);
+
+	// Timestamps are resolved on the GPU into one readback buffer with one copy per frame, instead of a query pool read per query
+	queryReadback = static_cast<VulkanBuffer*>(createStagingBuffer(queryPoolInfo.queryCount * sizeof(uint64_t), StagingType::Readback));
+	for (auto&& frame : frames)
+		frame.queryIds.reserve(queriesPerFrame);
+	resolvedQueries.reserve(frames.size() * queriesPerFrame);
+
+	executeImmediate([&](VkCommandBuffer cmd)
+	{
+		vkCmdResetQueryPool(cmd, queryPool, 0, queryPoolInfo.queryCount);
+	});
+
+	beginFrame();
+}
+
+VulkanDevice::~VulkanDevice()
+{
+	waitIdle();
+
+	delete queryReadback;
+	vkDestroyQueryPool(device, queryPool, nullptr);
+	for (auto&& frame : frames)
+	{
+		delete frame.uploadBuffer;
+		for (VulkanBuffer* buffer : frame.retiredUploads)
+			delete buffer;
+		vkDestroyDescriptorPool(device, frame.descriptorPool, nullptr);
+		vkDestroyFence(device, frame.fence, nullptr);
+	}
+	vkDestroyCommandPool(device, commandPool, nullptr);
+	vkDestroyDevice(device, nullptr);
+	vkDestroyInstance(instance, nullptr);
+}
+
+void VulkanDevice::waitIdle()
+{
+	if (!gpuIdle)
+	{
+		vkDeviceWaitIdle(device);
+		gpuIdle = true;
+	}
+}
+
+uint32_t VulkanDevice::findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags flags)
+{
+	for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i)
+	{
+		if ((typeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & flags) == flags)
+			return i;
+	}
+
+	// Device local and host cached are only preferences
+	const VkMemoryPropertyFlags preferences = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+	assert(flags & preferences);
+	return findMemoryType(typeBits, flags & ~preferences);
+}
+
+VkDescriptorPool VulkanDevice::createDescriptorPool()
+{
+	const uint32_t maxDescriptorSetsPerFrame = 4096;
+	VkDescriptorPoolSize poolSizes[] =
+	{
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, maxDescriptorSetsPerFrame * 2 },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, maxDescriptorSetsPerFrame * 2 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, maxDescriptorSetsPerFrame * 2 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, maxDescriptorSetsPerFrame * 2 },
+		{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxDescriptorSetsPerFrame * 2 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxDescriptorSetsPerFrame * 2 },
+		{ VK_DESCRIPTOR_TYPE_SAMPLER, maxDescriptorSetsPerFrame * 2 },
+	};
+
+	VkDescriptorPoolCreateInfo descriptorPoolInfo = {};
+	descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	descriptorPoolInfo.maxSets = maxDescriptorSetsPerFrame;
+	descriptorPoolInfo.poolSizeCount = sizeof(poolSizes) / sizeof(poolSizes[0]);
+	descriptorPoolInfo.pPoolSizes = poolSizes;
+
+	VkDescriptorPool pool = VK_NULL_HANDLE;
+	VkResult result = vkCreateDescriptorPool(device, &descriptorPoolInfo, nullptr, &pool);
+	assert(result == VK_SUCCESS);
+	return pool;
+}
+
+void VulkanDevice::executeImmediate(const std::function<void(VkCommandBuffer)>& record)
+{
+	VkCommandBufferAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = 1;
+
+	VkCommandBuffer cmd = VK_NULL_HANDLE;
+	VkResult result = vkAllocateCommandBuffers(device, &allocInfo, &cmd);
+	assert(result == VK_SUCCESS);
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(cmd, &beginInfo);
+	record(cmd);
+	vkEndCommandBuffer(cmd);
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &cmd;
+	result = vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+	assert(result == VK_SUCCESS);
+	vkQueueWaitIdle(queue);
+
+	vkFreeCommandBuffers(device, commandPool, 1, &cmd);
+}
+
+VulkanBuffer* VulkanDevice::allocateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags memoryFlags)
+{
+	VulkanBuffer* buffer = new VulkanBuffer(*this);
+	buffer->size = size;
+
+	VkBufferCreateInfo bufferInfo = {};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = size;
+	bufferInfo.usage = usage;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	VkResult result = vkCreateBuffer(device, &bufferInfo, nullptr, &buffer->buffer);
+	assert(result == VK_SUCCESS);
+
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements(device, buffer->buffer, &requirements);
+
+	VkMemoryAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = requirements.size;
+	allocInfo.memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, memoryFlags);
+	result = vkAllocateMemory(device, &allocInfo, nullptr, &buffer->memory);
+	assert(result == VK_SUCCESS);
+	vkBindBufferMemory(device, buffer->buffer, buffer->memory, 0);
+
+	if (memoryFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+	{
+		result = vkMapMemory(device, buffer->memory, 0, VK_WHOLE_SIZE, 0, &buffer->mapped);
+		assert(result == VK_SUCCESS);
+	}
+
+	return buffer;
+}
+
+Buffer* VulkanDevice::createConstantBuffer(unsigned bytes)
+{
+	// Persistently mapped, matches D3D11_USAGE_DYNAMIC
+	return allocateBuffer(bytes, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+							VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
+Buffer* VulkanDevice::createBuffer(unsigned numElements, unsigned strideBytes, BufferType type)
+{
+	// Buffer type only matters for D3D11 view creation. Vulkan buffers can be viewed in any way.
+	VkBufferUsageFlags usage =
+		VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT |
+		VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT |
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+		VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+	VulkanBuffer* buffer = allocateBuffer(VkDeviceSize(numElements) * strideBytes, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	// Vulkan memory isn't zero initialized
+	executeImmediate([&](VkCommandBuffer cmd)
+	{
+		vkCmdFillBuffer(cmd, buffer->buffer, 0, VK_WHOLE_SIZE, 0);
+	});
+
+	return buffer;
+}
+
+Buffer* VulkanDevice::createDynamicBuffer(unsigned bytes)
+{
+	// Persistently mapped like the constant buffers. An instance per frame, a frame's instance is free once beginFrame
+	// has waited for its fence.
+	VkBufferUsageFlags usage =
+		VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT |
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	VulkanBuffer* buffer = allocateBuffer(VkDeviceSize(bytes) * frames.size(), usage,
+										  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	buffer->size = bytes;
+	buffer->renamed = true;
+	return buffer;
+}
+
+Buffer* VulkanDevice::createStagingBuffer(unsigned bytes, StagingType type)
+{
+	// Readback prefers cached memory, uncached reads are slow. Coherent memory needs no invalidate.
+	if (type == StagingType::Upload)
+		return allocateBuffer(bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	return allocateBuffer(bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+						  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+}
+
+VulkanTexture* VulkanDevice::createTexture(VkImageType type, VkImageViewType viewType, VkExtent3D extent, Format format, unsigned mips)
+{
+	VulkanTexture* texture = new VulkanTexture(*this);
+	texture->viewType = viewType;
+	texture->format = vkFormat(format);
+	texture->mips = mips;
+
+	// Storage image support is optional for narrow formats
+	VkFormatProperties formatProperties;
+	vkGetPhysicalDeviceFormatProperties(physicalDevice, texture->format, &formatProperties);
+
+	VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT)
+		usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+
+	VkImageCreateInfo imageInfo = {};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = type;
+	imageInfo.format = texture->format;
+	imageInfo.extent = extent;
+	imageInfo.mipLevels = mips;
+	imageInfo.arrayLayers = 1;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = usage;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	VkResult result = vkCreateImage(device, &imageInfo, nullptr, &texture->image);
+	assert(result == VK_SUCCESS);
+
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements(device, texture->image, &requirements);
+
+	VkMemoryAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = requirements.size;
+	allocInfo.memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	result = vkAllocateMemory(device, &allocInfo, nullptr, &texture->memory);
+	assert(result == VK_SUCCESS);
+	vkBindImageMemory(device, texture->image, texture->memory, 0);
+
+	// Images stay in GENERAL layout for their whole lifetime. Valid for both sampled and storage access.
+	executeImmediate([&](VkCommandBuffer cmd)
+	{
+		VkImageSubresourceRange range = {};
+		range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		range.levelCount = mips;
+		range.layerCount = 1;
+
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = texture->image;
+		barrier.subresourceRange = range;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		VkClearColorValue clearColor = {};
+		vkCmdClearColorImage(cmd, texture->image, VK_IMAGE_LAYOUT_GENERAL, &clearColor, 1, &range);
+
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+	});
+
+	return texture;
+}
+
+Texture* VulkanDevice::createTexture2d(uint2 dimensions, Format format, unsigned mips)
+{
+	VkExtent3D extent = { dimensions.x, dimensions.y, 1 };
+	return createTexture(VK_IMAGE_TYPE_2D, VK_IMAGE_VIEW_TYPE_2D, extent, format, mips);
+}
+
+Texture* VulkanDevice::createTexture3d(uint3 dimensions, Format format, unsigned mips)
+{
+	VkExtent3D extent = { dimensions.x, dimensions.y, dimensions.z };
+	return createTexture(VK_IMAGE_TYPE_3D, VK_IMAGE_VIEW_TYPE_3D, extent, format, mips);
+}
+
+SamplerState* VulkanDevice::createSampler(SamplerType type)
+{
+	VkSamplerCreateInfo samplerInfo = {};
+	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	samplerInfo.compareOp = VK_COMPARE_OP_NEVER;
+	samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+	switch (type)
+	{
+	case SamplerType::Nearest:
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		break;
+
+	case SamplerType::Bilinear:
+		samplerInfo.magFilter = VK_FILTER_LINEAR;
+		samplerInfo.minFilter = VK_FILTER_LINEAR;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		break;
+
+	case SamplerType::Trilinear:
+		samplerInfo.magFilter = VK_FILTER_LINEAR;
+		samplerInfo.minFilter = VK_FILTER_LINEAR;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+		break;
+	}
+
+	VulkanSampler* sampler = new VulkanSampler(*this);
+	VkResult result = vkCreateSampler(device, &samplerInfo, nullptr, &sampler->sampler);
+	assert(result == VK_SUCCESS);
+	return sampler;
+}
+
+VkBufferView VulkanDevice::createBufferView(VulkanBuffer* buffer, VkFormat format, VkDeviceSize range)
+{
+	VkBufferViewCreateInfo viewInfo = {};
+	viewInfo.sType = VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO;
+	viewInfo.buffer = buffer->buffer;
+	viewInfo.format = format;
+	viewInfo.offset = 0;
+	viewInfo.range = range;
+
+	VkBufferView view = VK_NULL_HANDLE;
+	VkResult result = vkCreateBufferView(device, &viewInfo, nullptr, &view);
+	assert(result == VK_SUCCESS);
+	return view;
+}
+
+VkImageView VulkanDevice::createImageView(VulkanTexture* texture, unsigned mips)
+{
+	VkImageViewCreateInfo viewInfo = {};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = texture->image;
+	viewInfo.viewType = texture->viewType;
+	viewInfo.format = texture->format;
+	viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	viewInfo.subresourceRange.levelCount = mips;
+	viewInfo.subresourceRange.layerCount = 1;
+
+	VkImageView view = VK_NULL_HANDLE;
+	VkResult result = vkCreateImageView(device, &viewInfo, nullptr, &view);
+	assert(result == VK_SUCCESS);
+	return view;
+}
+
+bool VulkanDevice::supportsTypedUAV(Format format, bool texture) const
+{
+	// Storage images and storage texel buffers are only required for some formats
+	VkFormatProperties formatProperties;
+	vkGetPhysicalDeviceFormatProperties(physicalDevice, vkFormat(format), &formatProperties);
+	if (texture)
+		return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+	return (formatProperties.bufferFeatures & VK_FORMAT_FEATURE_STORAGE_TEXEL_BUFFER_BIT) != 0;
+}
+
+UnorderedAccessView* VulkanDevice::createUAV(Texture* texture)
+{
+	// The texture has no storage usage without format support
+	VkFormatProperties formatProperties;
+	vkGetPhysicalDeviceFormatProperties(physicalDevice, static_cast<VulkanTexture*>(texture)->format, &formatProperties);
+	assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT);
+
+	// UAV of a texture only sees the first mip, like the D3D11 default UAV desc
+	VulkanUAV* view = new VulkanUAV(*this);
+	view->descriptor.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	view->descriptor.imageInfo.imageView = createImageView(static_cast<VulkanTexture*>(texture), 1);
+	view->descriptor.imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+	return view;
+}
+
+UnorderedAccessView* VulkanDevice::createTypedUAV(Buffer* buffer, unsigned numElements, Format format)
+{
+	assert(supportsTypedUAV(format, false));
+	VulkanUAV* view = new VulkanUAV(*this);
+	view->descriptor.type = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+	view->descriptor.bufferView = createBufferView(static_cast<VulkanBuffer*>(buffer), vkFormat(format), VkDeviceSize(numElements) * formatBytes(format));
+	return view;
+}
+
+UnorderedAccessView* VulkanDevice::createStructuredUAV(Buffer* buffer, unsigned numElements, unsigned stride)
+{
+	VulkanUAV* view = new VulkanUAV(*this);
+	view->descriptor.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	view->descriptor.bufferInfo = { static_cast<VulkanBuffer*>(buffer)->buffer, 0, VkDeviceSize(numElements) * stride };
+	return view;
+}
+
+UnorderedAccessView* VulkanDevice::createByteAddressUAV(Buffer* buffer, unsigned numElements)
+{
+	// Raw view elements are 32 bit, like DXGI_FORMAT_R32_TYPELESS
+	VulkanUAV* view = new VulkanUAV(*this);
+	view->descriptor.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	view->descriptor.bufferInfo = { static_cast<VulkanBuffer*>(buffer)->buffer, 0, VkDeviceSize(numElements) * 4 };
+	return view;
+}
+
+ShaderResourceView* VulkanDevice::createSRV(Texture* texture)
+{
+	VulkanSRV* view = new VulkanSRV(*this);
+	view->descriptor.type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+	view->descriptor.imageInfo.imageView = createImageView(static_cast<VulkanTexture*>(texture), static_cast<VulkanTexture*>(texture)->mips);
+	view->descriptor.imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+	return view;
+}
+
+ShaderResourceView* VulkanDevice::createTypedSRV(Buffer* buffer, unsigned numElements, Format format)
+{
+	VulkanSRV* view = new VulkanSRV(*this);
+	view->descriptor.type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+	view->descriptor.bufferView = createBufferView(static_cast<VulkanBuffer*>(buffer), vkFormat(format), VkDeviceSize(numElements) * formatBytes(format));
+	return view;
+}
+
+ShaderResourceView* VulkanDevice::createStructuredSRV(Buffer* buffer, unsigned numElements, unsigned stride)
+{
+	VulkanSRV* view = new VulkanSRV(*this);
+	view->descriptor.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	view->descriptor.bufferInfo = { static_cast<VulkanBuffer*>(buffer)->buffer, 0, VkDeviceSize(numElements) * stride };
+	return view;
+}
+
+ShaderResourceView* VulkanDevice::createByteAddressSRV(Buffer* buffer, unsigned numElements)
+{
+	// Raw view elements are 32 bit, like DXGI_FORMAT_R32_TYPELESS
+	VulkanSRV* view = new VulkanSRV(*this);
+	view->descriptor.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	view->descriptor.bufferInfo = { static_cast<VulkanBuffer*>(buffer)->buffer, 0, VkDeviceSize(numElements) * 4 };
+	return view;
+}
+
+ComputeShader* VulkanDevice::createComputeShader(const unsigned char* shaderBytes, size_t size)
+{
+	// Mapped files are page aligned, SPIR-V words can be read in place
+	VkShaderModuleCreateInfo moduleInfo = {};
+	moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	moduleInfo.codeSize = size;
+	moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderBytes);
+
+	VulkanComputeShader* shader = new VulkanComputeShader(*this);
+	VkResult result = vkCreateShaderModule(device, &moduleInfo, nullptr, &shader->module);
+	assert(result == VK_SUCCESS);
+	return shader;
+}
+
+VulkanComputeShader::Pipeline& VulkanDevice::getPipeline(VulkanComputeShader* shader, const std::vector<uint32_t>& signature)
+{
+	// Pipelines of one shader can be prepared on a loading thread while it's dispatched
+	std::lock_guard<std::mutex> lock(shader->pipelineMutex);
+	auto it = shader->pipelines.find(signature);
+	if (it != shader->pipelines.end())
+		return it->second;
+
+	// Signature entries are (binding << 8) | descriptor type
+	std::vector<VkDescriptorSetLayoutBinding> bindings;
+	for (uint32_t entry : signature)
+	{
+		VkDescriptorSetLayoutBinding binding = {};
+		binding.binding = entry >> 8;
+		binding.descriptorType = static_cast<VkDescriptorType>(entry & 0xff);
+		binding.descriptorCount = 1;
+		binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		bindings.push_back(binding);
+	}
+
+	VulkanComputeShader::Pipeline pipeline;
+
+	VkDescriptorSetLayoutCreateInfo setLayoutInfo = {};
+	setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	setLayoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+	setLayoutInfo.pBindings = bindings.data();
+	VkResult result = vkCreateDescriptorSetLayout(device, &setLayoutInfo, nullptr, &pipeline.setLayout);
+	assert(result == VK_SUCCESS);
+
+	VkPipelineLayoutCreateInfo layoutInfo = {};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	layoutInfo.setLayoutCount = 1;
+	layoutInfo.pSetLayouts = &pipeline.setLayout;
+	result = vkCreatePipelineLayout(device, &layoutInfo, nullptr, &pipeline.layout);
+	assert(result == VK_SUCCESS);
+
+	VkComputePipelineCreateInfo pipelineInfo = {};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	pipelineInfo.stage.module = shader->module;
+	pipelineInfo.stage.pName = "main";
+	pipelineInfo.layout = pipeline.layout;
+	result = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline.pipeline);
+	assert(result == VK_SUCCESS);
+
+	return shader->pipelines[signature] = pipeline;
+}
+
+void VulkanDevice::updateConstantBuffer(Buffer* cbuffer, const void* data, size_t bytes)
+{
+	// No renaming like D3D11 WRITE_DISCARD. Wait for submitted frames, commands recorded
+	// in the current frame will see the new data.
+	VulkanBuffer* buffer = static_cast<VulkanBuffer*>(cbuffer);
+	assert(buffer->mapped && bytes <= buffer->size);
+	waitIdle();
+	memcpy(buffer->mapped, data, bytes);
+}
+
+void VulkanDevice::writeBuffer(Buffer* buffer, const void* data, size_t bytes)
+{
+	// Dynamic buffers switch to the instance of this frame, commands recorded earlier in the frame see the new data.
+	// Staging buffers wait for the copies reading them like D3D11 Map(WRITE).
+	VulkanBuffer* vkBuffer = static_cast<VulkanBuffer*>(buffer);
+	assert(vkBuffer->mapped && bytes <= vkBuffer->size);
+	if (vkBuffer->renamed)
+		vkBuffer->offset = frameIndex * vkBuffer->size;
+	else
+		waitIdle();
+	memcpy(static_cast<uint8_t*>(vkBuffer->mapped) + vkBuffer->offset, data, bytes);
+}
+
+void VulkanDevice::updateBuffer(Buffer* buffer, const void* data, size_t bytes)
+{
+	// What a D3D11 driver does: copy the data to upload memory and record a GPU copy
+	Frame& frame = frames[frameIndex];
+	if (!frame.uploadBuffer || frame.uploadOffset + bytes > frame.uploadBuffer->size)
+	{
+		VkDeviceSize size = std::max(VkDeviceSize(bytes), frame.uploadBuffer ? frame.uploadBuffer->size * 2 : VkDeviceSize(1 << 20));
+		if (frame.uploadBuffer)
+			frame.retiredUploads.push_back(frame.uploadBuffer);
+		frame.uploadBuffer = allocateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+											VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		frame.uploadOffset = 0;
+	}
+
+	memcpy(static_cast<uint8_t*>(frame.uploadBuffer->mapped) + frame.uploadOffset, data, bytes);
+	recordCopy(static_cast<VulkanBuffer*>(buffer)->buffer, frame.uploadBuffer->buffer, frame.uploadOffset, bytes);
+	frame.uploadOffset += bytes;
+}
+
+void VulkanDevice::readBuffer(Buffer* buffer, void* data, size_t bytes)
+{
+	// Like D3D11 Map(READ): submit the copies and wait for them. Copies submitted with an earlier frame only need the wait.
+	VulkanBuffer* vkBuffer = static_cast<VulkanBuffer*>(buffer);
+	assert(vkBuffer->mapped && bytes <= vkBuffer->size);
+	if (frames[frameIndex].copies)
+		presentFrame();
+	waitIdle();
+	memcpy(data, vkBuffer->mapped, bytes);
+}
+
+void VulkanDevice::recordCopy(VkBuffer destination, VkBuffer source, VkDeviceSize sourceOffset, VkDeviceSize bytes)
+{
+	VkCommandBuffer cmd = frames[frameIndex].commandBuffer;
+	frames[frameIndex].copies = true;
+
+	VkMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+						 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+	VkBufferCopy region = {};
+	region.srcOffset = sourceOffset;
+	region.dstOffset = 0;
+	region.size = bytes;
+	vkCmdCopyBuffer(cmd, source, destination, 1, &region);
+
+	// Later dispatches, copies and host reads see the data
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT |
+							VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_READ_BIT;
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+						 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+						 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+// Null slots are left unbound
+void VulkanDevice::gatherDescriptors(std::initializer_list<Buffer*> cbs,
+									 std::initializer_list<ShaderResourceView*> srvs,
+									 std::initializer_list<UnorderedAccessView*> uavs,
+									 std::initializer_list<SamplerState*> samplers,
+									 std::vector<VulkanDescriptor>& descriptors, std::vector<uint32_t>& bindings, std::vector<uint32_t>& signature)
+{
+	auto addDescriptor = [&](uint32_t binding, const VulkanDescriptor& descriptor)
+	{
+		descriptors.push_back(descriptor);
+		bindings.push_back(binding);
+		signature.push_back((binding << 8) | descriptor.type);
+	};
+
+	uint32_t slot = 0;
+	for (auto cb : cbs)
+	{
+		if (cb)
+		{
+			VulkanBuffer* buffer = static_cast<VulkanBuffer*>(cb);
+			VulkanDescriptor descriptor = {};
+			descriptor.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			descriptor.bufferInfo = { buffer->buffer, 0, buffer->size };
+			addDescriptor(VULKAN_CBV_BINDING + slot, descriptor);
+		}
+		slot++;
+	}
+
+	slot = 0;
+	for (auto srv : srvs)
+	{
+		if (srv)
+			addDescriptor(VULKAN_SRV_BINDING + slot, static_cast<VulkanSRV*>(srv)->descriptor);
+		slot++;
+	}
+
+	slot = 0;
+	for (auto uav : uavs)
+	{
+		if (uav)
+			addDescriptor(VULKAN_UAV_BINDING + slot, static_cast<VulkanUAV*>(uav)->descriptor);
+		slot++;
+	}
+
+	slot = 0;
+	for (auto sampler : samplers)
+	{
+		if (sampler)
+		{
+			VulkanDescriptor descriptor = {};
+			descriptor.type = VK_DESCRIPTOR_TYPE_SAMPLER;
+			descriptor.imageInfo.sampler = static_cast<VulkanSampler*>(sampler)->sampler;
+			addDescriptor(VULKAN_SAMPLER_BINDING + slot, descriptor);
+		}
+		slot++;
+	}
+}
+
+void VulkanDevice::prepareDispatch(ComputeShader* shader,
+								   std::initializer_list<Buffer*> cbs,
+								   std::initializer_list<ShaderResourceView*> srvs,
+								   std::initializer_list<UnorderedAccessView*> uavs,
+								   std::initializer_list<SamplerState*> samplers)
+{
+	std::vector<VulkanDescriptor> descriptors;
+	std::vector<uint32_t> bindings;
+	std::vector<uint32_t> signature;
+	gatherDescriptors(cbs, srvs, uavs, samplers, descriptors, bindings, signature);
+	getPipeline(static_cast<VulkanComputeShader*>(shader), signature);
+}
+
+void VulkanDevice::dispatch(ComputeShader* shader, uint3 resolution, uint3 groupSize,
+							std::initializer_list<Buffer*> cbs,
+							std::initializer_list<ShaderResourceView*> srvs,
+							std::initializer_list<UnorderedAccessView*> uavs,
+							std::initializer_list<SamplerState*> samplers)
+{
+	// Descriptor sets are allocated from the frame pool and recycled when the frame fence signals
+	Frame& frame = frames[frameIndex];
+	recordCompute(frame.commandBuffer, frame.descriptorPool, shader, resolution, groupSize, cbs, srvs, uavs, samplers);
+}
+
+void VulkanDevice::recordCompute(VkCommandBuffer cmd, VkDescriptorPool descriptorPool, ComputeShader* shader, uint3 resolution,
+								 uint3 groupSize,
+								 std::initializer_list<Buffer*> cbs,
+								 std::initializer_list<ShaderResourceView*> srvs,
+								 std::initializer_list<UnorderedAccessView*> uavs,
+								 std::initializer_list<SamplerState*> samplers)
+{
+	VulkanComputeShader* vkShader = static_cast<VulkanComputeShader*>(shader);
+
+	std::vector<VulkanDescriptor> descriptors;
+	std::vector<uint32_t> bindings;
+	std::vector<uint32_t> signature;
+	gatherDescriptors(cbs, srvs, uavs, samplers, descriptors, bindings, signature);
+
+	VulkanComputeShader::Pipeline& pipeline = getPipeline(vkShader, signature);
+
+	VkDescriptorSetAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = descriptorPool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = &pipeline.setLayout;
+
+	VkDescriptorSet set = VK_NULL_HANDLE;
+	VkResult result = vkAllocateDescriptorSets(device, &allocInfo, &set);
+	assert(result == VK_SUCCESS);
+
+	std::vector<VkWriteDescriptorSet> writes(descriptors.size());
+	for (size_t i = 0; i < descriptors.size(); ++i)
+	{
+		VkWriteDescriptorSet& write = writes[i];
+		write = {};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = set;
+		write.dstBinding = bindings[i];
+		write.descriptorCount = 1;
+		write.descriptorType = descriptors[i].type;
+		write.pBufferInfo = &descriptors[i].bufferInfo;
+		write.pTexelBufferView = &descriptors[i].bufferView;
+		write.pImageInfo = &descriptors[i].imageInfo;
+	}
+	vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+	// Render
+	uint3 groups = divRoundUp(resolution, groupSize);
+	assert(groups.x <= maxDispatchGroups && groups.y <= maxDispatchGroups && groups.z <= maxDispatchGroups);
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.pipeline);
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.layout, 0, 1, &set, 0, nullptr);
+	vkCmdDispatch(cmd, groups.x, groups.y, groups.z);
+
+	// D3D11 serializes dispatches writing the same UAV. Vulkan needs an explicit barrier for the same behavior.
+	VkMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+CommandList* VulkanDevice::createCommandList()
+{
+	VulkanCommandList* list = new VulkanCommandList(*this);
+
+	// Command pools are externally synchronized, each recording thread needs its own
+	VkCommandPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	poolInfo.queueFamilyIndex = queueFamily;
+	VkResult result = vkCreateCommandPool(device, &poolInfo, nullptr, &list->commandPool);
+	assert(result == VK_SUCCESS);
+
+	list->commandBuffers.resize(frames.size());
+	VkCommandBufferAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = list->commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+	allocInfo.commandBufferCount = static_cast<uint32_t>(frames.size());
+	result = vkAllocateCommandBuffers(device, &allocInfo, list->commandBuffers.data());
+	assert(result == VK_SUCCESS);
+
+	for (size_t i = 0; i < frames.size(); ++i)
+		list->descriptorPools.push_back(createDescriptorPool());
+	return list;
+}
+
+void VulkanDevice::beginCommandList(CommandList* list)
+{
+	// The buffers of a frame are free again once beginFrame has waited for its fence. The device thread doesn't
+	// present while lists record, so reading the frame index is safe.
+	VulkanCommandList* vkList = static_cast<VulkanCommandList*>(list);
+	vkList->frameIndex = frameIndex;
+	vkResetDescriptorPool(device, vkList->descriptorPools[frameIndex], 0);
+
+	VkCommandBufferInheritanceInfo inheritanceInfo = {};
+	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	beginInfo.pInheritanceInfo = &inheritanceInfo;
+	vkBeginCommandBuffer(vkList->commandBuffers[frameIndex], &beginInfo);
+}
+
+void VulkanDevice::recordDispatch(CommandList* list, ComputeShader* shader, uint3 resolution, uint3 groupSize,
+								  std::initializer_list<Buffer*> cbs,
+								  std::initializer_list<ShaderResourceView*> srvs,
+								  std::initializer_list<UnorderedAccessView*> uavs,
+								  std::initializer_list<SamplerState*> samplers)
+{
+	VulkanCommandList* vkList = static_cast<VulkanCommandList*>(list);
+	recordCompute(vkList->commandBuffers[vkList->frameIndex], vkList->descriptorPools[vkList->frameIndex], shader, resolution, groupSize,
+				  cbs, srvs, uavs, samplers);
+}
+
+void VulkanDevice::endCommandList(CommandList* list)
+{
+	VulkanCommandList* vkList = static_cast<VulkanCommandList*>(list);
+	vkEndCommandBuffer(vkList->commandBuffers[vkList->frameIndex]);
+}
+
+void VulkanDevice::executeCommandList(CommandList* list)
+{
+	// The frame command buffer ends with a barrier after its last dispatch, so the list is ordered after it
+	VulkanCommandList* vkList = static_cast<VulkanCommandList*>(list);
+	assert(vkList->frameIndex == frameIndex);
+	vkCmdExecuteCommands(frames[frameIndex].commandBuffer, 1, &vkList->commandBuffers[frameIndex]);
+}
+
+void VulkanDevice::copyBuffer(Buffer* destination, Buffer* source, size_t bytes)
+{
+	VulkanBuffer* vkSource = static_cast<VulkanBuffer*>(source);
+	recordCopy(static_cast<VulkanBuffer*>(destination)->buffer, vkSource->buffer, vkSource->offset, bytes);
+}
+
+void VulkanDevice::beginFrame()
+{
+	Frame& frame = frames[frameIndex];
+
+	// Wait until the GPU is done with this frame's command buffer and descriptors
+	if (frame.submitted)
+	{
+		vkWaitForFences(device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+		vkResetFences(device, 1, &frame.fence);
+		resolveQueries(frameIndex);
+		frame.submitted = false;
+	}
+
+	// Outgrown upload buffers wait for the other frame in their destructor, which is rare
+	for (VulkanBuffer* buffer : frame.retiredUploads)
+		delete buffer;
+	frame.retiredUploads.clear();
+	frame.uploadOffset = 0;
+	frame.copies = false;
+
+	vkResetDescriptorPool(device, frame.descriptorPool, 0);
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(frame.commandBuffer, &beginInfo);
+
+	// Reset the used part of the frame's query range for reuse
+	if (!frame.queryIds.empty())
+		vkCmdResetQueryPool(frame.commandBuffer, queryPool, frameIndex * queriesPerFrame * 2, static_cast<uint32_t>(frame.queryIds.size() * 2));
+	frame.queryIds.clear();
+	frame.queriesResolved = false;
+}
+
+void VulkanDevice::resolveQueries(unsigned index)
+{
+	Frame& frame = frames[index];
+	if (frame.queriesResolved)
+		return;
+
+	const uint64_t* timestamps = static_cast<const uint64_t*>(queryReadback->mapped) + index * queriesPerFrame * 2;
+	for (size_t query = 0; query < frame.queryIds.size(); ++query)
+	{
+		uint64_t d = (timestamps[query * 2 + 1] - timestamps[query * 2]) & timestampMask;
+		float delta = float(double(d) * properties.limits.timestampPeriod / 1000000.0);
+		int64_t startNanos = timestampsCalibrated ?
+			int64_t(double(timestamps[query * 2] & timestampMask) * properties.limits.timestampPeriod) + timestampOffsetNanos : 0;
+		resolvedQueries.push_back({ frame.queryIds[query], delta, startNanos });
+	}
+	frame.queriesResolved = true;
+}
+
+void VulkanDevice::presentFrame()
+{
+	// No swap chain. A frame is a command buffer submission guarded by a fence.
+	Frame& frame = frames[frameIndex];
+
+	// All timestamps of the frame in one copy. WAIT makes the copy wait for the last end timestamp.
+	if (!frame.queryIds.empty())
+	{
+		uint32_t first = frameIndex * queriesPerFrame * 2;
+		uint32_t count = static_cast<uint32_t>(frame.queryIds.size() * 2);
+		vkCmdCopyQueryPoolResults(frame.commandBuffer, queryPool, first, count, queryReadback->buffer, first * sizeof(uint64_t),
+								  sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		vkCmdPipelineBarrier(frame.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+							 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	vkEndCommandBuffer(frame.commandBuffer);
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &frame.commandBuffer;
+	VkResult result = vkQueueSubmit(queue, 1, &submitInfo, frame.fence);
+	assert(result == VK_SUCCESS);
+
+	frame.submitted = true;
+	gpuIdle = false;
+
+	if (headless)
+	{
+		vkWaitForFences(device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+		resolveQueries(frameIndex);
+		gpuIdle = true;
+	}
+
+	frameIndex = (frameIndex + 1) % frames.size();
+	beginFrame();
+}
+
+QueryHandle VulkanDevice::startPerformanceQuery(unsigned id)
+{
+	Frame& frame = frames[frameIndex];
+	assert(frame.queryIds.size() < queriesPerFrame);
+
+	uint32_t index = static_cast<uint32_t>(frameIndex * queriesPerFrame + frame.queryIds.size());
+	frame.queryIds.push_back(id);
+
+	// Start timestamp waits for the compute work of previous dispatches
+	vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, queryPool, index * 2);
+
+	QueryHandle out {index};
+	return out;
+}
+
+void VulkanDevice::endPerformanceQuery(QueryHandle queryHandle)
+{
+	vkCmdWriteTimestamp(frames[frameIndex].commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, queryHandle.queryIndex * 2 + 1);
+}
+
+void VulkanDevice::processPerformanceResults(std::vector<QueryResult>& results)
+{
+	// Frames that have finished without blocking, oldest first
+	for (unsigned i = 1; i <= frames.size(); ++i)
+	{
+		unsigned index = (frameIndex + i) % frames.size();
+		Frame& frame = frames[index];
+		if (frame.submitted)
+		{
+			if (vkGetFenceStatus(device, frame.fence) != VK_SUCCESS)
+				break;
+			resolveQueries(index);
+		}
+	}
+
+	results.insert(results.end(), resolvedQueries.begin(), resolvedQueries.end());
+	resolvedQueries.clear();
+}
+
+bool VulkanDevice::calibrateTimestamps()
+{
+	int64_t cpuNanos = 0;
+	uint64_t ticks = 0;
+	if (getCalibratedTimestamps)
+	{
+		VkCalibratedTimestampInfoEXT infos[2] = {};
+		infos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+		infos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+		infos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+		infos[1].timeDomain = steadyClockTimeDomain;
+		uint64_t timestamps[2] = {};
+		uint64_t maxDeviation = 0;
+		if (getCalibratedTimestamps(device, 2, infos, timestamps, &maxDeviation) != VK_SUCCESS)
+			return false;
+
+		ticks = timestamps[0];
+#ifdef _WIN32
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		cpuNanos = int64_t(double(timestamps[1]) * 1e9 / double(frequency.QuadPart));
+#else
+		cpuNanos = int64_t(timestamps[1]);
+#endif
+	}
+	else
+	{
+		// Without the extension: a timestamp of an otherwise empty submission on the idle queue, taken to be written
+		// halfway between the submit and the end of the wait. Accurate to the submission latency.
+		VkQueryPoolCreateInfo queryPoolInfo = {};
+		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolInfo.queryCount = 1;
+		VkQueryPool calibrationPool = VK_NULL_HANDLE;
+		VkResult result = vkCreateQueryPool(device, &queryPoolInfo, nullptr, &calibrationPool);
+		assert(result == VK_SUCCESS);
+
+		waitIdle();
+		auto before = std::chrono::steady_clock::now();
+		executeImmediate([&](VkCommandBuffer cmd)
+		{
+			vkCmdResetQueryPool(cmd, calibrationPool, 0, 1);
+			vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, calibrationPool, 0);
+		});
+		auto after = std::chrono::steady_clock::now();
+
+		result = vkGetQueryPoolResults(device, calibrationPool, 0, 1, sizeof(ticks), &ticks, sizeof(ticks), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+		vkDestroyQueryPool(device, calibrationPool, nullptr);
+		if (result != VK_SUCCESS)
+			return false;
+
+		cpuNanos = std::chrono::duration_cast<std::chrono::nanoseconds>((before + (after - before) / 2).time_since_epoch()).count();
+	}
+
+	timestampOffsetNanos = cpuNanos - int64_t(double(ticks & timestampMask) * properties.limits.timestampPeriod);
+	timestampsCalibrated = true;
+	return true;
+}
+
+std::string VulkanDevice::driverVersion()
+{
+	uint32_t version = properties.driverVersion;
+
+	// Encoding is vendor specific. NVIDIA uses 10.8.8.6 bits, the rest follow VK_MAKE_VERSION.
+	char text[64];
+	if (properties.vendorID == 0x10de)
+		snprintf(text, sizeof(text), "%u.%u.%u.%u", version >> 22, (version >> 14) & 0xff, (version >> 6) & 0xff, version & 0x3f);
+	else
+		snprintf(text, sizeof(text), "%u.%u.%u", VK_VERSION_MAJOR(version), VK_VERSION_MINOR(version), VK_VERSION_PATCH(version));
+	return text;
+}
@@ -0,0 +1,285 @@
+#pragma once
+#include "device.h"
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <array>
+#include <map>
+#include <mutex>
+
+// HLSL register spaces are flattened to a single descriptor set when compiling SPIR-V:
+// dxc -fvk-b-shift 0 0 -fvk-t-shift 16 0 -fvk-u-shift 32 0 -fvk-s-shift 48 0
+const uint32_t VULKAN_CBV_BINDING = 0;
+const uint32_t VULKAN_SRV_BINDING = 16;
+const uint32_t VULKAN_UAV_BINDING = 32;
+const uint32_t VULKAN_SAMPLER_BINDING = 48;
+
+// Everything needed to write one descriptor. Views and buffers fill in the fields matching their type.
+struct VulkanDescriptor
+{
+	VkDescriptorType type;
+	VkDescriptorBufferInfo bufferInfo;
+	VkBufferView bufferView;
+	VkDescriptorImageInfo imageInfo;
+};
+
+class VulkanDevice;
+
+class VulkanBuffer : public Buffer
+{
+public:
+	VulkanBuffer(VulkanDevice& owner) : owner(owner) {}
+	~VulkanBuffer();
+
+	VulkanDevice& owner;
+	VkBuffer buffer = VK_NULL_HANDLE;
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	VkDeviceSize size = 0;
+	void* mapped = nullptr;
+
+	// Dynamic buffers have an instance of size bytes per frame, renamed on write like Map(WRITE_DISCARD)
+	bool renamed = false;
+	VkDeviceSize offset = 0;		// Of the current instance
+};
+
+class VulkanTexture : public Texture
+{
+public:
+	VulkanTexture(VulkanDevice& owner) : owner(owner) {}
+	~VulkanTexture();
+
+	VulkanDevice& owner;
+	VkImage image = VK_NULL_HANDLE;
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D;
+	VkFormat format = VK_FORMAT_UNDEFINED;
+	unsigned mips = 1;
+};
+
+class VulkanSRV : public ShaderResourceView
+{
+public:
+	VulkanSRV(VulkanDevice& owner) : owner(owner) {}
+	~VulkanSRV();
+
+	VulkanDevice& owner;
+	VulkanDescriptor descriptor = {};
+};
+
+class VulkanUAV : public UnorderedAccessView
+{
+public:
+	VulkanUAV(VulkanDevice& owner) : owner(owner) {}
+	~VulkanUAV();
+
+	VulkanDevice& owner;
+	VulkanDescriptor descriptor = {};
+};
+
+class VulkanSampler : public SamplerState
+{
+public:
+	VulkanSampler(VulkanDevice& owner) : owner(owner) {}
+	~VulkanSampler();
+
+	VulkanDevice& owner;
+	VkSampler sampler = VK_NULL_HANDLE;
+};
+
+class VulkanComputeShader : public ComputeShader
+{
+public:
+	VulkanComputeShader(VulkanDevice& owner) : owner(owner) {}
+	~VulkanComputeShader();
+
+	// SPIR-V doesn't tell the descriptor type apart from the resource declaration (texel buffer vs storage buffer),
+	// so pipelines are created lazily for each combination of bound descriptor types
+	struct Pipeline
+	{
+		VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+		VkPipelineLayout layout = VK_NULL_HANDLE;
+		VkPipeline pipeline = VK_NULL_HANDLE;
+	};
+
+	VulkanDevice& owner;
+	VkShaderModule module = VK_NULL_HANDLE;
+	std::map<std::vector<uint32_t>, Pipeline> pipelines;
+	std::mutex pipelineMutex;
+};
+
+// Secondary command buffers and descriptor pools of each frame in flight, recorded on one thread at a time
+class VulkanCommandList : public CommandList
+{
+public:
+	VulkanCommandList(VulkanDevice& owner) : owner(owner) {}
+	~VulkanCommandList();
+
+	VulkanDevice& owner;
+	VkCommandPool commandPool = VK_NULL_HANDLE;
+	std::vector<VkCommandBuffer> commandBuffers;
+	std::vector<VkDescriptorPool> descriptorPools;
+	unsigned frameIndex = 0;		// Of the recording
+};
+
+std::vector<std::string> enumerateVulkanAdapters();
+
+class VulkanDevice : public Device
+{
+public:
+
+	// Headless device waits for every submitted frame, so that its queries can be resolved right away.
+	// Otherwise two frames are kept in flight.
+	VulkanDevice(unsigned adapterIndex, bool headless);
+	~VulkanDevice();
+
+	// Create resources
+	ComputeShader* createComputeShader(const unsigned char* shaderBytes, size_t size) override;
+
+	Buffer* createConstantBuffer(unsigned bytes) override;
+	Buffer* createBuffer(unsigned numElements, unsigned strideBytes, BufferType type = BufferType::Default) override;
+	Texture* createTexture2d(uint2 dimensions, Format format, unsigned mips) override;
+	Texture* createTexture3d(uint3 dimensions, Format format, unsigned mips) override;
+	SamplerState* createSampler(SamplerType type) override;
+	Buffer* createDynamicBuffer(unsigned bytes) override;
+	Buffer* createStagingBuffer(unsigned bytes, StagingType type) override;
+
+	UnorderedAccessView* createUAV(Texture* texture) override;
+	UnorderedAccessView* createTypedUAV(Buffer* buffer, unsigned numElements, Format format) override;
+	UnorderedAccessView* createStructuredUAV(Buffer* buffer, unsigned numElements, unsigned stride) override;
+	UnorderedAccessView* createByteAddressUAV(Buffer* buffer, unsigned numElements) override;
+
+	ShaderResourceView* createSRV(Texture* texture) override;
+	ShaderResourceView* createTypedSRV(Buffer* buffer, unsigned numElements, Format format) override;
+	ShaderResourceView* createStructuredSRV(Buffer* buffer, unsigned numElements, unsigned stride) override;
+	ShaderResourceView* createByteAddressSRV(Buffer* buffer, unsigned numElements) override;
+
+	// Data update
+	using Device::updateConstantBuffer;
+	void updateConstantBuffer(Buffer* cbuffer, const void* data, size_t bytes) override;
+	void writeBuffer(Buffer* buffer, const void* data, size_t bytes) override;
+	void updateBuffer(Buffer* buffer, const void* data, size_t bytes) override;
+	void readBuffer(Buffer* buffer, void* data, size_t bytes) override;
+
+	// Commands
+	void dispatch(ComputeShader* shader, uint3 resolution, uint3 groupSize,
+					std::initializer_list<Buffer*> cbs,
+					std::initializer_list<ShaderResourceView*> srvs,
+					std::initializer_list<UnorderedAccessView*> uavs = {},
+					std::initializer_list<SamplerState*> samplers = {}) override;
+	void prepareDispatch(ComputeShader* shader,
+						 std::initializer_list<Buffer*> cbs,
+						 std::initializer_list<ShaderResourceView*> srvs,
+						 std::initializer_list<UnorderedAccessView*> uavs = {},
+						 std::initializer_list<SamplerState*> samplers = {}) override;
+	void copyBuffer(Buffer* destination, Buffer* source, size_t bytes) override;
+	void presentFrame() override;
+	CommandList* createCommandList() override;
+	void beginCommandList(CommandList* list) override;
+	void recordDispatch(CommandList* list, ComputeShader* shader, uint3 resolution, uint3 groupSize,
+						std::initializer_list<Buffer*> cbs,
+						std::initializer_list<ShaderResourceView*> srvs,
+						std::initializer_list<UnorderedAccessView*> uavs = {},
+						std::initializer_list<SamplerState*> samplers = {}) override;
+	void endCommandList(CommandList* list) override;
+	void executeCommandList(CommandList* list) override;
+
+	// Performance querys
+	QueryHandle startPerformanceQuery(unsigned id) override;
+	void endPerformanceQuery(QueryHandle queryHandle) override;
+	void processPerformanceResults(std::vector<QueryResult>& results) override;
+	bool calibrateTimestamps() override;
+
+	const char* shaderFileExtension() const override { return ".spv"; }
+	std::string driverVersion() override;
+	bool supportsWaveIntrinsics() const override { return waveIntrinsics; }
+	bool supportsTypedUAV(Format format, bool texture) const override;
+
+	// Device
+	VkDevice getDevice() { return device; }
+	const VkPhysicalDeviceProperties& getProperties() { return properties; }
+
+	// Waits until the GPU no longer references any resource. Called before destroying API objects.
+	void waitIdle();
+
+private:
+
+	struct Frame
+	{
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		VkFence fence = VK_NULL_HANDLE;
+		VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+		bool submitted = false;
+
+		// Ids of the queries in this frame's range of the pool. Its timestamps are copied to the readback buffer at the end of the frame.
+		std::vector<unsigned> queryIds;
+		bool queriesResolved = false;
+
+		// updateBuffer data, read by the copies of this frame. Grows, outgrown buffers are released with the frame.
+		VulkanBuffer* uploadBuffer = nullptr;
+		VkDeviceSize uploadOffset = 0;
+		std::vector<VulkanBuffer*> retiredUploads;
+
+		// Copies recorded, readBuffer submits the frame
+		bool copies = false;
+	};
+
+	uint32_t findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties);
+	VulkanBuffer* allocateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags memoryFlags);
+	VkBufferView createBufferView(VulkanBuffer* buffer, VkFormat format, VkDeviceSize range);
+	VkImageView createImageView(VulkanTexture* texture, unsigned mips);
+	VulkanTexture* createTexture(VkImageType type, VkImageViewType viewType, VkExtent3D extent, Format format, unsigned mips);
+	VulkanComputeShader::Pipeline& getPipeline(VulkanComputeShader* shader, const std::vector<uint32_t>& signature);
+	void gatherDescriptors(std::initializer_list<Buffer*> cbs,
+						   std::initializer_list<ShaderResourceView*> srvs,
+						   std::initializer_list<UnorderedAccessView*> uavs,
+						   std::initializer_list<SamplerState*> samplers,
+						   std::vector<VulkanDescriptor>& descriptors, std::vector<uint32_t>& bindings, std::vector<uint32_t>& signature);
+
+	VkDescriptorPool createDescriptorPool();
+
+	// Dispatch and the barrier after it. Descriptor sets come from the pool. Thread safe with separate pools and command buffers.
+	void recordCompute(VkCommandBuffer cmd, VkDescriptorPool descriptorPool, ComputeShader* shader, uint3 resolution, uint3 groupSize,
+					   std::initializer_list<Buffer*> cbs,
+					   std::initializer_list<ShaderResourceView*> srvs,
+					   std::initializer_list<UnorderedAccessView*> uavs,
+					   std::initializer_list<SamplerState*> samplers);
+
+	// Copy in the frame command buffer, ordered after earlier dispatches and copies like D3D11
+	void recordCopy(VkBuffer destination, VkBuffer source, VkDeviceSize sourceOffset, VkDeviceSize bytes);
+
+	// Executes a one-off command buffer (resource initialization) and waits for it
+	void executeImmediate(const std::function<void(VkCommandBuffer)>& record);
+
+	void beginFrame();
+
+	// Reads the timestamps of a finished frame from the readback buffer into resolvedQueries
+	void resolveQueries(unsigned index);
+
+	// Vulkan
+	VkInstance instance = VK_NULL_HANDLE;
+	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+	VkDevice device = VK_NULL_HANDLE;
+	VkQueue queue = VK_NULL_HANDLE;
+	uint32_t queueFamily = 0;
+	VkPhysicalDeviceProperties properties;
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	VkCommandPool commandPool = VK_NULL_HANDLE;
+
+	// Frames in flight
+	std::array<Frame, 2> frames;
+	unsigned frameIndex = 0;
+	bool headless = false;
+	bool gpuIdle = true;
+	bool waveIntrinsics = false;
+
+	// Queries. Each frame owns a range of the pool, each query two consecutive timestamps in it.
+	static const unsigned queriesPerFrame = 4096;
+	VkQueryPool queryPool = VK_NULL_HANDLE;
+	VulkanBuffer* queryReadback = nullptr;
+	uint64_t timestampMask = ~0ull;
+	std::vector<QueryResult> resolvedQueries;		// Resolved by beginFrame, returned by the next processPerformanceResults
+
+	// Clock calibration. VK_EXT_calibrated_timestamps when the device can sample the steady_clock domain.
+	PFN_vkGetCalibratedTimestampsEXT getCalibratedTimestamps = nullptr;
+	bool timestampsCalibrated = false;
+	int64_t timestampOffsetNanos = 0;				// steady_clock minus GPU clock
+};
@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 4
+#define LOAD_INVARIANT
+#define WAVE_FIRST_LANE_LOAD
+#define LOAD_CONSTANT
+#include "waveLoadBody.hlsli"
@@ -0,0 +1,6 @@
+#define LOAD_WIDTH 1
+#define LOAD_INVARIANT
+#define WAVE_FIRST_LANE_LOAD
+#define LOAD_RAW
+ByteAddressBuffer sourceData : register(t0);
+#include "waveLoadBody.hlsli"
@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 2
+#define LOAD_INVARIANT
+#define WAVE_FIRST_LANE_LOAD
+Buffer<float2> sourceData : register(t0);
+#include "waveLoadBody.hlsli"
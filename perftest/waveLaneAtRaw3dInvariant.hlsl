@@ -0,0 +1,6 @@
+#define LOAD_WIDTH 3
+#define LOAD_INVARIANT
+#define WAVE_READ_LANE_AT
+#define LOAD_RAW
+ByteAddressBuffer sourceData : register(t0);
+#include "waveLoadBody.hlsli"
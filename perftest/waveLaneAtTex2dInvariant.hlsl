@@ -0,0 +1,6 @@
+#define LOAD_WIDTH 2
+#define LOAD_INVARIANT
+#define WAVE_READ_LANE_AT
+#define LOAD_TEX
+Texture2D<float2> sourceData : register(t0);
+#include "waveLoadBody.hlsli"
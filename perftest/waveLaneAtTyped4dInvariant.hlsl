@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 4
+#define LOAD_INVARIANT
+#define WAVE_READ_LANE_AT
+Buffer<float4> sourceData : register(t0);
+#include "waveLoadBody.hlsli"
@@ -0,0 +1,5 @@
+#define LOAD_WIDTH 1
+#define LOAD_INVARIANT
+#define WAVE_READ_LANE_FIRST
+Buffer<float> sourceData : register(t0);
+#include "waveLoadBody.hlsli"
@@ -0,0 +1,107 @@
+// Shader Model 6 / Vulkan subgroups. Not compiled for the D3D11 backend.
+#include "hash.hlsli"
+#include "loadConstantsGPU.h"
+
+RWBuffer<float> output : register(u0);
+
+cbuffer CB0 : register(b0)
+{
+#if defined(LOAD_CONSTANT)
+	LoadConstantsWithArray loadConstants;
+#else
+	LoadConstants loadConstants;
+#endif
+};
+
+#define THREAD_GROUP_SIZE 256
+
+groupshared float dummyLDS[THREAD_GROUP_SIZE];
+
+// Iteration i of the uniform address loop of the load bodies (LOAD_INVARIANT)
+float4 loadElement(uint i)
+{
+	// Mask with runtime constant to prevent unwanted compiler optimizations
+#if defined(LOAD_TEX)
+	// Same texel order as the 16x16 loop of loadTexBody.hlsli
+	uint2 elemIdx = uint2(i & 15, i >> 4) | loadConstants.elementsMask;
+	float4 v = sourceData[elemIdx];
+#elif defined(LOAD_RAW)
+	uint address = (loadConstants.readStartAddress + i * (4 * LOAD_WIDTH)) | loadConstants.elementsMask;
+#if LOAD_WIDTH == 1
+	float4 v = sourceData.Load(address).xxxx;
+#elif LOAD_WIDTH == 2
+	float4 v = sourceData.Load2(address).xyxy;
+#elif LOAD_WIDTH == 3
+	float4 v = sourceData.Load3(address).xyzx;
+#elif LOAD_WIDTH == 4
+	float4 v = sourceData.Load4(address).xyzw;
+#endif
+#elif defined(LOAD_CONSTANT)
+	float4 v = loadConstants.benchmarkArray[i | loadConstants.elementsMask];
+#else
+	float4 v = sourceData[i | loadConstants.elementsMask];
+#endif
+
+#if defined(LOAD_RAW) || defined(LOAD_CONSTANT) || LOAD_WIDTH == 4
+	return v;
+#elif LOAD_WIDTH == 1
+	return v.xxxx;
+#elif LOAD_WIDTH == 2
+	return v.xyxy;
+#endif
+}
+
+[numthreads(THREAD_GROUP_SIZE, 1, 1)]
+void main(uint3 tid : SV_DispatchThreadID, uint gix : SV_GroupIndex)
+{
+	float4 value = 0.0;
+
+#if defined(WAVE_READ_LANE_FIRST)
+	// Every lane loads, only the first lane's value is used. The compiler may drop the other lanes' loads.
+	[loop]
+	for (uint i = 0; i < 256; ++i)
+	{
+		value += WaveReadLaneFirst(loadElement(i));
+	}
+#elif defined(WAVE_READ_LANE_AT)
+	// Each lane loads one of the next WaveGetLaneCount() iterations, then the lanes are broadcast in order.
+	// One load per lane per wave width iterations. Lane counts are powers of two up to 128, they divide 256.
+	uint laneCount = WaveGetLaneCount();
+	uint lane = WaveGetLaneIndex();
+
+	[loop]
+	for (uint base = 0; base < 256; base += laneCount)
+	{
+		float4 laneValue = loadElement(base + lane);
+
+		[loop]
+		for (uint j = 0; j < laneCount; ++j)
+		{
+			value += WaveReadLaneAt(laneValue, j);
+		}
+	}
+#elif defined(WAVE_FIRST_LANE_LOAD)
+	// Only the first lane loads, the value is broadcast to the wave. One load per wave per iteration.
+	[loop]
+	for (uint i = 0; i < 256; ++i)
+	{
+		float4 laneValue = 0.0;
+		if (WaveIsFirstLane())
+			laneValue = loadElement(i);
+		value += WaveReadLaneFirst(laneValue);
+	}
+#endif
+
+	// Linear write to LDS (no bank conflicts). Significantly faster than memory loads.
+	dummyLDS[gix] = value.x + value.y + value.z + value.w;
+
+	GroupMemoryBarrierWithGroupSync();
+
+	// This branch is never taken, but the compiler doesn't know it
+	// Optimizer would remove all the memory loads if the data wouldn't be potentially used
+	[branch]
+	if (loadConstants.writeIndex != 0xffffffff)
+	{
+		output[tid.x + tid.y] = dummyLDS[loadConstants.writeIndex];
+	}
+}
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "dataTypes.h"
+#include "datatypes.h"
 #include <windows.h>
 
 enum class MessageStatus